@@ -0,0 +1,615 @@
+#include "GameTreeGenerator.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr qint64 WriteChunkSize = 1024 * 1024;
+constexpr int RegionSectorSize = 4096;
+constexpr int RegionChunkCount = 1024;  // 32x32 chunks per region
+constexpr quint8 RegionCompressionZlib = 2;
+
+constexpr qint64 KiB = 1024;
+constexpr qint64 MiB = 1024 * KiB;
+
+/**
+ * @brief SplitMix64: tiny, fast and identical on every platform
+ */
+class Prng {
+public:
+    explicit Prng(quint64 seed) : m_state(seed) {}
+
+    quint64 next()
+    {
+        quint64 z = (m_state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    double uniform()
+    {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    int range(int low, int high)
+    {
+        return low + static_cast<int>(next() % static_cast<quint64>(high - low + 1));
+    }
+
+    /**
+     * @brief Log-uniform size: most files small, a few very large
+     */
+    qint64 logSize(qint64 low, qint64 high)
+    {
+        return static_cast<qint64>(low * std::pow(double(high) / double(low), uniform()));
+    }
+
+    void fill(char* data, qint64 size)
+    {
+        qint64 i = 0;
+        for (; i + 8 <= size; i += 8) {
+            quint64 word = next();
+            memcpy(data + i, &word, 8);
+        }
+        if (i < size) {
+            quint64 word = next();
+            memcpy(data + i, &word, size - i);
+        }
+    }
+
+private:
+    quint64 m_state;
+};
+
+quint64 fnv1a(const QByteArray& data)
+{
+    quint64 hash = 0xCBF29CE484222325ULL;
+    for (char c : data) {
+        hash ^= static_cast<quint8>(c);
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Chunk payload shaped like block-state NBT: long runs of few values
+ *
+ * Compresses to roughly the ratio real region data does, unlike pure noise.
+ */
+QByteArray chunkPayload(Prng& rng, int rawSize)
+{
+    QByteArray payload(rawSize, Qt::Uninitialized);
+    char* data = payload.data();
+    int i = 0;
+    while (i < rawSize) {
+        int run = qMin(rawSize - i, rng.range(1, 48));
+        char block = static_cast<char>(rng.range(0, 15));
+        memset(data + i, block, run);
+        i += run;
+    }
+    return payload;
+}
+
+} // namespace
+
+GameTreeGenerator::GameTreeGenerator(const QString& rootPath, double scale, quint64 seed)
+    : m_rootPath(rootPath)
+    , m_scale(scale)
+    , m_countScale(std::sqrt(scale))
+    , m_seed(seed)
+{
+}
+
+QStringList GameTreeGenerator::profileNames()
+{
+    return {"skyrim", "minecraft"};
+}
+
+GameTreeProfile GameTreeGenerator::profile(const QString& name)
+{
+    GameTreeProfile profile;
+    profile.name = name;
+
+    if (name == "skyrim") {
+        profile.gameId = "skyrim_se";
+        profile.trackedPaths = {"Data/", "*.ini", "*.esp", "*.esm", "Saves/"};
+        profile.ignorePatterns = {"*.log", "*.bak", "Logs/", "Crashes/", "*.dmp", "SKSE/Plugins/*.log"};
+    } else if (name == "minecraft") {
+        profile.gameId = "minecraft_java";
+        profile.trackedPaths = {"saves/", "mods/", "config/", "resourcepacks/", "shaderpacks/",
+                                "servers.dat", "options.txt"};
+        profile.ignorePatterns = {"logs/", "crash-reports/", "*.log", "*.log.gz", "screenshots/",
+                                  "replay_recordings/", "usercache.json", "usernamecache.json"};
+    }
+
+    return profile;
+}
+
+Result<qint64, QString> GameTreeGenerator::generate(const QString& profileName)
+{
+    if (!QDir().mkpath(m_rootPath)) {
+        return Result<qint64, QString>::err(QString("Failed to create %1").arg(m_rootPath));
+    }
+
+    if (profileName == "skyrim") {
+        return generateSkyrim();
+    }
+    if (profileName == "minecraft") {
+        return generateMinecraft();
+    }
+    return Result<qint64, QString>::err(QString("Unknown profile: %1").arg(profileName));
+}
+
+Result<qint64, QString> GameTreeGenerator::mutate(const QString& profileName, int round)
+{
+    if (profileName == "skyrim") {
+        return mutateSkyrim(round);
+    }
+    if (profileName == "minecraft") {
+        return mutateMinecraft(round);
+    }
+    return Result<qint64, QString>::err(QString("Unknown profile: %1").arg(profileName));
+}
+
+qint64 GameTreeGenerator::scaledSize(qint64 realisticBytes) const
+{
+    return qMax<qint64>(1, std::llround(realisticBytes * m_scale));
+}
+
+int GameTreeGenerator::scaledCount(int realisticCount) const
+{
+    return qMax(1, static_cast<int>(std::lround(realisticCount * m_countScale)));
+}
+
+quint64 GameTreeGenerator::seedFor(const QString& relativePath, int round) const
+{
+    // Hash of the path, not its position, so adding files never reshuffles others
+    return m_seed ^ fnv1a(relativePath.toUtf8()) ^ (static_cast<quint64>(round) * 0x9E3779B97F4A7C15ULL);
+}
+
+Result<void, QString> GameTreeGenerator::ensureParent(const QString& relativePath)
+{
+    QString parent = QFileInfo(relativePath).path();
+    if (parent == "." || m_createdDirs.contains(parent)) {
+        return Result<void, QString>::ok();
+    }
+
+    if (!QDir(m_rootPath).mkpath(parent)) {
+        return Result<void, QString>::err(QString("Failed to create directory: %1").arg(parent));
+    }
+    m_createdDirs.insert(parent);
+    return Result<void, QString>::ok();
+}
+
+Result<qint64, QString> GameTreeGenerator::writeRandomFile(const QString& relativePath,
+                                                           qint64 size, quint64 seed)
+{
+    auto parentResult = ensureParent(relativePath);
+    if (parentResult.isErr()) {
+        return Result<qint64, QString>::err(parentResult.error());
+    }
+
+    QFile file(QDir(m_rootPath).filePath(relativePath));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return Result<qint64, QString>::err(QString("Failed to write %1").arg(relativePath));
+    }
+
+    Prng rng(seed);
+    QByteArray buffer(static_cast<int>(qMin(size, WriteChunkSize)), Qt::Uninitialized);
+    qint64 remaining = size;
+    while (remaining > 0) {
+        qint64 chunk = qMin(remaining, WriteChunkSize);
+        rng.fill(buffer.data(), chunk);
+        if (file.write(buffer.constData(), chunk) != chunk) {
+            return Result<qint64, QString>::err(QString("Short write to %1").arg(relativePath));
+        }
+        remaining -= chunk;
+    }
+
+    return Result<qint64, QString>::ok(size);
+}
+
+Result<qint64, QString> GameTreeGenerator::writeTextFile(const QString& relativePath,
+                                                         int lines, quint64 seed)
+{
+    auto parentResult = ensureParent(relativePath);
+    if (parentResult.isErr()) {
+        return Result<qint64, QString>::err(parentResult.error());
+    }
+
+    Prng rng(seed);
+    QByteArray content;
+    for (int i = 0; i < lines; ++i) {
+        content += QString("setting%1=%2\n").arg(i).arg(rng.range(0, 100000)).toLatin1();
+    }
+
+    QFile file(QDir(m_rootPath).filePath(relativePath));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(content) != content.size()) {
+        return Result<qint64, QString>::err(QString("Failed to write %1").arg(relativePath));
+    }
+    return Result<qint64, QString>::ok(content.size());
+}
+
+Result<qint64, QString> GameTreeGenerator::patchFile(const QString& relativePath,
+                                                     double fraction, quint64 seed)
+{
+    QFile file(QDir(m_rootPath).filePath(relativePath));
+    if (!file.open(QIODevice::ReadWrite)) {
+        return Result<qint64, QString>::err(QString("Failed to open %1").arg(relativePath));
+    }
+
+    // Rewrite a few scattered 4KiB blocks, like a game updating records in place
+    Prng rng(seed);
+    qint64 size = file.size();
+    qint64 blockCount = qMax<qint64>(1, size / RegionSectorSize);
+    qint64 patches = qMax<qint64>(1, std::llround(blockCount * fraction));
+    QByteArray block(RegionSectorSize, Qt::Uninitialized);
+    qint64 written = 0;
+
+    for (qint64 i = 0; i < patches; ++i) {
+        qint64 offset = static_cast<qint64>(rng.next() % blockCount) * RegionSectorSize;
+        qint64 length = qMin<qint64>(RegionSectorSize, size - offset);
+        if (length <= 0) {
+            continue;
+        }
+        rng.fill(block.data(), length);
+        file.seek(offset);
+        written += file.write(block.constData(), length);
+    }
+
+    return Result<qint64, QString>::ok(written);
+}
+
+Result<qint64, QString> GameTreeGenerator::writeRegionFile(const QString& relativePath,
+                                                           quint64 seed, int round)
+{
+    auto parentResult = ensureParent(relativePath);
+    if (parentResult.isErr()) {
+        return Result<qint64, QString>::err(parentResult.error());
+    }
+
+    // Anvil layout: 4KiB location table, 4KiB timestamp table, then chunks
+    // padded to whole sectors. Only chunks the player revisited change
+    // between rounds, which is what makes regions delta-friendly.
+    Prng layout(seed);
+    int present = layout.range(RegionChunkCount / 4, RegionChunkCount);
+    int rawSize = static_cast<int>(qMax<qint64>(64, scaledSize(12 * KiB)));
+
+    QByteArray header(2 * RegionSectorSize, '\0');
+    QByteArray body;
+    int sector = 2;
+
+    for (int index = 0; index < present; ++index) {
+        quint64 chunkSeed = seed ^ (static_cast<quint64>(index) << 32);
+        int touchedRound = 0;
+        for (int r = round; r > 0; --r) {
+            // About one chunk in ten is rewritten per play session
+            if (Prng(chunkSeed ^ static_cast<quint64>(r)).next() % 10 == 0) {
+                touchedRound = r;
+                break;
+            }
+        }
+
+        Prng rng(chunkSeed ^ (static_cast<quint64>(touchedRound) * 0x9E3779B97F4A7C15ULL));
+        // qCompress prefixes the zlib stream with a 4-byte length; regions don't
+        QByteArray compressed = qCompress(chunkPayload(rng, rawSize)).mid(4);
+
+        QByteArray chunk(5, '\0');
+        qToBigEndian<quint32>(static_cast<quint32>(compressed.size() + 1), chunk.data());
+        chunk[4] = static_cast<char>(RegionCompressionZlib);
+        chunk += compressed;
+
+        int sectors = (chunk.size() + RegionSectorSize - 1) / RegionSectorSize;
+        chunk.resize(sectors * RegionSectorSize);  // Zero padding
+        body += chunk;
+
+        uchar* location = reinterpret_cast<uchar*>(header.data()) + index * 4;
+        location[0] = static_cast<uchar>((sector >> 16) & 0xFF);
+        location[1] = static_cast<uchar>((sector >> 8) & 0xFF);
+        location[2] = static_cast<uchar>(sector & 0xFF);
+        location[3] = static_cast<uchar>(qMin(sectors, 255));
+        qToBigEndian<quint32>(static_cast<quint32>(1600000000 + touchedRound * 3600),
+                              header.data() + RegionSectorSize + index * 4);
+        sector += sectors;
+    }
+
+    QFile file(QDir(m_rootPath).filePath(relativePath));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || file.write(header) != header.size() || file.write(body) != body.size()) {
+        return Result<qint64, QString>::err(QString("Failed to write %1").arg(relativePath));
+    }
+    return Result<qint64, QString>::ok(header.size() + body.size());
+}
+
+Result<qint64, QString> GameTreeGenerator::generateSkyrim()
+{
+    qint64 total = 0;
+    QString error;
+    auto add = [&](const Result<qint64, QString>& result) {
+        if (result.isErr()) {
+            error = result.error();
+            return false;
+        }
+        total += result.value();
+        return true;
+    };
+    Prng rng(m_seed);
+
+    // Master files and BSA archives: few, very large, never change
+    const QStringList masters = {"Skyrim.esm", "Update.esm", "Dawnguard.esm",
+                                 "HearthFires.esm", "Dragonborn.esm"};
+    for (const QString& master : masters) {
+        QString path = "Data/" + master;
+        if (!add(writeRandomFile(path, scaledSize(rng.logSize(20 * MiB, 250 * MiB)), seedFor(path)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+    for (int i = 0; i < scaledCount(40); ++i) {
+        QString path = QString("Data/Archive%1 - Textures.bsa").arg(i, 3, 10, QChar('0'));
+        if (!add(writeRandomFile(path, scaledSize(rng.logSize(50 * MiB, 1200 * MiB)), seedFor(path)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+
+    // Mod plugins: thousands of small files
+    const QStringList pluginSuffixes = {"esp", "esp", "esp", "esl", "esm"};
+    for (int i = 0; i < scaledCount(2500); ++i) {
+        QString path = QString("Data/Mod%1.%2").arg(i, 4, 10, QChar('0'))
+            .arg(pluginSuffixes[rng.range(0, pluginSuffixes.size() - 1)]);
+        if (!add(writeRandomFile(path, scaledSize(rng.logSize(8 * KiB, 4 * MiB)), seedFor(path)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+
+    // Loose mod assets in nested folders
+    const QStringList assetDirs = {"meshes/armor", "meshes/weapons", "meshes/actors/character",
+                                   "textures/armor", "textures/landscape", "textures/actors",
+                                   "scripts", "sound/fx", "interface"};
+    const QStringList assetSuffixes = {"nif", "nif", "dds", "dds", "pex", "wav", "swf"};
+    for (int i = 0; i < scaledCount(4000); ++i) {
+        QString path = QString("Data/%1/mod%2/asset%3.%4")
+            .arg(assetDirs[rng.range(0, assetDirs.size() - 1)])
+            .arg(rng.range(0, 63))
+            .arg(i)
+            .arg(assetSuffixes[rng.range(0, assetSuffixes.size() - 1)]);
+        if (!add(writeRandomFile(path, scaledSize(rng.logSize(4 * KiB, 16 * MiB)), seedFor(path)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+
+    // Script extender plugins with their (ignored) logs
+    for (int i = 0; i < scaledCount(60); ++i) {
+        QString dll = QString("Data/SKSE/Plugins/plugin%1.dll").arg(i);
+        QString log = QString("Data/SKSE/Plugins/plugin%1.log").arg(i);
+        if (!add(writeRandomFile(dll, scaledSize(rng.logSize(64 * KiB, 4 * MiB)), seedFor(dll)))
+            || !add(writeRandomFile(log, scaledSize(rng.logSize(1 * KiB, 256 * KiB)), seedFor(log)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+
+    // Saves: small, numerous, and the part that changes every session
+    for (int i = 0; i < scaledCount(150); ++i) {
+        QString save = QString("Saves/Save%1_Dovahkiin_Whiterun.ess").arg(i + 1);
+        QString cosave = QString("Saves/Save%1_Dovahkiin_Whiterun.skse").arg(i + 1);
+        if (!add(writeRandomFile(save, scaledSize(rng.logSize(5 * MiB, 15 * MiB)), seedFor(save)))
+            || !add(writeRandomFile(cosave, scaledSize(rng.logSize(16 * KiB, 512 * KiB)), seedFor(cosave)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+
+    // Root: ini files are tracked, everything else is not
+    for (const QString& ini : {QString("Skyrim.ini"), QString("SkyrimPrefs.ini"), QString("SkyrimCustom.ini")}) {
+        if (!add(writeTextFile(ini, 200, seedFor(ini)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+    if (!add(writeRandomFile("SkyrimSE.exe", scaledSize(35 * MiB), seedFor("SkyrimSE.exe")))
+        || !add(writeRandomFile("skse64_loader.exe", scaledSize(200 * KiB), seedFor("skse64_loader.exe")))) {
+        return Result<qint64, QString>::err(error);
+    }
+    for (int i = 0; i < scaledCount(30); ++i) {
+        QString log = QString("Logs/Script/Papyrus.%1.log").arg(i);
+        QString dump = QString("Crashes/crash-%1.dmp").arg(i);
+        if (!add(writeRandomFile(log, scaledSize(rng.logSize(4 * KiB, 2 * MiB)), seedFor(log)))
+            || !add(writeRandomFile(dump, scaledSize(rng.logSize(1 * MiB, 64 * MiB)), seedFor(dump)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+
+    return Result<qint64, QString>::ok(total);
+}
+
+Result<qint64, QString> GameTreeGenerator::generateMinecraft()
+{
+    qint64 total = 0;
+    QString error;
+    auto add = [&](const Result<qint64, QString>& result) {
+        if (result.isErr()) {
+            error = result.error();
+            return false;
+        }
+        total += result.value();
+        return true;
+    };
+    Prng rng(m_seed);
+
+    // Worlds: region files dominate both size and count
+    const QStringList dimensions = {"region", "DIM-1/region", "DIM1/region"};
+    for (int world = 0; world < 3; ++world) {
+        QString worldDir = QString("saves/World %1").arg(world + 1);
+        for (int d = 0; d < dimensions.size(); ++d) {
+            int regions = scaledCount(d == 0 ? 400 : 60);
+            int side = qMax(1, static_cast<int>(std::ceil(std::sqrt(double(regions)))));
+            for (int i = 0; i < regions; ++i) {
+                QString path = QString("%1/%2/r.%3.%4.mca").arg(worldDir, dimensions[d])
+                    .arg(i % side - side / 2).arg(i / side - side / 2);
+                if (!add(writeRegionFile(path, seedFor(path), 0))) {
+                    return Result<qint64, QString>::err(error);
+                }
+            }
+        }
+
+        QString levelDat = worldDir + "/level.dat";
+        if (!add(writeRandomFile(levelDat, scaledSize(8 * KiB), seedFor(levelDat)))) {
+            return Result<qint64, QString>::err(error);
+        }
+        for (int p = 0; p < scaledCount(20); ++p) {
+            QString player = QString("%1/playerdata/player-%2.dat").arg(worldDir).arg(p);
+            QString stats = QString("%1/stats/player-%2.json").arg(worldDir).arg(p);
+            if (!add(writeRandomFile(player, scaledSize(24 * KiB), seedFor(player)))
+                || !add(writeTextFile(stats, 120, seedFor(stats)))) {
+                return Result<qint64, QString>::err(error);
+            }
+        }
+    }
+
+    // Mods, configs and packs
+    for (int i = 0; i < scaledCount(200); ++i) {
+        QString path = QString("mods/mod-%1-1.20.1.jar").arg(i);
+        if (!add(writeRandomFile(path, scaledSize(rng.logSize(50 * KiB, 20 * MiB)), seedFor(path)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+    for (int i = 0; i < scaledCount(300); ++i) {
+        QString path = QString("config/mod-%1/settings%2.toml").arg(i / 4).arg(i % 4);
+        if (!add(writeTextFile(path, 40, seedFor(path)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+    for (int i = 0; i < scaledCount(10); ++i) {
+        QString pack = QString("resourcepacks/pack%1.zip").arg(i);
+        QString shader = QString("shaderpacks/shader%1.zip").arg(i);
+        if (!add(writeRandomFile(pack, scaledSize(rng.logSize(10 * MiB, 200 * MiB)), seedFor(pack)))
+            || !add(writeRandomFile(shader, scaledSize(rng.logSize(1 * MiB, 20 * MiB)), seedFor(shader)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+    if (!add(writeTextFile("options.txt", 150, seedFor("options.txt")))
+        || !add(writeRandomFile("servers.dat", scaledSize(2 * KiB), seedFor("servers.dat")))
+        || !add(writeTextFile("usercache.json", 50, seedFor("usercache.json")))) {
+        return Result<qint64, QString>::err(error);
+    }
+
+    // Launcher content outside the tracked set; the scanner must prune it
+    for (int i = 0; i < scaledCount(3000); ++i) {
+        QString path = QString("assets/objects/%1/%2")
+            .arg(i % 256, 2, 16, QChar('0'))
+            .arg(rng.next(), 16, 16, QChar('0'));
+        if (!add(writeRandomFile(path, scaledSize(rng.logSize(1 * KiB, 2 * MiB)), seedFor(path)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+    for (int i = 0; i < scaledCount(500); ++i) {
+        QString path = QString("libraries/lib%1/lib%1.jar").arg(i);
+        if (!add(writeRandomFile(path, scaledSize(rng.logSize(10 * KiB, 8 * MiB)), seedFor(path)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+    for (int i = 0; i < scaledCount(200); ++i) {
+        QString log = QString("logs/%1.log.gz").arg(i);
+        QString shot = QString("screenshots/shot%1.png").arg(i);
+        if (!add(writeRandomFile(log, scaledSize(rng.logSize(2 * KiB, 512 * KiB)), seedFor(log)))
+            || !add(writeRandomFile(shot, scaledSize(rng.logSize(500 * KiB, 4 * MiB)), seedFor(shot)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+
+    return Result<qint64, QString>::ok(total);
+}
+
+Result<qint64, QString> GameTreeGenerator::mutateSkyrim(int round)
+{
+    qint64 total = 0;
+    QString error;
+    auto add = [&](const Result<qint64, QString>& result) {
+        if (result.isErr()) {
+            error = result.error();
+            return false;
+        }
+        total += result.value();
+        return true;
+    };
+    Prng rng(m_seed ^ static_cast<quint64>(round));
+
+    // A new manual save plus rewritten autosaves and quicksave
+    QString save = QString("Saves/Save%1_Dovahkiin_Session.ess").arg(1000 + round);
+    if (!add(writeRandomFile(save, scaledSize(rng.logSize(5 * MiB, 15 * MiB)), seedFor(save, round)))) {
+        return Result<qint64, QString>::err(error);
+    }
+    const QStringList rotating = {"Saves/Quicksave0.ess", "Saves/Autosave1.ess",
+                                  "Saves/Autosave2.ess", "Saves/Autosave3.ess"};
+    for (const QString& path : rotating) {
+        if (!add(writeRandomFile(path, scaledSize(rng.logSize(5 * MiB, 15 * MiB)), seedFor(path, round)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+
+    // A settings tweak, an occasional plugin update, and fresh logs
+    if (!add(writeTextFile("SkyrimPrefs.ini", 200, seedFor("SkyrimPrefs.ini", round)))) {
+        return Result<qint64, QString>::err(error);
+    }
+    if (round % 3 == 0) {
+        QString plugin = QString("Data/Mod%1.esp").arg(rng.range(0, scaledCount(2500) - 1), 4, 10, QChar('0'));
+        if (QFile::exists(QDir(m_rootPath).filePath(plugin)) && !add(patchFile(plugin, 0.05, seedFor(plugin, round)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+    QString log = QString("Logs/Script/Papyrus.session%1.log").arg(round);
+    if (!add(writeRandomFile(log, scaledSize(1 * MiB), seedFor(log)))) {
+        return Result<qint64, QString>::err(error);
+    }
+
+    return Result<qint64, QString>::ok(total);
+}
+
+Result<qint64, QString> GameTreeGenerator::mutateMinecraft(int round)
+{
+    qint64 total = 0;
+    QString error;
+    auto add = [&](const Result<qint64, QString>& result) {
+        if (result.isErr()) {
+            error = result.error();
+            return false;
+        }
+        total += result.value();
+        return true;
+    };
+
+    // The player explores around spawn in the first world: the regions near
+    // the origin are rewritten, with about a tenth of their chunks changed
+    QDir regionDir(QDir(m_rootPath).filePath("saves/World 1/region"));
+    const QStringList regions = regionDir.entryList({"*.mca"}, QDir::Files, QDir::Name);
+    for (const QString& name : regions) {
+        QStringList parts = name.split('.');
+        if (parts.size() == 4 && qAbs(parts[1].toInt()) <= 1 && qAbs(parts[2].toInt()) <= 1) {
+            QString path = "saves/World 1/region/" + name;
+            if (!add(writeRegionFile(path, seedFor(path), round))) {
+                return Result<qint64, QString>::err(error);
+            }
+        }
+    }
+
+    const QStringList rewritten = {"saves/World 1/level.dat", "saves/World 1/playerdata/player-0.dat"};
+    for (const QString& path : rewritten) {
+        if (!add(writeRandomFile(path, scaledSize(16 * KiB), seedFor(path, round)))) {
+            return Result<qint64, QString>::err(error);
+        }
+    }
+    if (!add(writeTextFile("options.txt", 150, seedFor("options.txt", round)))
+        || !add(writeTextFile("saves/World 1/stats/player-0.json", 120,
+                              seedFor("saves/World 1/stats/player-0.json", round)))) {
+        return Result<qint64, QString>::err(error);
+    }
+
+    QString log = QString("logs/session-%1.log.gz").arg(round);
+    if (!add(writeRandomFile(log, scaledSize(256 * KiB), seedFor(log)))) {
+        return Result<qint64, QString>::err(error);
+    }
+
+    return Result<qint64, QString>::ok(total);
+}
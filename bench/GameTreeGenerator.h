@@ -0,0 +1,72 @@
+#ifndef GAMETREEGENERATOR_H
+#define GAMETREEGENERATOR_H
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include "core/types/Result.h"
+
+/**
+ * @brief Shape of a synthetic game directory
+ *
+ * Tracked paths and ignore patterns mirror the matching preset in
+ * resources/presets so the benchmark exercises the same scoping as users.
+ */
+struct GameTreeProfile {
+    QString name;                // "skyrim" or "minecraft"
+    QString gameId;              // Matching preset ID
+    QStringList trackedPaths;
+    QStringList ignorePatterns;
+};
+
+/**
+ * @brief Deterministic generator for realistic game directory trees
+ *
+ * The same seed, profile and scale always produce byte-identical trees, so
+ * results are comparable between releases. Scale multiplies file sizes
+ * (1.0 is a realistic multi-GB install); file counts grow with the square
+ * root of the scale so small runs still have thousands of entries.
+ */
+class GameTreeGenerator {
+public:
+    GameTreeGenerator(const QString& rootPath, double scale, quint64 seed = 42);
+
+    static QStringList profileNames();
+    static GameTreeProfile profile(const QString& name);
+
+    /**
+     * @brief Create the initial install
+     * @return Number of bytes written
+     */
+    Result<qint64, QString> generate(const QString& profileName);
+
+    /**
+     * @brief Simulate one play session: new and rewritten saves, config edits
+     * @return Number of bytes written
+     */
+    Result<qint64, QString> mutate(const QString& profileName, int round);
+
+private:
+    QString m_rootPath;
+    double m_scale;
+    double m_countScale;
+    quint64 m_seed;
+    QSet<QString> m_createdDirs;
+
+    qint64 scaledSize(qint64 realisticBytes) const;
+    int scaledCount(int realisticCount) const;
+    quint64 seedFor(const QString& relativePath, int round = 0) const;
+
+    Result<void, QString> ensureParent(const QString& relativePath);
+    Result<qint64, QString> writeRandomFile(const QString& relativePath, qint64 size, quint64 seed);
+    Result<qint64, QString> writeTextFile(const QString& relativePath, int lines, quint64 seed);
+    Result<qint64, QString> patchFile(const QString& relativePath, double fraction, quint64 seed);
+    Result<qint64, QString> writeRegionFile(const QString& relativePath, quint64 seed, int round);
+
+    Result<qint64, QString> generateSkyrim();
+    Result<qint64, QString> generateMinecraft();
+    Result<qint64, QString> mutateSkyrim(int round);
+    Result<qint64, QString> mutateMinecraft(int round);
+};
+
+#endif // GAMETREEGENERATOR_H
@@ -0,0 +1,359 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdlib>
+#include "GameTreeGenerator.h"
+#include "core/GitService.h"
+#include "core/PresetBundle.h"
+#include "core/PresetIndex.h"
+#include "core/SnapshotManager.h"
+#include "utils/FileUtils.h"
+#include "utils/PatternMatcher.h"
+#include "utils/TrackedScope.h"
+
+/**
+ * vgvc_bench: end-to-end benchmarks on a generated game directory
+ *
+ * Every run on the same profile, scale and seed works on a byte-identical
+ * tree, so the JSON results can be compared between releases.
+ */
+
+namespace {
+
+constexpr int SyntheticPresetCount = 5000;
+constexpr int DetectionLookups = 10000;
+
+[[noreturn]] void fail(const QString& message)
+{
+    QTextStream(stderr) << "vgvc_bench: " << message << Qt::endl;
+    std::exit(1);
+}
+
+template<typename T>
+T unwrap(Result<T, QString> result, const QString& step)
+{
+    if (result.isErr()) {
+        fail(QString("%1 failed: %2").arg(step, result.error()));
+    }
+    return result.value();
+}
+
+void unwrap(const Result<void, QString>& result, const QString& step)
+{
+    if (result.isErr()) {
+        fail(QString("%1 failed: %2").arg(step, result.error()));
+    }
+}
+
+template<typename T>
+T await(QFuture<T> future)
+{
+    future.waitForFinished();
+    return future.takeResult();
+}
+
+int countChanges(QFuture<Result<QList<FileChange>, QString>> future)
+{
+    future.waitForFinished();
+    int count = 0;
+    for (int i = 0; i < future.resultCount(); ++i) {
+        count += unwrap(future.resultAt(i), "Diff").size();
+    }
+    return count;
+}
+
+double elapsedMs(const QElapsedTimer& timer)
+{
+    return timer.nsecsElapsed() / 1.0e6;
+}
+
+/**
+ * @brief One benchmark's samples plus min/median/mean/max
+ */
+QJsonObject summarize(const QString& name, QVector<double> samples,
+                      const QJsonObject& extra = QJsonObject())
+{
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    QJsonArray raw;
+    for (double sample : samples) {
+        sum += sample;
+        raw.append(sample);
+    }
+
+    int count = samples.size();
+    double median = count % 2 == 1
+        ? samples[count / 2]
+        : (samples[count / 2 - 1] + samples[count / 2]) / 2.0;
+
+    QJsonObject result = extra;
+    result["name"] = name;
+    result["unit"] = "ms";
+    result["samples"] = raw;
+    result["min"] = samples.first();
+    result["median"] = median;
+    result["mean"] = sum / count;
+    result["max"] = samples.last();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("vgvc_bench");
+    app.setApplicationVersion(VGVC_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks snapshot operations on a synthetic game directory.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({
+        {"profile", "Game tree to generate: skyrim or minecraft.", "name", "skyrim"},
+        {"scale", "Size multiplier; 1.0 is a realistic multi-GB install.", "factor", "0.01"},
+        {"iterations", "Samples per benchmark.", "count", "5"},
+        {"seed", "Generator seed.", "seed", "42"},
+        {"workdir", "Directory for the generated tree.", "path",
+         QDir::temp().filePath("vgvc_bench")},
+        {"output", "Write JSON results to this file instead of stdout.", "file"},
+        {"keep", "Keep the generated tree after the run."},
+    });
+    parser.process(app);
+
+    const QString profileName = parser.value("profile");
+    if (!GameTreeGenerator::profileNames().contains(profileName)) {
+        fail(QString("Unknown profile '%1' (expected one of: %2)")
+            .arg(profileName, GameTreeGenerator::profileNames().join(", ")));
+    }
+    const double scale = parser.value("scale").toDouble();
+    const int iterations = qMax(1, parser.value("iterations").toInt());
+    const quint64 seed = parser.value("seed").toULongLong();
+    const GameTreeProfile profile = GameTreeGenerator::profile(profileName);
+
+    const QString root = QDir(parser.value("workdir")).filePath(profileName);
+    QDir(root).removeRecursively();
+
+    QJsonArray results;
+    QElapsedTimer timer;
+
+    // Generate
+    GameTreeGenerator generator(root, scale, seed);
+    timer.start();
+    qint64 generatedBytes = unwrap(generator.generate(profileName), "Generate");
+    results.append(summarize("generate", {elapsedMs(timer)}, {{"bytes", generatedBytes}}));
+
+    // Size scans: whole tree, then pruned by the preset's scope
+    PatternMatcher ignore(profile.ignorePatterns + QStringList{".git/"});
+    TrackedScope scope(profile.trackedPaths);
+    {
+        QVector<double> fullSamples;
+        QVector<double> scopedSamples;
+        qint64 fullBytes = 0;
+        qint64 scopedBytes = 0;
+        for (int i = 0; i < iterations; ++i) {
+            timer.restart();
+            fullBytes = unwrap(await(FileUtils::getDirectorySize(root)), "Size scan");
+            fullSamples.append(elapsedMs(timer));
+
+            timer.restart();
+            scopedBytes = unwrap(await(FileUtils::getDirectorySize(root, ignore, scope)), "Scoped size scan");
+            scopedSamples.append(elapsedMs(timer));
+        }
+        results.append(summarize("size_scan_full", fullSamples, {{"bytes", fullBytes}}));
+        results.append(summarize("size_scan_scoped", scopedSamples, {{"bytes", scopedBytes}}));
+    }
+
+    GitService gitService(root);
+    gitService.setTrackedPaths(profile.trackedPaths);
+    SnapshotManager snapshotManager(&gitService);
+
+    // Cold commit without the commit pipeline: git add reads, hashes and
+    // stores every file alone. The baseline for commit_cold, which reads
+    // each file twice (pipeline, then git add) to overlap the work
+    {
+        QVector<double> samples;
+        gitService.setCommitPipelineEnabled(false);
+        for (int i = 0; i < iterations; ++i) {
+            QDir(QDir(root).filePath(".git")).removeRecursively();
+            unwrap(await(gitService.init()), "git init");
+
+            timer.restart();
+            unwrap(await(snapshotManager.createSnapshot("Initial snapshot")), "Cold commit without pipeline");
+            samples.append(elapsedMs(timer));
+        }
+        gitService.setCommitPipelineEnabled(true);
+        results.append(summarize("commit_cold_git_only", samples));
+    }
+
+    // Cold commit: fresh repository, every tracked file hashed and stored
+    {
+        QVector<double> samples;
+        for (int i = 0; i < iterations; ++i) {
+            QDir(QDir(root).filePath(".git")).removeRecursively();
+            unwrap(await(gitService.init()), "git init");
+
+            timer.restart();
+            unwrap(await(snapshotManager.createSnapshot("Initial snapshot")), "Cold commit");
+            samples.append(elapsedMs(timer));
+        }
+        results.append(summarize("commit_cold", samples));
+    }
+
+    // Warm commit: one simulated play session on top of existing history
+    {
+        QVector<double> samples;
+        qint64 changedBytes = 0;
+        for (int round = 1; round <= iterations; ++round) {
+            changedBytes += unwrap(generator.mutate(profileName, round), "Mutate");
+
+            timer.restart();
+            unwrap(await(snapshotManager.createSnapshot(QString("Session %1").arg(round))), "Warm commit");
+            samples.append(elapsedMs(timer));
+        }
+        results.append(summarize("commit_warm", samples, {{"changedBytesPerRound", changedBytes / iterations}}));
+    }
+
+    // History listing
+    QList<Snapshot> history;
+    {
+        QVector<double> samples;
+        for (int i = 0; i < iterations; ++i) {
+            timer.restart();
+            history = unwrap(await(snapshotManager.listSnapshots()), "History");
+            samples.append(elapsedMs(timer));
+        }
+        results.append(summarize("history", samples, {{"snapshots", history.size()}}));
+    }
+
+    // Oldest-to-newest diff: the first run lists both trees, later runs
+    // hit the tree cache
+    {
+        if (history.size() < 2) {
+            fail("Diff needs at least two snapshots");
+        }
+        QVector<double> coldSamples;
+        QVector<double> cachedSamples;
+        int changedFiles = 0;
+        for (int i = 0; i <= iterations; ++i) {
+            timer.restart();
+            changedFiles = countChanges(snapshotManager.diffSnapshots(history.last().id, history.first().id));
+            (i == 0 ? coldSamples : cachedSamples).append(elapsedMs(timer));
+        }
+        results.append(summarize("diff_cold", coldSamples, {{"files", changedFiles}}));
+        results.append(summarize("diff_cached", cachedSamples, {{"files", changedFiles}}));
+    }
+
+    // Restore the oldest snapshot, then return to the latest (untimed)
+    {
+        if (history.size() < 2) {
+            fail("Restore needs at least two snapshots");
+        }
+        QVector<double> samples;
+        const QString oldest = history.last().id;
+        for (int i = 0; i < iterations; ++i) {
+            timer.restart();
+            unwrap(await(snapshotManager.restoreSnapshot(oldest)), "Restore");
+            samples.append(elapsedMs(timer));
+
+            unwrap(await(gitService.checkout("main")), "Return to latest");
+        }
+        results.append(summarize("restore", samples));
+    }
+
+    // Preset detection against a large synthetic preset catalogue
+    {
+        QVector<double> buildSamples;
+        QVector<double> lookupSamples;
+        const QString lookupPath = QDir(root).filePath("Data/meshes/armor");
+        QString detected;
+
+        for (int i = 0; i < iterations; ++i) {
+            timer.restart();
+            PresetIndex index;
+            for (int p = 0; p < SyntheticPresetCount; ++p) {
+                index.addPath(QString("~/Games/Library%1/Game %2").arg(p % 16).arg(p),
+                              QString("synthetic_%1").arg(p));
+                index.addSteamAppId(QString::number(100000 + p), QString("synthetic_%1").arg(p));
+            }
+            index.addPath(root, profile.gameId);
+            buildSamples.append(elapsedMs(timer));
+
+            timer.restart();
+            for (int l = 0; l < DetectionLookups; ++l) {
+                detected = index.lookupPath(lookupPath);
+            }
+            lookupSamples.append(elapsedMs(timer));
+        }
+
+        if (detected != profile.gameId) {
+            fail(QString("Detection returned '%1', expected '%2'").arg(detected, profile.gameId));
+        }
+        results.append(summarize("detect_index_build", buildSamples, {{"presets", SyntheticPresetCount + 1}}));
+        results.append(summarize("detect_lookup", lookupSamples, {{"lookups", DetectionLookups}}));
+    }
+
+    // Opening the preset bundle at the same catalogue size: header check,
+    // binary search and one body decode, as PresetManager does at startup
+    {
+        QList<GamePreset> catalogue;
+        catalogue.reserve(SyntheticPresetCount);
+        for (int p = 0; p < SyntheticPresetCount; ++p) {
+            GamePreset preset;
+            preset.gameId = QString("synthetic_%1").arg(p);
+            preset.displayName = QString("Game %1").arg(p);
+            preset.steamAppId = QString::number(100000 + p);
+            preset.detectionPaths["linux"] = QStringList{QString("~/Games/Library%1/Game %2").arg(p % 16).arg(p)};
+            preset.trackedPaths = QStringList{"saves/**"};
+            catalogue.append(preset);
+        }
+        const QByteArray bundleData = unwrap(PresetBundle::compile(catalogue), "Compile presets");
+
+        QVector<double> samples;
+        for (int i = 0; i < iterations; ++i) {
+            timer.restart();
+            PresetBundle bundle(bundleData);
+            unwrap(bundle.preset(bundle.find("synthetic_4321")), "Load preset");
+            samples.append(elapsedMs(timer));
+        }
+        results.append(summarize("preset_bundle_open", samples, {{"presets", SyntheticPresetCount}}));
+    }
+
+    QJsonObject report;
+    report["tool"] = "vgvc_bench";
+    report["version"] = VGVC_VERSION;
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["platform"] = QSysInfo::prettyProductName();
+    report["qt"] = qVersion();
+    report["profile"] = profileName;
+    report["scale"] = scale;
+    report["seed"] = QString::number(seed);
+    report["iterations"] = iterations;
+    report["results"] = results;
+
+    QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet("output")) {
+        QFile file(parser.value("output"));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            fail(QString("Failed to write %1").arg(parser.value("output")));
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    if (!parser.isSet("keep")) {
+        QDir(root).removeRecursively();
+    }
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include "CliRunner.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+#include "core/ChunkRemote.h"
+#include "core/ProjectCommands.h"
+#include "ipc/DaemonClient.h"
+
+namespace {
+
+constexpr int ExitSuccess = 0;
+constexpr int ExitFailure = 1;
+
+} // namespace
+
+CliRunner::CliRunner(bool jsonOutput, DaemonClient* daemon)
+    : m_jsonOutput(jsonOutput)
+    , m_daemon(daemon)
+{
+}
+
+int CliRunner::snapshot(const QStringList& paths, const QString& message, const QString& presetId,
+                        ExecutionClass executionClass)
+{
+    QJsonArray results;
+    QStringList lines;
+    bool allOk = true;
+
+    for (const QString& path : paths) {
+        QString absolutePath = QFileInfo(path).absoluteFilePath();
+
+        Result<QJsonObject, QString> result = Result<QJsonObject, QString>::err(QString());
+        if (m_daemon) {
+            result = m_daemon->call("snapshot", {{"path", absolutePath}, {"message", message},
+                                                 {"preset", presetId},
+                                                 {"background", executionClass == ExecutionClass::Background}});
+        } else {
+            auto presetResult = resolvePreset(absolutePath, presetId);
+            result = presetResult.isOk()
+                ? ProjectCommands::snapshot(absolutePath, message, presetResult.value(), executionClass)
+                : Result<QJsonObject, QString>::err(presetResult.error());
+        }
+
+        QJsonObject entry;
+        if (result.isOk()) {
+            entry = result.value();
+            if (entry["status"].toString() == "unchanged") {
+                lines << QString("%1: no changes").arg(absolutePath);
+            } else {
+                lines << QString("%1: created %2").arg(absolutePath, entry["snapshot"].toObject()["id"].toString());
+            }
+        } else {
+            allOk = false;
+            entry["status"] = "error";
+            entry["error"] = result.error();
+            lines << QString("%1: error: %2").arg(absolutePath, result.error());
+        }
+        entry["path"] = absolutePath;
+        results.append(entry);
+    }
+
+    print(QJsonObject{{"command", "snapshot"}, {"results", results}}, lines.join('\n'));
+    return allOk ? ExitSuccess : ExitFailure;
+}
+
+int CliRunner::list(const QString& path, int limit)
+{
+    QString absolutePath = QFileInfo(path).absoluteFilePath();
+    auto result = m_daemon
+        ? m_daemon->call("list", {{"path", absolutePath}, {"limit", limit}})
+        : ProjectCommands::list(absolutePath, limit);
+    if (result.isErr()) {
+        return fail(result.error());
+    }
+
+    QJsonObject json = result.value();
+    QStringList lines;
+    for (const QJsonValue& value : json["snapshots"].toArray()) {
+        QJsonObject snapshot = value.toObject();
+        QDateTime timestamp = QDateTime::fromString(snapshot["timestamp"].toString(), Qt::ISODate);
+        lines << QString("%1  %2 - %3").arg(snapshot["id"].toString().left(12),
+                                           timestamp.toString("yyyy-MM-dd HH:mm"),
+                                           snapshot["description"].toString());
+    }
+
+    json["command"] = "list";
+    json["path"] = absolutePath;
+    print(json, lines.join('\n'));
+    return ExitSuccess;
+}
+
+int CliRunner::restore(const QString& path, const QString& snapshotId, const QString& presetId)
+{
+    QString absolutePath = QFileInfo(path).absoluteFilePath();
+
+    Result<QJsonObject, QString> result = Result<QJsonObject, QString>::err(QString());
+    if (m_daemon) {
+        result = m_daemon->call("restore", {{"path", absolutePath}, {"snapshot", snapshotId},
+                                            {"preset", presetId}});
+    } else {
+        auto presetResult = resolvePreset(absolutePath, presetId);
+        if (presetResult.isErr()) {
+            return fail(presetResult.error());
+        }
+        result = ProjectCommands::restore(absolutePath, snapshotId, presetResult.value());
+    }
+    if (result.isErr()) {
+        return fail(result.error());
+    }
+
+    QJsonObject json = result.value();
+    json["command"] = "restore";
+    json["path"] = absolutePath;
+    print(json, QString("Restored %1").arg(snapshotId));
+    return ExitSuccess;
+}
+
+int CliRunner::exportSnapshot(const QString& path, const QString& snapshotId, const QString& archivePath)
+{
+    QString absolutePath = QFileInfo(path).absoluteFilePath();
+    QString absoluteArchive = QFileInfo(archivePath).absoluteFilePath();
+
+    auto result = m_daemon
+        ? m_daemon->call("export", {{"path", absolutePath}, {"snapshot", snapshotId},
+                                    {"archive", absoluteArchive}})
+        : ProjectCommands::exportSnapshot(absolutePath, snapshotId, absoluteArchive);
+    if (result.isErr()) {
+        return fail(result.error());
+    }
+
+    QJsonObject json = result.value();
+    json["command"] = "export";
+    json["path"] = absolutePath;
+    print(json, QString("Exported %1 to %2").arg(snapshotId, absoluteArchive));
+    return ExitSuccess;
+}
+
+int CliRunner::fetch(const QString& remoteUrl, const QString& snapshotId, const QString& directory)
+{
+    QString absoluteDirectory = QFileInfo(directory).absoluteFilePath();
+
+    auto remote = ChunkRemote::open(remoteUrl);
+    if (remote.isErr()) {
+        return fail(remote.error());
+    }
+    auto result = remote.value()->download(snapshotId, absoluteDirectory);
+    if (result.isErr()) {
+        return fail(result.error());
+    }
+
+    print(QJsonObject{{"command", "fetch"}, {"remote", remoteUrl}, {"snapshot", snapshotId},
+                      {"path", absoluteDirectory}},
+          QString("Fetched %1 to %2").arg(snapshotId, absoluteDirectory));
+    return ExitSuccess;
+}
+
+int CliRunner::registerProject(const QString& path, const QString& presetId, int intervalMinutes)
+{
+    if (!m_daemon) {
+        return fail("vgvcd is not running");
+    }
+
+    QJsonObject params{{"path", QFileInfo(path).absoluteFilePath()}};
+    if (!presetId.isEmpty()) {
+        params["preset"] = presetId;
+    }
+    if (intervalMinutes >= 0) {
+        params["interval_minutes"] = intervalMinutes;
+    }
+
+    auto result = m_daemon->call("register", params);
+    if (result.isErr()) {
+        return fail(result.error());
+    }
+
+    QJsonObject json = result.value();
+    print(QJsonObject{{"command", "register"}, {"project", json}},
+          QString("Registered %1 (every %2 min)").arg(json["path"].toString())
+              .arg(json["snapshot_interval_minutes"].toInt()));
+    return ExitSuccess;
+}
+
+int CliRunner::fail(const QString& message)
+{
+    if (m_jsonOutput) {
+        QTextStream(stdout) << QJsonDocument(QJsonObject{{"error", message}}).toJson(QJsonDocument::Compact)
+                            << Qt::endl;
+    } else {
+        QTextStream(stderr) << "vgvc-cli: " << message << Qt::endl;
+    }
+    return ExitFailure;
+}
+
+Result<GamePreset, QString> CliRunner::resolvePreset(const QString& path, const QString& presetId)
+{
+    if (!presetId.isEmpty()) {
+        return m_presetManager.loadPreset(presetId);
+    }
+
+    auto gameResult = m_presetManager.detectGame(path);
+    if (gameResult.isErr()) {
+        return Result<GamePreset, QString>::ok(GamePreset());
+    }
+
+    auto presetResult = m_presetManager.loadPreset(gameResult.value());
+    if (presetResult.isErr()) {
+        return Result<GamePreset, QString>::ok(GamePreset());
+    }
+    return presetResult;
+}
+
+void CliRunner::print(const QJsonObject& json, const QString& text)
+{
+    QTextStream out(stdout);
+    if (m_jsonOutput) {
+        out << QJsonDocument(json).toJson(QJsonDocument::Compact) << Qt::endl;
+    } else if (!text.isEmpty()) {
+        out << text << Qt::endl;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef CLIRUNNER_H
+#define CLIRUNNER_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include "core/PresetManager.h"
+#include "core/types/GamePreset.h"
+#include "core/types/Result.h"
+#include "utils/ExecutionPolicy.h"
+
+class DaemonClient;
+
+/**
+ * @brief Implements the vgvc-cli commands
+ *
+ * When a vgvcd daemon is running, commands are forwarded to it so they
+ * share its I/O budget with every other project; otherwise they run
+ * in-process through ProjectCommands. Both paths produce the same result
+ * objects, printed as plain text or a single JSON document. Return values
+ * are process exit codes.
+ */
+class CliRunner {
+public:
+    /**
+     * @param daemon Connected client, or nullptr to run commands directly
+     */
+    CliRunner(bool jsonOutput, DaemonClient* daemon);
+
+    /**
+     * @brief Snapshot each directory, initializing repositories as needed
+     *
+     * Directories without changes since their last snapshot are skipped.
+     */
+    int snapshot(const QStringList& paths, const QString& message, const QString& presetId,
+                 ExecutionClass executionClass);
+    int list(const QString& path, int limit);
+    int restore(const QString& path, const QString& snapshotId, const QString& presetId);
+    int exportSnapshot(const QString& path, const QString& snapshotId, const QString& archivePath);
+
+    /**
+     * @brief Write a snapshot from a chunk remote into a directory
+     *
+     * Needs no project or daemon, so a backup can be recovered on a machine
+     * that never had the game directory.
+     */
+    int fetch(const QString& remoteUrl, const QString& snapshotId, const QString& directory);
+
+    /**
+     * @brief Register a directory with the daemon for scheduled snapshots
+     */
+    int registerProject(const QString& path, const QString& presetId, int intervalMinutes);
+
+    /**
+     * @brief Report an error in the selected output format
+     * @return Exit code for the failure
+     */
+    int fail(const QString& message);
+
+private:
+    bool m_jsonOutput;
+    DaemonClient* m_daemon;
+    PresetManager m_presetManager;
+
+    /**
+     * @brief Preset for a directory: explicit ID, detection, or none
+     * @return Invalid preset (tracks everything) when nothing matches
+     */
+    Result<GamePreset, QString> resolvePreset(const QString& path, const QString& presetId);
+
+    void print(const QJsonObject& json, const QString& text);
+};
+
+#endif // CLIRUNNER_H
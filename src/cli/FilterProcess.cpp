@@ -0,0 +1,241 @@
+#include "FilterProcess.h"
+#include "core/RegionFile.h"
+#include "utils/Logger.h"
+#include <QDir>
+#include <QLockFile>
+
+namespace {
+
+constexpr int PacketHeaderSize = 4;
+constexpr int MaxPacketPayload = 65516;
+
+QByteArray stripNewline(const QByteArray& line)
+{
+    return line.endsWith('\n') ? line.chopped(1) : line;
+}
+
+} // namespace
+
+FilterProcess::FilterProcess(Kind kind, QIODevice* input, QIODevice* output)
+    : m_kind(kind)
+    , m_input(input)
+    , m_output(output)
+    , m_store(QDir::current().filePath(kind == Kind::Region ? ".git/vgvc/chunks" : ".git/vgvc/deltas"))
+    , m_deltaFile(m_store)
+    , m_atEnd(false)
+{
+}
+
+int FilterProcess::run()
+{
+    // Two git commands may run at once (GUI and daemon); the store has one writer
+    QDir().mkpath(m_store.directory());
+    QLockFile lock(QDir(m_store.directory()).filePath("lock"));
+    lock.setStaleLockTime(0);  // Held for the whole git command, however long
+    if (!lock.lock()) {
+        Logger::error("Cannot lock the chunk store", "FilterProcess");
+        return 1;
+    }
+
+    auto openResult = m_store.open();
+    if (openResult.isOk() && m_kind == Kind::Delta) {
+        openResult = m_deltaFile.load();
+    }
+    if (openResult.isErr()) {
+        Logger::error(openResult.error(), "FilterProcess");
+        return 1;
+    }
+
+    auto handshakeResult = handshake();
+    if (handshakeResult.isErr()) {
+        Logger::error(handshakeResult.error(), "FilterProcess");
+        return 1;
+    }
+
+    while (true) {
+        auto requestResult = readKeyValues();
+        if (m_atEnd) {
+            return 0;
+        }
+        if (requestResult.isErr()) {
+            Logger::error(requestResult.error(), "FilterProcess");
+            return 1;
+        }
+
+        auto handleResult = handleRequest(requestResult.value());
+        if (handleResult.isErr()) {
+            Logger::error(handleResult.error(), "FilterProcess");
+            return 1;
+        }
+    }
+}
+
+Result<void, QString> FilterProcess::handshake()
+{
+    auto welcomeResult = readKeyValues();
+    if (welcomeResult.isErr()) {
+        return Result<void, QString>::err(welcomeResult.error());
+    }
+    const auto& welcome = welcomeResult.value();
+    if (!welcome.contains("git-filter-client") || welcome.value("version") != "2") {
+        return Result<void, QString>::err("Unsupported filter protocol");
+    }
+    if (!writePacket("git-filter-server\n") || !writePacket("version=2\n") || !writeFlush()) {
+        return Result<void, QString>::err("Cannot write to git");
+    }
+
+    // Git lists capability=... lines; clean and smudge are all we offer
+    auto capabilityResult = readKeyValues();
+    if (capabilityResult.isErr()) {
+        return Result<void, QString>::err(capabilityResult.error());
+    }
+    if (!writePacket("capability=clean\n") || !writePacket("capability=smudge\n") || !writeFlush()) {
+        return Result<void, QString>::err("Cannot write to git");
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<void, QString> FilterProcess::handleRequest(const QHash<QByteArray, QByteArray>& request)
+{
+    auto contentResult = readContent();
+    if (contentResult.isErr()) {
+        return Result<void, QString>::err(contentResult.error());
+    }
+
+    QByteArray command = request.value("command");
+    Result<QByteArray, QString> filtered = Result<QByteArray, QString>::err(
+        QString("Unsupported filter command: %1").arg(QString::fromUtf8(command)));
+    if (command == "clean" && m_kind == Kind::Region) {
+        filtered = RegionFile::clean(contentResult.value(), m_store);
+    } else if (command == "smudge" && m_kind == Kind::Region) {
+        filtered = RegionFile::smudge(contentResult.value(), m_store);
+    } else if (command == "clean") {
+        filtered = m_deltaFile.clean(QString::fromUtf8(request.value("pathname")), contentResult.value());
+    } else if (command == "smudge") {
+        filtered = m_deltaFile.smudge(contentResult.value());
+    }
+
+    if (filtered.isErr()) {
+        // Git fails this file (the filter is required) and keeps talking to us
+        Logger::error(QString("%1 %2: %3").arg(QString::fromUtf8(command),
+                                               QString::fromUtf8(request.value("pathname")),
+                                               filtered.error()),
+                      "FilterProcess");
+        if (!writePacket("status=error\n") || !writeFlush()) {
+            return Result<void, QString>::err("Cannot write to git");
+        }
+        return Result<void, QString>::ok();
+    }
+
+    // An empty trailing list keeps the status at success
+    if (!writePacket("status=success\n") || !writeFlush()
+        || !writeContent(filtered.value()) || !writeFlush() || !writeFlush()) {
+        return Result<void, QString>::err("Cannot write to git");
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<bool, QString> FilterProcess::readPacket(QByteArray& payload)
+{
+    char header[PacketHeaderSize];
+    qint64 headerRead = readExactly(header, PacketHeaderSize);
+    if (headerRead == 0) {
+        m_atEnd = true;
+        return Result<bool, QString>::err("Git closed the filter pipe");
+    }
+    if (headerRead != PacketHeaderSize) {
+        return Result<bool, QString>::err("Truncated packet header");
+    }
+
+    bool ok = false;
+    int length = QByteArray(header, PacketHeaderSize).toInt(&ok, 16);
+    if (!ok || (length != 0 && length < PacketHeaderSize)) {
+        return Result<bool, QString>::err("Malformed packet header");
+    }
+    if (length == 0) {
+        return Result<bool, QString>::ok(false);
+    }
+
+    payload.resize(length - PacketHeaderSize);
+    if (readExactly(payload.data(), payload.size()) != payload.size()) {
+        return Result<bool, QString>::err("Truncated packet");
+    }
+    return Result<bool, QString>::ok(true);
+}
+
+Result<QHash<QByteArray, QByteArray>, QString> FilterProcess::readKeyValues()
+{
+    QHash<QByteArray, QByteArray> values;
+    QByteArray payload;
+    while (true) {
+        auto packetResult = readPacket(payload);
+        if (packetResult.isErr()) {
+            return Result<QHash<QByteArray, QByteArray>, QString>::err(packetResult.error());
+        }
+        if (!packetResult.value()) {
+            return Result<QHash<QByteArray, QByteArray>, QString>::ok(values);
+        }
+
+        // Handshake lines carry no '=' and land as keys with empty values
+        QByteArray line = stripNewline(payload);
+        int separator = line.indexOf('=');
+        if (separator < 0) {
+            values.insert(line, QByteArray());
+        } else {
+            values.insert(line.left(separator), line.mid(separator + 1));
+        }
+    }
+}
+
+Result<QByteArray, QString> FilterProcess::readContent()
+{
+    QByteArray content;
+    QByteArray payload;
+    while (true) {
+        auto packetResult = readPacket(payload);
+        if (packetResult.isErr()) {
+            m_atEnd = false;  // Mid-request, closing the pipe is an error
+            return Result<QByteArray, QString>::err(packetResult.error());
+        }
+        if (!packetResult.value()) {
+            return Result<QByteArray, QString>::ok(content);
+        }
+        content += payload;
+    }
+}
+
+bool FilterProcess::writePacket(const QByteArray& payload)
+{
+    QByteArray header = QByteArray::number(payload.size() + PacketHeaderSize, 16).rightJustified(
+        PacketHeaderSize, '0');
+    return m_output->write(header) == PacketHeaderSize
+        && m_output->write(payload) == payload.size();
+}
+
+bool FilterProcess::writeFlush()
+{
+    return m_output->write("0000", PacketHeaderSize) == PacketHeaderSize;
+}
+
+bool FilterProcess::writeContent(const QByteArray& content)
+{
+    for (qsizetype offset = 0; offset < content.size(); offset += MaxPacketPayload) {
+        if (!writePacket(content.mid(offset, MaxPacketPayload))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+qint64 FilterProcess::readExactly(char* buffer, qint64 length)
+{
+    qint64 total = 0;
+    while (total < length) {
+        qint64 count = m_input->read(buffer + total, length - total);
+        if (count <= 0) {
+            break;
+        }
+        total += count;
+    }
+    return total;
+}
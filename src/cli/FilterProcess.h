@@ -0,0 +1,62 @@
+#ifndef FILTERPROCESS_H
+#define FILTERPROCESS_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QIODevice>
+#include <QString>
+#include "core/ChunkStore.h"
+#include "core/DeltaFile.h"
+#include "core/types/Result.h"
+
+/**
+ * @brief Git filter process storing large files through a ChunkStore
+ *
+ * Speaks git's long-running filter protocol (gitattributes(5), "Long
+ * Running Filter Process") on stdin/stdout, so one process cleans or
+ * smudges every matching file in a git command instead of one process per
+ * file. GitService registers one per filter kind ("vgvc-cli region-filter",
+ * "vgvc-cli delta-filter") for the preset's patterns. Each kind has its own
+ * store, since git runs both processes at once. Runs with the repository
+ * root as the working directory.
+ */
+class FilterProcess {
+public:
+    enum class Kind {
+        Region,      // Minecraft region files, stored per chunk (RegionFile)
+        Delta        // Save files, stored as deltas (DeltaFile)
+    };
+
+    FilterProcess(Kind kind, QIODevice* input, QIODevice* output);
+
+    /**
+     * @return Process exit code; 0 once git closes the pipe
+     */
+    int run();
+
+private:
+    Kind m_kind;
+    QIODevice* m_input;
+    QIODevice* m_output;
+    ChunkStore m_store;
+    DeltaFile m_deltaFile;
+    bool m_atEnd;        // Git closed the pipe between requests
+
+    Result<void, QString> handshake();
+    Result<void, QString> handleRequest(const QHash<QByteArray, QByteArray>& request);
+
+    /**
+     * @brief Read one pkt-line
+     * @return False for a flush packet, which has no payload
+     */
+    Result<bool, QString> readPacket(QByteArray& payload);
+    Result<QHash<QByteArray, QByteArray>, QString> readKeyValues();
+    Result<QByteArray, QString> readContent();
+
+    bool writePacket(const QByteArray& payload);
+    bool writeFlush();
+    bool writeContent(const QByteArray& content);
+    qint64 readExactly(char* buffer, qint64 length);
+};
+
+#endif // FILTERPROCESS_H
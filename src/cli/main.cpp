@@ -0,0 +1,118 @@
+#include "CliRunner.h"
+#include "FilterProcess.h"
+#include "ipc/DaemonClient.h"
+#include "utils/Logger.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <cstdio>
+
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+
+constexpr int ExitUsage = 2;
+
+const char* const CommandSummary =
+    "Commands:\n"
+    "  snapshot <dir>...            Snapshot one or more game directories\n"
+    "  list <dir>                   List snapshots, newest first\n"
+    "  restore <dir> <id>           Restore a snapshot (after a safety backup)\n"
+    "  export <dir> <id> <archive>  Write a snapshot to .zip, .tar or .tar.gz\n"
+    "  register <dir>               Let vgvcd snapshot a directory on a schedule\n"
+    "  fetch <remote> <id> <dir>    Write a snapshot backed up to a chunk remote\n"
+    "\n"
+    "Commands run through vgvcd when it is running, so they share its I/O budget.";
+
+/**
+ * @brief Serve git as a storage filter (internal; started by git)
+ */
+int runFilter(FilterProcess::Kind kind)
+{
+#ifdef Q_OS_WIN
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    QFile input;
+    QFile output;
+    if (!input.open(fileno(stdin), QIODevice::ReadOnly | QIODevice::Unbuffered)
+        || !output.open(fileno(stdout), QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        return 1;
+    }
+    return FilterProcess(kind, &input, &output).run();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // No QApplication: the CLI never loads Qt Widgets
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("VideoGameVersionControl");
+    QCoreApplication::setApplicationVersion("1.0.0");
+    QCoreApplication::setOrganizationName("VGVC Team");
+    QCoreApplication::setOrganizationDomain("github.com/vgvc");
+
+    // Keep stdout clean for scripts; only problems reach stderr
+    Logger::setLogLevel(Logger::Level::Warning);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QString("Headless snapshots for game directories.\n\n%1")
+        .arg(CommandSummary));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({
+        {"json", "Print results as a single JSON document."},
+        {{"m", "message"}, "Snapshot description (default: timestamp).", "text"},
+        {"preset", "Use this game preset instead of detecting one.", "id"},
+        {"limit", "Maximum number of snapshots to list.", "count", "50"},
+        {"interval", "Minutes between scheduled snapshots (register; 0 disables).", "minutes"},
+        {"direct", "Run in this process even if vgvcd is running."},
+        {"background", "Snapshot at low CPU and disk priority (for use while a game runs)."},
+    });
+    parser.addPositionalArgument("command", "snapshot, list, restore, export, register or fetch.");
+    parser.addPositionalArgument("args", "Command arguments.", "[args...]");
+    parser.process(app);
+
+    QStringList args = parser.positionalArguments();
+    QString command = args.isEmpty() ? QString() : args.takeFirst();
+
+    // Never touches the daemon: stdout belongs to git's filter protocol
+    if (command == "region-filter" || command == "delta-filter") {
+        int result = runFilter(command == "region-filter" ? FilterProcess::Kind::Region
+                                                          : FilterProcess::Kind::Delta);
+        Logger::shutdown();
+        return result;
+    }
+
+    DaemonClient daemon;
+    bool useDaemon = !parser.isSet("direct") && daemon.connectToDaemon();
+
+    CliRunner runner(parser.isSet("json"), useDaemon ? &daemon : nullptr);
+    int result = ExitUsage;
+
+    if (command == "snapshot" && !args.isEmpty()) {
+        ExecutionClass executionClass = parser.isSet("background")
+            ? ExecutionClass::Background : ExecutionClass::Foreground;
+        result = runner.snapshot(args, parser.value("message"), parser.value("preset"), executionClass);
+    } else if (command == "list" && args.size() == 1) {
+        result = runner.list(args[0], qMax(1, parser.value("limit").toInt()));
+    } else if (command == "restore" && args.size() == 2) {
+        result = runner.restore(args[0], args[1], parser.value("preset"));
+    } else if (command == "export" && args.size() == 3) {
+        result = runner.exportSnapshot(args[0], args[1], args[2]);
+    } else if (command == "register" && args.size() == 1) {
+        int interval = parser.isSet("interval") ? parser.value("interval").toInt() : -1;
+        result = runner.registerProject(args[0], parser.value("preset"), interval);
+    } else if (command == "fetch" && args.size() == 3) {
+        result = runner.fetch(args[0], args[1], args[2]);
+    } else {
+        runner.fail(QString("Invalid usage.\n\n%1").arg(CommandSummary));
+    }
+
+    Logger::shutdown();
+    return result;
+}
@@ -0,0 +1,275 @@
+#include "ChunkRemote.h"
+#include "LocalChunkRemote.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QSaveFile>
+#include <QUrl>
+
+namespace {
+
+constexpr quint32 RecipeMagic = 0x56474352;    // "VGCR"
+constexpr quint32 SnapshotMagic = 0x56475253;  // "VGRS"
+constexpr quint32 FormatVersion = 1;
+const QString ChunkScheme = QStringLiteral("chunks:");
+
+ObjectId derivedKey(const char* kind, const QString& objectId)
+{
+    return ObjectId::fromBytes(QCryptographicHash::hash(
+        QByteArray(kind) + ' ' + objectId.toLatin1(), QCryptographicHash::Sha1));
+}
+
+/**
+ * @brief Whether writing path stays under root (a canonical path)
+ *
+ * Resolves the nearest ancestor already on disk, so a symlink there,
+ * whether old or just downloaded, can't redirect the write elsewhere.
+ */
+bool staysInside(const QString& path, const QString& canonicalRoot)
+{
+    QFileInfo ancestor(QFileInfo(path).path());
+    while (!ancestor.exists() && !ancestor.isSymLink()) {
+        QString parent = ancestor.path();
+        if (parent == ancestor.filePath()) {
+            return false;
+        }
+        ancestor = QFileInfo(parent);
+    }
+
+    // Empty for a dangling link
+    QString canonical = ancestor.canonicalFilePath();
+    QString prefix = canonicalRoot.endsWith('/') ? canonicalRoot : canonicalRoot + '/';
+    return !canonical.isEmpty() && (canonical == canonicalRoot || canonical.startsWith(prefix));
+}
+
+} // namespace
+
+QByteArray ChunkRecipe::encode() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << RecipeMagic << FormatVersion << size << qint32(chunks.size());
+    for (const ObjectId& chunk : chunks) {
+        out.writeRawData(reinterpret_cast<const char*>(chunk.data()), ObjectId::Size);
+    }
+    return data;
+}
+
+Result<ChunkRecipe, QString> ChunkRecipe::decode(const QByteArray& data)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    ChunkRecipe recipe;
+    in >> magic >> version >> recipe.size >> count;
+    if (magic != RecipeMagic || version != FormatVersion || count < 0) {
+        return Result<ChunkRecipe, QString>::err("Unsupported chunk recipe");
+    }
+
+    recipe.chunks.reserve(count);
+    char bytes[ObjectId::Size];
+    for (qint32 i = 0; i < count; ++i) {
+        if (in.readRawData(bytes, ObjectId::Size) != ObjectId::Size) {
+            return Result<ChunkRecipe, QString>::err("Truncated chunk recipe");
+        }
+        recipe.chunks.append(ObjectId::fromBytes(QByteArrayView(bytes, ObjectId::Size)));
+    }
+    return Result<ChunkRecipe, QString>::ok(std::move(recipe));
+}
+
+ObjectId ChunkRecipe::recipeKey(const QString& blobId)
+{
+    return derivedKey("vgvc-recipe", blobId);
+}
+
+QByteArray RemoteSnapshot::encode() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << SnapshotMagic << FormatVersion << commit << qint32(entries.size());
+    for (const Entry& entry : entries) {
+        out << entry.path << entry.mode << entry.blobId;
+    }
+    return data;
+}
+
+Result<RemoteSnapshot, QString> RemoteSnapshot::decode(const QByteArray& data)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    RemoteSnapshot snapshot;
+    in >> magic >> version >> snapshot.commit >> count;
+    if (magic != SnapshotMagic || version != FormatVersion || count < 0) {
+        return Result<RemoteSnapshot, QString>::err("Unsupported snapshot manifest");
+    }
+
+    snapshot.entries.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Entry entry;
+        in >> entry.path >> entry.mode >> entry.blobId;
+        snapshot.entries.append(entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        return Result<RemoteSnapshot, QString>::err("Truncated snapshot manifest");
+    }
+    return Result<RemoteSnapshot, QString>::ok(std::move(snapshot));
+}
+
+ObjectId RemoteSnapshot::snapshotKey(const QString& commit)
+{
+    return derivedKey("vgvc-snapshot", commit);
+}
+
+bool ChunkRemote::isChunkUrl(const QString& url)
+{
+    return url.startsWith(ChunkScheme);
+}
+
+Result<QSharedPointer<ChunkRemote>, QString> ChunkRemote::open(const QString& url)
+{
+    if (!isChunkUrl(url)) {
+        return Result<QSharedPointer<ChunkRemote>, QString>::err(QString("Not a chunk remote: %1").arg(url));
+    }
+
+    QString location = url.mid(ChunkScheme.size());
+    QUrl fileUrl(location);
+    if (fileUrl.isLocalFile()) {
+        location = fileUrl.toLocalFile();
+    }
+
+    auto remote = QSharedPointer<LocalChunkRemote>::create(location);
+    auto openResult = remote->open();
+    if (openResult.isErr()) {
+        return Result<QSharedPointer<ChunkRemote>, QString>::err(openResult.error());
+    }
+    return Result<QSharedPointer<ChunkRemote>, QString>::ok(remote);
+}
+
+Result<void, QString> ChunkRemote::download(const QString& commit, const QString& directory)
+{
+    auto manifestResult = get(RemoteSnapshot::snapshotKey(commit));
+    if (manifestResult.isErr()) {
+        return Result<void, QString>::err(QString("Snapshot %1 is not on the remote").arg(commit));
+    }
+    auto snapshotResult = RemoteSnapshot::decode(manifestResult.value());
+    if (snapshotResult.isErr()) {
+        return Result<void, QString>::err(snapshotResult.error());
+    }
+
+    // Chunks are named by their content, so a damaged one is detected here
+    auto fetchChunk = [this](const ObjectId& chunk) -> Result<QByteArray, QString> {
+        auto data = get(chunk);
+        if (data.isOk()
+            && ObjectId::fromBytes(QCryptographicHash::hash(data.value(), QCryptographicHash::Sha1)) != chunk) {
+            return Result<QByteArray, QString>::err(QString("Corrupt chunk %1").arg(chunk.toHex()));
+        }
+        return data;
+    };
+
+    QDir().mkpath(directory);
+    QDir target(directory);
+    const QString canonicalTarget = QFileInfo(directory).canonicalFilePath();
+    if (canonicalTarget.isEmpty()) {
+        return Result<void, QString>::err(QString("Cannot create %1").arg(directory));
+    }
+
+    // Links are made after every file, so no file is written through one
+    struct PendingLink {
+        QString path;
+        QString target;
+    };
+    QList<PendingLink> links;
+
+    for (const RemoteSnapshot::Entry& entry : snapshotResult.value().entries) {
+        // The manifest comes from outside; never write above the target
+        QString relative = QDir::cleanPath(entry.path);
+        if (QDir::isAbsolutePath(relative) || relative == ".." || relative.startsWith("../")) {
+            return Result<void, QString>::err(QString("Unsafe path in snapshot: %1").arg(entry.path));
+        }
+
+        auto recipeData = get(ChunkRecipe::recipeKey(entry.blobId));
+        if (recipeData.isErr()) {
+            return Result<void, QString>::err(recipeData.error());
+        }
+        auto recipe = ChunkRecipe::decode(recipeData.value());
+        if (recipe.isErr()) {
+            return Result<void, QString>::err(recipe.error());
+        }
+
+        QString path = target.filePath(relative);
+        if (entry.mode == "120000") {
+            // A symlink's content is its target
+            QByteArray linkTarget;
+            for (const ObjectId& chunk : recipe.value().chunks) {
+                auto chunkData = fetchChunk(chunk);
+                if (chunkData.isErr()) {
+                    return Result<void, QString>::err(chunkData.error());
+                }
+                linkTarget += chunkData.value();
+            }
+            links.append({path, QString::fromUtf8(linkTarget)});
+            continue;
+        }
+
+        // A symlink already in the target directory could still lead out
+        if (!staysInside(path, canonicalTarget)) {
+            return Result<void, QString>::err(QString("Unsafe path in snapshot: %1").arg(entry.path));
+        }
+        QDir().mkpath(QFileInfo(path).path());
+        if (QFileInfo(path).isSymLink()) {
+            QFile::remove(path);  // QSaveFile would write to the link's target
+        }
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return Result<void, QString>::err(QString("Cannot write %1").arg(path));
+        }
+
+        qint64 written = 0;
+        for (const ObjectId& chunk : recipe.value().chunks) {
+            auto chunkData = fetchChunk(chunk);
+            if (chunkData.isErr()) {
+                return Result<void, QString>::err(chunkData.error());
+            }
+            const QByteArray& data = chunkData.value();
+            if (file.write(data) != data.size()) {
+                return Result<void, QString>::err(QString("Cannot write %1").arg(path));
+            }
+            written += data.size();
+        }
+
+        if (written != recipe.value().size || !file.commit()) {
+            return Result<void, QString>::err(QString("Cannot write %1").arg(path));
+        }
+        if (entry.mode == "100755") {
+            QFile::setPermissions(path, QFile::permissions(path)
+                | QFileDevice::ExeOwner | QFileDevice::ExeGroup | QFileDevice::ExeOther);
+        }
+    }
+
+    // Checked one by one: a link made here must not carry a later one out
+    for (const PendingLink& link : links) {
+        if (!staysInside(link.path, canonicalTarget)) {
+            return Result<void, QString>::err(QString("Unsafe path in snapshot: %1")
+                                                  .arg(target.relativeFilePath(link.path)));
+        }
+        QDir().mkpath(QFileInfo(link.path).path());
+        QFile::remove(link.path);
+        if (!QFile::link(link.target, link.path)) {
+            return Result<void, QString>::err(QString("Cannot link %1").arg(link.path));
+        }
+    }
+    return Result<void, QString>::ok();
+}
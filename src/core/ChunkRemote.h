@@ -0,0 +1,90 @@
+#ifndef CHUNKREMOTE_H
+#define CHUNKREMOTE_H
+
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include "types/ObjectId.h"
+#include "types/Result.h"
+
+/**
+ * @brief How a file's content splits into chunks on a chunk remote
+ *
+ * Stored under recipeKey() of the file's git blob, so a machine that
+ * already knows the blob can tell whether the file is backed up without
+ * reading it.
+ */
+struct ChunkRecipe {
+    qint64 size = 0;
+    QVector<ObjectId> chunks;
+
+    QByteArray encode() const;
+    static Result<ChunkRecipe, QString> decode(const QByteArray& data);
+    static ObjectId recipeKey(const QString& blobId);
+};
+
+/**
+ * @brief Every file of one snapshot, as stored on a chunk remote
+ */
+struct RemoteSnapshot {
+    struct Entry {
+        QString path;
+        QString mode;        // git file mode, e.g. 100644
+        QString blobId;      // Recipe is at ChunkRecipe::recipeKey(blobId)
+    };
+
+    QString commit;
+    QVector<Entry> entries;
+
+    QByteArray encode() const;
+    static Result<RemoteSnapshot, QString> decode(const QByteArray& data);
+    static ObjectId snapshotKey(const QString& commit);
+};
+
+/**
+ * @brief Content-addressed object storage for backups, one backend per kind of remote
+ *
+ * Holds chunks keyed by the SHA-1 of their content, plus recipes and
+ * snapshot manifests under keys derived from the git objects they
+ * describe. Nothing is named per machine, so every machine backing up the
+ * same mods to one remote shares their chunks. Existence is asked for
+ * many keys at once so a remote backend answers in one round trip per
+ * batch rather than per chunk.
+ */
+class ChunkRemote {
+public:
+    static constexpr int QueryBatchSize = 1024;
+
+    virtual ~ChunkRemote() = default;
+
+    /**
+     * @brief Open the backend for a remote URL
+     *
+     * "chunks:<directory>" (or chunks:file://...) is a plain directory,
+     * for a backup drive or a synced folder. Other URLs are git remotes.
+     */
+    static Result<QSharedPointer<ChunkRemote>, QString> open(const QString& url);
+    static bool isChunkUrl(const QString& url);
+
+    /**
+     * @return One flag per key, in order; at most QueryBatchSize keys
+     */
+    virtual Result<QVector<bool>, QString> contains(const QVector<ObjectId>& keys) = 0;
+
+    /**
+     * @brief Store an object; storing an existing key again is harmless
+     */
+    virtual Result<void, QString> put(const ObjectId& key, const QByteArray& data) = 0;
+    virtual Result<QByteArray, QString> get(const ObjectId& key) = 0;
+
+    /**
+     * @brief Write a backed-up snapshot's files into a directory
+     *
+     * Symlinks are made after every file, and nothing is written where a
+     * symlink would carry it out of the directory.
+     */
+    Result<void, QString> download(const QString& commit, const QString& directory);
+};
+
+#endif // CHUNKREMOTE_H
@@ -0,0 +1,126 @@
+#include "ChunkStore.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QtEndian>
+
+namespace {
+
+constexpr quint32 IndexMagic = 0x5647434b;  // "VGCK"
+constexpr quint32 IndexVersion = 1;
+constexpr int IndexHeaderSize = 8;
+constexpr int IndexEntrySize = ObjectId::Size + 8 + 4;  // ID, offset, length
+
+} // namespace
+
+ChunkStore::ChunkStore(const QString& directory)
+    : m_directory(directory)
+    , m_data(QDir(m_directory).filePath("chunks.dat"))
+    , m_index(QDir(m_directory).filePath("chunks.idx"))
+{
+}
+
+Result<void, QString> ChunkStore::open()
+{
+    m_locations.clear();
+    if (!QDir().mkpath(m_directory)) {
+        return Result<void, QString>::err(QString("Cannot create %1").arg(m_directory));
+    }
+    if (!m_data.open(QIODevice::ReadWrite)) {
+        return Result<void, QString>::err(QString("Cannot open %1").arg(m_data.fileName()));
+    }
+    if (!m_index.open(QIODevice::ReadWrite)) {
+        return Result<void, QString>::err(QString("Cannot open %1").arg(m_index.fileName()));
+    }
+
+    if (m_index.size() == 0) {
+        uchar header[IndexHeaderSize];
+        qToBigEndian(IndexMagic, header);
+        qToBigEndian(IndexVersion, header + 4);
+        if (m_index.write(reinterpret_cast<const char*>(header), IndexHeaderSize) != IndexHeaderSize
+            || !m_index.flush()) {
+            return Result<void, QString>::err(QString("Cannot write %1").arg(m_index.fileName()));
+        }
+        return Result<void, QString>::ok();
+    }
+
+    QByteArray contents = m_index.readAll();
+    if (contents.size() < IndexHeaderSize
+        || qFromBigEndian<quint32>(contents.constData()) != IndexMagic
+        || qFromBigEndian<quint32>(contents.constData() + 4) != IndexVersion) {
+        // Unlike the rebuildable indexes, the chunks are the only copy
+        return Result<void, QString>::err(QString("Unsupported chunk index %1").arg(m_index.fileName()));
+    }
+
+    qint64 dataSize = m_data.size();
+    int entryCount = (contents.size() - IndexHeaderSize) / IndexEntrySize;
+    m_locations.reserve(entryCount);
+    for (int i = 0; i < entryCount; ++i) {
+        const char* entry = contents.constData() + IndexHeaderSize + i * IndexEntrySize;
+        Location location;
+        location.offset = qFromBigEndian<qint64>(entry + ObjectId::Size);
+        location.length = qFromBigEndian<quint32>(entry + ObjectId::Size + 8);
+        if (location.offset + location.length > dataSize) {
+            continue;  // Data lost in a crash; the chunk is written again on demand
+        }
+        m_locations.insert(ObjectId::fromBytes(QByteArrayView(entry, ObjectId::Size)), location);
+    }
+
+    // Drop a torn trailing entry so the next append stays aligned
+    qint64 validSize = IndexHeaderSize + qint64(entryCount) * IndexEntrySize;
+    if (m_index.size() != validSize && !m_index.resize(validSize)) {
+        return Result<void, QString>::err(QString("Cannot repair %1").arg(m_index.fileName()));
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<ObjectId, QString> ChunkStore::put(QByteArrayView data)
+{
+    ObjectId id = ObjectId::fromBytes(QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+    if (m_locations.contains(id)) {
+        return Result<ObjectId, QString>::ok(id);
+    }
+
+    Location location;
+    location.offset = m_data.size();
+    location.length = quint32(data.size());
+    if (!m_data.seek(location.offset)
+        || m_data.write(data.data(), data.size()) != data.size()
+        || !m_data.flush()) {
+        return Result<ObjectId, QString>::err(QString("Cannot write %1").arg(m_data.fileName()));
+    }
+
+    // Indexed only once the data is on disk
+    uchar entry[IndexEntrySize];
+    std::memcpy(entry, id.data(), ObjectId::Size);
+    qToBigEndian(location.offset, entry + ObjectId::Size);
+    qToBigEndian(location.length, entry + ObjectId::Size + 8);
+    if (!m_index.seek(m_index.size())
+        || m_index.write(reinterpret_cast<const char*>(entry), IndexEntrySize) != IndexEntrySize
+        || !m_index.flush()) {
+        return Result<ObjectId, QString>::err(QString("Cannot write %1").arg(m_index.fileName()));
+    }
+
+    m_locations.insert(id, location);
+    return Result<ObjectId, QString>::ok(id);
+}
+
+Result<QByteArray, QString> ChunkStore::get(const ObjectId& id)
+{
+    auto it = m_locations.constFind(id);
+    if (it == m_locations.constEnd()) {
+        return Result<QByteArray, QString>::err(QString("Missing chunk %1").arg(id.toHex()));
+    }
+
+    if (!m_data.seek(it->offset)) {
+        return Result<QByteArray, QString>::err(QString("Cannot read %1").arg(m_data.fileName()));
+    }
+    QByteArray data = m_data.read(it->length);
+    if (data.size() != qsizetype(it->length)) {
+        return Result<QByteArray, QString>::err(QString("Truncated chunk %1").arg(id.toHex()));
+    }
+    // A damaged chunk must fail the smudge, not restore a corrupt file
+    if (ObjectId::fromBytes(QCryptographicHash::hash(data, QCryptographicHash::Sha1)) != id) {
+        return Result<QByteArray, QString>::err(QString("Corrupt chunk %1").arg(id.toHex()));
+    }
+    return Result<QByteArray, QString>::ok(data);
+}
@@ -0,0 +1,67 @@
+#ifndef CHUNKSTORE_H
+#define CHUNKSTORE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include "types/ObjectId.h"
+#include "types/Result.h"
+
+/**
+ * @brief Content-addressed store for pieces of large files
+ *
+ * Lives under .git/vgvc next to the other vgvc indexes. Chunks are
+ * keyed by the SHA-1 of their content, so a chunk shared by many
+ * snapshots (or moved within a file) is stored once. Both files are
+ * append-only: chunk data goes to chunks.dat and a fixed-size index
+ * entry to chunks.idx after the data is written, so an interrupted write
+ * leaves at worst unreferenced bytes. Not thread-safe; one process at a
+ * time should hold the store (filter processes take a lock file).
+ */
+class ChunkStore {
+public:
+    /**
+     * @param directory Store location, e.g. .git/vgvc/chunks
+     */
+    explicit ChunkStore(const QString& directory);
+
+    /**
+     * @brief Open the store, creating it if needed, and load its index
+     */
+    Result<void, QString> open();
+
+    bool contains(const ObjectId& id) const { return m_locations.contains(id); }
+
+    /**
+     * @brief Store a chunk unless an identical one is already present
+     * @return The chunk's content hash
+     */
+    Result<ObjectId, QString> put(QByteArrayView data);
+
+    Result<QByteArray, QString> get(const ObjectId& id);
+
+    int chunkCount() const { return m_locations.size(); }
+
+    QList<ObjectId> ids() const { return m_locations.keys(); }
+
+    /**
+     * @brief Directory holding the store; lock files belong here too
+     */
+    QString directory() const { return m_directory; }
+
+private:
+    struct Location {
+        qint64 offset;
+        quint32 length;
+    };
+
+    QString m_directory;
+    QFile m_data;
+    QFile m_index;
+    QHash<ObjectId, Location> m_locations;
+};
+
+#endif // CHUNKSTORE_H
@@ -0,0 +1,643 @@
+#include "CommitPipeline.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QProcess>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtEndian>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "utils/BoundedQueue.h"
+#include "utils/FileScanner.h"
+#include "utils/Tracer.h"
+
+namespace {
+
+constexpr size_t QueueCapacity = 64;
+constexpr int LooseCompressionLevel = 1;     // git's core.looseCompression default
+constexpr qint64 ModifiedSlackMs = 2000;     // Coarse file system timestamps
+constexpr int SpinAttempts = 64;
+constexpr auto BackOffSleep = std::chrono::microseconds(200);
+constexpr quint32 PackIndexMagic = 0xff744f63;  // "\377tOc", pack index version 2 on
+constexpr qint64 PackIndexHeaderBytes = 8 + 256 * 4;  // Magic, version, fan-out table
+constexpr int ObjectIdBytes = 20;
+constexpr int GitStartTimeoutMs = 10000;
+
+// Attributes that make git convert content before hashing it
+const QStringList ConversionAttributes{"text", "eol", "crlf", "ident", "filter", "working-tree-encoding"};
+
+struct PipelineItem {
+    QString path;            // Relative to the repository
+    qint64 size = 0;         // Bytes counted against InFlightBytes
+    QByteArray objectId;     // Hex, from the hash stage on
+    QByteArray data;         // Raw object, then its deflated form
+    bool autoText = false;   // git converts it if it holds CRLF line endings
+};
+
+/**
+ * @brief Stage threads waiting on a queue: spin briefly, then sleep
+ */
+class BackOff {
+public:
+    void wait()
+    {
+        if (m_attempt++ < SpinAttempts) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(BackOffSleep);
+        }
+    }
+
+private:
+    int m_attempt = 0;
+};
+
+/**
+ * @brief Shared state of one run, and the queues between its stages
+ */
+struct PipelineState {
+    BoundedQueue<PipelineItem> scanned{QueueCapacity};
+    BoundedQueue<PipelineItem> hashed{QueueCapacity};
+    BoundedQueue<PipelineItem> compressed{QueueCapacity};
+
+    // Producers still running for each queue; a consumer stops when its
+    // queue is empty and this reaches zero
+    std::atomic<int> scanners{1};
+    std::atomic<int> hashers{0};
+    std::atomic<int> compressors{0};
+
+    std::atomic<qint64> inFlightBytes{0};
+    std::atomic<qint64> existingObjects{0};
+    std::atomic<bool> failed{false};
+
+    QMutex mutex;            // Guards stats and error
+    CommitPipelineStats stats;
+    QString error;
+
+    void fail(const QString& message)
+    {
+        QMutexLocker locker(&mutex);
+        if (error.isEmpty()) {
+            error = message;
+        }
+        failed = true;
+    }
+
+    void add(PipelineStageStats& total, const PipelineStageStats& part)
+    {
+        QMutexLocker locker(&mutex);
+        total.items += part.items;
+        total.bytes += part.bytes;
+        total.busyUs += part.busyUs;
+        total.starvedUs += part.starvedUs;
+        total.blockedUs += part.blockedUs;
+    }
+
+    void release(const PipelineItem& item)
+    {
+        inFlightBytes.fetch_sub(item.size, std::memory_order_release);
+    }
+};
+
+/**
+ * @brief Push, waiting while the queue is full; false if the run failed
+ */
+bool pushWaiting(BoundedQueue<PipelineItem>& queue, const PipelineItem& item,
+                 const PipelineState& state, PipelineStageStats& stats)
+{
+    if (queue.tryPush(item)) {
+        return true;
+    }
+    qint64 start = Tracer::nowUs();
+    BackOff backOff;
+    while (!queue.tryPush(item)) {
+        if (state.failed.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        backOff.wait();
+    }
+    stats.blockedUs += Tracer::nowUs() - start;
+    return true;
+}
+
+/**
+ * @brief Pop, waiting while the queue is empty; false once it is drained
+ */
+bool popWaiting(BoundedQueue<PipelineItem>& queue, PipelineItem& item,
+                const std::atomic<int>& producers, const PipelineState& state,
+                PipelineStageStats& stats)
+{
+    if (queue.tryPop(item)) {
+        return true;
+    }
+    qint64 start = Tracer::nowUs();
+    BackOff backOff;
+    while (!queue.tryPop(item)) {
+        if (state.failed.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        // Producers publish their last item before they count down
+        if (producers.load(std::memory_order_acquire) == 0) {
+            bool found = queue.tryPop(item);
+            stats.starvedUs += Tracer::nowUs() - start;
+            return found;
+        }
+        backOff.wait();
+    }
+    stats.starvedUs += Tracer::nowUs() - start;
+    return true;
+}
+
+QString looseObjectPath(const QString& objectsDir, const QByteArray& objectId)
+{
+    return QString("%1/%2/%3").arg(objectsDir, QString::fromLatin1(objectId.left(2)),
+                                   QString::fromLatin1(objectId.mid(2)));
+}
+
+/**
+ * @brief The object IDs in the repository's pack indexes, mapped read-only
+ *
+ * Repacking and git gc move content out of the loose objects; a hashed
+ * file found in a pack is stored already. Indexes that aren't version 2
+ * are skipped, which costs only a duplicate loose object.
+ */
+class PackedObjects {
+public:
+    explicit PackedObjects(const QString& objectsDir)
+    {
+        QDir packDir(QDir(objectsDir).filePath("pack"));
+        const QFileInfoList indexFiles = packDir.entryInfoList({"*.idx"}, QDir::Files);
+        for (const QFileInfo& info : indexFiles) {
+            auto file = std::make_unique<QFile>(info.filePath());
+            if (!file->open(QIODevice::ReadOnly) || file->size() < PackIndexHeaderBytes) {
+                continue;
+            }
+            const uchar* data = file->map(0, file->size());
+            if (!data || qFromBigEndian<quint32>(data) != PackIndexMagic
+                || qFromBigEndian<quint32>(data + 4) != 2) {
+                continue;
+            }
+            quint32 count = qFromBigEndian<quint32>(data + PackIndexHeaderBytes - 4);
+            if (file->size() < PackIndexHeaderBytes + qint64(count) * ObjectIdBytes) {
+                continue;
+            }
+            m_indexes.push_back({std::move(file), data, count});
+        }
+    }
+
+    /**
+     * @brief Whether a pack holds the object; safe from any thread
+     * @param objectId Hex object ID
+     */
+    bool contains(const QByteArray& objectId) const
+    {
+        const QByteArray id = QByteArray::fromHex(objectId);
+        if (id.size() != ObjectIdBytes) {
+            return false;
+        }
+        const uchar firstByte = uchar(id[0]);
+
+        for (const PackIndex& index : m_indexes) {
+            // The fan-out table bounds the IDs starting with this byte
+            const uchar* fanOut = index.data + 8;
+            quint32 low = firstByte == 0 ? 0 : qFromBigEndian<quint32>(fanOut + 4 * (firstByte - 1));
+            quint32 high = qMin(qFromBigEndian<quint32>(fanOut + 4 * firstByte), index.count);
+            const uchar* ids = index.data + PackIndexHeaderBytes;
+            while (low < high) {
+                quint32 middle = low + (high - low) / 2;
+                int order = std::memcmp(ids + qint64(middle) * ObjectIdBytes, id.constData(), ObjectIdBytes);
+                if (order == 0) {
+                    return true;
+                }
+                if (order < 0) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    struct PackIndex {
+        std::unique_ptr<QFile> file;  // Keeps the mapping alive
+        const uchar* data;
+        quint32 count;
+    };
+    std::vector<PackIndex> m_indexes;
+};
+
+/**
+ * @brief Asks git which scanned files it would store exactly as on disk
+ *
+ * check-ignore applies every ignore source git add does (nested .gitignore
+ * files, info/exclude, core.excludesFile); check-attr reports conversions
+ * that change the content git hashes. Both answer one path at a time over
+ * a pipe, so the scan keeps streaming.
+ */
+class GitPathFilter {
+public:
+    enum class Verdict {
+        Skip,      // Ignored, or converted on the way in: left to git add
+        Store,
+        AutoText   // Stored as is unless it holds CRLF line endings
+    };
+
+    explicit GitPathFilter(const QString& repoPath)
+        : m_repoPath(repoPath)
+        , m_autoCrlf(false)
+    {}
+
+    ~GitPathFilter()
+    {
+        for (QProcess* process : {&m_ignore, &m_attributes}) {
+            if (process->state() != QProcess::NotRunning) {
+                process->closeWriteChannel();
+                process->waitForFinished();
+            }
+        }
+    }
+
+    Result<void, QString> start()
+    {
+        QProcess config;
+        config.setWorkingDirectory(m_repoPath);
+        config.start("git", {"config", "--get", "core.autocrlf"});
+        if (!config.waitForFinished(GitStartTimeoutMs)) {
+            return Result<void, QString>::err("Cannot read core.autocrlf");
+        }
+        const QByteArray autoCrlf = config.readAllStandardOutput().trimmed().toLower();
+        m_autoCrlf = !autoCrlf.isEmpty() && autoCrlf != "false" && autoCrlf != "no"
+                     && autoCrlf != "off" && autoCrlf != "0";
+
+        m_ignore.setWorkingDirectory(m_repoPath);
+        m_ignore.start("git", {"check-ignore", "-z", "--stdin", "--verbose", "--non-matching"});
+        m_attributes.setWorkingDirectory(m_repoPath);
+        m_attributes.start("git", QStringList{"check-attr", "-z", "--stdin"} + ConversionAttributes);
+        if (!m_ignore.waitForStarted(GitStartTimeoutMs) || !m_attributes.waitForStarted(GitStartTimeoutMs)) {
+            return Result<void, QString>::err("Failed to start git process");
+        }
+        return Result<void, QString>::ok();
+    }
+
+    Result<Verdict, QString> check(const QString& path)
+    {
+        const QByteArray request = path.toUtf8() + '\0';
+        m_ignore.write(request);
+        m_attributes.write(request);
+
+        // <source> <line> <pattern> <path>; all but the path are empty for
+        // no match, and a matching "!" pattern un-ignores
+        QByteArray fields[4];
+        for (QByteArray& field : fields) {
+            if (!readField(m_ignore, field)) {
+                return Result<Verdict, QString>::err(QString("git check-ignore failed on %1").arg(path));
+            }
+        }
+        bool ignored = !fields[2].isEmpty() && !fields[2].startsWith('!');
+
+        // <path> <attribute> <value> for each attribute, in the order asked
+        QHash<QByteArray, QByteArray> values;
+        for (int i = 0; i < ConversionAttributes.size(); ++i) {
+            QByteArray attributePath;
+            QByteArray attribute;
+            QByteArray value;
+            if (!readField(m_attributes, attributePath) || !readField(m_attributes, attribute)
+                || !readField(m_attributes, value)) {
+                return Result<Verdict, QString>::err(QString("git check-attr failed on %1").arg(path));
+            }
+            values.insert(attribute, value);
+        }
+
+        if (ignored) {
+            return Result<Verdict, QString>::ok(Verdict::Skip);
+        }
+        return Result<Verdict, QString>::ok(verdict(values));
+    }
+
+private:
+    QString m_repoPath;
+    QProcess m_ignore;
+    QProcess m_attributes;
+    bool m_autoCrlf;
+
+    Verdict verdict(const QHash<QByteArray, QByteArray>& values) const
+    {
+        auto specified = [&values](const char* attribute) {
+            const QByteArray value = values.value(attribute);
+            return value != "unspecified" && value != "unset";
+        };
+        if (specified("filter") || specified("ident") || specified("working-tree-encoding")
+            || values.value("crlf") != "unspecified") {
+            return Verdict::Skip;
+        }
+
+        const QByteArray text = values.value("text");
+        if (text == "unset") {
+            return Verdict::Store;
+        }
+        if (text == "auto") {
+            return Verdict::AutoText;
+        }
+        if (text != "unspecified" || specified("eol")) {
+            return Verdict::Skip;  // Always converted, or eol implies text
+        }
+        return m_autoCrlf ? Verdict::AutoText : Verdict::Store;
+    }
+
+    static bool readField(QProcess& process, QByteArray& field)
+    {
+        field.clear();
+        char c;
+        while (true) {
+            if (process.bytesAvailable() == 0 && !process.waitForReadyRead(-1)) {
+                return false;
+            }
+            while (process.getChar(&c)) {
+                if (c == '\0') {
+                    return true;
+                }
+                field += c;
+            }
+        }
+    }
+};
+
+/**
+ * @brief The top-level .gitignore, to prune ignored directories cheaply
+ *
+ * GitPathFilter decides for each file; this only saves walking trees git
+ * would ignore anyway.
+ */
+PatternMatcher gitignoreMatcher(const QString& repoPath)
+{
+    // Git never tracks its own directory
+    QStringList patterns{".git/"};
+    QFile file(QDir(repoPath).filePath(".gitignore"));
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        for (const QString& line : QString::fromUtf8(file.readAll()).split('\n')) {
+            QString pattern = line.trimmed();
+            if (!pattern.isEmpty() && !pattern.startsWith('#')) {
+                patterns << pattern;
+            }
+        }
+    }
+    return PatternMatcher(patterns);
+}
+
+} // namespace
+
+QString CommitPipelineStats::summary() const
+{
+    auto line = [](const char* name, const PipelineStageStats& stage) {
+        return QString("%1: %2 files, %3 MB, %4 MB/s busy, %5 ms starved, %6 ms blocked")
+            .arg(name).arg(stage.items).arg(stage.bytes / (1024 * 1024))
+            .arg(stage.megabytesPerSecond(), 0, 'f', 1)
+            .arg(stage.starvedUs / 1000).arg(stage.blockedUs / 1000);
+    };
+    return QStringList{
+        QString("Commit pipeline: %1 ms, %2 objects already stored").arg(wallUs / 1000).arg(existingObjects),
+        line("scan", scan),
+        line("hash", hash),
+        line("compress", compress),
+        line("write", write)
+    }.join("\n  ");
+}
+
+CommitPipeline::CommitPipeline(const QString& repoPath, ExecutionClass executionClass)
+    : m_repoPath(QDir::cleanPath(repoPath))
+    , m_executionClass(executionClass)
+    , m_baselineMs(0)
+{
+}
+
+void CommitPipeline::setTrackedScope(const TrackedScope& scope)
+{
+    m_scope = scope;
+}
+
+void CommitPipeline::setFilteredFiles(const PatternMatcher& matcher)
+{
+    m_filtered = matcher;
+}
+
+void CommitPipeline::setBaseline(QSharedPointer<const TreeListing> listing, qint64 sinceMs)
+{
+    m_baseline = listing;
+    m_baselineMs = sinceMs;
+}
+
+Result<CommitPipelineStats, QString> CommitPipeline::run()
+{
+    TraceSpan span("git", "Commit pipeline");
+    qint64 startUs = Tracer::nowUs();
+    PipelineState state;
+    const QString objectsDir = QDir(m_repoPath).filePath(".git/objects");
+    const PackedObjects packed(objectsDir);
+    const ExecutionClass executionClass = m_executionClass;
+
+    // Background snapshots run beside the game: one thread per stage
+    int cores = qMax(1, QThread::idealThreadCount());
+    int hashThreads = executionClass == ExecutionClass::Background ? 1 : qBound(1, cores / 2, 4);
+    int compressThreads = executionClass == ExecutionClass::Background ? 1 : cores;
+    state.hashers = hashThreads;
+    state.compressors = compressThreads;
+
+    auto scanStage = [&]() {
+        ExecutionPolicy::applyToCurrentThread(executionClass);
+        PipelineStageStats stats;
+        qint64 busyStart = Tracer::nowUs();
+
+        GitPathFilter pathFilter(m_repoPath);
+        auto startResult = pathFilter.start();
+        if (startResult.isErr()) {
+            state.fail(startResult.error());
+            state.scanners.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+
+        FileScanner scanner(m_repoPath);
+        scanner.setIgnoreMatcher(gitignoreMatcher(m_repoPath));
+        scanner.setTrackedScope(m_scope);
+        scanner.scan([&](const ScannedFile& file) {
+            if (state.failed.load(std::memory_order_relaxed) || file.size > MaxFileBytes
+                || m_filtered.matches(file.relativePath, false)) {
+                return;
+            }
+            if (m_baseline && file.modifiedMs < m_baselineMs - ModifiedSlackMs) {
+                const TreeEntry* entry = TreeCache::lookup(*m_baseline, file.relativePath);
+                if (entry && entry->size == file.size) {
+                    return;
+                }
+            }
+
+            auto verdict = pathFilter.check(file.relativePath);
+            if (verdict.isErr()) {
+                state.fail(verdict.error());
+                return;
+            }
+            if (verdict.value() == GitPathFilter::Verdict::Skip) {
+                return;
+            }
+
+            ++stats.items;
+            stats.bytes += file.size;
+            PipelineItem item;
+            item.path = file.relativePath;
+            item.size = file.size;
+            item.autoText = verdict.value() == GitPathFilter::Verdict::AutoText;
+
+            qint64 pushStart = Tracer::nowUs();
+            pushWaiting(state.scanned, item, state, stats);
+            busyStart += Tracer::nowUs() - pushStart;
+        });
+
+        stats.busyUs = Tracer::nowUs() - busyStart;
+        state.add(state.stats.scan, stats);
+        state.scanners.fetch_sub(1, std::memory_order_release);
+    };
+
+    auto hashStage = [&]() {
+        ExecutionPolicy::applyToCurrentThread(executionClass);
+        PipelineStageStats stats;
+        PipelineItem item;
+        QDir repoDir(m_repoPath);
+
+        while (popWaiting(state.scanned, item, state.scanners, state, stats)) {
+            // Cap the bytes between here and the writer
+            qint64 waitStart = Tracer::nowUs();
+            BackOff backOff;
+            while (state.inFlightBytes.load(std::memory_order_acquire) + item.size > InFlightBytes
+                   && state.inFlightBytes.load(std::memory_order_acquire) > 0
+                   && !state.failed.load(std::memory_order_relaxed)) {
+                backOff.wait();
+            }
+            stats.blockedUs += Tracer::nowUs() - waitStart;
+
+            qint64 busyStart = Tracer::nowUs();
+            QString filePath = repoDir.filePath(item.path);
+            QFile file(filePath);
+            if (QFileInfo(filePath).isSymLink() || !file.open(QIODevice::ReadOnly)) {
+                continue;  // git add stores links, and reports unreadable files
+            }
+            QByteArray content = file.readAll();
+            if (item.autoText && content.contains("\r\n")) {
+                continue;  // git add stores it with LF line endings
+            }
+            item.size = content.size();
+            state.inFlightBytes.fetch_add(item.size, std::memory_order_acq_rel);
+
+            item.data = QByteArray("blob ") + QByteArray::number(content.size()) + '\0';
+            item.data += content;
+            content.clear();
+            item.objectId = QCryptographicHash::hash(item.data, QCryptographicHash::Sha1).toHex();
+            ++stats.items;
+            stats.bytes += item.size;
+            stats.busyUs += Tracer::nowUs() - busyStart;
+
+            if (packed.contains(item.objectId)
+                || QFileInfo::exists(looseObjectPath(objectsDir, item.objectId))) {
+                state.existingObjects.fetch_add(1, std::memory_order_relaxed);
+                state.release(item);
+                continue;
+            }
+            if (!pushWaiting(state.hashed, item, state, stats)) {
+                break;
+            }
+        }
+
+        state.add(state.stats.hash, stats);
+        state.hashers.fetch_sub(1, std::memory_order_release);
+    };
+
+    auto compressStage = [&]() {
+        ExecutionPolicy::applyToCurrentThread(executionClass);
+        PipelineStageStats stats;
+        PipelineItem item;
+
+        while (popWaiting(state.hashed, item, state.hashers, state, stats)) {
+            qint64 busyStart = Tracer::nowUs();
+            // qCompress prefixes the zlib stream with a 4-byte length; loose objects don't
+            item.data = qCompress(item.data, LooseCompressionLevel).mid(4);
+            ++stats.items;
+            stats.bytes += item.size;
+            stats.busyUs += Tracer::nowUs() - busyStart;
+
+            if (!pushWaiting(state.compressed, item, state, stats)) {
+                break;
+            }
+        }
+
+        state.add(state.stats.compress, stats);
+        state.compressors.fetch_sub(1, std::memory_order_release);
+    };
+
+    auto writeStage = [&]() {
+        ExecutionPolicy::applyToCurrentThread(executionClass);
+        PipelineStageStats stats;
+        PipelineItem item;
+
+        while (popWaiting(state.compressed, item, state.compressors, state, stats)) {
+            qint64 busyStart = Tracer::nowUs();
+            QString objectPath = looseObjectPath(objectsDir, item.objectId);
+            QDir().mkpath(QFileInfo(objectPath).path());
+
+            // Renamed into place, so git never sees a partial object
+            QSaveFile file(objectPath);
+            if (!file.open(QIODevice::WriteOnly)
+                || file.write(item.data) != item.data.size()
+                || !file.commit()) {
+                state.fail(QString("Cannot write object for %1").arg(item.path));
+                break;
+            }
+            QFile::setPermissions(objectPath, QFileDevice::ReadOwner | QFileDevice::ReadGroup
+                                              | QFileDevice::ReadOther);
+
+            ++stats.items;
+            stats.bytes += item.data.size();
+            stats.busyUs += Tracer::nowUs() - busyStart;
+            state.release(item);
+        }
+
+        state.add(state.stats.write, stats);
+    };
+
+    // Stages wait on each other, so each needs a thread of its own; the
+    // shared pools may be busy with the very task running this pipeline
+    QThreadPool pool;
+    pool.setMaxThreadCount(2 + hashThreads + compressThreads);
+    QList<QFuture<void>> stages;
+    stages << QtConcurrent::run(&pool, scanStage);
+    for (int i = 0; i < hashThreads; ++i) {
+        stages << QtConcurrent::run(&pool, hashStage);
+    }
+    for (int i = 0; i < compressThreads; ++i) {
+        stages << QtConcurrent::run(&pool, compressStage);
+    }
+    stages << QtConcurrent::run(&pool, writeStage);
+    for (QFuture<void>& stage : stages) {
+        stage.waitForFinished();
+    }
+
+    if (state.failed) {
+        return Result<CommitPipelineStats, QString>::err(state.error);
+    }
+
+    CommitPipelineStats stats = state.stats;
+    stats.existingObjects = state.existingObjects;
+    stats.wallUs = Tracer::nowUs() - startUs;
+    span.setArg("files", stats.hash.items);
+    span.setArg("written", stats.write.items);
+    span.setArg("existing", stats.existingObjects);
+    return Result<CommitPipelineStats, QString>::ok(stats);
+}
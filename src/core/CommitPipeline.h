@@ -0,0 +1,94 @@
+#ifndef COMMITPIPELINE_H
+#define COMMITPIPELINE_H
+
+#include <QSharedPointer>
+#include <QString>
+#include "TreeCache.h"
+#include "types/Result.h"
+#include "utils/ExecutionPolicy.h"
+#include "utils/PatternMatcher.h"
+#include "utils/TrackedScope.h"
+
+/**
+ * @brief Throughput of one pipeline stage, summed over its threads
+ */
+struct PipelineStageStats {
+    qint64 items = 0;
+    qint64 bytes = 0;
+    qint64 busyUs = 0;       // Doing the stage's own work
+    qint64 starvedUs = 0;    // Waiting for the previous stage
+    qint64 blockedUs = 0;    // Waiting for room in the next stage's queue
+
+    double megabytesPerSecond() const
+    {
+        return busyUs > 0 ? double(bytes) / double(busyUs) : 0.0;
+    }
+};
+
+struct CommitPipelineStats {
+    PipelineStageStats scan;
+    PipelineStageStats hash;
+    PipelineStageStats compress;
+    PipelineStageStats write;
+    qint64 existingObjects = 0;  // Hashed, but git already had the content
+    qint64 wallUs = 0;
+
+    /**
+     * @brief One line per stage, for the log
+     */
+    QString summary() const;
+};
+
+/**
+ * @brief Writes the objects for a snapshot's changed files ahead of git add
+ *
+ * Four stages run at once, connected by bounded lock-free queues: a
+ * directory scan picks files that changed since the last snapshot, hash
+ * threads read them and name their blobs, compress threads deflate the
+ * ones no pack or loose object holds yet and one writer stores them as
+ * loose objects. A full queue stalls the stage feeding it, and the bytes
+ * read but not yet written are capped, so memory stays flat however large
+ * the snapshot. Disk reads, compression and writes overlap instead of
+ * taking turns.
+ *
+ * git add still builds the index. It finds each object already present and
+ * only hashes the file, skipping the compression and write that dominate
+ * a large snapshot. Files git ignores, files whose attributes or
+ * core.autocrlf make git convert them (filters, text, eol, ident) and very
+ * large files are left to git entirely; a file the pipeline gets wrong
+ * costs only an unused object, never a wrong snapshot. Stage threads don't
+ * pause for a congested disk, so GitService runs the pipeline for
+ * foreground commits only.
+ */
+class CommitPipeline {
+public:
+    static constexpr qint64 MaxFileBytes = 16 * 1024 * 1024;    // Larger files go to git
+    static constexpr qint64 InFlightBytes = 128 * 1024 * 1024;  // Read but not yet written
+
+    CommitPipeline(const QString& repoPath, ExecutionClass executionClass);
+
+    void setTrackedScope(const TrackedScope& scope);
+
+    /**
+     * @brief Paths git stores through a filter; never hashed here
+     */
+    void setFilteredFiles(const PatternMatcher& matcher);
+
+    /**
+     * @brief The last snapshot's files, to skip the ones that didn't change
+     * @param sinceMs Files modified before this and matching in size are unchanged
+     */
+    void setBaseline(QSharedPointer<const TreeListing> listing, qint64 sinceMs);
+
+    Result<CommitPipelineStats, QString> run();
+
+private:
+    QString m_repoPath;
+    ExecutionClass m_executionClass;
+    TrackedScope m_scope;
+    PatternMatcher m_filtered;
+    QSharedPointer<const TreeListing> m_baseline;
+    qint64 m_baselineMs;
+};
+
+#endif // COMMITPIPELINE_H
@@ -0,0 +1,56 @@
+#include "ContentChunker.h"
+#include <array>
+
+namespace {
+
+// Bits that must be zero to cut: more before the average size, fewer after
+constexpr quint64 StrictMask = ~quint64(0) << (64 - 20);
+constexpr quint64 LooseMask = ~quint64(0) << (64 - 16);
+
+// Fixed pseudo-random table (splitmix64), so every build cuts alike
+constexpr std::array<quint64, 256> makeGearTable()
+{
+    std::array<quint64, 256> table{};
+    quint64 state = 0x5647564343444331ULL;  // "VGVCCDC1"
+    for (quint64& entry : table) {
+        state += 0x9e3779b97f4a7c15ULL;
+        quint64 value = state;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        entry = value ^ (value >> 31);
+    }
+    return table;
+}
+
+constexpr std::array<quint64, 256> GearTable = makeGearTable();
+
+} // namespace
+
+qsizetype ContentChunker::boundary(QByteArrayView data)
+{
+    const qsizetype size = data.size();
+    if (size <= MinSize) {
+        return size;
+    }
+
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.data());
+    const qsizetype normalEnd = qMin(size, AverageSize);
+    const qsizetype end = qMin(size, MaxSize);
+
+    // Bytes before MinSize never end a chunk, so they are not hashed
+    quint64 hash = 0;
+    qsizetype i = MinSize;
+    for (; i < normalEnd; ++i) {
+        hash = (hash << 1) + GearTable[bytes[i]];
+        if (!(hash & StrictMask)) {
+            return i + 1;
+        }
+    }
+    for (; i < end; ++i) {
+        hash = (hash << 1) + GearTable[bytes[i]];
+        if (!(hash & LooseMask)) {
+            return i + 1;
+        }
+    }
+    return end;
+}
@@ -0,0 +1,32 @@
+#ifndef CONTENTCHUNKER_H
+#define CONTENTCHUNKER_H
+
+#include <QByteArrayView>
+
+/**
+ * @brief Content-defined chunk boundaries for large files
+ *
+ * A gear hash slides over the data and a chunk ends where its top bits
+ * are zero, so boundaries follow the content rather than fixed offsets:
+ * inserting or patching a few bytes in a multi-GB archive changes only
+ * the chunks around the edit, and two copies of an asset cut identically
+ * on every machine. Boundaries are harder to hit before the average size
+ * and easier after it (FastCDC normalization), keeping chunk sizes close
+ * to the average within [MinSize, MaxSize].
+ */
+class ContentChunker {
+public:
+    static constexpr qsizetype MinSize = 64 * 1024;
+    static constexpr qsizetype AverageSize = 256 * 1024;
+    static constexpr qsizetype MaxSize = 1024 * 1024;
+
+    /**
+     * @brief Length of the chunk starting at data
+     *
+     * For stable boundaries, pass at least MaxSize bytes unless data is
+     * the end of the file.
+     */
+    static qsizetype boundary(QByteArrayView data);
+};
+
+#endif // CONTENTCHUNKER_H
@@ -0,0 +1,200 @@
+#include "DeltaCodec.h"
+#include <QVector>
+#include <cstring>
+
+namespace {
+
+constexpr int BlockSize = 32;
+constexpr quint32 HashMultiplier = 0x01000193;
+constexpr char InsertOp = 0x00;
+constexpr char CopyOp = 0x01;
+
+void writeVarint(QByteArray& out, quint64 value)
+{
+    while (value >= 0x80) {
+        out += char((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += char(value);
+}
+
+bool readVarint(const QByteArray& in, qsizetype& position, quint64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (position >= in.size()) {
+            return false;
+        }
+        quint8 byte = quint8(in[position++]);
+        value |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+quint32 blockHash(const uchar* data)
+{
+    quint32 hash = 0;
+    for (int i = 0; i < BlockSize; ++i) {
+        hash = hash * HashMultiplier + data[i];
+    }
+    return hash;
+}
+
+/**
+ * @brief Base block offsets by hash; one offset per bucket, like git's
+ *        diff-delta, so memory stays proportional to the base
+ */
+class BlockIndex {
+public:
+    explicit BlockIndex(const QByteArray& base)
+    {
+        qsizetype blocks = base.size() / BlockSize;
+        int buckets = 16;
+        while (buckets < blocks * 2) {
+            buckets <<= 1;
+        }
+        m_mask = quint32(buckets - 1);
+        m_offsets.fill(-1, buckets);
+
+        const uchar* data = reinterpret_cast<const uchar*>(base.constData());
+        for (qsizetype offset = 0; offset + BlockSize <= base.size(); offset += BlockSize) {
+            qint32& slot = m_offsets[bucket(blockHash(data + offset))];
+            if (slot < 0) {
+                slot = qint32(offset);  // Earliest block wins
+            }
+        }
+    }
+
+    qint32 find(quint32 hash) const { return m_offsets[bucket(hash)]; }
+
+private:
+    QVector<qint32> m_offsets;
+    quint32 m_mask;
+
+    int bucket(quint32 hash) const { return int((hash ^ (hash >> 15)) & m_mask); }
+};
+
+} // namespace
+
+QByteArray DeltaCodec::encode(const QByteArray& base, const QByteArray& target)
+{
+    QByteArray delta;
+    writeVarint(delta, quint64(base.size()));
+    writeVarint(delta, quint64(target.size()));
+
+    auto emitInsert = [&](qsizetype start, qsizetype length) {
+        if (length > 0) {
+            delta += InsertOp;
+            writeVarint(delta, quint64(length));
+            delta.append(target.constData() + start, length);
+        }
+    };
+
+    qsizetype size = target.size();
+    if (base.size() < BlockSize || size < BlockSize) {
+        emitInsert(0, size);
+        return delta;
+    }
+
+    BlockIndex index(base);
+    const uchar* from = reinterpret_cast<const uchar*>(base.constData());
+    const uchar* to = reinterpret_cast<const uchar*>(target.constData());
+
+    // Weight of the byte leaving the window
+    quint32 outgoingWeight = 1;
+    for (int i = 1; i < BlockSize; ++i) {
+        outgoingWeight *= HashMultiplier;
+    }
+
+    qsizetype position = 0;
+    qsizetype insertStart = 0;
+    quint32 hash = blockHash(to);
+    while (position + BlockSize <= size) {
+        qint32 candidate = index.find(hash);
+        if (candidate >= 0 && std::memcmp(from + candidate, to + position, BlockSize) == 0) {
+            // Grow the match into the pending insert, then forward
+            qsizetype matchStart = position;
+            qsizetype baseStart = candidate;
+            while (matchStart > insertStart && baseStart > 0 && from[baseStart - 1] == to[matchStart - 1]) {
+                --matchStart;
+                --baseStart;
+            }
+            qsizetype matchEnd = position + BlockSize;
+            qsizetype baseEnd = candidate + BlockSize;
+            while (matchEnd < size && baseEnd < base.size() && from[baseEnd] == to[matchEnd]) {
+                ++matchEnd;
+                ++baseEnd;
+            }
+
+            emitInsert(insertStart, matchStart - insertStart);
+            delta += CopyOp;
+            writeVarint(delta, quint64(baseStart));
+            writeVarint(delta, quint64(matchEnd - matchStart));
+
+            position = matchEnd;
+            insertStart = matchEnd;
+            if (position + BlockSize <= size) {
+                hash = blockHash(to + position);
+            }
+            continue;
+        }
+
+        if (position + BlockSize < size) {
+            hash = (hash - to[position] * outgoingWeight) * HashMultiplier + to[position + BlockSize];
+        }
+        ++position;
+    }
+
+    emitInsert(insertStart, size - insertStart);
+    return delta;
+}
+
+Result<QByteArray, QString> DeltaCodec::apply(const QByteArray& base, const QByteArray& delta)
+{
+    using ApplyResult = Result<QByteArray, QString>;
+
+    qsizetype position = 0;
+    quint64 baseSize = 0;
+    quint64 targetSize = 0;
+    if (!readVarint(delta, position, baseSize) || !readVarint(delta, position, targetSize)) {
+        return ApplyResult::err("Truncated delta header");
+    }
+    if (baseSize != quint64(base.size())) {
+        return ApplyResult::err("Delta was made for a different base");
+    }
+
+    // A corrupt header must not reserve an absurd size; the size is checked as ops apply
+    QByteArray target;
+    target.reserve(qsizetype(qMin(targetSize, quint64(base.size()) + quint64(delta.size()))));
+    while (position < delta.size()) {
+        char op = delta[position++];
+        quint64 length = 0;
+        if (op == InsertOp) {
+            if (!readVarint(delta, position, length) || length > quint64(delta.size() - position)) {
+                return ApplyResult::err("Truncated delta insert");
+            }
+            target.append(delta.constData() + position, qsizetype(length));
+            position += qsizetype(length);
+        } else if (op == CopyOp) {
+            quint64 offset = 0;
+            if (!readVarint(delta, position, offset) || !readVarint(delta, position, length)
+                || offset > baseSize || length > baseSize - offset) {
+                return ApplyResult::err("Delta copy outside the base");
+            }
+            target.append(base.constData() + offset, qsizetype(length));
+        } else {
+            return ApplyResult::err("Unknown delta operation");
+        }
+        if (quint64(target.size()) > targetSize) {
+            return ApplyResult::err("Delta produced the wrong size");
+        }
+    }
+
+    if (quint64(target.size()) != targetSize) {
+        return ApplyResult::err("Delta produced the wrong size");
+    }
+    return ApplyResult::ok(target);
+}
@@ -0,0 +1,30 @@
+#ifndef DELTACODEC_H
+#define DELTACODEC_H
+
+#include <QByteArray>
+#include "types/Result.h"
+
+/**
+ * @brief Binary copy/insert deltas between two versions of a file
+ *
+ * encode() indexes the base in fixed-size blocks by a rolling hash, then
+ * slides the same hash over the target: wherever a window matches a base
+ * block, the match is extended both ways and emitted as a copy from the
+ * base; bytes between matches are emitted as inserts. Save files that
+ * change a few records per save encode to a small fraction of their size.
+ *
+ * Format: varint base size, varint target size, then operations:
+ *   0x00 <varint length> <bytes>      insert
+ *   0x01 <varint offset> <varint length>  copy from base
+ */
+class DeltaCodec {
+public:
+    static QByteArray encode(const QByteArray& base, const QByteArray& target);
+
+    /**
+     * @brief Rebuild the target; fails on a delta made for another base
+     */
+    static Result<QByteArray, QString> apply(const QByteArray& base, const QByteArray& delta);
+};
+
+#endif // DELTACODEC_H
@@ -0,0 +1,350 @@
+#include "DeltaFile.h"
+#include "ChunkStore.h"
+#include "DeltaCodec.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QList>
+#include <QSaveFile>
+
+namespace {
+
+constexpr quint32 HeadsMagic = 0x56474448;  // "VGDH"
+constexpr quint32 HeadsVersion = 3;          // 2 added the content index, 3 made it a log
+constexpr char FullRecord = 'F';
+constexpr char DeltaRecord = 'D';
+const QByteArray ManifestMagic = QByteArrayLiteral("vgvc-delta 2\n");
+const QByteArray RecordManifestMagic = QByteArrayLiteral("vgvc-delta 1\n");
+
+QByteArray idBytes(const ObjectId& id)
+{
+    return QByteArray(reinterpret_cast<const char*>(id.data()), ObjectId::Size);
+}
+
+ObjectId contentHash(const QByteArray& data)
+{
+    return ObjectId::fromBytes(QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+}
+
+} // namespace
+
+DeltaFile::DeltaFile(ChunkStore& store)
+    : m_store(store)
+    , m_headsPath(QDir(store.directory()).filePath("heads"))
+    , m_loaded(false)
+{
+}
+
+Result<void, QString> DeltaFile::load()
+{
+    m_heads.clear();
+    m_records.clear();
+    m_loaded = false;
+
+    QFile file(m_headsPath);
+    if (!file.exists()) {
+        // Never written, or deleted to recover from corruption: every
+        // record is in the store, so the index can be rebuilt from it
+        auto rebuildResult = m_store.chunkCount() > 0 ? rebuild() : Result<void, QString>::ok();
+        m_loaded = rebuildResult.isOk();
+        return rebuildResult;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Result<void, QString>::err(QString("Cannot open %1").arg(m_headsPath));
+    }
+
+    const QString corrupt = QString("Corrupt delta index %1; delete it to rebuild it from the store")
+        .arg(m_headsPath);
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != HeadsMagic) {
+        return Result<void, QString>::err(corrupt);
+    }
+    if (version < 1 || version > HeadsVersion) {
+        // Written by a newer version; left alone so it keeps working there
+        return Result<void, QString>::err(QString("Unsupported delta index %1 (version %2)")
+                                              .arg(m_headsPath).arg(version));
+    }
+
+    if (version < 3) {
+        // Versions 1 and 2 wrote the whole index each time: heads, then
+        // (from 2) the content index. Read in full, then kept as a log
+        qint32 count = 0;
+        in >> count;
+        for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            QString path;
+            QByteArray record;
+            QByteArray content;
+            qint32 depth = 0;
+            in >> path >> record >> content >> depth;
+            addEntry(path, {ObjectId::fromBytes(record), ObjectId::fromBytes(content), depth});
+        }
+        qint32 recordCount = 0;
+        if (version >= 2) {
+            in >> recordCount;
+        }
+        for (qint32 i = 0; i < recordCount && in.status() == QDataStream::Ok; ++i) {
+            QByteArray content;
+            QByteArray record;
+            in >> content >> record;
+            m_records.insert(ObjectId::fromBytes(content), ObjectId::fromBytes(record));
+        }
+        if (in.status() != QDataStream::Ok) {
+            m_heads.clear();
+            m_records.clear();
+            return Result<void, QString>::err(corrupt);
+        }
+        file.close();
+
+        auto writeResult = writeIndex();
+        m_loaded = writeResult.isOk();
+        return writeResult;
+    }
+
+    qint64 validSize = file.pos();
+    while (!in.atEnd()) {
+        QString path;
+        QByteArray record;
+        QByteArray content;
+        qint32 depth = 0;
+        in >> path >> record >> content >> depth;
+        if (in.status() == QDataStream::ReadPastEnd) {
+            break;  // An append cut short; the record itself is in the store
+        }
+        if (in.status() != QDataStream::Ok || record.size() != ObjectId::Size
+            || content.size() != ObjectId::Size || depth < 0 || depth > MaxChainDepth) {
+            m_heads.clear();
+            m_records.clear();
+            return Result<void, QString>::err(corrupt);
+        }
+        addEntry(path, {ObjectId::fromBytes(record), ObjectId::fromBytes(content), depth});
+        validSize = file.pos();
+    }
+
+    // Drop a torn trailing entry so the next append starts cleanly
+    if (validSize != file.size()) {
+        file.close();
+        if (!QFile::resize(m_headsPath, validSize)) {
+            return Result<void, QString>::err(QString("Cannot repair %1").arg(m_headsPath));
+        }
+    }
+    m_loaded = true;
+    return Result<void, QString>::ok();
+}
+
+void DeltaFile::addEntry(const QString& path, const Head& head)
+{
+    m_records.insert(head.content, head.record);
+    if (!path.isEmpty()) {
+        m_heads.insert(path, head);
+    }
+}
+
+Result<void, QString> DeltaFile::rebuild()
+{
+    m_heads.clear();
+    m_records.clear();
+
+    // Every record, full or delta, is named by its content once rebuilt.
+    // The heads are lost, so each path starts a new chain
+    const QList<ObjectId> records = m_store.ids();
+    for (const ObjectId& record : records) {
+        auto versionResult = readVersion(record);
+        if (versionResult.isOk()) {
+            m_records.insert(contentHash(versionResult.value()), record);
+        }
+    }
+    return writeIndex();
+}
+
+Result<void, QString> DeltaFile::writeIndex() const
+{
+    QSaveFile file(m_headsPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(m_headsPath));
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << HeadsMagic << HeadsVersion;
+    for (auto it = m_records.cbegin(); it != m_records.cend(); ++it) {
+        out << QString() << idBytes(it.value()) << idBytes(it.key()) << qint32(0);
+    }
+    // After the records, so replaying sets each path's head last
+    for (auto it = m_heads.cbegin(); it != m_heads.cend(); ++it) {
+        const Head& head = it.value();
+        out << it.key() << idBytes(head.record) << idBytes(head.content) << qint32(head.depth);
+    }
+
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(m_headsPath));
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<void, QString> DeltaFile::appendEntry(const QString& path, const Head& head) const
+{
+    QFile file(m_headsPath);
+    bool created = !file.exists();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(m_headsPath));
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    if (created) {
+        out << HeadsMagic << HeadsVersion;
+    }
+    out << path << idBytes(head.record) << idBytes(head.content) << qint32(head.depth);
+    if (out.status() != QDataStream::Ok || !file.flush()) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(m_headsPath));
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<QByteArray, QString> DeltaFile::clean(const QString& path, const QByteArray& data)
+{
+    if (!m_loaded) {
+        return Result<QByteArray, QString>::err("Delta index not loaded");
+    }
+
+    ObjectId content = contentHash(data);
+
+    // Known content (unchanged, reverted, or the same save under another
+    // path) is already stored; nothing is written
+    if (!m_records.contains(content)) {
+        auto headIt = m_heads.constFind(path);
+        Head head{ObjectId(), content, 0};
+        QByteArray record;
+        if (headIt != m_heads.constEnd() && headIt->depth < MaxChainDepth) {
+            // A base that can't be read just means a full copy
+            auto baseResult = readVersion(headIt->record);
+            if (baseResult.isOk()) {
+                QByteArray delta = DeltaCodec::encode(baseResult.value(), data);
+                if (delta.size() < data.size() / 2) {
+                    record.reserve(1 + ObjectId::Size + delta.size());
+                    record += DeltaRecord;
+                    record.append(reinterpret_cast<const char*>(headIt->record.data()), ObjectId::Size);
+                    record += delta;
+                    head.depth = headIt->depth + 1;
+                }
+            }
+        }
+        if (record.isEmpty()) {
+            record.reserve(1 + data.size());
+            record += FullRecord;
+            record += data;
+        }
+
+        auto putResult = m_store.put(record);
+        if (putResult.isErr()) {
+            return Result<QByteArray, QString>::err(putResult.error());
+        }
+        head.record = putResult.value();
+
+        auto appendResult = appendEntry(path, head);
+        if (appendResult.isErr()) {
+            return Result<QByteArray, QString>::err(appendResult.error());
+        }
+        addEntry(path, head);
+    }
+
+    QByteArray manifest = ManifestMagic;
+    manifest += "size " + QByteArray::number(data.size()) + '\n';
+    manifest += "content " + content.toHex().toLatin1() + '\n';
+    return Result<QByteArray, QString>::ok(manifest);
+}
+
+Result<QByteArray, QString> DeltaFile::smudge(const QByteArray& data)
+{
+    using SmudgeResult = Result<QByteArray, QString>;
+
+    if (!isManifest(data)) {
+        return SmudgeResult::ok(data);
+    }
+
+    QHash<QByteArray, QByteArray> fields;
+    for (const QByteArray& line : data.mid(ManifestMagic.size()).split('\n')) {
+        int separator = line.indexOf(' ');
+        if (separator > 0) {
+            fields.insert(line.left(separator), line.mid(separator + 1));
+        }
+    }
+
+    bool sizeOk = false;
+    qint64 size = fields.value("size").toLongLong(&sizeOk);
+    ObjectId content = ObjectId::fromHex(QString::fromLatin1(fields.value("content")));
+    if (!sizeOk || content.isNull()) {
+        return SmudgeResult::err("Malformed delta manifest");
+    }
+
+    ObjectId record;
+    if (data.startsWith(RecordManifestMagic)) {
+        record = ObjectId::fromHex(QString::fromLatin1(fields.value("record")));
+        if (record.isNull()) {
+            return SmudgeResult::err("Malformed delta manifest");
+        }
+    } else {
+        record = m_records.value(content);
+        if (record.isNull()) {
+            return SmudgeResult::err(QString("No record holds content %1").arg(content.toHex()));
+        }
+    }
+
+    auto versionResult = readVersion(record);
+    if (versionResult.isErr()) {
+        return versionResult;
+    }
+    if (versionResult.value().size() != size || contentHash(versionResult.value()) != content) {
+        return SmudgeResult::err(QString("Record %1 does not match its manifest").arg(record.toHex()));
+    }
+    return versionResult;
+}
+
+bool DeltaFile::isManifest(const QByteArray& data)
+{
+    return data.startsWith(ManifestMagic) || data.startsWith(RecordManifestMagic);
+}
+
+Result<QByteArray, QString> DeltaFile::readVersion(const ObjectId& record)
+{
+    using VersionResult = Result<QByteArray, QString>;
+
+    // Walk back to the full copy, then apply the deltas forward
+    QList<QByteArray> deltas;
+    ObjectId current = record;
+    while (true) {
+        if (deltas.size() > MaxChainDepth) {
+            return VersionResult::err(QString("Delta chain from %1 is too long").arg(record.toHex()));
+        }
+
+        auto recordResult = m_store.get(current);
+        if (recordResult.isErr()) {
+            return recordResult;
+        }
+        QByteArray bytes = recordResult.takeValue();
+
+        if (bytes.startsWith(FullRecord)) {
+            QByteArray version = bytes.mid(1);
+            for (auto it = deltas.crbegin(); it != deltas.crend(); ++it) {
+                auto applyResult = DeltaCodec::apply(version, *it);
+                if (applyResult.isErr()) {
+                    return applyResult;
+                }
+                version = applyResult.takeValue();
+            }
+            return VersionResult::ok(version);
+        }
+
+        if (!bytes.startsWith(DeltaRecord) || bytes.size() < 1 + ObjectId::Size) {
+            return VersionResult::err(QString("Malformed record %1").arg(current.toHex()));
+        }
+        current = ObjectId::fromBytes(QByteArrayView(bytes.constData() + 1, ObjectId::Size));
+        deltas.append(bytes.mid(1 + ObjectId::Size));
+    }
+}
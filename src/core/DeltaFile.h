@@ -0,0 +1,92 @@
+#ifndef DELTAFILE_H
+#define DELTAFILE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include "types/ObjectId.h"
+#include "types/Result.h"
+
+class ChunkStore;
+
+/**
+ * @brief Delta storage for save files rewritten in full on every save
+ *
+ * clean() stores each new version of a path as a DeltaCodec delta against
+ * the version stored before it, and git keeps a small manifest in place of
+ * the file; smudge() rebuilds the file by applying the chain of deltas.
+ * Chains are capped at MaxChainDepth, after which a full copy starts a new
+ * chain, so a restore never applies more than that many deltas. A version
+ * is also stored whole when its delta would save less than half its size.
+ *
+ * The manifest depends only on the content, so git status, diff and
+ * hash-object agree with the committed blob whatever was cleaned before,
+ * and cleaning content the store already holds changes nothing. An index
+ * next to the store maps each content hash to its record, and the newest
+ * record per path is kept as the next delta base. The index is an
+ * append-only log with one entry per stored version; it is never
+ * rewritten from a copy that failed to load, and a deleted index is
+ * rebuilt from the records in the store.
+ *
+ * Records in the ChunkStore are 'F' followed by the content, or 'D', the
+ * base record's ID and a delta.
+ *
+ * Manifest format:
+ *   vgvc-delta 2
+ *   size <file size>
+ *   content <hash of the file>
+ *
+ * Version 1 manifests also name their record ("record <hash>"), which
+ * smudge() still follows.
+ */
+class DeltaFile {
+public:
+    static constexpr int MaxChainDepth = 16;
+
+    explicit DeltaFile(ChunkStore& store);
+
+    /**
+     * @brief Read the content index and per-path heads
+     *
+     * A missing index is rebuilt from the store. A corrupt one, or one
+     * from a newer version, is an error and left untouched; clean()
+     * refuses to store anything until a load succeeds.
+     */
+    Result<void, QString> load();
+
+    /**
+     * @param path Only picks the delta base; never affects the manifest
+     */
+    Result<QByteArray, QString> clean(const QString& path, const QByteArray& data);
+
+    /**
+     * @brief Rebuild a file from its manifest
+     *
+     * Anything else, such as a save snapshotted before delta storage was
+     * enabled, is returned unchanged.
+     */
+    Result<QByteArray, QString> smudge(const QByteArray& data);
+
+    static bool isManifest(const QByteArray& data);
+
+private:
+    struct Head {
+        ObjectId record;
+        ObjectId content;
+        int depth;           // Deltas between the record and a full copy
+    };
+
+    ChunkStore& m_store;
+    QString m_headsPath;
+    QHash<QString, Head> m_heads;
+    QHash<ObjectId, ObjectId> m_records;   // Content hash to the record holding it
+    bool m_loaded;
+
+    Result<QByteArray, QString> readVersion(const ObjectId& record);
+    void addEntry(const QString& path, const Head& head);
+    Result<void, QString> rebuild();
+    Result<void, QString> writeIndex() const;
+    Result<void, QString> appendEntry(const QString& path, const Head& head) const;
+};
+
+#endif // DELTAFILE_H
@@ -0,0 +1,170 @@
+#include "FileHistoryIndex.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+
+constexpr quint32 IndexMagic = 0x56474648;  // "VGFH"
+constexpr quint32 IndexVersion = 1;
+
+} // namespace
+
+FileHistoryIndex::FileHistoryIndex(const QString& repoPath)
+    : m_filePath(QDir(repoPath).filePath(".git/vgvc/file-history.idx"))
+{
+}
+
+void FileHistoryIndex::clear()
+{
+    m_tips.clear();
+    m_snapshots.clear();
+    m_changes.clear();
+}
+
+Result<void, QString> FileHistoryIndex::load()
+{
+    clear();
+
+    QFile file(m_filePath);
+    if (!file.exists()) {
+        return Result<void, QString>::ok();  // Built on first update
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Result<void, QString>::err(QString("Cannot open %1").arg(m_filePath));
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != IndexMagic || version != IndexVersion) {
+        return Result<void, QString>::ok();  // Foreign or older format: rebuild
+    }
+
+    in >> m_tips;
+
+    qint32 snapshotCount = 0;
+    in >> snapshotCount;
+    m_snapshots.reserve(snapshotCount);
+    for (qint32 i = 0; i < snapshotCount && in.status() == QDataStream::Ok; ++i) {
+        SnapshotInfo info;
+        in >> info.id >> info.description >> info.timestamp;
+        m_snapshots.append(info);
+    }
+
+    qint32 pathCount = 0;
+    in >> pathCount;
+    m_changes.reserve(pathCount);
+    for (qint32 i = 0; i < pathCount && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        qint32 changeCount = 0;
+        in >> path >> changeCount;
+
+        QVector<Change>& changes = m_changes[path];
+        changes.reserve(changeCount);
+        for (qint32 j = 0; j < changeCount && in.status() == QDataStream::Ok; ++j) {
+            Change change;
+            in >> change.snapshot >> change.blobId;
+            changes.append(change);
+        }
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        clear();  // Truncated: rebuilt from the log on the next update
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<void, QString> FileHistoryIndex::save() const
+{
+    QDir().mkpath(QFileInfo(m_filePath).path());
+
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(m_filePath));
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << IndexMagic << IndexVersion << m_tips;
+
+    out << qint32(m_snapshots.size());
+    for (const SnapshotInfo& info : m_snapshots) {
+        out << info.id << info.description << info.timestamp;
+    }
+
+    out << qint32(m_changes.size());
+    for (auto it = m_changes.cbegin(); it != m_changes.cend(); ++it) {
+        out << it.key() << qint32(it.value().size());
+        for (const Change& change : it.value()) {
+            out << qint32(change.snapshot) << change.blobId;
+        }
+    }
+
+    if (!file.commit()) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(m_filePath));
+    }
+    return Result<void, QString>::ok();
+}
+
+void FileHistoryIndex::addSnapshot(const QString& snapshotId, const QString& description,
+                                   const QDateTime& timestamp, const QHash<QString, QString>& changes)
+{
+    int snapshot = m_snapshots.size();
+    m_snapshots.append({snapshotId, description, timestamp});
+
+    for (auto it = changes.cbegin(); it != changes.cend(); ++it) {
+        m_changes[it.key()].append({snapshot, it.value()});
+    }
+}
+
+QList<FileVersion> FileHistoryIndex::versions(const QString& path) const
+{
+    QList<FileVersion> result;
+    auto it = m_changes.constFind(path);
+    if (it == m_changes.constEnd()) {
+        return result;
+    }
+
+    result.reserve(it.value().size());
+    for (auto change = it.value().crbegin(); change != it.value().crend(); ++change) {
+        const SnapshotInfo& info = m_snapshots[change->snapshot];
+        FileVersion version;
+        version.snapshotId = info.id;
+        version.description = info.description;
+        version.timestamp = info.timestamp;
+        version.blobId = change->blobId;
+        result.append(version);
+    }
+    return result;
+}
+
+QStringList FileHistoryIndex::paths() const
+{
+    QStringList result = m_changes.keys();
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void FileHistoryIndex::forEachSnapshot(const std::function<void(const QString&, const QString&,
+                                                                const QDateTime&,
+                                                                const QStringList&)>& visit) const
+{
+    QVector<QStringList> changedPaths(m_snapshots.size());
+    for (auto it = m_changes.cbegin(); it != m_changes.cend(); ++it) {
+        for (const Change& change : it.value()) {
+            changedPaths[change.snapshot] << it.key();
+        }
+    }
+
+    for (int i = 0; i < m_snapshots.size(); ++i) {
+        const SnapshotInfo& info = m_snapshots[i];
+        visit(info.id, info.description, info.timestamp, changedPaths[i]);
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef FILEHISTORYINDEX_H
+#define FILEHISTORYINDEX_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+#include "types/Result.h"
+
+/**
+ * @brief One snapshot in which a file's content changed
+ */
+struct FileVersion {
+    QString snapshotId;
+    QString description;
+    QDateTime timestamp;
+    QString blobId;          // Content hash; empty if the snapshot deleted the file
+
+    bool isDeleted() const { return blobId.isEmpty(); }
+};
+
+/**
+ * @brief Inverted index from file path to the snapshots that changed it
+ *
+ * Lives in .git/vgvc so it travels with the repository and never shows up
+ * in snapshots. GitService extends it after every commit with only the
+ * new commits, so per-file history never walks the whole log. The index
+ * remembers the branch tips it has covered; anything reachable from the
+ * current tips but not from those is new.
+ */
+class FileHistoryIndex {
+public:
+    explicit FileHistoryIndex(const QString& repoPath);
+
+    /**
+     * @brief Read the index from disk; a missing file yields an empty index
+     */
+    Result<void, QString> load();
+    Result<void, QString> save() const;
+
+    void clear();
+
+    /**
+     * @brief Commits the index is complete up to
+     */
+    QStringList tips() const { return m_tips; }
+    void setTips(const QStringList& tips) { m_tips = tips; }
+
+    /**
+     * @brief Record a snapshot and the files it changed
+     * @param changes Path -> new content hash, empty for deletions
+     */
+    void addSnapshot(const QString& snapshotId, const QString& description,
+                     const QDateTime& timestamp, const QHash<QString, QString>& changes);
+
+    /**
+     * @brief Every version of a file, newest first
+     */
+    QList<FileVersion> versions(const QString& path) const;
+
+    /**
+     * @brief Every path that ever appeared in a snapshot, sorted
+     */
+    QStringList paths() const;
+
+    int snapshotCount() const { return m_snapshots.size(); }
+
+    /**
+     * @brief Visit every indexed snapshot, oldest first, with the paths it changed
+     */
+    void forEachSnapshot(const std::function<void(const QString& snapshotId, const QString& description,
+                                                  const QDateTime& timestamp,
+                                                  const QStringList& changedPaths)>& visit) const;
+
+private:
+    struct SnapshotInfo {
+        QString id;
+        QString description;
+        QDateTime timestamp;
+    };
+
+    struct Change {
+        int snapshot;        // Index into m_snapshots
+        QString blobId;
+    };
+
+    QString m_filePath;
+    QStringList m_tips;
+    QVector<SnapshotInfo> m_snapshots;       // Oldest first
+    QHash<QString, QVector<Change>> m_changes;  // Oldest first per path
+};
+
+#endif // FILEHISTORYINDEX_H
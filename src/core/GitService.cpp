@@ -1,14 +1,370 @@
 #include "GitService.h"
 #include <QProcess>
+#include <QCoreApplication>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QPromise>
+#include <QRegularExpression>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QtConcurrent>
+#include <QSet>
+#include <QUrl>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include "ChunkRemote.h"
+#include "CommitPipeline.h"
+#include "ContentChunker.h"
+#include "DeltaFile.h"
+#include "RegionFile.h"
+#include "utils/AdaptiveThrottle.h"
+#include "utils/ExecutionPolicy.h"
+#include "utils/FileScanner.h"
+#include "utils/FileUtils.h"
+#include "utils/Logger.h"
+#include "utils/PatternMatcher.h"
+#include "utils/Tracer.h"
+
+namespace {
+
+using ChangeBatch = Result<QList<FileChange>, QString>;
+
+constexpr int DiffBatchSize = 256;
+constexpr int DiffBatchIntervalMs = 50;
+
+constexpr qint64 HashReadSize = 1024 * 1024;
+constexpr int PathBatchSize = 200;   // Paths per git command line
+constexpr int MaxCaptureAttempts = 5;
+constexpr int CaptureRetryMs = 100;  // Doubles after every failed attempt
+constexpr int SnapshotsPerBatch = 8; // Per push; an interruption loses at most one batch, however large
+constexpr qint64 PendingChunkBytes = 64 * 1024 * 1024; // Chunks held for one existence query
+constexpr qint64 MaxManifestBytes = 1024 * 1024;        // Region manifests list up to 1024 chunks
+
+// Separators in the file history log format; neither occurs in hashes or subjects
+constexpr char CommitMarker = '\x01';
+constexpr char FieldSeparator = '\x02';
+
+/**
+ * @brief A file's git blob name, computed the way git does for raw content
+ * @return Empty if the file can't be read
+ */
+QByteArray hashBlob(const QString& filePath, qint64& bytesRead)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray("blob ") + QByteArray::number(file.size()) + '\0');
+    QByteArray buffer(HashReadSize, Qt::Uninitialized);
+    qint64 count = 0;
+    while ((count = file.read(buffer.data(), buffer.size())) > 0) {
+        hash.addData(QByteArrayView(buffer.constData(), count));
+        bytesRead += count;
+    }
+    if (count < 0) {
+        return QByteArray();
+    }
+    return hash.result().toHex();
+}
+
+/**
+ * @brief Read up to count bytes, waiting for git to produce them
+ * @return Fewer bytes only if git closed its output first
+ */
+QByteArray readFromProcess(QProcess& process, qint64 count)
+{
+    QByteArray data;
+    while (data.size() < count) {
+        if (process.bytesAvailable() == 0 && !process.waitForReadyRead(-1)) {
+            break;
+        }
+        data += process.read(count - data.size());
+    }
+    return data;
+}
+
+QByteArray readLineFromProcess(QProcess& process)
+{
+    while (!process.canReadLine()) {
+        if (!process.waitForReadyRead(-1)) {
+            break;
+        }
+    }
+    return process.readLine();
+}
+
+/**
+ * @brief Groups streamed changes into batches for a QPromise
+ * 
+ * Batches are published when full or when the oldest pending change has
+ * waited DiffBatchIntervalMs, so a slow diff still updates the UI.
+ */
+class ChangeBatcher {
+public:
+    ChangeBatcher(QPromise<ChangeBatch>& promise, bool reverse)
+        : m_promise(promise)
+        , m_reverse(reverse)
+        , m_count(0)
+    {
+    }
+    
+    /**
+     * @return false once the consumer has cancelled the diff
+     */
+    bool add(const FileChange& change)
+    {
+        if (m_batch.isEmpty()) {
+            m_batchTimer.start();
+        }
+        m_batch.append(m_reverse ? change.reversed() : change);
+        ++m_count;
+        
+        if (m_batch.size() >= DiffBatchSize || m_batchTimer.elapsed() >= DiffBatchIntervalMs) {
+            flush();
+        }
+        return !m_promise.isCanceled();
+    }
+    
+    void flush()
+    {
+        if (!m_batch.isEmpty()) {
+            m_promise.addResult(ChangeBatch::ok(m_batch));
+            m_batch.clear();
+        }
+    }
+    
+    int count() const { return m_count; }
+    
+private:
+    QPromise<ChangeBatch>& m_promise;
+    bool m_reverse;
+    int m_count;
+    QList<FileChange> m_batch;
+    QElapsedTimer m_batchTimer;
+};
+
+/**
+ * @brief The size of the file a region or delta manifest stands for
+ * @return -1 if the data isn't a manifest
+ */
+qint64 manifestFileSize(const QByteArray& data)
+{
+    if (!RegionFile::isManifest(data) && !DeltaFile::isManifest(data)) {
+        return -1;
+    }
+    int start = data.indexOf("\nsize ");
+    if (start < 0) {
+        return -1;
+    }
+    start += 6;
+    int end = data.indexOf('\n', start);
+    bool ok = false;
+    qint64 size = data.mid(start, end < 0 ? -1 : end - start).toLongLong(&ok);
+    return ok ? size : -1;
+}
+
+/**
+ * @brief Whether the program a configured filter command starts is installed
+ * 
+ * Commands are either a quoted absolute path or a bare name found on PATH.
+ */
+bool filterProgramExists(const QString& command)
+{
+    QString program;
+    if (command.startsWith('"')) {
+        int closingQuote = command.indexOf('"', 1);
+        if (closingQuote < 0) {
+            return false;
+        }
+        program = command.mid(1, closingQuote - 1);
+    } else {
+        program = command.section(' ', 0, 0);
+    }
+    
+    if (program.isEmpty()) {
+        return false;
+    }
+    if (QDir::isAbsolutePath(program)) {
+        return QFileInfo(program).isExecutable();
+    }
+    return !QStandardPaths::findExecutable(program).isEmpty();
+}
+
+} // namespace
 
 GitService::GitService(const QString& repoPath, QObject* parent)
     : QObject(parent)
     , m_repoPath(repoPath)
     , m_gitExecutable(findGitExecutable())
+    , m_executionClass(ExecutionClass::Foreground)
+    , m_commitPipelineEnabled(true)
+    , m_storageFiltersConfigured(false)
+    , m_fileHistory(repoPath)
+    , m_fileHistoryLoaded(false)
+{
+}
+
+void GitService::setTrackedPaths(const QStringList& trackedPaths)
+{
+    m_trackedScope = TrackedScope(trackedPaths);
+}
+
+void GitService::setExecutionClass(ExecutionClass executionClass)
+{
+    m_executionClass = executionClass;
+}
+
+void GitService::setCommitPipelineEnabled(bool enabled)
+{
+    m_commitPipelineEnabled = enabled;
+}
+
+void GitService::setRegionFiles(const QStringList& patterns)
+{
+    m_regionFiles = patterns;
+    m_storageFiltersConfigured = false;
+}
+
+void GitService::setDeltaFiles(const QStringList& patterns)
+{
+    m_deltaFiles = patterns;
+    m_storageFiltersConfigured = false;
+}
+
+Result<void, QString> GitService::configureStorageFilters()
 {
+    if (m_storageFiltersConfigured) {
+        return Result<void, QString>::ok();
+    }
+    
+    // .git/info/attributes is never snapshotted. Patterns of earlier
+    // presets stay, because snapshots stored as manifests need the filter
+    // to restore; each pattern keeps one line, for the driver set last.
+    QString attributesPath = QDir(m_repoPath).filePath(".git/info/attributes");
+    QByteArray existing;
+    QStringList otherLines;
+    QStringList patterns;
+    QHash<QString, QString> drivers;
+    QFile attributes(attributesPath);
+    if (attributes.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        existing = attributes.readAll();
+        const QStringList lines = QString::fromUtf8(existing).split('\n', Qt::SkipEmptyParts);
+        for (const QString& line : lines) {
+            int driverStart = line.indexOf(" filter=vgvc-");
+            if (driverStart < 0) {
+                otherLines << line;
+                continue;
+            }
+            QString pattern = line.left(driverStart);
+            if (!drivers.contains(pattern)) {
+                patterns << pattern;
+            }
+            drivers.insert(pattern, line.mid(driverStart + 8).section(' ', 0, 0));
+        }
+    }
+    
+    if (m_regionFiles.isEmpty() && m_deltaFiles.isEmpty() && drivers.isEmpty()) {
+        m_storageFiltersConfigured = true;
+        return Result<void, QString>::ok();
+    }
+    
+    // Prefer vgvc-cli on PATH: the command then survives the app moving or
+    // being reinstalled elsewhere. Otherwise use the copy next to this binary.
+    QString cliProgram;
+    if (!QStandardPaths::findExecutable("vgvc-cli").isEmpty()) {
+        cliProgram = "vgvc-cli";
+    } else {
+#ifdef Q_OS_WIN
+        QString cliPath = QDir(QCoreApplication::applicationDirPath()).filePath("vgvc-cli.exe");
+#else
+        QString cliPath = QDir(QCoreApplication::applicationDirPath()).filePath("vgvc-cli");
+#endif
+        if (QFileInfo::exists(cliPath)) {
+            cliProgram = QString("\"%1\"").arg(QDir::fromNativeSeparators(cliPath));
+        }
+    }
+    
+    // Required: a failing filter must fail the snapshot, never store the raw file
+    struct StorageFilter {
+        QString driver;
+        QString command;
+        QStringList patterns;
+    };
+    const StorageFilter filters[] = {
+        {"vgvc-region", "region-filter", m_regionFiles},
+        {"vgvc-delta", "delta-filter", m_deltaFiles}
+    };
+    
+    for (const StorageFilter& filter : filters) {
+        bool inUse = std::find(drivers.cbegin(), drivers.cend(), filter.driver) != drivers.cend();
+        if (filter.patterns.isEmpty() && !inUse) {
+            continue;
+        }
+        
+        // A command that still works is left alone, so the GUI, daemon and
+        // bench (each in its own directory) don't keep re-pointing it
+        QString processKey = QString("filter.%1.process").arg(filter.driver);
+        auto currentResult = executeGitCommand({"config", "--get", processKey});
+        QString currentCommand = currentResult.isOk() ? currentResult.value().trimmed() : QString();
+        bool currentWorks = currentCommand.endsWith(" " + filter.command)
+            && filterProgramExists(currentCommand);
+        if (!currentWorks) {
+            if (cliProgram.isEmpty()) {
+                // With its lines in place, every checkout, add and diff of
+                // those files would fail on the required filter
+                if (inUse) {
+                    return Result<void, QString>::err(
+                        QString("vgvc-cli not found; it is needed to read the %1 files in this "
+                                "project's snapshots. Reinstall VGVC or put vgvc-cli on PATH.")
+                            .arg(filter.driver));
+                }
+                Logger::warning(QString("vgvc-cli not found; %1 files are stored whole").arg(filter.driver),
+                                "GitService");
+                continue;
+            }
+            QString filterCommand = QString("%1 %2").arg(cliProgram, filter.command);
+            auto processResult = executeGitCommand({"config", processKey, filterCommand});
+            if (processResult.isErr()) {
+                return Result<void, QString>::err(processResult.error());
+            }
+            auto requiredResult = executeGitCommand(
+                {"config", QString("filter.%1.required").arg(filter.driver), "true"});
+            if (requiredResult.isErr()) {
+                return Result<void, QString>::err(requiredResult.error());
+            }
+        }
+        
+        for (const QString& pattern : filter.patterns) {
+            if (!drivers.contains(pattern)) {
+                patterns << pattern;
+            }
+            drivers.insert(pattern, filter.driver);
+        }
+    }
+    
+    QStringList lines = otherLines;
+    for (const QString& pattern : patterns) {
+        lines << QString("%1 filter=%2 -diff").arg(pattern, drivers.value(pattern));
+    }
+    QByteArray content = lines.isEmpty() ? QByteArray() : (lines.join('\n') + '\n').toUtf8();
+    if (content != existing) {
+        QDir().mkpath(QFileInfo(attributesPath).path());
+        QSaveFile file(attributesPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)
+            || file.write(content) != content.size()
+            || !file.commit()) {
+            return Result<void, QString>::err(QString("Cannot write %1").arg(attributesPath));
+        }
+    }
+    
+    m_storageFiltersConfigured = true;
+    return Result<void, QString>::ok();
 }
 
 QString GitService::findGitExecutable()
@@ -36,23 +392,53 @@ QString GitService::findGitExecutable()
     return "git";  // Fallback, might not work
 }
 
-Result<QString, QString> GitService::executeGitCommand(const QStringList& args)
+Result<QString, QString> GitService::executeGitCommand(const QStringList& args, int timeoutMs)
 {
+    // The hottest path: build span text only when tracing is on
+    const bool tracing = Tracer::isEnabled();
+    TraceSpan span("git", tracing ? QString("git %1").arg(args.value(0)) : QString());
+    if (tracing) {
+        span.setArg("args", args.join(' '));
+    }
+    
     QProcess process;
+    if (!startGitProcess(process, args)) {
+        return Result<QString, QString>::err("Failed to start git process");
+    }
+    return finishGitProcess(process, timeoutMs, span);
+}
+
+bool GitService::startGitProcess(QProcess& process, const QStringList& args)
+{
     process.setWorkingDirectory(m_repoPath);
     process.setProgram(m_gitExecutable);
-    process.setArguments(args);
+    process.setArguments(ExecutionPolicy::gitConfigArgs(m_executionClass) + args);
+    ExecutionPolicy::configureProcess(process, m_executionClass);
     
     process.start();
-    if (!process.waitForStarted(5000)) {
-        return Result<QString, QString>::err("Failed to start git process");
+    return process.waitForStarted(5000);
+}
+
+Result<QString, QString> GitService::finishGitProcess(QProcess& process, int timeoutMs, TraceSpan& span)
+{
+    bool finished = false;
+    if (m_executionClass == ExecutionClass::Background) {
+        // Paused time while the game needs the disk doesn't count
+        AdaptiveThrottle throttle(m_repoPath);
+        finished = throttle.waitForProcess(process, timeoutMs);
+        span.setArg("throttledMs", throttle.throttledMs());
+    } else {
+        finished = process.waitForFinished(timeoutMs);
     }
     
-    if (!process.waitForFinished(30000)) {  // 30 second timeout
+    if (!finished) {
         process.kill();
         return Result<QString, QString>::err("Git operation timed out");
     }
     
+    if (Tracer::isEnabled()) {
+        span.setArg("exitCode", process.exitCode());
+    }
     if (process.exitCode() != 0) {
         QString error = process.readAllStandardError();
         return Result<QString, QString>::err(QString("Git error: %1").arg(error));
@@ -64,7 +450,12 @@ Result<QString, QString> GitService::executeGitCommand(const QStringList& args)
 
 QFuture<Result<void, QString>> GitService::init()
 {
-    return QtConcurrent::run([this]() -> Result<void, QString> {
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, queuedAt]() -> Result<void, QString> {
+        Tracer::recordQueueWait("GitService::init", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::init");
+        
         // Initialize git repository
         auto initResult = executeGitCommand({"init", "-b", "main"});
         if (initResult.isErr()) {
@@ -89,95 +480,392 @@ QFuture<Result<void, QString>> GitService::init()
 
 QFuture<Result<void, QString>> GitService::commit(const QString& message)
 {
-    return QtConcurrent::run([this, message]() -> Result<void, QString> {
-        // Add all files
-        auto addResult = executeGitCommand({"add", "."});
+    TrackedScope scope = m_trackedScope;
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, message, scope, queuedAt]() -> Result<void, QString> {
+        Tracer::recordQueueWait("GitService::commit", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::commit");
+        
+        auto filterResult = configureStorageFilters();
+        if (filterResult.isErr()) {
+            return Result<void, QString>::err(filterResult.error());
+        }
+        
+        auto pathspecResult = trackedPathspecs(scope);
+        if (pathspecResult.isErr()) {
+            return Result<void, QString>::err(pathspecResult.error());
+        }
+        
+        const QStringList& pathspecs = pathspecResult.value();
+        if (pathspecs.isEmpty()) {
+            return Result<void, QString>::err("No tracked files matched the preset");
+        }
+        
+        // After a restore HEAD is detached at the restored snapshot. The new
+        // snapshot goes on main, on top of the latest one, with the working
+        // tree exactly as it is
+        if (executeGitCommand({"symbolic-ref", "-q", "HEAD"}).isErr()) {
+            auto attachResult = executeGitCommand({"symbolic-ref", "HEAD", "refs/heads/main"});
+            if (attachResult.isErr()) {
+                return Result<void, QString>::err(attachResult.error());
+            }
+        }
+        
+        // Store changed files' objects with the disk and every core busy at
+        // once; git add then finds them present and only builds the index.
+        // Its threads don't pause for a congested disk, so background
+        // snapshots leave everything to git, which does
+        if (m_commitPipelineEnabled && m_executionClass != ExecutionClass::Background) {
+            CommitPipeline pipeline(m_repoPath, m_executionClass);
+            pipeline.setTrackedScope(scope);
+            pipeline.setFilteredFiles(PatternMatcher(m_regionFiles + m_deltaFiles));
+            QFileInfo index(QDir(m_repoPath).filePath(".git/index"));
+            auto baselineResult = treeListing("HEAD");
+            if (baselineResult.isOk() && index.exists()) {
+                pipeline.setBaseline(baselineResult.value(), index.lastModified().toMSecsSinceEpoch());
+            }
+            
+            auto pipelineResult = pipeline.run();
+            if (pipelineResult.isErr()) {
+                Logger::warning(QString("Commit pipeline stopped; git add stores the rest: %1")
+                                    .arg(pipelineResult.error()), "GitService");
+            } else {
+                Logger::debug(pipelineResult.value().summary(), "GitService");
+            }
+        }
+        
+        // Add tracked files (all files when no preset restricts the scope)
+        auto addResult = executeGitCommand(QStringList() << "add" << "-A" << "--" << pathspecs);
         if (addResult.isErr()) {
             return Result<void, QString>::err(addResult.error());
         }
         
+        // The game may be saving while we read; recapture files that moved
+        auto captureResult = captureHotFiles(pathspecs);
+        if (captureResult.isErr()) {
+            return Result<void, QString>::err(captureResult.error());
+        }
+        
         // Commit
         auto commitResult = executeGitCommand({"commit", "-m", message});
         if (commitResult.isErr()) {
             return Result<void, QString>::err(commitResult.error());
         }
         
+        // The snapshot exists either way; a stale index catches up next time
+        auto indexResult = updateFileHistory();
+        if (indexResult.isErr()) {
+            Logger::warning(QString("File history index not updated: %1").arg(indexResult.error()),
+                            "GitService");
+        }
+        
         return Result<void, QString>::ok();
     });
 }
 
-QFuture<Result<QList<Snapshot>, QString>> GitService::getHistory(int limit)
+Result<void, QString> GitService::captureHotFiles(const QStringList& pathspecs)
 {
-    return QtConcurrent::run([this, limit]() -> Result<QList<Snapshot>, QString> {
-        // Ensure we're on main branch
-        auto checkoutResult = executeGitCommand({"checkout", "main"});
-        if (checkoutResult.isErr()) {
-            return Result<QList<Snapshot>, QString>::err(checkoutResult.error());
+    // git add recorded each file's stat from before it read the file; any
+    // file whose stat no longer matches changed during or after the read
+    auto diffResult = executeGitCommand(QStringList() << "diff-files" << "--name-only" << "-z" << "--" << pathspecs);
+    if (diffResult.isErr()) {
+        return Result<void, QString>::err(diffResult.error());
+    }
+    const QStringList hotPaths = diffResult.value().split(QChar('\0'), Qt::SkipEmptyParts);
+    if (hotPaths.isEmpty()) {
+        return Result<void, QString>::ok();
+    }
+    
+    TraceSpan span("git", "Capture hot files");
+    span.setArg("files", hotPaths.size());
+    
+    // Staged modes, so recaptured entries keep their executable bit
+    QHash<QString, QString> modes;
+    for (int start = 0; start < hotPaths.size(); start += PathBatchSize) {
+        QStringList args{"ls-files", "-s", "-z", "--"};
+        for (const QString& path : hotPaths.mid(start, PathBatchSize)) {
+            args << ":(literal)" + path;
+        }
+        auto lsResult = executeGitCommand(args);
+        if (lsResult.isErr()) {
+            return Result<void, QString>::err(lsResult.error());
+        }
+        for (const QString& record : lsResult.value().split(QChar('\0'), Qt::SkipEmptyParts)) {
+            // <mode> SP <object> SP <stage> TAB <path>
+            int tab = record.indexOf('\t');
+            if (tab > 0) {
+                modes.insert(record.mid(tab + 1), record.section(' ', 0, 0));
+            }
+        }
+    }
+    
+    // Same file system as the game directory, so clones are possible
+    QDir repoDir(m_repoPath);
+    QString stagingPath = repoDir.filePath(".git/vgvc/staging");
+    QDir().mkpath(stagingPath);
+    QString stagingFile = QDir(stagingPath).filePath("capture");
+    
+    int cloned = 0;
+    for (const QString& path : hotPaths) {
+        QString source = repoDir.filePath(path);
+        if (!QFileInfo::exists(source)) {
+            // Deleted mid-snapshot: record the deletion like git add would
+            auto removeResult = executeGitCommand({"add", "-A", "--", ":(literal)" + path});
+            if (removeResult.isErr()) {
+                return Result<void, QString>::err(removeResult.error());
+            }
+            continue;
         }
         
-        // Format: hash|author|timestamp|subject
-        auto result = executeGitCommand({
-            "log",
-            "--pretty=format:%H|%an|%at|%s",
-            QString("-n%1").arg(limit)
-        });
-        
-        if (result.isErr()) {
-            return Result<QList<Snapshot>, QString>::err(result.error());
+        // A copy is stable if the source didn't change while it was taken
+        auto copyResult = FileUtils::copyStable(source, stagingFile, MaxCaptureAttempts, CaptureRetryMs);
+        if (copyResult.isErr()) {
+            Logger::warning(QString("%1 kept changing; the snapshot may hold a partial save").arg(path),
+                            "GitService");
+            continue;
+        }
+        if (copyResult.value()) {
+            ++cloned;
         }
         
-        QList<Snapshot> snapshots;
-        QStringList lines = result.value().split('\n', Qt::SkipEmptyParts);
+        // --path applies the file's attributes (region/delta filters) to the copy
+        auto hashResult = executeGitCommand({"hash-object", "-w", "--path=" + path, stagingFile});
+        if (hashResult.isErr()) {
+            return Result<void, QString>::err(hashResult.error());
+        }
         
-        for (int i = 0; i < lines.size(); ++i) {
-            const QString& line = lines[i];
-            
-            // Skip the very last commit (oldest/initial commit from init)
-            if (i == lines.size() - 1 && lines.size() > 1) {
-                continue;
-            }
-            
-            auto snapshotResult = parseCommitLog(line);
-            if (snapshotResult.isOk()) {
-                snapshots.append(snapshotResult.value());
+        QString mode = modes.value(path, QFileInfo(source).isExecutable() ? "100755" : "100644");
+        auto updateResult = executeGitCommand({"update-index", "--add", "--cacheinfo",
+                                               QString("%1,%2,%3").arg(mode, hashResult.value().trimmed(), path)});
+        if (updateResult.isErr()) {
+            return Result<void, QString>::err(updateResult.error());
+        }
+    }
+    
+    QFile::remove(stagingFile);
+    span.setArg("cloned", cloned);
+    return Result<void, QString>::ok();
+}
+
+Result<QStringList, QString> GitService::trackedPathspecs(const TrackedScope& scope)
+{
+    if (scope.isEmpty()) {
+        return Result<QStringList, QString>::ok(QStringList() << ".");
+    }
+    
+    // Topmost tracked entries on disk; untracked folders are never entered
+    TraceSpan scanSpan("scan", "Tracked path scan");
+    FileScanner scanner(m_repoPath);
+    scanner.setTrackedScope(scope);
+    // Only background scans are paced; the throttle stats the disk on creation
+    std::unique_ptr<AdaptiveThrottle> throttle;
+    if (m_executionClass == ExecutionClass::Background) {
+        throttle = std::make_unique<AdaptiveThrottle>(m_repoPath);
+        scanner.setThrottle(throttle.get());
+    }
+    QStringList roots = scanner.trackedRoots();
+    scanSpan.setArg("roots", roots.size());
+    scanSpan.finish();
+    QSet<QString> seen(roots.begin(), roots.end());
+    
+    // Tracked files deleted since the last snapshot only exist in the index.
+    // ls-files reads the index, not the working tree.
+    QStringList lsArgs = {"ls-files", "-z", "--"};
+    for (const QString& literal : scope.literalPaths()) {
+        lsArgs << ":(literal)" + literal;
+    }
+    for (QString glob : scope.globs()) {
+        while (glob.endsWith('/')) {
+            glob.chop(1);
+        }
+        lsArgs << ":(glob)" + glob << ":(glob)" + glob + "/**";
+    }
+    
+    auto lsResult = executeGitCommand(lsArgs);
+    if (lsResult.isErr()) {
+        return Result<QStringList, QString>::err(lsResult.error());
+    }
+    
+    const QStringList indexedPaths = lsResult.value().split(QChar('\0'), Qt::SkipEmptyParts);
+    for (const QString& path : indexedPaths) {
+        QString root = path;
+        int separator = path.indexOf('/');
+        while (separator >= 0) {
+            if (scope.matchesEntry(path.left(separator), true)) {
+                root = path.left(separator);
+                break;
             }
+            separator = path.indexOf('/', separator + 1);
+        }
+        if (!seen.contains(root)) {
+            seen.insert(root);
+            roots << root;
+        }
+    }
+    
+    QStringList pathspecs;
+    for (const QString& root : roots) {
+        pathspecs << ":(literal)" + root;
+    }
+    return Result<QStringList, QString>::ok(pathspecs);
+}
+
+QFuture<Result<QList<Snapshot>, QString>> GitService::getHistory(int limit)
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, limit, queuedAt]() -> Result<QList<Snapshot>, QString> {
+        Tracer::recordQueueWait("GitService::getHistory", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::getHistory");
+        
+        auto result = readHistory(limit);
+        if (result.isErr()) {
+            return Result<QList<Snapshot>, QString>::err(result.error());
         }
+        return Result<QList<Snapshot>, QString>::ok(result.value()->toList());
+    });
+}
+
+QFuture<Result<SnapshotTablePtr, QString>> GitService::getHistoryTable(int limit)
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, limit, queuedAt]() -> Result<SnapshotTablePtr, QString> {
+        Tracer::recordQueueWait("GitService::getHistoryTable", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::getHistoryTable");
         
-        return Result<QList<Snapshot>, QString>::ok(snapshots);
+        return readHistory(limit);
     });
 }
 
-Result<Snapshot, QString> GitService::parseCommitLog(const QString& logLine)
+Result<SnapshotTablePtr, QString> GitService::readHistory(int limit)
 {
-    QStringList parts = logLine.split('|');
-    if (parts.size() < 4) {
-        return Result<Snapshot, QString>::err("Invalid log format");
+    // The snapshot branch, whatever is checked out: a restore leaves HEAD
+    // on an older snapshot, and listing must never touch the working tree
+    // Format: hash|author|timestamp|subject
+    auto result = executeGitCommand({
+        "log",
+        "--pretty=format:%H|%an|%at|%s",
+        QString("-n%1").arg(limit),
+        "main",
+        "--"
+    });
+    
+    if (result.isErr()) {
+        return Result<SnapshotTablePtr, QString>::err(result.error());
+    }
+    
+    const QString& output = result.value();
+    const QList<QStringView> lines = QStringView(output).split('\n', Qt::SkipEmptyParts);
+    
+    SnapshotTable table;
+    table.reserve(lines.size());
+    for (int i = 0; i < lines.size(); ++i) {
+        // Skip the very last commit (oldest/initial commit from init)
+        if (i == lines.size() - 1 && lines.size() > 1) {
+            continue;
+        }
+        
+        // Fields are sliced in place; only the arena copies the text
+        QStringView line = lines[i];
+        qsizetype authorStart = line.indexOf('|') + 1;
+        qsizetype timeStart = line.indexOf('|', authorStart) + 1;
+        qsizetype subjectStart = line.indexOf('|', timeStart) + 1;
+        if (authorStart <= 0 || timeStart <= 0 || subjectStart <= 0) {
+            continue;  // Invalid log format
+        }
+        
+        ObjectId id = ObjectId::fromHex(line.first(authorStart - 1));
+        if (id.isNull()) {
+            continue;
+        }
+        table.append(id,
+                     line.mid(timeStart, subjectStart - timeStart - 1).toLongLong(),
+                     line.mid(subjectStart).toString(),
+                     line.mid(authorStart, timeStart - authorStart - 1).toString());
     }
     
-    Snapshot snapshot;
-    snapshot.id = parts[0];
-    snapshot.author = parts[1];
-    snapshot.timestamp = QDateTime::fromSecsSinceEpoch(parts[2].toLongLong());
-    snapshot.description = parts[3];
-    snapshot.isAutomatic = snapshot.description.startsWith("[AUTO]");
+    // Catches the search index up with snapshots taken by another process, e.g. vgvcd
+    auto indexResult = updateFileHistory();
+    if (indexResult.isErr()) {
+        Logger::warning(QString("File history index not updated: %1").arg(indexResult.error()),
+                        "GitService");
+    }
     
-    return Result<Snapshot, QString>::ok(snapshot);
+    return Result<SnapshotTablePtr, QString>::ok(SnapshotTable::share(std::move(table)));
 }
 
 QFuture<Result<void, QString>> GitService::checkout(const QString& commitHash)
 {
-    return QtConcurrent::run([this, commitHash]() -> Result<void, QString> {
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, commitHash, queuedAt]() -> Result<void, QString> {
+        Tracer::recordQueueWait("GitService::checkout", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::checkout");
+        
+        auto filterResult = configureStorageFilters();
+        if (filterResult.isErr()) {
+            return Result<void, QString>::err(filterResult.error());
+        }
+        
         auto result = executeGitCommand({"checkout", commitHash});
         if (result.isErr()) {
             return Result<void, QString>::err(result.error());
         }
+        
+        // The restore happened either way; only verification needs the record.
+        // A record left by an earlier restore would verify the wrong snapshot.
+        auto recordResult = recordRestore(commitHash);
+        if (recordResult.isErr()) {
+            Logger::warning(QString("Restore not recorded for verification: %1").arg(recordResult.error()),
+                            "GitService");
+            RestoreManifest(m_repoPath).remove();
+        }
+        return Result<void, QString>::ok();
+    });
+}
+
+QFuture<Result<void, QString>> GitService::archive(const QString& commitHash, const QString& outputPath)
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, commitHash, outputPath, queuedAt]() -> Result<void, QString> {
+        Tracer::recordQueueWait("GitService::archive", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::archive");
+        
+        auto result = executeGitCommand({"archive", "-o", outputPath, commitHash});
+        if (result.isErr()) {
+            return Result<void, QString>::err(result.error());
+        }
+        return Result<void, QString>::ok();
+    });
+}
+
+QFuture<Result<void, QString>> GitService::maintenance()
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, queuedAt]() -> Result<void, QString> {
+        Tracer::recordQueueWait("GitService::maintenance", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::maintenance");
+        
+        auto result = executeGitCommand({"gc", "--auto", "--quiet"});
+        if (result.isErr()) {
+            return Result<void, QString>::err(result.error());
+        }
         return Result<void, QString>::ok();
     });
 }
 
 QFuture<Result<qint64, QString>> GitService::getRepoSize()
 {
-    return QtConcurrent::run([this]() -> Result<qint64, QString> {
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, queuedAt]() -> Result<qint64, QString> {
+        Tracer::recordQueueWait("GitService::getRepoSize", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::getRepoSize");
+        
         auto result = executeGitCommand({"count-objects", "-v"});
         if (result.isErr()) {
             return Result<qint64, QString>::err(result.error());
@@ -191,8 +879,23 @@ QFuture<Result<qint64, QString>> GitService::getRepoSize()
 
 QFuture<Result<bool, QString>> GitService::hasChanges()
 {
-    return QtConcurrent::run([this]() -> Result<bool, QString> {
-        auto result = executeGitCommand({"status", "--porcelain"});
+    TrackedScope scope = m_trackedScope;
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, scope, queuedAt]() -> Result<bool, QString> {
+        Tracer::recordQueueWait("GitService::hasChanges", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::hasChanges");
+        
+        auto pathspecResult = trackedPathspecs(scope);
+        if (pathspecResult.isErr()) {
+            return Result<bool, QString>::err(pathspecResult.error());
+        }
+        if (pathspecResult.value().isEmpty()) {
+            return Result<bool, QString>::ok(false);
+        }
+        
+        auto result = executeGitCommand(
+            QStringList() << "status" << "--porcelain" << "--" << pathspecResult.value());
         if (result.isErr()) {
             return Result<bool, QString>::err(result.error());
         }
@@ -201,3 +904,1088 @@ QFuture<Result<bool, QString>> GitService::hasChanges()
         return Result<bool, QString>::ok(hasChanges);
     });
 }
+
+QFuture<Result<QList<FileChange>, QString>> GitService::diff(const QString& fromCommit,
+                                                             const QString& toCommit)
+{
+    TrackedScope scope = m_trackedScope;
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass),
+        [this, fromCommit, toCommit, scope, queuedAt](QPromise<ChangeBatch>& promise) {
+        Tracer::recordQueueWait("GitService::diff", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::diff");
+        
+        if (fromCommit.isEmpty() && toCommit.isEmpty()) {
+            promise.addResult(ChangeBatch::err("Cannot compare the working tree with itself"));
+            return;
+        }
+        
+        // The working tree is always diffed as the newer side; a working
+        // tree "from" side is the same diff read backwards
+        ChangeBatcher batcher(promise, fromCommit.isEmpty());
+        auto emitChange = [&batcher](const FileChange& change) { return batcher.add(change); };
+        
+        Result<void, QString> result = Result<void, QString>::ok();
+        if (fromCommit.isEmpty() || toCommit.isEmpty()) {
+            result = diffWorkingTree(fromCommit.isEmpty() ? toCommit : fromCommit, scope, emitChange);
+        } else {
+            result = diffCommits(fromCommit, toCommit, emitChange);
+        }
+        
+        batcher.flush();
+        span.setArg("files", batcher.count());
+        if (result.isErr()) {
+            promise.addResult(ChangeBatch::err(result.error()));
+        }
+    });
+}
+
+Result<void, QString> GitService::diffCommits(const QString& fromCommit, const QString& toCommit,
+                                              const std::function<bool(const FileChange&)>& emitChange)
+{
+    auto fromResult = treeListing(fromCommit);
+    if (fromResult.isErr()) {
+        return Result<void, QString>::err(fromResult.error());
+    }
+    auto toResult = treeListing(toCommit);
+    if (toResult.isErr()) {
+        return Result<void, QString>::err(toResult.error());
+    }
+    
+    // Both listings are sorted by path: a single merge pass finds every change
+    const TreeListing& from = *fromResult.value();
+    const TreeListing& to = *toResult.value();
+    int i = 0;
+    int j = 0;
+    while (i < from.size() || j < to.size()) {
+        FileChange change;
+        if (j >= to.size() || (i < from.size() && from[i].path < to[j].path)) {
+            change.path = from[i].path;
+            change.kind = FileChange::Kind::Deleted;
+            change.oldSize = from[i].size;
+            ++i;
+        } else if (i >= from.size() || to[j].path < from[i].path) {
+            change.path = to[j].path;
+            change.kind = FileChange::Kind::Added;
+            change.newSize = to[j].size;
+            ++j;
+        } else {
+            bool same = from[i].blobId == to[j].blobId;
+            change.path = to[j].path;
+            change.kind = FileChange::Kind::Modified;
+            change.oldSize = from[i].size;
+            change.newSize = to[j].size;
+            ++i;
+            ++j;
+            if (same) {
+                continue;
+            }
+        }
+        
+        if (!emitChange(change)) {
+            break;
+        }
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<void, QString> GitService::diffWorkingTree(const QString& commit, const TrackedScope& scope,
+                                                  const std::function<bool(const FileChange&)>& emitChange)
+{
+    auto listingResult = treeListing(commit);
+    if (listingResult.isErr()) {
+        return Result<void, QString>::err(listingResult.error());
+    }
+    const TreeListing& listing = *listingResult.value();
+    
+    auto pathspecResult = trackedPathspecs(scope);
+    if (pathspecResult.isErr()) {
+        return Result<void, QString>::err(pathspecResult.error());
+    }
+    const QStringList& pathspecs = pathspecResult.value();
+    
+    // Nothing tracked is left on disk or in the index
+    if (pathspecs.isEmpty()) {
+        for (const TreeEntry& entry : listing) {
+            FileChange change;
+            change.path = entry.path;
+            change.kind = FileChange::Kind::Deleted;
+            change.oldSize = entry.size;
+            if (!emitChange(change)) {
+                break;
+            }
+        }
+        return Result<void, QString>::ok();
+    }
+    
+    QDir repoDir(m_repoPath);
+    
+    // Raw output skips content diffs: git only compares hashes and stat data
+    auto diffResult = executeGitCommand(
+        QStringList() << "diff" << "--raw" << "-z" << "--no-renames" << "--ignore-submodules"
+                      << commit << "--" << pathspecs);
+    if (diffResult.isErr()) {
+        return Result<void, QString>::err(diffResult.error());
+    }
+    
+    const QStringList fields = diffResult.value().split(QChar('\0'));
+    for (int i = 0; i + 1 < fields.size(); i += 2) {
+        // :<old mode> <new mode> <old id> <new id> <status>, then the path
+        const QString& header = fields[i];
+        if (!header.startsWith(':')) {
+            break;
+        }
+        
+        FileChange change;
+        change.path = fields[i + 1];
+        const TreeEntry* old = TreeCache::lookup(listing, change.path);
+        change.oldSize = old ? old->size : 0;
+        
+        if (header.endsWith('D')) {
+            change.kind = FileChange::Kind::Deleted;
+        } else {
+            change.kind = old ? FileChange::Kind::Modified : FileChange::Kind::Added;
+            change.newSize = QFileInfo(repoDir.filePath(change.path)).size();
+        }
+        
+        if (!emitChange(change)) {
+            return Result<void, QString>::ok();
+        }
+    }
+    
+    // Files never added to the index; the next snapshot will pick them up
+    auto untrackedResult = executeGitCommand(
+        QStringList() << "ls-files" << "-z" << "--others" << "--exclude-standard"
+                      << "--" << pathspecs);
+    if (untrackedResult.isErr()) {
+        return Result<void, QString>::err(untrackedResult.error());
+    }
+    
+    const QStringList untracked = untrackedResult.value().split(QChar('\0'), Qt::SkipEmptyParts);
+    for (const QString& path : untracked) {
+        FileChange change;
+        change.path = path;
+        change.kind = FileChange::Kind::Added;
+        change.newSize = QFileInfo(repoDir.filePath(path)).size();
+        if (!emitChange(change)) {
+            break;
+        }
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<QSharedPointer<const TreeListing>, QString> GitService::treeListing(const QString& commit)
+{
+    // Snapshot IDs are full hashes already; anything else is resolved so
+    // the cache key names the commit, not a moving ref
+    static const QRegularExpression fullHash("^[0-9a-f]{40}([0-9a-f]{24})?$");
+    QString commitHash = commit;
+    if (!fullHash.match(commitHash).hasMatch()) {
+        auto revResult = executeGitCommand({"rev-parse", "--verify", "--quiet", commit + "^{commit}"});
+        if (revResult.isErr()) {
+            return Result<QSharedPointer<const TreeListing>, QString>::err(
+                QString("Unknown snapshot: %1").arg(commit));
+        }
+        commitHash = revResult.value().trimmed();
+    }
+    
+    QSharedPointer<const TreeListing> cached = m_treeCache.find(commitHash);
+    if (cached) {
+        return Result<QSharedPointer<const TreeListing>, QString>::ok(cached);
+    }
+    
+    TraceSpan span("git", "Tree listing");
+    auto result = executeGitCommand({"ls-tree", "-r", "-l", "-z", "--full-tree", commitHash});
+    if (result.isErr()) {
+        return Result<QSharedPointer<const TreeListing>, QString>::err(result.error());
+    }
+    
+    const QStringList records = result.value().split(QChar('\0'), Qt::SkipEmptyParts);
+    auto listing = QSharedPointer<TreeListing>::create();
+    listing->reserve(records.size());
+    for (const QString& record : records) {
+        // <mode> SP <type> SP <object> SP <padded size> TAB <path>
+        int tab = record.indexOf('\t');
+        if (tab < 0) {
+            continue;
+        }
+        const QStringList fields = record.left(tab).split(' ', Qt::SkipEmptyParts);
+        if (fields.size() < 4 || fields[1] != "blob") {
+            continue;  // Submodules have no size and no files of ours
+        }
+        
+        TreeEntry entry;
+        entry.path = record.mid(tab + 1);
+        entry.blobId = fields[2].toLatin1();
+        entry.mode = fields[0].toLatin1();
+        entry.size = fields[3].toLongLong();
+        listing->append(entry);
+    }
+    
+    // git orders a directory as if its name ended in '/'; a plain path
+    // order keeps lookups and merges simple
+    std::sort(listing->begin(), listing->end(),
+        [](const TreeEntry& a, const TreeEntry& b) { return a.path < b.path; });
+    span.setArg("files", listing->size());
+    
+    auto sizesResult = applyManifestSizes(*listing);
+    if (sizesResult.isErr()) {
+        return Result<QSharedPointer<const TreeListing>, QString>::err(sizesResult.error());
+    }
+    
+    m_treeCache.insert(commitHash, listing);
+    return Result<QSharedPointer<const TreeListing>, QString>::ok(listing);
+}
+
+Result<void, QString> GitService::applyManifestSizes(TreeListing& listing)
+{
+    const QStringList patterns = storageFilterPatterns();
+    if (patterns.isEmpty()) {
+        return Result<void, QString>::ok();
+    }
+    
+    const PatternMatcher filtered(patterns);
+    QVector<TreeEntry*> candidates;
+    for (TreeEntry& entry : listing) {
+        if (entry.size <= MaxManifestBytes && filtered.matches(entry.path, false)) {
+            candidates.append(&entry);
+        }
+    }
+    if (candidates.isEmpty()) {
+        return Result<void, QString>::ok();
+    }
+    
+    TraceSpan span("git", "Manifest sizes");
+    span.setArg("files", candidates.size());
+    QProcess batch;
+    if (!startGitProcess(batch, {"cat-file", "--batch"})) {
+        return Result<void, QString>::err("Failed to start git process");
+    }
+    for (TreeEntry* entry : candidates) {
+        batch.write(entry->blobId + '\n');
+        const QList<QByteArray> fields = readLineFromProcess(batch).trimmed().split(' ');
+        if (fields.size() != 3 || fields[1] != "blob") {
+            batch.kill();
+            batch.waitForFinished();
+            return Result<void, QString>::err(QString("Cannot read %1").arg(entry->path));
+        }
+        QByteArray content = readFromProcess(batch, fields[2].toLongLong());
+        readFromProcess(batch, 1);   // Newline after the content
+        
+        // A file stored before its pattern was added is its own size already
+        qint64 size = manifestFileSize(content);
+        if (size >= 0) {
+            entry->size = size;
+        }
+    }
+    batch.closeWriteChannel();
+    batch.waitForFinished();
+    return Result<void, QString>::ok();
+}
+
+QStringList GitService::storageFilterPatterns() const
+{
+    // Patterns of earlier presets stay in the attributes file, and their
+    // snapshots still hold manifests
+    QStringList patterns = m_regionFiles + m_deltaFiles;
+    QFile attributes(QDir(m_repoPath).filePath(".git/info/attributes"));
+    if (attributes.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QStringList lines = QString::fromUtf8(attributes.readAll()).split('\n');
+        for (const QString& line : lines) {
+            if (line.contains(" filter=vgvc-")) {
+                patterns << line.section(' ', 0, 0);
+            }
+        }
+    }
+    patterns.removeDuplicates();
+    return patterns;
+}
+
+QFuture<Result<QList<FileVersion>, QString>> GitService::fileHistory(const QString& path)
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, path, queuedAt]() -> Result<QList<FileVersion>, QString> {
+        Tracer::recordQueueWait("GitService::fileHistory", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::fileHistory");
+        
+        // Usually a no-op: commits made through GitService update the index
+        auto updateResult = updateFileHistory();
+        if (updateResult.isErr()) {
+            return Result<QList<FileVersion>, QString>::err(updateResult.error());
+        }
+        
+        QString relativePath = QDir::cleanPath(QDir(m_repoPath).relativeFilePath(path));
+        QMutexLocker locker(&m_fileHistoryMutex);
+        return Result<QList<FileVersion>, QString>::ok(m_fileHistory.versions(relativePath));
+    });
+}
+
+QFuture<Result<void, QString>> GitService::restoreFile(const QString& commitHash, const QString& path)
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, commitHash, path, queuedAt]() -> Result<void, QString> {
+        Tracer::recordQueueWait("GitService::restoreFile", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::restoreFile");
+        
+        auto filterResult = configureStorageFilters();
+        if (filterResult.isErr()) {
+            return Result<void, QString>::err(filterResult.error());
+        }
+        
+        // Working tree only: the index and HEAD stay put, so the restored
+        // file shows up as a change in the next snapshot
+        QString relativePath = QDir::cleanPath(QDir(m_repoPath).relativeFilePath(path));
+        auto result = executeGitCommand({"restore", "--source=" + commitHash, "--worktree",
+                                         "--", ":(literal)" + relativePath});
+        if (result.isErr()) {
+            return Result<void, QString>::err(result.error());
+        }
+        
+        return Result<void, QString>::ok();
+    });
+}
+
+QFuture<Result<VerifyReport, QString>> GitService::verifyRestore(VerifyMode mode)
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, mode, queuedAt]() -> Result<VerifyReport, QString> {
+        Tracer::recordQueueWait("GitService::verifyRestore", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::verifyRestore");
+        span.setArg("deep", mode == VerifyMode::Deep);
+        
+        RestoreManifest manifest(m_repoPath);
+        auto loadResult = manifest.load();
+        if (loadResult.isErr()) {
+            return Result<VerifyReport, QString>::err(loadResult.error());
+        }
+        
+        VerifyReport report;
+        report.snapshotId = manifest.snapshotId();
+        QVector<RestoreManifest::Entry>& entries = manifest.entries();
+        QDir repoDir(m_repoPath);
+        
+        // Unchanged stat data means unchanged content since the restore
+        QList<int> toHash;
+        for (int i = 0; i < entries.size(); ++i) {
+            const RestoreManifest::Entry& entry = entries[i];
+            QFileInfo info(repoDir.filePath(entry.path));
+            ++report.checkedFiles;
+            if (!info.exists()) {
+                report.missing << entry.path;
+            } else if (mode == VerifyMode::Deep || info.size() != entry.size
+                       || info.lastModified().toMSecsSinceEpoch() != entry.modifiedMs) {
+                toHash << i;
+            }
+        }
+        
+        // Largest first, so one big file doesn't finish last on its own
+        std::sort(toHash.begin(), toHash.end(),
+            [&entries](int a, int b) { return entries[a].size > entries[b].size; });
+        
+        struct HashOutcome {
+            int entry;
+            QByteArray blobId;
+            qint64 bytes;
+        };
+        const QList<HashOutcome> outcomes = QtConcurrent::blockingMapped(
+            ExecutionPolicy::pool(m_executionClass), toHash,
+            [this, &entries, &repoDir](int index) {
+                ExecutionPolicy::applyToCurrentThread(m_executionClass);
+                qint64 bytes = 0;
+                QByteArray blobId = hashBlob(repoDir.filePath(entries[index].path), bytes);
+                return HashOutcome{index, blobId, bytes};
+            });
+        
+        QList<int> matched;
+        QList<int> suspects;
+        for (const HashOutcome& outcome : outcomes) {
+            ++report.hashedFiles;
+            report.hashedBytes += outcome.bytes;
+            if (outcome.blobId == entries[outcome.entry].blobId) {
+                matched << outcome.entry;
+            } else {
+                suspects << outcome.entry;
+            }
+        }
+        
+        // Filtered files (region, delta, line endings) are stored as git's
+        // cleaned form; let git hash the few raw mismatches the same way
+        for (int start = 0; start < suspects.size(); start += PathBatchSize) {
+            QStringList args{"hash-object", "--"};
+            const QList<int> batch = suspects.mid(start, PathBatchSize);
+            for (int index : batch) {
+                args << entries[index].path;
+            }
+            auto hashResult = executeGitCommand(args);
+            QStringList blobIds = hashResult.isOk()
+                ? hashResult.value().split('\n', Qt::SkipEmptyParts) : QStringList();
+            for (int i = 0; i < batch.size(); ++i) {
+                if (i < blobIds.size() && blobIds[i].toLatin1() == entries[batch[i]].blobId) {
+                    matched << batch[i];
+                } else {
+                    report.modified << entries[batch[i]].path;
+                }
+            }
+        }
+        
+        // Touched but intact: record the new stat data so the next quick
+        // verify skips them
+        for (int index : matched) {
+            QFileInfo info(repoDir.filePath(entries[index].path));
+            entries[index].size = info.size();
+            entries[index].modifiedMs = info.lastModified().toMSecsSinceEpoch();
+        }
+        if (!matched.isEmpty()) {
+            auto saveResult = manifest.save();
+            if (saveResult.isErr()) {
+                Logger::warning(saveResult.error(), "GitService");
+            }
+        }
+        
+        report.modified.sort();
+        report.missing.sort();
+        span.setArg("hashedFiles", report.hashedFiles);
+        span.setArg("damaged", report.modified.size() + report.missing.size());
+        return Result<VerifyReport, QString>::ok(report);
+    });
+}
+
+QFuture<Result<void, QString>> GitService::repairRestore(const QStringList& paths)
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, paths, queuedAt]() -> Result<void, QString> {
+        Tracer::recordQueueWait("GitService::repairRestore", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::repairRestore");
+        span.setArg("files", paths.size());
+        
+        RestoreManifest manifest(m_repoPath);
+        auto loadResult = manifest.load();
+        if (loadResult.isErr()) {
+            return Result<void, QString>::err(loadResult.error());
+        }
+        
+        auto filterResult = configureStorageFilters();
+        if (filterResult.isErr()) {
+            return Result<void, QString>::err(filterResult.error());
+        }
+        
+        for (int start = 0; start < paths.size(); start += PathBatchSize) {
+            QStringList args{"checkout", manifest.snapshotId(), "--"};
+            for (const QString& path : paths.mid(start, PathBatchSize)) {
+                args << ":(literal)" + path;
+            }
+            auto result = executeGitCommand(args);
+            if (result.isErr()) {
+                return Result<void, QString>::err(result.error());
+            }
+        }
+        
+        // Repaired files match the snapshot again; trust their new stat data
+        QSet<QString> repaired(paths.cbegin(), paths.cend());
+        QDir repoDir(m_repoPath);
+        for (RestoreManifest::Entry& entry : manifest.entries()) {
+            if (repaired.contains(entry.path)) {
+                QFileInfo info(repoDir.filePath(entry.path));
+                entry.size = info.size();
+                entry.modifiedMs = info.lastModified().toMSecsSinceEpoch();
+            }
+        }
+        return manifest.save();
+    });
+}
+
+QFuture<Result<SyncReport, QString>> GitService::pushSnapshots(const QString& remoteUrl)
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, remoteUrl, queuedAt]() -> Result<SyncReport, QString> {
+        Tracer::recordQueueWait("GitService::pushSnapshots", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::pushSnapshots");
+        
+        SyncReport report;
+        report.remoteUrl = remoteUrl;
+        
+        // Region and delta files are committed as manifests whose content
+        // lives in .git/vgvc, which git push doesn't send; the remote copy
+        // couldn't restore them. Stores left from earlier presets count too.
+        QDir repoDir(m_repoPath);
+        if (!m_regionFiles.isEmpty() || !m_deltaFiles.isEmpty()
+            || repoDir.exists(".git/vgvc/chunks") || repoDir.exists(".git/vgvc/deltas")) {
+            return Result<SyncReport, QString>::err(
+                "This project stores region or delta files outside git, which a git remote can't hold; "
+                "sync to a chunk remote (chunks:<location>) instead");
+        }
+        
+        // A local remote is created on first use
+        QUrl url(remoteUrl);
+        QString localPath = url.isLocalFile() ? url.toLocalFile()
+            : (QDir::isAbsolutePath(remoteUrl) ? remoteUrl : QString());
+        if (!localPath.isEmpty() && !QFileInfo::exists(localPath)) {
+            auto initResult = executeGitCommand({"init", "--bare", "--quiet", "-b", "main", localPath});
+            if (initResult.isErr()) {
+                return Result<SyncReport, QString>::err(initResult.error());
+            }
+        }
+        
+        auto localResult = executeGitCommand({"rev-parse", "--verify", "--quiet", "main^{commit}"});
+        if (localResult.isErr()) {
+            return Result<SyncReport, QString>::err("No snapshots to sync");
+        }
+        const QString localTip = localResult.value().trimmed();
+        
+        // The remote's branch is the resume point: whatever landed before
+        // an interruption is not sent again
+        auto remoteResult = executeGitCommand({"ls-remote", remoteUrl, "refs/heads/main"});
+        if (remoteResult.isErr()) {
+            return Result<SyncReport, QString>::err(
+                QString("Cannot reach %1: %2").arg(remoteUrl, remoteResult.error()));
+        }
+        const QString remoteTip = remoteResult.value().section('\t', 0, 0).trimmed();
+        report.remoteTip = remoteTip;
+        
+        if (!remoteTip.isEmpty()) {
+            auto ancestorResult = executeGitCommand({"merge-base", "--is-ancestor", remoteTip, localTip});
+            if (ancestorResult.isErr()) {
+                return Result<SyncReport, QString>::err(
+                    "The remote holds snapshots this project doesn't have; sync to an empty remote instead");
+            }
+        }
+        
+        QStringList revListArgs = {"rev-list", "--reverse", "--first-parent", localTip};
+        if (!remoteTip.isEmpty()) {
+            revListArgs << "^" + remoteTip;
+        }
+        auto pendingResult = executeGitCommand(revListArgs);
+        if (pendingResult.isErr()) {
+            return Result<SyncReport, QString>::err(pendingResult.error());
+        }
+        const QStringList pending = pendingResult.value().split('\n', Qt::SkipEmptyParts);
+        if (pending.isEmpty()) {
+            return Result<SyncReport, QString>::ok(report);
+        }
+        
+        const int batchCount = (pending.size() + SnapshotsPerBatch - 1) / SnapshotsPerBatch;
+        auto batchEnd = [&](int batch) { return qMin((batch + 1) * SnapshotsPerBatch, int(pending.size())); };
+        auto batchTip = [&](int batch) { return pending[batchEnd(batch) - 1]; };
+        auto batchBase = [&](int batch) { return batch == 0 ? remoteTip : batchTip(batch - 1); };
+        
+        auto packResult = packForPush(batchTip(0), batchBase(0));
+        if (packResult.isErr()) {
+            return Result<SyncReport, QString>::err(packResult.error());
+        }
+        
+        for (int batch = 0; batch < batchCount; ++batch) {
+            emit operationProgress(int(report.pushedSnapshots * 100 / pending.size()),
+                QString("Uploading snapshots (%1 of %2)...").arg(report.pushedSnapshots).arg(pending.size()));
+            
+            TraceSpan pushSpan("git", "git push");
+            pushSpan.setArg("batch", batch);
+            
+            // Stalled HTTP transfers fail rather than hang; the next sync resumes
+            QProcess push;
+            if (!startGitProcess(push, {"-c", "http.lowSpeedLimit=1024", "-c", "http.lowSpeedTime=60",
+                                        "push", "--quiet", "--no-verify", remoteUrl,
+                                        batchTip(batch) + ":refs/heads/main"})) {
+                return Result<SyncReport, QString>::err("Failed to start git process");
+            }
+            
+            // Pack the next batch while this one uploads; its push then
+            // copies the packed objects instead of compressing them
+            Result<void, QString> nextPack = Result<void, QString>::ok();
+            if (batch + 1 < batchCount) {
+                nextPack = packForPush(batchTip(batch + 1), batchBase(batch + 1));
+            }
+            
+            auto pushResult = finishGitProcess(push, -1, pushSpan);
+            if (pushResult.isErr()) {
+                return Result<SyncReport, QString>::err(
+                    QString("Synced %1 of %2 snapshots; sync again to continue. %3")
+                        .arg(report.pushedSnapshots).arg(pending.size()).arg(pushResult.error()));
+            }
+            report.remoteTip = batchTip(batch);
+            report.pushedSnapshots = batchEnd(batch);
+            report.batches = batch + 1;
+            
+            if (nextPack.isErr()) {
+                return Result<SyncReport, QString>::err(nextPack.error());
+            }
+        }
+        
+        // Loose copies of everything just packed are redundant now
+        auto pruneResult = executeGitCommand({"prune-packed", "--quiet"});
+        if (pruneResult.isErr()) {
+            Logger::warning(QString("Loose objects not pruned after sync: %1").arg(pruneResult.error()),
+                            "GitService");
+        }
+        
+        emit operationProgress(100, "Sync complete");
+        return Result<SyncReport, QString>::ok(report);
+    });
+}
+
+Result<void, QString> GitService::packForPush(const QString& tip, const QString& exclude)
+{
+    TraceSpan span("git", "git pack-objects");
+    
+    QProcess process;
+    if (!startGitProcess(process, {"pack-objects", "--revs", "--incremental", "--non-empty",
+                                   "--delta-base-offset", "--quiet", ".git/objects/pack/pack"})) {
+        return Result<void, QString>::err("Failed to start git process");
+    }
+    
+    QByteArray revisions = tip.toLatin1() + '\n';
+    if (!exclude.isEmpty()) {
+        revisions += '^' + exclude.toLatin1() + '\n';
+    }
+    process.write(revisions);
+    process.closeWriteChannel();
+    
+    auto result = finishGitProcess(process, -1, span);
+    if (result.isErr()) {
+        return Result<void, QString>::err(result.error());
+    }
+    return Result<void, QString>::ok();
+}
+
+QFuture<Result<SyncReport, QString>> GitService::uploadSnapshots(const QString& remoteUrl)
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, remoteUrl, queuedAt]() -> Result<SyncReport, QString> {
+        Tracer::recordQueueWait("GitService::uploadSnapshots", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::uploadSnapshots");
+        
+        SyncReport report;
+        report.remoteUrl = remoteUrl;
+        
+        auto remoteResult = ChunkRemote::open(remoteUrl);
+        if (remoteResult.isErr()) {
+            return Result<SyncReport, QString>::err(remoteResult.error());
+        }
+        ChunkRemote& remote = *remoteResult.value();
+        
+        // Region and delta files are backed up as their real content
+        auto filterResult = configureStorageFilters();
+        if (filterResult.isErr()) {
+            return Result<SyncReport, QString>::err(filterResult.error());
+        }
+        
+        auto historyResult = executeGitCommand({"rev-list", "--reverse", "--first-parent", "main"});
+        if (historyResult.isErr()) {
+            return Result<SyncReport, QString>::err("No snapshots to sync");
+        }
+        const QStringList history = historyResult.value().split('\n', Qt::SkipEmptyParts);
+        
+        // Snapshots whose manifest is on the remote are complete: the
+        // manifest is written after everything it refers to
+        QStringList pending;
+        for (int start = 0; start < history.size(); start += ChunkRemote::QueryBatchSize) {
+            const QStringList commits = history.mid(start, ChunkRemote::QueryBatchSize);
+            QVector<ObjectId> keys;
+            keys.reserve(commits.size());
+            for (const QString& commit : commits) {
+                keys.append(RemoteSnapshot::snapshotKey(commit));
+            }
+            auto present = remote.contains(keys);
+            if (present.isErr()) {
+                return Result<SyncReport, QString>::err(present.error());
+            }
+            for (int i = 0; i < commits.size(); ++i) {
+                if (present.value()[i]) {
+                    report.remoteTip = commits[i];
+                } else {
+                    pending << commits[i];
+                }
+            }
+        }
+        if (pending.isEmpty()) {
+            return Result<SyncReport, QString>::ok(report);
+        }
+        
+        const PatternMatcher filtered(m_regionFiles + m_deltaFiles);
+        QSet<QByteArray> storedBlobs;   // Recipes known to be on the remote
+        
+        // Unfiltered blobs stream through one long-running cat-file
+        QProcess batch;
+        if (!startGitProcess(batch, {"cat-file", "--batch"})) {
+            return Result<SyncReport, QString>::err("Failed to start git process");
+        }
+        auto failed = [&](const QString& error) {
+            batch.kill();
+            batch.waitForFinished();
+            return Result<SyncReport, QString>::err(
+                QString("Backed up %1 of %2 snapshots; sync again to continue. %3")
+                    .arg(report.pushedSnapshots).arg(pending.size()).arg(error));
+        };
+        
+        for (const QString& commit : pending) {
+            emit operationProgress(int(report.pushedSnapshots * 100 / pending.size()),
+                QString("Backing up snapshots (%1 of %2)...").arg(report.pushedSnapshots).arg(pending.size()));
+            
+            auto listingResult = treeListing(commit);
+            if (listingResult.isErr()) {
+                return failed(listingResult.error());
+            }
+            const TreeListing& listing = *listingResult.value();
+            
+            RemoteSnapshot snapshot;
+            snapshot.commit = commit;
+            snapshot.entries.reserve(listing.size());
+            QVector<const TreeEntry*> candidates;
+            QSet<QByteArray> seen;
+            for (const TreeEntry& entry : listing) {
+                snapshot.entries.append({entry.path, QString::fromLatin1(entry.mode),
+                                         QString::fromLatin1(entry.blobId)});
+                if (!storedBlobs.contains(entry.blobId) && !seen.contains(entry.blobId)) {
+                    seen.insert(entry.blobId);
+                    candidates.append(&entry);
+                }
+            }
+            
+            for (int start = 0; start < candidates.size(); start += ChunkRemote::QueryBatchSize) {
+                const QVector<const TreeEntry*> group = candidates.mid(start, ChunkRemote::QueryBatchSize);
+                QVector<ObjectId> keys;
+                keys.reserve(group.size());
+                for (const TreeEntry* entry : group) {
+                    keys.append(ChunkRecipe::recipeKey(QString::fromLatin1(entry->blobId)));
+                }
+                auto present = remote.contains(keys);
+                if (present.isErr()) {
+                    return failed(present.error());
+                }
+                
+                for (int i = 0; i < group.size(); ++i) {
+                    const TreeEntry& entry = *group[i];
+                    if (present.value()[i]) {
+                        storedBlobs.insert(entry.blobId);
+                        continue;
+                    }
+                    
+                    Result<ChunkRecipe, QString> recipe = Result<ChunkRecipe, QString>::err(QString());
+                    if (filtered.matches(entry.path, false)) {
+                        // Filters need the path, which --batch can't take here
+                        TraceSpan fileSpan("git", "git cat-file --filters");
+                        QProcess source;
+                        if (!startGitProcess(source, {"cat-file", "--filters", commit + ":" + entry.path})) {
+                            return failed("Failed to start git process");
+                        }
+                        recipe = uploadContent(remote, source, -1, report);
+                        auto finished = finishGitProcess(source, -1, fileSpan);
+                        if (recipe.isOk() && finished.isErr()) {
+                            recipe = Result<ChunkRecipe, QString>::err(finished.error());
+                        }
+                    } else {
+                        batch.write(entry.blobId + '\n');
+                        QByteArray header = readLineFromProcess(batch);
+                        const QList<QByteArray> fields = header.trimmed().split(' ');
+                        if (fields.size() != 3 || fields[1] != "blob") {
+                            return failed(QString("Cannot read %1").arg(entry.path));
+                        }
+                        recipe = uploadContent(remote, batch, fields[2].toLongLong(), report);
+                        readFromProcess(batch, 1);   // Newline after the content
+                    }
+                    if (recipe.isErr()) {
+                        return failed(recipe.error());
+                    }
+                    
+                    auto putResult = remote.put(ChunkRecipe::recipeKey(QString::fromLatin1(entry.blobId)),
+                                                recipe.value().encode());
+                    if (putResult.isErr()) {
+                        return failed(putResult.error());
+                    }
+                    storedBlobs.insert(entry.blobId);
+                }
+            }
+            
+            auto putResult = remote.put(RemoteSnapshot::snapshotKey(commit), snapshot.encode());
+            if (putResult.isErr()) {
+                return failed(putResult.error());
+            }
+            report.remoteTip = commit;
+            report.pushedSnapshots++;
+        }
+        
+        batch.closeWriteChannel();
+        batch.waitForFinished();
+        report.batches = 1;
+        span.setArg("chunks", report.uploadedChunks);
+        span.setArg("bytes", report.uploadedBytes);
+        
+        emit operationProgress(100, "Backup complete");
+        return Result<SyncReport, QString>::ok(report);
+    });
+}
+
+Result<ChunkRecipe, QString> GitService::uploadContent(ChunkRemote& remote, QProcess& source,
+                                                       qint64 size, SyncReport& report)
+{
+    ChunkRecipe recipe;
+    QVector<ObjectId> pendingKeys;
+    QVector<QByteArray> pendingChunks;
+    qint64 pendingBytes = 0;
+    
+    // Ask about many chunks at once; upload only the ones the remote lacks
+    auto flush = [&]() -> Result<void, QString> {
+        if (pendingKeys.isEmpty()) {
+            return Result<void, QString>::ok();
+        }
+        auto present = remote.contains(pendingKeys);
+        if (present.isErr()) {
+            return Result<void, QString>::err(present.error());
+        }
+        for (int i = 0; i < pendingKeys.size(); ++i) {
+            if (present.value()[i]) {
+                continue;
+            }
+            auto putResult = remote.put(pendingKeys[i], pendingChunks[i]);
+            if (putResult.isErr()) {
+                return putResult;
+            }
+            report.uploadedChunks++;
+            report.uploadedBytes += pendingChunks[i].size();
+        }
+        pendingKeys.clear();
+        pendingChunks.clear();
+        pendingBytes = 0;
+        return Result<void, QString>::ok();
+    };
+    
+    // Keep MaxSize bytes ahead of the cut point so boundaries are the same
+    // no matter how the stream arrives
+    QByteArray buffer;
+    qint64 remaining = size < 0 ? std::numeric_limits<qint64>::max() : size;
+    bool atEnd = false;
+    while (!atEnd || !buffer.isEmpty()) {
+        if (!atEnd) {
+            qint64 wanted = qMin<qint64>(2 * ContentChunker::MaxSize - buffer.size(), remaining);
+            QByteArray data = readFromProcess(source, wanted);
+            remaining -= data.size();
+            buffer += data;
+            atEnd = data.size() < wanted || remaining == 0;
+            if (atEnd && remaining > 0 && size >= 0) {
+                return Result<ChunkRecipe, QString>::err("git stopped before the end of a file");
+            }
+        }
+        
+        qsizetype offset = 0;
+        while (buffer.size() - offset >= ContentChunker::MaxSize
+               || (atEnd && offset < buffer.size())) {
+            QByteArrayView rest(buffer.constData() + offset, buffer.size() - offset);
+            qsizetype length = ContentChunker::boundary(rest);
+            QByteArray chunk = buffer.mid(offset, length);
+            offset += length;
+            
+            ObjectId key = ObjectId::fromBytes(QCryptographicHash::hash(chunk, QCryptographicHash::Sha1));
+            recipe.chunks.append(key);
+            recipe.size += chunk.size();
+            pendingKeys.append(key);
+            pendingBytes += chunk.size();
+            pendingChunks.append(std::move(chunk));
+            
+            if (pendingKeys.size() == ChunkRemote::QueryBatchSize || pendingBytes >= PendingChunkBytes) {
+                auto flushResult = flush();
+                if (flushResult.isErr()) {
+                    return Result<ChunkRecipe, QString>::err(flushResult.error());
+                }
+            }
+        }
+        buffer.remove(0, offset);
+    }
+    
+    auto flushResult = flush();
+    if (flushResult.isErr()) {
+        return Result<ChunkRecipe, QString>::err(flushResult.error());
+    }
+    return Result<ChunkRecipe, QString>::ok(std::move(recipe));
+}
+
+Result<void, QString> GitService::recordRestore(const QString& commitHash)
+{
+    TraceSpan span("git", "Record restore");
+    
+    auto listingResult = treeListing(commitHash);
+    if (listingResult.isErr()) {
+        return Result<void, QString>::err(listingResult.error());
+    }
+    
+    RestoreManifest manifest(m_repoPath);
+    manifest.setSnapshotId(commitHash);
+    
+    const TreeListing& listing = *listingResult.value();
+    QVector<RestoreManifest::Entry>& entries = manifest.entries();
+    entries.reserve(listing.size());
+    QDir repoDir(m_repoPath);
+    for (const TreeEntry& treeEntry : listing) {
+        // A file checkout failed to write keeps size -1 and reports as damaged
+        QFileInfo info(repoDir.filePath(treeEntry.path));
+        RestoreManifest::Entry entry;
+        entry.path = treeEntry.path;
+        entry.blobId = treeEntry.blobId;
+        entry.size = info.exists() ? info.size() : -1;
+        entry.modifiedMs = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+        entries.append(entry);
+    }
+    span.setArg("files", entries.size());
+    
+    return manifest.save();
+}
+
+QFuture<Result<SnapshotSearchResult, QString>> GitService::searchSnapshots(const SnapshotQuery& query,
+                                                                          int limit)
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run(ExecutionPolicy::pool(m_executionClass), [this, query, limit, queuedAt]() -> Result<SnapshotSearchResult, QString> {
+        Tracer::recordQueueWait("GitService::searchSnapshots", queuedAt);
+        ExecutionPolicy::applyToCurrentThread(m_executionClass);
+        TraceSpan span("git", "GitService::searchSnapshots");
+        
+        // Commits and history refreshes keep the index current; only the
+        // first search has to build it
+        bool loaded;
+        {
+            QMutexLocker locker(&m_fileHistoryMutex);
+            loaded = m_fileHistoryLoaded;
+        }
+        if (!loaded) {
+            auto updateResult = updateFileHistory();
+            if (updateResult.isErr()) {
+                return Result<SnapshotSearchResult, QString>::err(updateResult.error());
+            }
+        }
+        
+        QMutexLocker locker(&m_fileHistoryMutex);
+        SnapshotSearchResult result = m_searchIndex.search(query, limit);
+        span.setArg("matches", result.total);
+        return Result<SnapshotSearchResult, QString>::ok(result);
+    });
+}
+
+Result<void, QString> GitService::updateFileHistory()
+{
+    // Serializes updates; readers only wait while the indexes change, never on git
+    QMutexLocker updateLocker(&m_fileHistoryUpdateMutex);
+    
+    QStringList indexedTips;
+    {
+        QMutexLocker locker(&m_fileHistoryMutex);
+        if (!m_fileHistoryLoaded) {
+            auto loadResult = m_fileHistory.load();
+            if (loadResult.isErr()) {
+                return loadResult;
+            }
+            m_searchIndex.clear();
+            m_fileHistory.forEachSnapshot([this](const QString& snapshotId, const QString& description,
+                                                 const QDateTime& timestamp, const QStringList& changedPaths) {
+                m_searchIndex.addSnapshot(snapshotId, description, timestamp, changedPaths);
+            });
+            m_fileHistoryLoaded = true;
+        }
+        indexedTips = m_fileHistory.tips();
+    }
+    
+    // One git call: every branch plus HEAD, which is detached after a restore,
+    // minus what is already indexed. Usually prints nothing.
+    TraceSpan span("git", "File history index update");
+    QStringList logArgs = {"log", "--reverse", "--raw", "-z", "--no-renames", "--no-abbrev", "--root",
+                           QString("--format=%x01%H%x02%P%x02%ct%x02%s"), "--branches", "HEAD"};
+    if (!indexedTips.isEmpty()) {
+        logArgs << "--not" << indexedTips;
+    }
+    
+    bool rebuild = false;
+    auto logResult = executeGitCommand(logArgs);
+    if (logResult.isErr() && !indexedTips.isEmpty()) {
+        // An old tip no longer resolves; rebuild from the full log
+        rebuild = true;
+        indexedTips.clear();
+        logArgs = logArgs.mid(0, logArgs.indexOf("--not"));
+        logResult = executeGitCommand(logArgs);
+    }
+    if (logResult.isErr()) {
+        if (executeGitCommand({"rev-parse", "--verify", "--quiet", "HEAD"}).isOk()) {
+            return Result<void, QString>::err(logResult.error());
+        }
+        // No commits yet, so nothing to index
+        QMutexLocker locker(&m_fileHistoryMutex);
+        if (m_fileHistory.tips().isEmpty()) {
+            return Result<void, QString>::ok();
+        }
+        m_fileHistory.clear();
+        m_searchIndex.clear();
+        return m_fileHistory.save();
+    }
+    
+    struct LoggedSnapshot {
+        QString id;
+        QString description;
+        QDateTime timestamp;
+        QHash<QString, QString> changes;
+    };
+    QList<LoggedSnapshot> snapshots;
+    QSet<QString> parents;
+    
+    // Each commit is \x01<hash>\x02<parents>\x02<time>\x02<subject>, a newline,
+    // then NUL-separated pairs of ":<modes> <ids> <status>" and the path
+    const QStringList tokens = logResult.value().split(QChar('\0'));
+    for (int i = 0; i < tokens.size(); ++i) {
+        QString token = tokens[i];
+        while (token.startsWith('\n')) {
+            token.remove(0, 1);
+        }
+        
+        if (token.startsWith(CommitMarker)) {
+            int newline = token.indexOf('\n');
+            const QStringList fields = token.mid(1, newline < 0 ? -1 : newline - 1).split(FieldSeparator);
+            LoggedSnapshot snapshot;
+            snapshot.id = fields.value(0);
+            for (const QString& parent : fields.value(1).split(' ', Qt::SkipEmptyParts)) {
+                parents.insert(parent);
+            }
+            snapshot.timestamp = QDateTime::fromSecsSinceEpoch(fields.value(2).toLongLong());
+            snapshot.description = fields.value(3);
+            snapshots.append(snapshot);
+            token = newline < 0 ? QString() : token.mid(newline + 1);
+        }
+        
+        if (token.startsWith(':') && i + 1 < tokens.size() && !snapshots.isEmpty()) {
+            // :<old mode> <new mode> <old id> <new id> <status>
+            const QStringList fields = token.split(' ');
+            QString blobId = token.endsWith('D') ? QString() : fields.value(3);
+            snapshots.last().changes.insert(tokens[++i], blobId);
+        }
+    }
+    span.setArg("snapshots", snapshots.size());
+    
+    if (snapshots.isEmpty() && !rebuild) {
+        return Result<void, QString>::ok();
+    }
+    
+    // New tips: everything indexed that no new commit builds on
+    QStringList tips = indexedTips;
+    for (const LoggedSnapshot& snapshot : snapshots) {
+        tips << snapshot.id;
+    }
+    tips.erase(std::remove_if(tips.begin(), tips.end(),
+                              [&parents](const QString& tip) { return parents.contains(tip); }),
+               tips.end());
+    tips.removeDuplicates();
+    std::sort(tips.begin(), tips.end());
+    
+    QMutexLocker locker(&m_fileHistoryMutex);
+    if (rebuild) {
+        m_fileHistory.clear();
+        m_searchIndex.clear();
+    }
+    for (const LoggedSnapshot& snapshot : snapshots) {
+        m_fileHistory.addSnapshot(snapshot.id, snapshot.description, snapshot.timestamp, snapshot.changes);
+        m_searchIndex.addSnapshot(snapshot.id, snapshot.description, snapshot.timestamp,
+                                  snapshot.changes.keys());
+    }
+    m_fileHistory.setTips(tips);
+    return m_fileHistory.save();
+}
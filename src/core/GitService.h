@@ -3,10 +3,27 @@
 
 #include <QObject>
 #include <QFuture>
+#include <QMutex>
 #include <QString>
 #include <QStringList>
+#include <atomic>
+#include <functional>
+#include "FileHistoryIndex.h"
+#include "RestoreManifest.h"
+#include "SnapshotSearchIndex.h"
+#include "SnapshotTable.h"
+#include "TreeCache.h"
+#include "types/FileChange.h"
 #include "types/Result.h"
 #include "types/Snapshot.h"
+#include "types/SyncReport.h"
+#include "utils/ExecutionPolicy.h"
+#include "utils/TrackedScope.h"
+
+class ChunkRemote;
+struct ChunkRecipe;
+class QProcess;
+class TraceSpan;
 
 /**
  * @brief Low-level Git operations wrapper
@@ -21,23 +38,248 @@ public:
     explicit GitService(const QString& repoPath, QObject* parent = nullptr);
     ~GitService() override = default;
     
+    /**
+     * @brief Restrict snapshots to a preset's tracked paths
+     * 
+     * Only the selected subtrees and root-level globs are scanned, hashed
+     * and stored. An empty list tracks the whole directory.
+     */
+    void setTrackedPaths(const QStringList& trackedPaths);
+    
+    /**
+     * @brief Run subsequent operations at full speed or in the background
+     * 
+     * Background operations yield CPU and disk to a running game: lower
+     * thread and process priorities, single-threaded git, and pauses while
+     * the disk is congested. Set before starting operations.
+     */
+    void setExecutionClass(ExecutionClass executionClass);
+    
+    /**
+     * @brief Store changed files' objects ahead of git add (default on)
+     * 
+     * Foreground commits only: the pipeline's threads read at full speed,
+     * so background snapshots always leave the work to git. Turned off to
+     * measure what it saves.
+     */
+    void setCommitPipelineEnabled(bool enabled);
+    
+    /**
+     * @brief Store files matching these patterns chunk by chunk
+     * 
+     * For Minecraft region files (.mca), which the game rewrites whole
+     * when any chunk changes. Matching files pass through vgvc-cli as a
+     * git filter that stores each chunk once in .git/vgvc/chunks, so a
+     * snapshot grows only by the chunks that changed. Patterns use
+     * gitattributes syntax and, once registered, stay registered so older
+     * snapshots keep restoring.
+     */
+    void setRegionFiles(const QStringList& patterns);
+    
+    /**
+     * @brief Store files matching these patterns as deltas between versions
+     * 
+     * For save files rewritten in full on every save (Skyrim .ess, KSP
+     * .sfs). Each new version is stored as a delta against the previous
+     * one in .git/vgvc/deltas, with chains capped so restores stay fast.
+     * Same filter mechanism and rules as setRegionFiles().
+     */
+    void setDeltaFiles(const QStringList& patterns);
+    
     // Async operations
     QFuture<Result<void, QString>> init();
     QFuture<Result<void, QString>> commit(const QString& message);
     QFuture<Result<QList<Snapshot>, QString>> getHistory(int limit = 50);
+    
+    /**
+     * @brief History as a compact shared table; prefer this for large listings
+     */
+    QFuture<Result<SnapshotTablePtr, QString>> getHistoryTable(int limit = 50);
     QFuture<Result<void, QString>> checkout(const QString& commitHash);
     QFuture<Result<qint64, QString>> getRepoSize();
     QFuture<Result<bool, QString>> hasChanges();
     
+    /**
+     * @brief Write a commit's tree to an archive
+     * 
+     * The format follows the output extension (.zip, .tar, .tar.gz, .tgz).
+     */
+    QFuture<Result<void, QString>> archive(const QString& commitHash, const QString& outputPath);
+    
+    /**
+     * @brief Repack and prune if git's own thresholds say it is worthwhile
+     */
+    QFuture<Result<void, QString>> maintenance();
+    
+    /**
+     * @brief Files that differ between two commits, or a commit and the working tree
+     * 
+     * Either hash may be empty to mean the working tree (not both). Changes
+     * stream in as batches, in path order for commit pairs; an error
+     * result ends the stream. Commit listings are cached, so comparing
+     * snapshots already seen costs an in-memory merge of two sorted lists.
+     * The working tree side is limited to the tracked paths.
+     */
+    QFuture<Result<QList<FileChange>, QString>> diff(const QString& fromCommit, const QString& toCommit);
+    
+    /**
+     * @brief Snapshots in which a file's content changed, newest first
+     * 
+     * Answered from the file history index, which commits keep current;
+     * only commits made outside GitService cost a git call to catch up.
+     * @param path Absolute or relative to the repository
+     */
+    QFuture<Result<QList<FileVersion>, QString>> fileHistory(const QString& path);
+    
+    /**
+     * @brief Overwrite one working tree file with its version in a commit
+     */
+    QFuture<Result<void, QString>> restoreFile(const QString& commitHash, const QString& path);
+    
+    /**
+     * @brief Check the working tree against the last checkout()
+     * 
+     * checkout() records every file's hash and stat data. A quick verify
+     * hashes only files whose size or modification time changed since;
+     * a deep verify hashes everything, in parallel across the pool.
+     */
+    QFuture<Result<VerifyReport, QString>> verifyRestore(VerifyMode mode);
+    
+    /**
+     * @brief Rewrite files from the last checkout()'s snapshot
+     * @param paths Relative paths, as in VerifyReport
+     */
+    QFuture<Result<void, QString>> repairRestore(const QStringList& paths);
+    
+    /**
+     * @brief Push snapshots the remote doesn't have yet, in batches
+     * 
+     * The remote may be any git URL; a local path or file:// URL that does
+     * not exist yet is created as a bare repository. Every batch moves the
+     * remote's main branch forward, so an interrupted sync resumes after
+     * the last batch that landed. Each batch is packed locally while the
+     * previous one is transferred, and git sends only objects the remote
+     * lacks. Batches count snapshots, not bytes: a single huge snapshot is
+     * one push, and an interruption sends it again from the start.
+     * 
+     * Refused for projects with region or delta files, whose content git
+     * push can't carry; those sync through uploadSnapshots().
+     */
+    QFuture<Result<SyncReport, QString>> pushSnapshots(const QString& remoteUrl);
+    
+    /**
+     * @brief Back up snapshots to a chunk remote ("chunks:<directory>")
+     * 
+     * Files are cut into content-defined chunks and only chunks the remote
+     * lacks are uploaded, found with batched existence queries. A file whose
+     * blob already has a recipe on the remote is not read at all, so a
+     * second machine with the same mods uploads little more than its
+     * snapshot manifests. Snapshots are stored oldest first; an interrupted
+     * backup resumes at the first snapshot without a manifest.
+     */
+    QFuture<Result<SyncReport, QString>> uploadSnapshots(const QString& remoteUrl);
+    
+    /**
+     * @brief Snapshots matching a search query, newest first
+     * 
+     * Searches every snapshot, not just the recent history listing. Served
+     * from an in-memory token index built from the file history index and
+     * extended with it on every commit and history refresh.
+     */
+    QFuture<Result<SnapshotSearchResult, QString>> searchSnapshots(const SnapshotQuery& query, int limit);
+    
 signals:
     void operationProgress(int percentage, const QString& status);
     
 private:
     QString m_repoPath;
     QString m_gitExecutable;  // Path to git binary
+    TrackedScope m_trackedScope;
+    ExecutionClass m_executionClass;
+    bool m_commitPipelineEnabled;
+    QStringList m_regionFiles;
+    QStringList m_deltaFiles;
+    std::atomic<bool> m_storageFiltersConfigured;
+    TreeCache m_treeCache;
+    FileHistoryIndex m_fileHistory;
+    SnapshotSearchIndex m_searchIndex;
+    QMutex m_fileHistoryMutex;   // Guards both indexes and m_fileHistoryLoaded
+    QMutex m_fileHistoryUpdateMutex;   // One updateFileHistory at a time; held across git calls
+    bool m_fileHistoryLoaded;
+    
+    /**
+     * @param timeoutMs -1 waits as long as git runs
+     */
+    Result<QString, QString> executeGitCommand(const QStringList& args, int timeoutMs = 30000);
+    bool startGitProcess(QProcess& process, const QStringList& args);
+    Result<QString, QString> finishGitProcess(QProcess& process, int timeoutMs, TraceSpan& span);
+    Result<SnapshotTablePtr, QString> readHistory(int limit);
+    Result<QStringList, QString> trackedPathspecs(const TrackedScope& scope);
+    
+    /**
+     * @brief Restage files that changed while git add was reading them
+     * 
+     * Only files whose stat moved since they were staged are touched: each
+     * is cloned (reflink where supported) into .git/vgvc/staging until a
+     * copy is taken with the source unchanged, and that copy is staged.
+     */
+    Result<void, QString> captureHotFiles(const QStringList& pathspecs);
+    
+    /**
+     * @brief Register the region and delta filters with git, and their patterns
+     * 
+     * Once per GitService; keeps the filters pointing at this vgvc-cli.
+     */
+    Result<void, QString> configureStorageFilters();
+    
+    /**
+     * @brief Snapshot files with their sizes on disk
+     * 
+     * Region and delta files are stored as small manifests; their entries
+     * carry the size of the file the manifest stands for, so diffs compare
+     * like with like.
+     */
+    Result<QSharedPointer<const TreeListing>, QString> treeListing(const QString& commit);
+    Result<void, QString> applyManifestSizes(TreeListing& listing);
+    
+    /**
+     * @brief Patterns stored through a filter now or by an earlier preset
+     */
+    QStringList storageFilterPatterns() const;
+    
+    /**
+     * @brief Pack the objects of commits (exclude, tip] not yet in a local pack
+     * 
+     * Snapshots are written as loose objects, which push's own pack-objects
+     * would have to deflate and delta-search before sending anything. Objects
+     * already in a pack are copied as they are (push reports them as
+     * "reused"), so packing batch n+1 while batch n uploads takes that work
+     * off the transfer's critical path.
+     */
+    Result<void, QString> packForPush(const QString& tip, const QString& exclude);
+    
+    /**
+     * @brief Chunk one file's content as git streams it, uploading new chunks
+     * @param size Bytes to read, or -1 to read until git exits
+     */
+    Result<ChunkRecipe, QString> uploadContent(ChunkRemote& remote, QProcess& source,
+                                               qint64 size, SyncReport& report);
+    
+    /**
+     * @brief Write the restore manifest for a commit just checked out
+     */
+    Result<void, QString> recordRestore(const QString& commitHash);
     
-    Result<QString, QString> executeGitCommand(const QStringList& args);
-    Result<Snapshot, QString> parseCommitLog(const QString& logLine);
+    /**
+     * @brief Index commits added since the last update
+     * 
+     * Extends the file history and search indexes together.
+     */
+    Result<void, QString> updateFileHistory();
+    Result<void, QString> diffCommits(const QString& fromCommit, const QString& toCommit,
+                                      const std::function<bool(const FileChange&)>& emitChange);
+    Result<void, QString> diffWorkingTree(const QString& commit, const TrackedScope& scope,
+                                          const std::function<bool(const FileChange&)>& emitChange);
     QString findGitExecutable();
 };
 
@@ -0,0 +1,62 @@
+#include "LocalChunkRemote.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+LocalChunkRemote::LocalChunkRemote(const QString& directory)
+    : m_directory(directory)
+{
+}
+
+Result<void, QString> LocalChunkRemote::open()
+{
+    if (!QDir().mkpath(QDir(m_directory).filePath("objects"))) {
+        return Result<void, QString>::err(QString("Cannot create %1").arg(m_directory));
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<QVector<bool>, QString> LocalChunkRemote::contains(const QVector<ObjectId>& keys)
+{
+    QVector<bool> present;
+    present.reserve(keys.size());
+    for (const ObjectId& key : keys) {
+        present.append(QFileInfo::exists(objectPath(key)));
+    }
+    return Result<QVector<bool>, QString>::ok(std::move(present));
+}
+
+Result<void, QString> LocalChunkRemote::put(const ObjectId& key, const QByteArray& data)
+{
+    QString path = objectPath(key);
+    if (QFileInfo::exists(path)) {
+        return Result<void, QString>::ok();
+    }
+
+    // Written whole or not at all: a crash never leaves a short object that
+    // contains() would report as present
+    QDir().mkpath(QFileInfo(path).path());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(data) != data.size()
+        || !file.commit()) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(path));
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<QByteArray, QString> LocalChunkRemote::get(const ObjectId& key)
+{
+    QFile file(objectPath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Result<QByteArray, QString>::err(QString("Missing object %1").arg(key.toHex()));
+    }
+    return Result<QByteArray, QString>::ok(file.readAll());
+}
+
+QString LocalChunkRemote::objectPath(const ObjectId& key) const
+{
+    QString hex = key.toHex();
+    return QDir(m_directory).filePath(QString("objects/%1/%2").arg(hex.left(2), hex.mid(2)));
+}
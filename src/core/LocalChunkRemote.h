@@ -0,0 +1,31 @@
+#ifndef LOCALCHUNKREMOTE_H
+#define LOCALCHUNKREMOTE_H
+
+#include <QString>
+#include "ChunkRemote.h"
+
+/**
+ * @brief Chunk remote in a plain directory
+ *
+ * One file per object under objects/<2 hex>/<38 hex>, written atomically,
+ * so several machines can back up into the same shared folder at once.
+ * The reference backend: a network backend implements the same calls as
+ * requests.
+ */
+class LocalChunkRemote : public ChunkRemote {
+public:
+    explicit LocalChunkRemote(const QString& directory);
+
+    Result<void, QString> open();
+
+    Result<QVector<bool>, QString> contains(const QVector<ObjectId>& keys) override;
+    Result<void, QString> put(const ObjectId& key, const QByteArray& data) override;
+    Result<QByteArray, QString> get(const ObjectId& key) override;
+
+private:
+    QString m_directory;
+
+    QString objectPath(const ObjectId& key) const;
+};
+
+#endif // LOCALCHUNKREMOTE_H
@@ -0,0 +1,233 @@
+#include "PresetBundle.h"
+#include <QDataStream>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QResource>
+#include <QtEndian>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr quint32 BundleMagic = 0x56475042;  // "VGPB"
+constexpr quint32 BundleVersion = 1;
+constexpr int HeaderSize = 12;               // Magic, version, entry count
+constexpr int ColumnCount = 3;               // Offset and length of each
+constexpr int EntrySize = ColumnCount * 8;
+constexpr int IdColumn = 0;
+constexpr int DetectionColumn = 1;
+constexpr int BodyColumn = 2;
+
+const char* const EmbeddedPath = ":/presets/presets.vgpb";
+
+// Byte order, which is what presetc sorts by
+int compareBytes(QByteArrayView a, QByteArrayView b)
+{
+    qsizetype common = qMin(a.size(), b.size());
+    int order = common > 0 ? std::memcmp(a.data(), b.data(), size_t(common)) : 0;
+    if (order != 0) {
+        return order;
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+QStringList toStringList(const QJsonValue& value)
+{
+    QStringList list;
+    for (const QJsonValue& item : value.toArray()) {
+        list.append(item.toString());
+    }
+    return list;
+}
+
+} // namespace
+
+PresetBundle::PresetBundle(const QByteArray& data)
+    : m_data(data)
+{
+    if (m_data.size() < HeaderSize
+        || qFromBigEndian<quint32>(m_data.constData()) != BundleMagic
+        || qFromBigEndian<quint32>(m_data.constData() + 4) != BundleVersion) {
+        return;
+    }
+
+    quint32 count = qFromBigEndian<quint32>(m_data.constData() + 8);
+    if (count > quint32((m_data.size() - HeaderSize) / EntrySize)) {
+        return;
+    }
+    m_count = int(count);
+}
+
+PresetBundle PresetBundle::embedded()
+{
+    QResource resource(EmbeddedPath);
+    if (!resource.isValid()) {
+        return PresetBundle();
+    }
+
+    // Built with rcc --no-compress, so this points straight into the binary
+    if (resource.compressionAlgorithm() == QResource::NoCompression) {
+        return PresetBundle(QByteArray::fromRawData(
+            reinterpret_cast<const char*>(resource.data()), resource.size()));
+    }
+    return PresetBundle(resource.uncompressedData());
+}
+
+QByteArrayView PresetBundle::field(int entry, int column) const
+{
+    if (entry < 0 || entry >= count()) {
+        return QByteArrayView();
+    }
+
+    const char* location = m_data.constData() + HeaderSize + entry * EntrySize + column * 8;
+    quint32 offset = qFromBigEndian<quint32>(location);
+    quint32 length = qFromBigEndian<quint32>(location + 4);
+    if (qint64(offset) + length > m_data.size()) {
+        return QByteArrayView();
+    }
+    return QByteArrayView(m_data.constData() + offset, length);
+}
+
+QString PresetBundle::gameId(int entry) const
+{
+    return QString::fromUtf8(field(entry, IdColumn));
+}
+
+int PresetBundle::find(const QString& gameId) const
+{
+    const QByteArray key = gameId.toUtf8();
+
+    int low = 0;
+    int high = count() - 1;
+    while (low <= high) {
+        int middle = low + (high - low) / 2;
+        int order = compareBytes(field(middle, IdColumn), key);
+        if (order == 0) {
+            return middle;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return -1;
+}
+
+Result<GamePreset, QString> PresetBundle::preset(int entry) const
+{
+    QByteArrayView body = field(entry, BodyColumn);
+    QDataStream in(QByteArray::fromRawData(body.data(), body.size()));
+    in.setVersion(QDataStream::Qt_6_0);
+
+    GamePreset preset;
+    in >> preset.gameId >> preset.displayName >> preset.steamAppId >> preset.detectionPaths
+       >> preset.trackedPaths >> preset.ignorePatterns >> preset.regionFiles >> preset.deltaFiles
+       >> preset.largeFileWarningMB;
+
+    if (in.status() != QDataStream::Ok || !preset.isValid()) {
+        return Result<GamePreset, QString>::err(QString("Corrupt preset bundle entry %1").arg(entry));
+    }
+    return Result<GamePreset, QString>::ok(std::move(preset));
+}
+
+Result<PresetBundle::Detection, QString> PresetBundle::detection(int entry) const
+{
+    QByteArrayView record = field(entry, DetectionColumn);
+    QDataStream in(QByteArray::fromRawData(record.data(), record.size()));
+    in.setVersion(QDataStream::Qt_6_0);
+
+    Detection detection;
+    in >> detection.steamAppId >> detection.paths;
+
+    if (in.status() != QDataStream::Ok) {
+        return Result<Detection, QString>::err(QString("Corrupt preset bundle entry %1").arg(entry));
+    }
+    return Result<Detection, QString>::ok(std::move(detection));
+}
+
+Result<GamePreset, QString> PresetBundle::parseJson(const QByteArray& json)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(json);
+    if (!doc.isObject()) {
+        return Result<GamePreset, QString>::err("Invalid JSON format");
+    }
+
+    QJsonObject obj = doc.object();
+    GamePreset preset;
+
+    preset.gameId = obj["game_id"].toString();
+    preset.displayName = obj["display_name"].toString();
+    preset.steamAppId = obj["steam_app_id"].toVariant().toString();
+    preset.largeFileWarningMB = obj["large_file_warning_mb"].toInteger(5000);
+
+    QJsonObject detection = obj["detection"].toObject();
+    for (auto it = detection.constBegin(); it != detection.constEnd(); ++it) {
+        preset.detectionPaths[it.key()] = toStringList(it.value());
+    }
+
+    preset.trackedPaths = toStringList(obj["tracked_paths"]);
+    preset.ignorePatterns = toStringList(obj["ignore_patterns"]);
+    preset.regionFiles = toStringList(obj["region_files"]);     // Optional
+    preset.deltaFiles = toStringList(obj["delta_files"]);       // Optional
+
+    if (!preset.isValid()) {
+        return Result<GamePreset, QString>::err("Preset validation failed");
+    }
+    return Result<GamePreset, QString>::ok(std::move(preset));
+}
+
+Result<QByteArray, QString> PresetBundle::compile(const QList<GamePreset>& presets)
+{
+    // Keyed by UTF-8 so the table is in the order find() searches
+    QMap<QByteArray, const GamePreset*> sorted;
+    for (const GamePreset& preset : presets) {
+        QByteArray key = preset.gameId.toUtf8();
+        if (sorted.contains(key)) {
+            return Result<QByteArray, QString>::err(QString("Duplicate preset %1").arg(preset.gameId));
+        }
+        sorted.insert(key, &preset);
+    }
+
+    const qint64 blobStart = HeaderSize + qint64(sorted.size()) * EntrySize;
+    QByteArray table(int(blobStart), Qt::Uninitialized);
+    QByteArray blobs;
+    uchar* out = reinterpret_cast<uchar*>(table.data());
+    qToBigEndian(BundleMagic, out);
+    qToBigEndian(BundleVersion, out + 4);
+    qToBigEndian(quint32(sorted.size()), out + 8);
+    out += HeaderSize;
+
+    auto appendColumn = [&](const QByteArray& bytes) {
+        qToBigEndian(quint32(blobStart + blobs.size()), out);
+        qToBigEndian(quint32(bytes.size()), out + 4);
+        out += 8;
+        blobs.append(bytes);
+    };
+
+    for (auto it = sorted.constBegin(); it != sorted.constEnd(); ++it) {
+        const GamePreset& preset = *it.value();
+
+        QByteArray detection;
+        QDataStream detectionOut(&detection, QIODevice::WriteOnly);
+        detectionOut.setVersion(QDataStream::Qt_6_0);
+        detectionOut << preset.steamAppId << preset.detectionPaths;
+
+        QByteArray body;
+        QDataStream bodyOut(&body, QIODevice::WriteOnly);
+        bodyOut.setVersion(QDataStream::Qt_6_0);
+        bodyOut << preset.gameId << preset.displayName << preset.steamAppId << preset.detectionPaths
+                << preset.trackedPaths << preset.ignorePatterns << preset.regionFiles << preset.deltaFiles
+                << preset.largeFileWarningMB;
+
+        appendColumn(it.key());
+        appendColumn(detection);
+        appendColumn(body);
+    }
+
+    if (blobStart + blobs.size() > qint64(std::numeric_limits<quint32>::max())) {
+        return Result<QByteArray, QString>::err("Preset bundle exceeds 4 GiB");
+    }
+    return Result<QByteArray, QString>::ok(table + blobs);
+}
@@ -0,0 +1,79 @@
+#ifndef PRESETBUNDLE_H
+#define PRESETBUNDLE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include "types/GamePreset.h"
+#include "types/Result.h"
+
+/**
+ * @brief Every built-in preset, compiled into one binary blob
+ *
+ * The presetc build step parses resources/presets/*.json and writes a
+ * bundle that is embedded in the executable as an uncompressed Qt
+ * resource, so opening it is a pointer into the binary. A fixed-size entry
+ * table sorted by game ID comes first and is read in place: finding a
+ * preset is a binary search and only that preset's body is decoded.
+ * Detection data is stored apart from the bodies so building the
+ * detection index does not decode whole presets.
+ */
+class PresetBundle {
+public:
+    /**
+     * @brief What game detection needs from a preset
+     */
+    struct Detection {
+        QString steamAppId;
+        QMap<QString, QStringList> paths;    // platform -> list of common paths
+    };
+
+    /**
+     * @brief Empty bundle; isValid() is false
+     */
+    PresetBundle() = default;
+
+    /**
+     * @param data Bundle bytes; not copied when built with QByteArray::fromRawData
+     */
+    explicit PresetBundle(const QByteArray& data);
+
+    /**
+     * @brief The bundle compiled into this executable
+     */
+    static PresetBundle embedded();
+
+    bool isValid() const { return m_count >= 0; }
+    int count() const { return qMax(m_count, 0); }
+
+    QString gameId(int entry) const;
+
+    /**
+     * @return Entry index, or -1 if the bundle has no such preset
+     */
+    int find(const QString& gameId) const;
+
+    Result<GamePreset, QString> preset(int entry) const;
+    Result<Detection, QString> detection(int entry) const;
+
+    /**
+     * @brief Parse one preset file's JSON
+     */
+    static Result<GamePreset, QString> parseJson(const QByteArray& json);
+
+    /**
+     * @brief Build a bundle; fails on duplicate game IDs
+     */
+    static Result<QByteArray, QString> compile(const QList<GamePreset>& presets);
+
+private:
+    QByteArray m_data;
+    int m_count = -1;
+
+    QByteArrayView field(int entry, int column) const;
+};
+
+#endif // PRESETBUNDLE_H
@@ -0,0 +1,81 @@
+#include "PresetIndex.h"
+#include "utils/PathDetector.h"
+#include <QDir>
+
+PresetIndex::PresetIndex()
+{
+    clear();
+}
+
+void PresetIndex::clear()
+{
+    m_nodes.clear();
+    m_nodes.append(Node());
+    m_steamAppIds.clear();
+}
+
+QStringList PresetIndex::pathComponents(const QString& path)
+{
+    QString normalized = QDir::cleanPath(
+        QDir::fromNativeSeparators(PathDetector::expandPath(path)));
+
+    // Detection is case-insensitive on every platform
+    return normalized.toCaseFolded().split('/', Qt::SkipEmptyParts);
+}
+
+void PresetIndex::addPath(const QString& detectionPath, const QString& gameId)
+{
+    const QStringList components = pathComponents(detectionPath);
+    if (components.isEmpty()) {
+        return;
+    }
+
+    int node = 0;
+    for (const QString& component : components) {
+        auto it = m_nodes[node].children.constFind(component);
+        if (it != m_nodes[node].children.constEnd()) {
+            node = it.value();
+        } else {
+            int child = m_nodes.size();
+            m_nodes.append(Node());
+            m_nodes[node].children.insert(component, child);
+            node = child;
+        }
+    }
+
+    // First preset to claim a path wins, matching the old iteration order
+    if (m_nodes[node].gameId.isEmpty()) {
+        m_nodes[node].gameId = gameId;
+    }
+}
+
+void PresetIndex::addSteamAppId(const QString& appId, const QString& gameId)
+{
+    if (!appId.isEmpty() && !m_steamAppIds.contains(appId)) {
+        m_steamAppIds.insert(appId, gameId);
+    }
+}
+
+QString PresetIndex::lookupPath(const QString& path) const
+{
+    QString match;
+    int node = 0;
+
+    for (const QString& component : pathComponents(path)) {
+        auto it = m_nodes[node].children.constFind(component);
+        if (it == m_nodes[node].children.constEnd()) {
+            break;
+        }
+        node = it.value();
+        if (!m_nodes[node].gameId.isEmpty()) {
+            match = m_nodes[node].gameId;
+        }
+    }
+
+    return match;
+}
+
+QString PresetIndex::lookupSteamAppId(const QString& appId) const
+{
+    return m_steamAppIds.value(appId);
+}
@@ -0,0 +1,61 @@
+#ifndef PRESETINDEX_H
+#define PRESETINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+
+/**
+ * @brief Precompiled lookup structure for game detection
+ *
+ * Detection paths are normalized once (~ and environment variables
+ * expanded, separators unified, case folded) and stored in a trie keyed on
+ * path components. Looking up a directory walks its components once and
+ * returns the deepest preset whose detection path is a prefix of it, so the
+ * cost is independent of how many presets are loaded.
+ */
+class PresetIndex {
+public:
+    PresetIndex();
+
+    void clear();
+
+    /**
+     * @brief Register a detection path for a preset
+     */
+    void addPath(const QString& detectionPath, const QString& gameId);
+
+    /**
+     * @brief Register a Steam app ID for a preset
+     */
+    void addSteamAppId(const QString& appId, const QString& gameId);
+
+    /**
+     * @brief Find the preset whose detection path contains the given path
+     * @return Game ID, or an empty string if no preset matches
+     */
+    QString lookupPath(const QString& path) const;
+
+    /**
+     * @brief Find the preset registered for a Steam app ID
+     * @return Game ID, or an empty string if no preset matches
+     */
+    QString lookupSteamAppId(const QString& appId) const;
+
+    /**
+     * @brief Normalize a path into lookup components
+     */
+    static QStringList pathComponents(const QString& path);
+
+private:
+    struct Node {
+        QHash<QString, int> children;  // component -> node index
+        QString gameId;                // Set if a detection path ends here
+    };
+
+    QVector<Node> m_nodes;             // m_nodes[0] is the root
+    QHash<QString, QString> m_steamAppIds;
+};
+
+#endif // PRESETINDEX_H
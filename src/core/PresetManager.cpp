@@ -1,138 +1,112 @@
 #include "PresetManager.h"
 #include <QFile>
 #include <QDir>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QCoreApplication>
+#include <QTextStream>
+#include "utils/PathDetector.h"
 
 PresetManager::PresetManager(QObject* parent)
     : QObject(parent)
+    , m_bundle(PresetBundle::embedded())
+    , m_indexBuilt(false)
 {
-    // Load built-in presets on construction
-    loadBuiltInPresets();
+    // Nothing is decoded until a preset or a detection is requested, so
+    // startup does not grow with the number of presets
 }
 
 Result<QList<GamePreset>, QString> PresetManager::loadBuiltInPresets()
 {
-    m_presets.clear();
-    QList<GamePreset> presetList;
-    
-    // Get presets directory
-    QString presetsPath = QCoreApplication::applicationDirPath() + "/resources/presets";
-    QDir presetsDir(presetsPath);
-    
-    if (!presetsDir.exists()) {
-        return Result<QList<GamePreset>, QString>::err("Presets directory not found");
+    if (!m_bundle.isValid()) {
+        return Result<QList<GamePreset>, QString>::err("Built-in presets are missing");
     }
     
-    // Load all .json files
-    QStringList filters;
-    filters << "*.json";
-    QFileInfoList files = presetsDir.entryInfoList(filters, QDir::Files);
+    QList<GamePreset> presetList;
+    presetList.reserve(m_bundle.count());
     
-    for (const QFileInfo& fileInfo : files) {
-        auto result = parsePresetFile(fileInfo.absoluteFilePath());
+    for (int entry = 0; entry < m_bundle.count(); ++entry) {
+        auto result = loadPreset(m_bundle.gameId(entry));
         if (result.isOk()) {
-            GamePreset preset = result.value();
-            m_presets[preset.gameId] = preset;
-            presetList.append(preset);
+            presetList.append(result.takeValue());
         }
     }
     
     return Result<QList<GamePreset>, QString>::ok(presetList);
 }
 
-Result<GamePreset, QString> PresetManager::parsePresetFile(const QString& filePath)
+Result<GamePreset, QString> PresetManager::loadPreset(const QString& presetId)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return Result<GamePreset, QString>::err("Failed to open preset file");
+    QMutexLocker locker(&m_presetsMutex);
+    auto cached = m_presets.constFind(presetId);
+    if (cached != m_presets.constEnd()) {
+        return Result<GamePreset, QString>::ok(cached.value());
     }
     
-    QByteArray data = file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    
-    if (!doc.isObject()) {
-        return Result<GamePreset, QString>::err("Invalid JSON format");
-    }
-    
-    QJsonObject obj = doc.object();
-    GamePreset preset;
-    
-    preset.gameId = obj["game_id"].toString();
-    preset.displayName = obj["display_name"].toString();
-    preset.largeFileWarningMB = obj["large_file_warning_mb"].toInteger(5000);
-    
-    // Parse detection paths
-    QJsonObject detection = obj["detection"].toObject();
-    for (const QString& platform : detection.keys()) {
-        QJsonArray paths = detection[platform].toArray();
-        QStringList pathList;
-        for (const QJsonValue& val : paths) {
-            pathList.append(val.toString());
-        }
-        preset.detectionPaths[platform] = pathList;
-    }
-    
-    // Parse tracked paths
-    QJsonArray tracked = obj["tracked_paths"].toArray();
-    for (const QJsonValue& val : tracked) {
-        preset.trackedPaths.append(val.toString());
-    }
-    
-    // Parse ignore patterns
-    QJsonArray ignore = obj["ignore_patterns"].toArray();
-    for (const QJsonValue& val : ignore) {
-        preset.ignorePatterns.append(val.toString());
+    int entry = m_bundle.find(presetId);
+    if (entry < 0) {
+        return Result<GamePreset, QString>::err("Preset not found");
     }
     
-    if (!preset.isValid()) {
-        return Result<GamePreset, QString>::err("Preset validation failed");
+    auto result = m_bundle.preset(entry);
+    if (result.isOk()) {
+        m_presets.insert(presetId, result.value());
     }
-    
-    return Result<GamePreset, QString>::ok(preset);
+    return result;
 }
 
-Result<GamePreset, QString> PresetManager::loadPreset(const QString& presetId)
+void PresetManager::ensureIndex()
 {
-    if (!m_presets.contains(presetId)) {
-        return Result<GamePreset, QString>::err("Preset not found");
-    }
-    
-    return Result<GamePreset, QString>::ok(m_presets[presetId]);
+    QMutexLocker locker(&m_indexMutex);
+    buildIndex();
 }
 
-Result<QString, QString> PresetManager::detectGame(const QString& path)
+void PresetManager::buildIndex()
 {
-    // Try to detect which game preset matches the given path
-    for (auto it = m_presets.begin(); it != m_presets.end(); ++it) {
-        const GamePreset& preset = it.value();
-        
-        // Check detection paths for current platform
+    if (m_indexBuilt) {
+        return;
+    }
+    m_indexBuilt = true;
+    
 #ifdef Q_OS_WIN
-        QString platform = "windows";
+    QString platform = "windows";
 #elif defined(Q_OS_MAC)
-        QString platform = "macos";
+    QString platform = "macos";
 #else
-        QString platform = "linux";
+    QString platform = "linux";
 #endif
+    
+    // The bundle is sorted by gameId, so overlapping paths resolve the same
+    // way the old linear scan did. Only the detection records are decoded.
+    for (int entry = 0; entry < m_bundle.count(); ++entry) {
+        auto detection = m_bundle.detection(entry);
+        if (detection.isErr()) {
+            continue;
+        }
         
-        if (preset.detectionPaths.contains(platform)) {
-            const QStringList& paths = preset.detectionPaths[platform];
-            for (const QString& detectionPath : paths) {
-                // Expand ~ to home directory
-                QString expandedPath = detectionPath;
-                if (expandedPath.startsWith("~")) {
-                    expandedPath = QDir::homePath() + expandedPath.mid(1);
-                }
-                
-                // Check if the path matches
-                if (path.contains(expandedPath, Qt::CaseInsensitive)) {
-                    return Result<QString, QString>::ok(preset.gameId);
-                }
-            }
+        const QString gameId = m_bundle.gameId(entry);
+        for (const QString& detectionPath : detection.value().paths.value(platform)) {
+            m_index.addPath(detectionPath, gameId);
         }
+        m_index.addSteamAppId(detection.value().steamAppId, gameId);
+    }
+    
+    // Games in secondary Steam libraries: their install directories join
+    // the trie, so detection stays a single lookup after this one scan
+    for (const SteamInstall& install : PathDetector::getSteamInstalls()) {
+        QString gameId = m_index.lookupSteamAppId(install.appId);
+        if (!gameId.isEmpty()) {
+            m_index.addPath(install.installPath, gameId);
+        }
+    }
+}
+
+Result<QString, QString> PresetManager::detectGame(const QString& path)
+{
+    QMutexLocker locker(&m_indexMutex);
+    buildIndex();
+    
+    // Known install location for the current platform, or a Steam library
+    QString gameId = m_index.lookupPath(path);
+    if (!gameId.isEmpty()) {
+        return Result<QString, QString>::ok(gameId);
     }
     
     return Result<QString, QString>::err("Game not detected");
@@ -143,11 +117,26 @@ Result<void, QString> PresetManager::applyPreset(const QString& repoPath, const
     // Create .gitignore file with preset's ignore patterns
     createGitignore(repoPath, preset.ignorePatterns);
     
-    // TODO: Apply tracked paths configuration if needed
+    // Tracked paths are not written to disk: GitService::setTrackedPaths
+    // restricts what each snapshot scans and stores
     
     return Result<void, QString>::ok();
 }
 
+PatternMatcher PresetManager::ignoreMatcher(const GamePreset& preset)
+{
+    QMutexLocker locker(&m_presetsMutex);
+    auto it = m_ignoreMatchers.constFind(preset.gameId);
+    if (it != m_ignoreMatchers.constEnd()) {
+        return it.value();
+    }
+    
+    // Git never tracks its own directory, so never scan it either
+    PatternMatcher matcher(QStringList(preset.ignorePatterns) << ".git/");
+    m_ignoreMatchers.insert(preset.gameId, matcher);
+    return matcher;
+}
+
 void PresetManager::createGitignore(const QString& repoPath, const QStringList& patterns)
 {
     QString gitignorePath = repoPath + "/.gitignore";
@@ -2,14 +2,24 @@
 #define PRESETMANAGER_H
 
 #include <QObject>
-#include <QMap>
+#include <QHash>
+#include <QMutex>
 #include "types/Result.h"
 #include "types/GamePreset.h"
+#include "PresetBundle.h"
+#include "PresetIndex.h"
+#include "utils/PatternMatcher.h"
 
 /**
  * @brief Manages game presets and .gitignore configuration
  * 
  * Loads built-in game presets and applies them to repositories.
+ * Presets come from the bundle embedded at build time: construction only
+ * checks its header, a preset is decoded the first time it is requested,
+ * and the detection index is built on the first detection. Building it
+ * scans the Steam libraries once, so games installed after that are found
+ * by their preset detection paths only. Loading, matching and detection are
+ * thread-safe; applyPreset writes files and belongs to one caller.
  */
 class PresetManager : public QObject {
     Q_OBJECT
@@ -18,15 +28,46 @@ public:
     explicit PresetManager(QObject* parent = nullptr);
     ~PresetManager() override = default;
     
+    /**
+     * @brief Decode every built-in preset
+     */
     Result<QList<GamePreset>, QString> loadBuiltInPresets();
     Result<GamePreset, QString> loadPreset(const QString& presetId);
+    
+    /**
+     * @brief Find the game installed at a path
+     * 
+     * Thread-safe. The first call builds the detection index, which scans
+     * the Steam libraries, so the UI runs it on a pool thread.
+     */
     Result<QString, QString> detectGame(const QString& path);
     Result<void, QString> applyPreset(const QString& repoPath, const GamePreset& preset);
     
+    /**
+     * @brief Compiled matcher for a preset's ignore patterns (and .git/)
+     * 
+     * Compiled on first use and cached per preset.
+     */
+    PatternMatcher ignoreMatcher(const GamePreset& preset);
+    
+    /**
+     * @brief Build the detection index now instead of on the first detection
+     * 
+     * Includes the Steam library scan, so long-running processes call this
+     * at startup rather than while a request waits.
+     */
+    void ensureIndex();
+    
 private:
-    QMap<QString, GamePreset> m_presets;
+    PresetBundle m_bundle;
+    QMutex m_presetsMutex;                   // Guards m_presets and m_ignoreMatchers
+    QHash<QString, GamePreset> m_presets;    // Decoded so far
+    QMutex m_indexMutex;                     // Guards m_index and m_indexBuilt
+    PresetIndex m_index;
+    bool m_indexBuilt;
+    QHash<QString, PatternMatcher> m_ignoreMatchers;
     
-    Result<GamePreset, QString> parsePresetFile(const QString& filePath);
+    void buildIndex();
     void createGitignore(const QString& repoPath, const QStringList& patterns);
 };
 
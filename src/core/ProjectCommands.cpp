@@ -0,0 +1,167 @@
+#include "ProjectCommands.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include "GitService.h"
+#include "PresetManager.h"
+#include "SnapshotManager.h"
+
+namespace {
+
+template<typename T>
+T await(QFuture<T> future)
+{
+    future.waitForFinished();
+    return future.takeResult();
+}
+
+Result<void, QString> requireRepository(const QString& path)
+{
+    if (!QDir(path).exists(".git")) {
+        return Result<void, QString>::err(QString("No snapshots in %1").arg(path));
+    }
+    return Result<void, QString>::ok();
+}
+
+} // namespace
+
+Result<QJsonObject, QString> ProjectCommands::snapshot(const QString& path, const QString& message,
+                                                       const GamePreset& preset,
+                                                       ExecutionClass executionClass)
+{
+    if (!QFileInfo(path).isDir()) {
+        return Result<QJsonObject, QString>::err(QString("Not a directory: %1").arg(path));
+    }
+
+    GitService gitService(path);
+    gitService.setTrackedPaths(preset.trackedPaths);
+    gitService.setRegionFiles(preset.regionFiles);
+    gitService.setDeltaFiles(preset.deltaFiles);
+    gitService.setExecutionClass(executionClass);
+    SnapshotManager snapshotManager(&gitService);
+
+    if (!QDir(path).exists(".git")) {
+        auto initResult = await(gitService.init());
+        if (initResult.isErr()) {
+            return Result<QJsonObject, QString>::err(initResult.error());
+        }
+        if (preset.isValid()) {
+            PresetManager().applyPreset(path, preset);
+        }
+    } else {
+        // Hooks and schedules fire whether or not anything changed
+        auto changesResult = await(gitService.hasChanges());
+        if (changesResult.isOk() && !changesResult.value()) {
+            return Result<QJsonObject, QString>::ok(QJsonObject{{"status", "unchanged"}});
+        }
+    }
+
+    auto createResult = await(snapshotManager.createSnapshot(message));
+    if (createResult.isErr()) {
+        return Result<QJsonObject, QString>::err(createResult.error());
+    }
+
+    QJsonObject result{{"status", "created"}};
+    if (preset.isValid()) {
+        result["game"] = preset.gameId;
+    }
+    auto historyResult = await(gitService.getHistory(1));
+    if (historyResult.isOk() && !historyResult.value().isEmpty()) {
+        result["snapshot"] = toJson(historyResult.takeValue().first());
+    }
+    return Result<QJsonObject, QString>::ok(result);
+}
+
+Result<QJsonObject, QString> ProjectCommands::list(const QString& path, int limit)
+{
+    auto repoResult = requireRepository(path);
+    if (repoResult.isErr()) {
+        return Result<QJsonObject, QString>::err(repoResult.error());
+    }
+
+    GitService gitService(path);
+    auto result = await(gitService.getHistory(limit));
+    if (result.isErr()) {
+        return Result<QJsonObject, QString>::err(result.error());
+    }
+
+    QJsonArray snapshots;
+    for (const Snapshot& snapshot : result.value()) {
+        snapshots.append(toJson(snapshot));
+    }
+    return Result<QJsonObject, QString>::ok(QJsonObject{{"snapshots", snapshots}});
+}
+
+Result<QJsonObject, QString> ProjectCommands::restore(const QString& path, const QString& snapshotId,
+                                                      const GamePreset& preset)
+{
+    auto repoResult = requireRepository(path);
+    if (repoResult.isErr()) {
+        return Result<QJsonObject, QString>::err(repoResult.error());
+    }
+
+    // The safety backup taken before restoring must use the same scope
+    GitService gitService(path);
+    gitService.setTrackedPaths(preset.trackedPaths);
+    gitService.setRegionFiles(preset.regionFiles);
+    gitService.setDeltaFiles(preset.deltaFiles);
+    SnapshotManager snapshotManager(&gitService);
+
+    auto result = await(snapshotManager.restoreSnapshot(snapshotId));
+    if (result.isErr()) {
+        return Result<QJsonObject, QString>::err(result.error());
+    }
+    return Result<QJsonObject, QString>::ok(QJsonObject{{"snapshot", snapshotId}});
+}
+
+Result<QJsonObject, QString> ProjectCommands::exportSnapshot(const QString& path, const QString& snapshotId,
+                                                             const QString& archivePath)
+{
+    auto repoResult = requireRepository(path);
+    if (repoResult.isErr()) {
+        return Result<QJsonObject, QString>::err(repoResult.error());
+    }
+
+    GitService gitService(path);
+    SnapshotManager snapshotManager(&gitService);
+
+    QString absoluteArchive = QFileInfo(archivePath).absoluteFilePath();
+    auto result = await(snapshotManager.exportSnapshot(snapshotId, absoluteArchive));
+    if (result.isErr()) {
+        return Result<QJsonObject, QString>::err(result.error());
+    }
+
+    return Result<QJsonObject, QString>::ok(QJsonObject{
+        {"snapshot", snapshotId},
+        {"archive", absoluteArchive},
+        {"sizeBytes", QFileInfo(absoluteArchive).size()}
+    });
+}
+
+Result<QJsonObject, QString> ProjectCommands::maintenance(const QString& path,
+                                                          ExecutionClass executionClass)
+{
+    auto repoResult = requireRepository(path);
+    if (repoResult.isErr()) {
+        return Result<QJsonObject, QString>::err(repoResult.error());
+    }
+
+    GitService gitService(path);
+    gitService.setExecutionClass(executionClass);
+    auto result = await(gitService.maintenance());
+    if (result.isErr()) {
+        return Result<QJsonObject, QString>::err(result.error());
+    }
+    return Result<QJsonObject, QString>::ok(QJsonObject());
+}
+
+QJsonObject ProjectCommands::toJson(const Snapshot& snapshot)
+{
+    QJsonObject json;
+    json["id"] = snapshot.id;
+    json["description"] = snapshot.description;
+    json["timestamp"] = snapshot.timestamp.toString(Qt::ISODate);
+    json["author"] = snapshot.author;
+    json["automatic"] = snapshot.isAutomatic;
+    return json;
+}
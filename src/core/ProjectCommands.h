@@ -0,0 +1,54 @@
+#ifndef PROJECTCOMMANDS_H
+#define PROJECTCOMMANDS_H
+
+#include <QJsonObject>
+#include <QString>
+#include "types/GamePreset.h"
+#include "types/Result.h"
+#include "types/Snapshot.h"
+#include "utils/ExecutionPolicy.h"
+
+/**
+ * @brief Blocking, self-contained project operations with JSON results
+ *
+ * Shared by vgvc-cli (run directly) and the vgvcd daemon (run on its job
+ * pool), so both report identical result objects. Each call creates its
+ * own GitService, so calls for different projects may run concurrently.
+ * The preset is resolved by the caller because PresetManager is not
+ * thread-safe; pass an invalid preset to track the whole directory.
+ */
+class ProjectCommands {
+public:
+    /**
+     * @brief Snapshot a directory, initializing its repository on first use
+     * @return {"status": "created"|"unchanged", "snapshot": {...}}
+     */
+    static Result<QJsonObject, QString> snapshot(const QString& path, const QString& message,
+                                                 const GamePreset& preset,
+                                                 ExecutionClass executionClass = ExecutionClass::Foreground);
+
+    /**
+     * @brief Snapshot history, newest first
+     * @return {"snapshots": [...]}
+     */
+    static Result<QJsonObject, QString> list(const QString& path, int limit);
+
+    /**
+     * @brief Restore a snapshot after a safety backup of the preset's scope
+     */
+    static Result<QJsonObject, QString> restore(const QString& path, const QString& snapshotId,
+                                                const GamePreset& preset);
+
+    static Result<QJsonObject, QString> exportSnapshot(const QString& path, const QString& snapshotId,
+                                                       const QString& archivePath);
+
+    /**
+     * @brief Repack and prune when git thinks it is worthwhile
+     */
+    static Result<QJsonObject, QString> maintenance(const QString& path,
+                                                    ExecutionClass executionClass = ExecutionClass::Foreground);
+
+    static QJsonObject toJson(const Snapshot& snapshot);
+};
+
+#endif // PROJECTCOMMANDS_H
@@ -1,7 +1,34 @@
 #include "ProjectConfig.h"
 #include <QFile>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QSaveFile>
+
+namespace {
+
+QJsonObject snapshotToJson(const Snapshot& snapshot)
+{
+    QJsonObject obj;
+    obj["id"] = snapshot.id;
+    obj["description"] = snapshot.description;
+    obj["timestamp"] = snapshot.timestamp.toSecsSinceEpoch();
+    obj["author"] = snapshot.author;
+    return obj;
+}
+
+Snapshot snapshotFromJson(const QJsonObject& obj)
+{
+    Snapshot snapshot;
+    snapshot.id = obj["id"].toString();
+    snapshot.description = obj["description"].toString();
+    snapshot.timestamp = QDateTime::fromSecsSinceEpoch(obj["timestamp"].toInteger());
+    snapshot.author = obj["author"].toString();
+    snapshot.isAutomatic = snapshot.description.startsWith("[AUTO]");
+    return snapshot;
+}
+
+} // namespace
 
 ProjectConfig::ProjectConfig()
 {
@@ -14,6 +41,7 @@ void ProjectConfig::setDefaults()
     maxSnapshots = 50;
     maxSizeBytes = 5 * 1024 * 1024 * 1024LL;  // 5GB
     cloudSyncEnabled = false;
+    cachedSizeBytes = -1;
 }
 
 bool ProjectConfig::load(const QString& configPath)
@@ -46,6 +74,14 @@ bool ProjectConfig::load(const QString& configPath)
         lastSyncTime = QDateTime::fromString(lastSyncStr, Qt::ISODate);
     }
     
+    lastOpened = QDateTime::fromString(obj["last_opened"].toString(), Qt::ISODate);
+    headSnapshotId = obj["head_snapshot"].toString();
+    cachedSizeBytes = obj["cached_size_bytes"].toInteger(-1);
+    historyPage.clear();
+    for (const QJsonValue& value : obj["history_page"].toArray()) {
+        historyPage.append(snapshotFromJson(value.toObject()));
+    }
+    
     return true;
 }
 
@@ -65,13 +101,25 @@ bool ProjectConfig::save(const QString& configPath) const
         obj["last_sync_time"] = lastSyncTime.toString(Qt::ISODate);
     }
     
+    if (lastOpened.isValid()) {
+        obj["last_opened"] = lastOpened.toString(Qt::ISODate);
+    }
+    obj["head_snapshot"] = headSnapshotId;
+    obj["cached_size_bytes"] = cachedSizeBytes;
+    QJsonArray history;
+    for (const Snapshot& snapshot : historyPage) {
+        history.append(snapshotToJson(snapshot));
+    }
+    obj["history_page"] = history;
+    
     QJsonDocument doc(obj);
     
-    QFile file(configPath);
+    // Rewritten on every refresh, so never leave it half-written
+    QSaveFile file(configPath);
     if (!file.open(QIODevice::WriteOnly)) {
         return false;
     }
     
-    file.write(doc.toJson());
-    return true;
+    file.write(doc.toJson(QJsonDocument::Compact));
+    return file.commit();
 }
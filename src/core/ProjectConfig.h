@@ -3,11 +3,14 @@
 
 #include <QString>
 #include <QDateTime>
+#include <QList>
+#include "types/Snapshot.h"
 
 /**
  * @brief Per-project configuration
  * 
- * Stores settings specific to each game project.
+ * Stores settings specific to each game project, plus the state last seen
+ * in its repository so the project can be shown before git is asked.
  */
 class ProjectConfig {
 public:
@@ -28,6 +31,12 @@ public:
     QString remoteUrl;
     QDateTime lastSyncTime;
     
+    // Last-known state; may be stale until the repository is read again
+    QDateTime lastOpened;
+    QString headSnapshotId;        // Newest snapshot, empty if none
+    qint64 cachedSizeBytes;        // Tracked files, -1 if never measured
+    QList<Snapshot> historyPage;   // Newest snapshots as last listed
+    
     // Load/save configuration
     bool load(const QString& configPath);
     bool save(const QString& configPath) const;
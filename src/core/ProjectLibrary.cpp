@@ -0,0 +1,95 @@
+#include "ProjectLibrary.h"
+#include "ProjectRegistry.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <algorithm>
+
+ProjectLibrary::ProjectLibrary()
+{
+}
+
+QString ProjectLibrary::defaultDirectory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation))
+        .filePath("projects");
+}
+
+Result<void, QString> ProjectLibrary::load(const QString& directory)
+{
+    m_directory = directory;
+    m_projects.clear();
+
+    QDir dir(directory);
+    if (!dir.exists()) {
+        return Result<void, QString>::ok();  // Nothing opened yet
+    }
+
+    for (const QFileInfo& info : dir.entryInfoList(QStringList() << "*.json", QDir::Files)) {
+        ProjectConfig config;
+        if (!config.load(info.absoluteFilePath()) || config.projectPath.isEmpty()) {
+            continue;
+        }
+        config.projectPath = ProjectRegistry::normalizePath(config.projectPath);
+        m_projects.insert(config.projectPath, config);
+    }
+    return Result<void, QString>::ok();
+}
+
+QList<ProjectConfig> ProjectLibrary::projects() const
+{
+    QList<ProjectConfig> projects = m_projects.values();
+    std::sort(projects.begin(), projects.end(), [](const ProjectConfig& a, const ProjectConfig& b) {
+        return a.lastOpened > b.lastOpened;
+    });
+    return projects;
+}
+
+bool ProjectLibrary::contains(const QString& path) const
+{
+    return m_projects.contains(ProjectRegistry::normalizePath(path));
+}
+
+ProjectConfig ProjectLibrary::project(const QString& path) const
+{
+    QString normalized = ProjectRegistry::normalizePath(path);
+    auto it = m_projects.constFind(normalized);
+    if (it != m_projects.constEnd()) {
+        return it.value();
+    }
+
+    ProjectConfig config;
+    config.projectPath = normalized;
+    return config;
+}
+
+Result<void, QString> ProjectLibrary::save(const ProjectConfig& config)
+{
+    ProjectConfig normalized = config;
+    normalized.projectPath = ProjectRegistry::normalizePath(config.projectPath);
+
+    QString path = filePath(normalized.projectPath);
+    if (!QDir().mkpath(m_directory) || !normalized.save(path)) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(path));
+    }
+    m_projects.insert(normalized.projectPath, normalized);
+    return Result<void, QString>::ok();
+}
+
+bool ProjectLibrary::remove(const QString& path)
+{
+    QString normalized = ProjectRegistry::normalizePath(path);
+    if (!m_projects.remove(normalized)) {
+        return false;
+    }
+    QFile::remove(filePath(normalized));
+    return true;
+}
+
+QString ProjectLibrary::filePath(const QString& normalizedPath) const
+{
+    QByteArray hash = QCryptographicHash::hash(normalizedPath.toUtf8(), QCryptographicHash::Sha1);
+    return QDir(m_directory).filePath(QString::fromLatin1(hash.toHex().left(16)) + ".json");
+}
@@ -0,0 +1,57 @@
+#ifndef PROJECTLIBRARY_H
+#define PROJECTLIBRARY_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include "ProjectConfig.h"
+#include "types/Result.h"
+
+/**
+ * @brief Every project opened in the GUI, with its last-known state
+ *
+ * One ProjectConfig file per project in the application data directory,
+ * named after a hash of the project path, so updating one project's cache
+ * rewrites only its own small file. Not thread-safe: the GUI only touches
+ * it from its main thread.
+ *
+ * Deliberately separate from the daemon's ProjectRegistry. Both list
+ * project paths, but little else overlaps: this holds what the GUI shows
+ * and its settings (cached history, size, sync remote), the registry holds
+ * scheduling state (interval, last snapshot and maintenance). Each file
+ * has one writer process, so neither needs cross-process locking, and the
+ * GUI works without a daemon. The GUI keeps the registry in step by
+ * registering every project it opens.
+ */
+class ProjectLibrary {
+public:
+    ProjectLibrary();
+
+    static QString defaultDirectory();
+
+    /**
+     * @brief Read every project file; unreadable ones are skipped
+     */
+    Result<void, QString> load(const QString& directory);
+
+    /**
+     * @return Projects, most recently opened first
+     */
+    QList<ProjectConfig> projects() const;
+    bool contains(const QString& path) const;
+    ProjectConfig project(const QString& path) const;
+
+    /**
+     * @brief Add or update a project and write its file
+     */
+    Result<void, QString> save(const ProjectConfig& config);
+    bool remove(const QString& path);
+
+private:
+    QString m_directory;
+    QHash<QString, ProjectConfig> m_projects;    // Normalized path -> config
+
+    QString filePath(const QString& normalizedPath) const;
+};
+
+#endif // PROJECTLIBRARY_H
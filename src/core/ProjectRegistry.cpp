@@ -0,0 +1,142 @@
+#include "ProjectRegistry.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+QJsonObject RegisteredProject::toJson() const
+{
+    QJsonObject obj;
+    obj["path"] = path;
+    obj["game_id"] = gameId;
+    obj["snapshot_interval_minutes"] = snapshotIntervalMinutes;
+    if (lastSnapshot.isValid()) {
+        obj["last_snapshot"] = lastSnapshot.toString(Qt::ISODate);
+    }
+    if (lastMaintenance.isValid()) {
+        obj["last_maintenance"] = lastMaintenance.toString(Qt::ISODate);
+    }
+    return obj;
+}
+
+RegisteredProject RegisteredProject::fromJson(const QJsonObject& obj)
+{
+    RegisteredProject project;
+    project.path = obj["path"].toString();
+    project.gameId = obj["game_id"].toString();
+    project.snapshotIntervalMinutes = obj["snapshot_interval_minutes"].toInt(0);
+    project.lastSnapshot = QDateTime::fromString(obj["last_snapshot"].toString(), Qt::ISODate);
+    project.lastMaintenance = QDateTime::fromString(obj["last_maintenance"].toString(), Qt::ISODate);
+    return project;
+}
+
+ProjectRegistry::ProjectRegistry()
+{
+}
+
+QString ProjectRegistry::defaultFilePath()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation))
+        .filePath("projects.json");
+}
+
+Result<void, QString> ProjectRegistry::load(const QString& filePath)
+{
+    m_filePath = filePath;
+    m_projects.clear();
+
+    QFile file(filePath);
+    if (!file.exists()) {
+        return Result<void, QString>::ok();  // Nothing registered yet
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Result<void, QString>::err(QString("Cannot open %1").arg(filePath));
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) {
+        return Result<void, QString>::err(QString("Invalid project registry: %1").arg(filePath));
+    }
+
+    for (const QJsonValue& value : doc.object()["projects"].toArray()) {
+        RegisteredProject project = RegisteredProject::fromJson(value.toObject());
+        if (!project.path.isEmpty()) {
+            m_projects.append(project);
+        }
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<void, QString> ProjectRegistry::save() const
+{
+    QJsonArray projects;
+    for (const RegisteredProject& project : m_projects) {
+        projects.append(project.toJson());
+    }
+
+    QDir().mkpath(QFileInfo(m_filePath).path());
+
+    // Written atomically: a crash never leaves a truncated registry
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(m_filePath));
+    }
+    file.write(QJsonDocument(QJsonObject{{"projects", projects}}).toJson());
+    if (!file.commit()) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(m_filePath));
+    }
+    return Result<void, QString>::ok();
+}
+
+bool ProjectRegistry::contains(const QString& path) const
+{
+    return indexOf(path) >= 0;
+}
+
+RegisteredProject ProjectRegistry::project(const QString& path) const
+{
+    int index = indexOf(path);
+    return index >= 0 ? m_projects[index] : RegisteredProject();
+}
+
+void ProjectRegistry::upsert(const RegisteredProject& project)
+{
+    RegisteredProject normalized = project;
+    normalized.path = normalizePath(project.path);
+
+    int index = indexOf(normalized.path);
+    if (index >= 0) {
+        m_projects[index] = normalized;
+    } else {
+        m_projects.append(normalized);
+    }
+}
+
+bool ProjectRegistry::remove(const QString& path)
+{
+    int index = indexOf(path);
+    if (index < 0) {
+        return false;
+    }
+    m_projects.removeAt(index);
+    return true;
+}
+
+QString ProjectRegistry::normalizePath(const QString& path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+int ProjectRegistry::indexOf(const QString& path) const
+{
+    QString normalized = normalizePath(path);
+    for (int i = 0; i < m_projects.size(); ++i) {
+        if (m_projects[i].path == normalized) {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,62 @@
+#ifndef PROJECTREGISTRY_H
+#define PROJECTREGISTRY_H
+
+#include <QDateTime>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include "types/Result.h"
+
+/**
+ * @brief A game directory managed by the background daemon
+ */
+struct RegisteredProject {
+    QString path;                     // Absolute, cleaned
+    QString gameId;                   // Preset ID, empty to track everything
+    int snapshotIntervalMinutes;      // 0 disables scheduled snapshots
+    QDateTime lastSnapshot;
+    QDateTime lastMaintenance;
+
+    RegisteredProject()
+        : snapshotIntervalMinutes(0)
+    {}
+
+    QJsonObject toJson() const;
+    static RegisteredProject fromJson(const QJsonObject& obj);
+};
+
+/**
+ * @brief Persistent list of registered projects
+ *
+ * Stored as JSON in the application data directory. Not thread-safe: the
+ * daemon only touches it from its main thread.
+ */
+class ProjectRegistry {
+public:
+    ProjectRegistry();
+
+    static QString defaultFilePath();
+
+    Result<void, QString> load(const QString& filePath);
+    Result<void, QString> save() const;
+
+    QList<RegisteredProject> projects() const { return m_projects; }
+    bool contains(const QString& path) const;
+    RegisteredProject project(const QString& path) const;
+
+    /**
+     * @brief Add a project, or update it if the path is already registered
+     */
+    void upsert(const RegisteredProject& project);
+    bool remove(const QString& path);
+
+    static QString normalizePath(const QString& path);
+
+private:
+    QString m_filePath;
+    QList<RegisteredProject> m_projects;
+
+    int indexOf(const QString& path) const;
+};
+
+#endif // PROJECTREGISTRY_H
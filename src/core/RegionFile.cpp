@@ -0,0 +1,159 @@
+#include "RegionFile.h"
+#include "ChunkStore.h"
+#include <QList>
+#include <QtEndian>
+#include <algorithm>
+
+namespace {
+
+constexpr qint64 SectorSize = 4096;
+constexpr int ChunkSlots = 1024;
+constexpr qint64 HeaderSize = 2 * SectorSize;   // Locations, then timestamps
+const QByteArray ManifestMagic = QByteArrayLiteral("vgvc-region 1\n");
+
+} // namespace
+
+Result<QVector<RegionSegment>, QString> RegionFile::split(const QByteArray& data)
+{
+    using SplitResult = Result<QVector<RegionSegment>, QString>;
+
+    qint64 size = data.size();
+    if (size < HeaderSize) {
+        return SplitResult::err("Too small for a region file");
+    }
+
+    const char* locations = data.constData();
+    const char* timestamps = data.constData() + SectorSize;
+
+    QVector<RegionSegment> chunks;
+    chunks.reserve(ChunkSlots);
+    for (int slot = 0; slot < ChunkSlots; ++slot) {
+        quint32 location = qFromBigEndian<quint32>(locations + 4 * slot);
+        if (location == 0) {
+            continue;  // Chunk never generated
+        }
+
+        qint64 offset = qint64(location >> 8) * SectorSize;
+        qint64 length = qint64(location & 0xff) * SectorSize;
+        if (offset < HeaderSize || length == 0 || offset + length > size) {
+            return SplitResult::err(QString("Chunk %1 lies outside the file").arg(slot));
+        }
+        chunks.append({RegionSegment::Kind::Chunk, offset, length, slot,
+                       qFromBigEndian<quint32>(timestamps + 4 * slot)});
+    }
+
+    std::sort(chunks.begin(), chunks.end(),
+        [](const RegionSegment& a, const RegionSegment& b) { return a.offset < b.offset; });
+
+    QVector<RegionSegment> segments;
+    segments.reserve(chunks.size() * 2 + 2);
+    segments.append({RegionSegment::Kind::Header, 0, HeaderSize, -1, 0});
+
+    qint64 position = HeaderSize;
+    for (const RegionSegment& chunk : chunks) {
+        if (chunk.offset < position) {
+            return SplitResult::err(QString("Chunk %1 overlaps another").arg(chunk.slot));
+        }
+        if (chunk.offset > position) {
+            segments.append({RegionSegment::Kind::Gap, position, chunk.offset - position, -1, 0});
+        }
+        segments.append(chunk);
+        position = chunk.offset + chunk.length;
+    }
+    if (position < size) {
+        segments.append({RegionSegment::Kind::Gap, position, size - position, -1, 0});
+    }
+    return SplitResult::ok(segments);
+}
+
+Result<QByteArray, QString> RegionFile::clean(const QByteArray& data, ChunkStore& store)
+{
+    auto splitResult = split(data);
+    if (splitResult.isErr()) {
+        return Result<QByteArray, QString>::ok(data);
+    }
+
+    QByteArray manifest = ManifestMagic;
+    manifest += "size " + QByteArray::number(data.size()) + '\n';
+
+    for (const RegionSegment& segment : splitResult.value()) {
+        auto putResult = store.put(QByteArrayView(data.constData() + segment.offset, segment.length));
+        if (putResult.isErr()) {
+            return Result<QByteArray, QString>::err(putResult.error());
+        }
+        QByteArray hash = putResult.value().toHex().toLatin1();
+
+        switch (segment.kind) {
+        case RegionSegment::Kind::Header:
+            manifest += "h " + QByteArray::number(segment.length) + ' ' + hash + '\n';
+            break;
+        case RegionSegment::Kind::Chunk:
+            manifest += "c " + QByteArray::number(segment.slot) + ' '
+                + QByteArray::number(segment.timestamp) + ' '
+                + QByteArray::number(segment.length) + ' ' + hash + '\n';
+            break;
+        case RegionSegment::Kind::Gap:
+            manifest += "g " + QByteArray::number(segment.length) + ' ' + hash + '\n';
+            break;
+        }
+    }
+    return Result<QByteArray, QString>::ok(manifest);
+}
+
+Result<QByteArray, QString> RegionFile::smudge(const QByteArray& data, ChunkStore& store)
+{
+    using SmudgeResult = Result<QByteArray, QString>;
+
+    if (!isManifest(data)) {
+        return SmudgeResult::ok(data);
+    }
+
+    QList<QByteArray> lines = data.mid(ManifestMagic.size()).split('\n');
+    if (lines.isEmpty() || !lines.first().startsWith("size ")) {
+        return SmudgeResult::err("Region manifest has no size");
+    }
+
+    bool sizeOk = false;
+    qint64 size = lines.first().mid(5).toLongLong(&sizeOk);
+    if (!sizeOk) {
+        return SmudgeResult::err("Region manifest has an invalid size");
+    }
+
+    QByteArray file;
+    file.reserve(size);
+    for (int i = 1; i < lines.size(); ++i) {
+        if (lines[i].isEmpty()) {
+            continue;
+        }
+
+        // The hash is always the last field and the length the one before it
+        QList<QByteArray> fields = lines[i].split(' ');
+        if (fields.size() < 3) {
+            return SmudgeResult::err(QString("Malformed region manifest line %1").arg(i + 2));
+        }
+        qint64 length = fields[fields.size() - 2].toLongLong();
+        ObjectId id = ObjectId::fromHex(QString::fromLatin1(fields.last()));
+        if (id.isNull()) {
+            return SmudgeResult::err(QString("Malformed region manifest line %1").arg(i + 2));
+        }
+
+        auto chunkResult = store.get(id);
+        if (chunkResult.isErr()) {
+            return SmudgeResult::err(chunkResult.error());
+        }
+        if (chunkResult.value().size() != length) {
+            return SmudgeResult::err(QString("Chunk %1 has the wrong length").arg(id.toHex()));
+        }
+        file += chunkResult.value();
+    }
+
+    if (file.size() != size) {
+        return SmudgeResult::err("Rebuilt region file has the wrong size");
+    }
+    return SmudgeResult::ok(file);
+}
+
+bool RegionFile::isManifest(const QByteArray& data)
+{
+    return data.startsWith(ManifestMagic);
+}
@@ -0,0 +1,74 @@
+#ifndef REGIONFILE_H
+#define REGIONFILE_H
+
+#include <QByteArray>
+#include <QVector>
+#include "types/Result.h"
+
+class ChunkStore;
+
+/**
+ * @brief One contiguous piece of a region file
+ */
+struct RegionSegment {
+    enum class Kind {
+        Header,      // Location and timestamp tables
+        Chunk,       // One chunk's sectors, padding included
+        Gap          // Unreferenced sectors or trailing bytes
+    };
+
+    Kind kind;
+    qint64 offset;
+    qint64 length;
+    int slot;            // Chunk index 0-1023, -1 otherwise
+    quint32 timestamp;   // Chunk's last-save time, 0 otherwise
+};
+
+/**
+ * @brief Chunk-level storage for Minecraft Anvil region files (.mca)
+ *
+ * A region file holds 32x32 chunks in 4 KiB sectors behind an 8 KiB
+ * header, and the game rewrites the whole file whenever any chunk in it
+ * is saved. Storing the file as one blob duplicates every unchanged
+ * chunk in every snapshot. Instead, clean() splits the file into its
+ * header, chunks and gaps, puts each piece in the ChunkStore, and returns
+ * a small text manifest that git stores in place of the file; smudge()
+ * reassembles the exact original bytes. Unchanged chunks hash to pieces
+ * already in the store, so a snapshot costs only the chunks that were
+ * saved since the last one.
+ *
+ * Manifest format, one segment per line in file order:
+ *   vgvc-region 1
+ *   size <file size>
+ *   h <length> <hash>
+ *   c <slot> <timestamp> <length> <hash>
+ *   g <length> <hash>
+ */
+class RegionFile {
+public:
+    /**
+     * @brief Cut a region file into segments covering every byte
+     * @return An error if the data isn't a well-formed region file
+     */
+    static Result<QVector<RegionSegment>, QString> split(const QByteArray& data);
+
+    /**
+     * @brief Store a region file's pieces and describe them
+     *
+     * Data that isn't a region file (empty, truncated mid-save) is
+     * returned unchanged and stored as an ordinary blob.
+     */
+    static Result<QByteArray, QString> clean(const QByteArray& data, ChunkStore& store);
+
+    /**
+     * @brief Rebuild a region file from its manifest
+     *
+     * Anything that isn't a manifest, such as a region file snapshotted
+     * before chunk storage was enabled, is returned unchanged.
+     */
+    static Result<QByteArray, QString> smudge(const QByteArray& data, ChunkStore& store);
+
+    static bool isManifest(const QByteArray& data);
+};
+
+#endif // REGIONFILE_H
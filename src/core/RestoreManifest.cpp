@@ -0,0 +1,81 @@
+#include "RestoreManifest.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace {
+
+constexpr quint32 ManifestMagic = 0x5647524d;  // "VGRM"
+constexpr quint32 ManifestVersion = 1;
+
+} // namespace
+
+RestoreManifest::RestoreManifest(const QString& repoPath)
+    : m_filePath(QDir(repoPath).filePath(".git/vgvc/restore.manifest"))
+{
+}
+
+Result<void, QString> RestoreManifest::load()
+{
+    m_snapshotId.clear();
+    m_entries.clear();
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Result<void, QString>::err("No restore to verify");
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    in >> magic >> version;
+    if (magic != ManifestMagic || version != ManifestVersion) {
+        return Result<void, QString>::err("Restore record is from another version; restore again to verify");
+    }
+
+    in >> m_snapshotId >> count;
+    m_entries.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Entry entry;
+        in >> entry.path >> entry.blobId >> entry.size >> entry.modifiedMs;
+        m_entries.append(entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        m_entries.clear();
+        return Result<void, QString>::err(QString("Corrupt restore record %1").arg(m_filePath));
+    }
+    return Result<void, QString>::ok();
+}
+
+Result<void, QString> RestoreManifest::save() const
+{
+    QDir().mkpath(QFileInfo(m_filePath).path());
+
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(m_filePath));
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << ManifestMagic << ManifestVersion << m_snapshotId << qint32(m_entries.size());
+    for (const Entry& entry : m_entries) {
+        out << entry.path << entry.blobId << entry.size << entry.modifiedMs;
+    }
+
+    if (!file.commit()) {
+        return Result<void, QString>::err(QString("Cannot write %1").arg(m_filePath));
+    }
+    return Result<void, QString>::ok();
+}
+
+bool RestoreManifest::remove() const
+{
+    return !QFile::exists(m_filePath) || QFile::remove(m_filePath);
+}
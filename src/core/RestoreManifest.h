@@ -0,0 +1,75 @@
+#ifndef RESTOREMANIFEST_H
+#define RESTOREMANIFEST_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "types/Result.h"
+
+/**
+ * @brief How thoroughly to check a restored working tree
+ */
+enum class VerifyMode {
+    Quick,       // Compare stat data; hash only files that changed since the restore
+    Deep         // Hash every file, in parallel
+};
+
+/**
+ * @brief Outcome of verifying the working tree against the last restore
+ */
+struct VerifyReport {
+    QString snapshotId;
+    int checkedFiles = 0;
+    int hashedFiles = 0;
+    qint64 hashedBytes = 0;
+    QStringList modified;    // Content differs from the snapshot
+    QStringList missing;     // In the snapshot, gone from disk
+
+    bool isClean() const { return modified.isEmpty() && missing.isEmpty(); }
+    QStringList damaged() const { return modified + missing; }
+};
+
+/**
+ * @brief Every file a restore wrote, with its content hash and stat data
+ *
+ * Written to .git/vgvc/restore.manifest right after a restore, while the
+ * working tree is known to match the snapshot. Verification can then trust
+ * any file whose size and modification time are unchanged and hash only
+ * the rest, instead of re-reading the whole install.
+ */
+class RestoreManifest {
+public:
+    struct Entry {
+        QString path;            // Relative to the repository
+        QByteArray blobId;       // git object name (hex) of the content
+        qint64 size;
+        qint64 modifiedMs;       // Milliseconds since the epoch
+    };
+
+    explicit RestoreManifest(const QString& repoPath);
+
+    /**
+     * @brief Read the manifest; fails if no restore has been recorded
+     */
+    Result<void, QString> load();
+    Result<void, QString> save() const;
+
+    /**
+     * @brief Forget the recorded restore, so nothing verifies against it
+     */
+    bool remove() const;
+
+    QString snapshotId() const { return m_snapshotId; }
+    void setSnapshotId(const QString& snapshotId) { m_snapshotId = snapshotId; }
+
+    const QVector<Entry>& entries() const { return m_entries; }
+    QVector<Entry>& entries() { return m_entries; }
+
+private:
+    QString m_filePath;
+    QString m_snapshotId;
+    QVector<Entry> m_entries;
+};
+
+#endif // RESTOREMANIFEST_H
@@ -1,6 +1,8 @@
 #include "SnapshotManager.h"
 #include <QDateTime>
+#include <QFileInfo>
 #include <QtConcurrent>
+#include "utils/Tracer.h"
 
 SnapshotManager::SnapshotManager(GitService* gitService, QObject* parent)
     : QObject(parent)
@@ -22,30 +24,38 @@ QString SnapshotManager::generateDescription(const QString& userDescription)
 
 QFuture<Result<void, QString>> SnapshotManager::createSnapshot(const QString& description)
 {
-    return QtConcurrent::run([this, description]() -> Result<void, QString> {
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run([this, description, queuedAt]() -> Result<void, QString> {
+        Tracer::recordQueueWait("SnapshotManager::createSnapshot", queuedAt);
+        TraceSpan span("snapshot", "SnapshotManager::createSnapshot");
+        
         emit operationProgress(25, "Preparing snapshot...");
         
         QString finalDescription = generateDescription(description);
         
         emit operationProgress(50, "Creating snapshot...");
         
+        TraceSpan commitSpan("snapshot", "Commit phase");
         auto commitFuture = m_gitService->commit(finalDescription);
         commitFuture.waitForFinished();
-        auto result = commitFuture.result();
+        auto result = commitFuture.takeResult();
+        commitSpan.finish();
         
         if (result.isErr()) {
-            return Result<void, QString>::err(result.error());
+            return result;
         }
         
         emit operationProgress(100, "Snapshot created");
         
         // Fetch the snapshot to emit signal
+        TraceSpan historySpan("snapshot", "History refresh");
         auto historyFuture = m_gitService->getHistory(1);
         historyFuture.waitForFinished();
-        auto historyResult = historyFuture.result();
+        auto historyResult = historyFuture.takeResult();
+        historySpan.finish();
         
         if (historyResult.isOk() && !historyResult.value().isEmpty()) {
-            emit snapshotCreated(historyResult.value().first());
+            emit snapshotCreated(historyResult.takeValue().first());
         }
         
         return Result<void, QString>::ok();
@@ -57,30 +67,41 @@ QFuture<Result<QList<Snapshot>, QString>> SnapshotManager::listSnapshots()
     return m_gitService->getHistory();
 }
 
+QFuture<Result<SnapshotTablePtr, QString>> SnapshotManager::listSnapshotTable()
+{
+    return m_gitService->getHistoryTable();
+}
+
 QFuture<Result<void, QString>> SnapshotManager::restoreSnapshot(const QString& snapshotId)
 {
-    return QtConcurrent::run([this, snapshotId]() -> Result<void, QString> {
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run([this, snapshotId, queuedAt]() -> Result<void, QString> {
+        Tracer::recordQueueWait("SnapshotManager::restoreSnapshot", queuedAt);
+        TraceSpan span("snapshot", "SnapshotManager::restoreSnapshot");
+        
         emit operationProgress(20, "Creating safety backup...");
         
         // Create automatic safety snapshot before restoring
+        TraceSpan safetySpan("snapshot", "Safety backup phase");
         auto hasChangesFuture = m_gitService->hasChanges();
         hasChangesFuture.waitForFinished();
-        auto hasChangesResult = hasChangesFuture.result();
+        auto hasChangesResult = hasChangesFuture.takeResult();
         
         if (hasChangesResult.isOk() && hasChangesResult.value()) {
             auto safetyFuture = m_gitService->commit("[AUTO] Safety backup before restore");
             safetyFuture.waitForFinished();
             // Continue even if safety backup fails
         }
+        safetySpan.finish();
         
         emit operationProgress(50, "Restoring snapshot...");
         
         auto checkoutFuture = m_gitService->checkout(snapshotId);
         checkoutFuture.waitForFinished();
-        auto result = checkoutFuture.result();
+        auto result = checkoutFuture.takeResult();
         
         if (result.isErr()) {
-            return Result<void, QString>::err(result.error());
+            return result;
         }
         
         emit operationProgress(100, "Snapshot restored");
@@ -90,6 +111,72 @@ QFuture<Result<void, QString>> SnapshotManager::restoreSnapshot(const QString& s
     });
 }
 
+QFuture<Result<void, QString>> SnapshotManager::exportSnapshot(const QString& snapshotId,
+                                                               const QString& archivePath)
+{
+    // git resolves relative output paths against the repository, not the caller
+    return m_gitService->archive(snapshotId, QFileInfo(archivePath).absoluteFilePath());
+}
+
+QFuture<Result<QList<FileChange>, QString>> SnapshotManager::diffSnapshots(const QString& fromId,
+                                                                          const QString& toId)
+{
+    return m_gitService->diff(fromId, toId);
+}
+
+QFuture<Result<QList<FileChange>, QString>> SnapshotManager::previewRestore(const QString& snapshotId)
+{
+    return m_gitService->diff(QString(), snapshotId);
+}
+
+QFuture<Result<QList<FileVersion>, QString>> SnapshotManager::fileHistory(const QString& path)
+{
+    return m_gitService->fileHistory(path);
+}
+
+QFuture<Result<void, QString>> SnapshotManager::restoreFile(const QString& snapshotId, const QString& path)
+{
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run([this, snapshotId, path, queuedAt]() -> Result<void, QString> {
+        Tracer::recordQueueWait("SnapshotManager::restoreFile", queuedAt);
+        TraceSpan span("snapshot", "SnapshotManager::restoreFile");
+        
+        emit operationProgress(20, "Creating safety backup...");
+        
+        auto hasChangesFuture = m_gitService->hasChanges();
+        hasChangesFuture.waitForFinished();
+        auto hasChangesResult = hasChangesFuture.takeResult();
+        
+        if (hasChangesResult.isOk() && hasChangesResult.value()) {
+            auto safetyFuture = m_gitService->commit(
+                QString("[AUTO] Safety backup before restoring %1").arg(QFileInfo(path).fileName()));
+            safetyFuture.waitForFinished();
+            // Continue even if safety backup fails
+        }
+        
+        emit operationProgress(50, "Restoring file...");
+        
+        auto restoreFuture = m_gitService->restoreFile(snapshotId, path);
+        restoreFuture.waitForFinished();
+        auto result = restoreFuture.takeResult();
+        
+        if (result.isErr()) {
+            return result;
+        }
+        
+        emit operationProgress(100, "File restored");
+        emit fileRestored(snapshotId, path);
+        
+        return Result<void, QString>::ok();
+    });
+}
+
+QFuture<Result<SnapshotSearchResult, QString>> SnapshotManager::searchSnapshots(const QString& queryText,
+                                                                               int limit)
+{
+    return m_gitService->searchSnapshots(SnapshotQuery::parse(queryText), limit);
+}
+
 QFuture<Result<void, QString>> SnapshotManager::deleteSnapshot(const QString& snapshotId)
 {
     // TODO: Implement snapshot deletion
@@ -99,3 +186,13 @@ QFuture<Result<void, QString>> SnapshotManager::deleteSnapshot(const QString& sn
         return Result<void, QString>::err("Snapshot deletion not yet implemented");
     });
 }
+
+QFuture<Result<VerifyReport, QString>> SnapshotManager::verifyRestore(VerifyMode mode)
+{
+    return m_gitService->verifyRestore(mode);
+}
+
+QFuture<Result<void, QString>> SnapshotManager::repairRestore(const QStringList& paths)
+{
+    return m_gitService->repairRestore(paths);
+}
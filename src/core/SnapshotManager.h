@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QFuture>
 #include "GitService.h"
+#include "types/FileChange.h"
 #include "types/Result.h"
 #include "types/Snapshot.h"
 
@@ -22,12 +23,65 @@ public:
     
     QFuture<Result<void, QString>> createSnapshot(const QString& description);
     QFuture<Result<QList<Snapshot>, QString>> listSnapshots();
+    
+    /**
+     * @brief Recent history as a shared table, for views of large histories
+     */
+    QFuture<Result<SnapshotTablePtr, QString>> listSnapshotTable();
     QFuture<Result<void, QString>> restoreSnapshot(const QString& snapshotId);
     QFuture<Result<void, QString>> deleteSnapshot(const QString& snapshotId);
+    QFuture<Result<void, QString>> exportSnapshot(const QString& snapshotId, const QString& archivePath);
+    
+    /**
+     * @brief Files added, modified and deleted going from one snapshot to another
+     * 
+     * Results arrive in batches while the comparison runs; watch them with
+     * QFutureWatcher::resultsReadyAt to show changes as they stream in.
+     */
+    QFuture<Result<QList<FileChange>, QString>> diffSnapshots(const QString& fromId, const QString& toId);
+    
+    /**
+     * @brief Changes restoring a snapshot would make to the working tree
+     * 
+     * Streams like diffSnapshots. Unsnapshotted files count as deleted,
+     * since restoring backs them up and then removes them.
+     */
+    QFuture<Result<QList<FileChange>, QString>> previewRestore(const QString& snapshotId);
+    
+    /**
+     * @brief Snapshots holding a different version of a file, newest first
+     */
+    QFuture<Result<QList<FileVersion>, QString>> fileHistory(const QString& path);
+    
+    /**
+     * @brief Restore a single file from a snapshot, leaving everything else
+     * 
+     * Takes a safety backup first, like restoreSnapshot.
+     */
+    QFuture<Result<void, QString>> restoreFile(const QString& snapshotId, const QString& path);
+    
+    /**
+     * @brief Search all snapshots; see SnapshotQuery for the syntax
+     */
+    QFuture<Result<SnapshotSearchResult, QString>> searchSnapshots(const QString& queryText, int limit = 500);
+    
+    /**
+     * @brief Check that the working tree still matches the last restore
+     * 
+     * Quick mode is cheap enough to run after every restore; deep mode
+     * re-reads every file.
+     */
+    QFuture<Result<VerifyReport, QString>> verifyRestore(VerifyMode mode);
+    
+    /**
+     * @brief Rewrite only the files a verification reported as damaged
+     */
+    QFuture<Result<void, QString>> repairRestore(const QStringList& paths);
     
 signals:
     void snapshotCreated(const Snapshot& snapshot);
     void snapshotRestored(const QString& snapshotId);
+    void fileRestored(const QString& snapshotId, const QString& path);
     void operationProgress(int percentage, const QString& status);
     
 private:
@@ -0,0 +1,177 @@
+#include "SnapshotSearchIndex.h"
+#include <QRegularExpression>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+SnapshotQuery SnapshotQuery::parse(const QString& text)
+{
+    static const QRegularExpression whitespace("\\s+");
+    static const QRegularExpression duration("^(\\d+)([hdw])$");
+
+    SnapshotQuery query;
+    for (const QString& word : text.split(whitespace, Qt::SkipEmptyParts)) {
+        QString lower = word.toLower();
+
+        if (lower == "is:auto" || lower == "is:automatic") {
+            query.automatic = 1;
+        } else if (lower == "is:manual") {
+            query.automatic = 0;
+        } else if (lower.startsWith("path:")) {
+            query.pathTerms << SnapshotSearchIndex::tokenize(lower.mid(5));
+        } else if (lower.startsWith("after:") || lower.startsWith("before:")) {
+            int colon = lower.indexOf(':');
+            QDate date = QDate::fromString(lower.mid(colon + 1), Qt::ISODate);
+            if (!date.isValid()) {
+                continue;  // Still being typed
+            }
+            if (lower.startsWith("after:")) {
+                query.from = date.startOfDay();
+            } else {
+                query.to = date.startOfDay();
+            }
+        } else if (lower.startsWith("since:")) {
+            QRegularExpressionMatch match = duration.match(lower.mid(6));
+            if (!match.hasMatch()) {
+                continue;
+            }
+            qint64 amount = match.captured(1).toLongLong();
+            QChar unit = match.captured(2).at(0);
+            qint64 hours = unit == 'h' ? amount : unit == 'd' ? amount * 24 : amount * 24 * 7;
+            query.from = QDateTime::currentDateTime().addSecs(-hours * 3600);
+        } else {
+            query.terms << SnapshotSearchIndex::tokenize(lower);
+        }
+    }
+    return query;
+}
+
+void SnapshotSearchIndex::clear()
+{
+    m_snapshots = SnapshotTable();
+    m_descriptionTokens.clear();
+    m_pathTokens.clear();
+}
+
+QStringList SnapshotSearchIndex::tokenize(const QString& text)
+{
+    QStringList tokens;
+    QString current;
+    for (QChar c : text) {
+        if (c.isLetterOrNumber()) {
+            current += c.toLower();
+        } else if (!current.isEmpty()) {
+            tokens << current;
+            current.clear();
+        }
+    }
+    if (!current.isEmpty()) {
+        tokens << current;
+    }
+    return tokens;
+}
+
+void SnapshotSearchIndex::addSnapshot(const QString& snapshotId, const QString& description,
+                                      const QDateTime& timestamp, const QStringList& changedPaths)
+{
+    int ordinal = m_snapshots.size();
+
+    m_snapshots.append(ObjectId::fromHex(snapshotId), timestamp.toSecsSinceEpoch(), description, QString());
+
+    addPostings(m_descriptionTokens, tokenize(description), ordinal);
+    for (const QString& path : changedPaths) {
+        addPostings(m_pathTokens, tokenize(path), ordinal);
+    }
+}
+
+void SnapshotSearchIndex::addPostings(QMap<QString, Postings>& tokens, const QStringList& words, int ordinal)
+{
+    for (const QString& word : words) {
+        Postings& postings = tokens[word];
+        // Ordinals only grow, so a duplicate can only be the last entry
+        if (postings.isEmpty() || postings.last() != ordinal) {
+            postings.append(ordinal);
+        }
+    }
+}
+
+SnapshotSearchIndex::Postings SnapshotSearchIndex::lookup(const QMap<QString, Postings>& tokens,
+                                                          const QString& term)
+{
+    Postings merged;
+    for (auto it = tokens.lowerBound(term); it != tokens.cend() && it.key().startsWith(term); ++it) {
+        merged += it.value();
+    }
+    std::sort(merged.begin(), merged.end());
+    merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+    return merged;
+}
+
+SnapshotSearchResult SnapshotSearchIndex::search(const SnapshotQuery& query, int limit) const
+{
+    Postings candidates;
+    bool restricted = false;
+    auto intersect = [&candidates, &restricted](const Postings& postings) {
+        if (!restricted) {
+            candidates = postings;
+            restricted = true;
+            return;
+        }
+        Postings both;
+        std::set_intersection(candidates.cbegin(), candidates.cend(),
+                              postings.cbegin(), postings.cend(), std::back_inserter(both));
+        candidates = both;
+    };
+
+    for (const QString& term : query.terms) {
+        Postings inDescription = lookup(m_descriptionTokens, term);
+        Postings inPaths = lookup(m_pathTokens, term);
+        Postings either;
+        std::set_union(inDescription.cbegin(), inDescription.cend(),
+                       inPaths.cbegin(), inPaths.cend(), std::back_inserter(either));
+        intersect(either);
+    }
+    for (const QString& term : query.pathTerms) {
+        intersect(lookup(m_pathTokens, term));
+    }
+
+    SnapshotSearchResult result;
+    SnapshotTable matches;
+    qint64 from = query.from.isValid() ? query.from.toSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+    qint64 to = query.to.isValid() ? query.to.toSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+    auto consider = [&](int ordinal) {
+        qint64 timestamp = m_snapshots.timestampSecs(ordinal);
+        if (timestamp < from || timestamp >= to) {
+            return;
+        }
+
+        // Facet counts ignore the is: filter, so they show what switching it would give
+        bool automatic = m_snapshots.isAutomatic(ordinal);
+        if (automatic) {
+            ++result.automaticCount;
+        } else {
+            ++result.manualCount;
+        }
+        if (query.automatic >= 0 && automatic != (query.automatic == 1)) {
+            return;
+        }
+
+        ++result.total;
+        if (matches.size() < limit) {
+            matches.appendRow(m_snapshots, ordinal);
+        }
+    };
+
+    // Snapshots are indexed oldest first, so newest first is descending order
+    if (restricted) {
+        for (auto it = candidates.crbegin(); it != candidates.crend(); ++it) {
+            consider(*it);
+        }
+    } else {
+        for (int ordinal = m_snapshots.size() - 1; ordinal >= 0; --ordinal) {
+            consider(ordinal);
+        }
+    }
+    result.snapshots = SnapshotTable::share(std::move(matches));
+    return result;
+}
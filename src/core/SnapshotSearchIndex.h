@@ -0,0 +1,94 @@
+#ifndef SNAPSHOTSEARCHINDEX_H
+#define SNAPSHOTSEARCHINDEX_H
+
+#include <QDateTime>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "SnapshotTable.h"
+
+/**
+ * @brief Parsed search box input
+ *
+ * Plain words match snapshot descriptions and changed paths; every word
+ * must match, as a prefix of some token, so results follow typing.
+ * Filters:
+ *   is:auto, is:manual          automatic or manual snapshots
+ *   path:word                   word must match a changed path
+ *   after:2024-05-01            on or after a date
+ *   before:2024-05-01           before a date
+ *   since:7d (also h, w)        within the last days, hours or weeks
+ */
+struct SnapshotQuery {
+    QStringList terms;
+    QStringList pathTerms;
+    int automatic;           // -1 any, 0 manual only, 1 automatic only
+    QDateTime from;          // Invalid for no bound
+    QDateTime to;
+
+    bool isEmpty() const {
+        return terms.isEmpty() && pathTerms.isEmpty() && automatic < 0
+            && !from.isValid() && !to.isValid();
+    }
+
+    static SnapshotQuery parse(const QString& text);
+
+    SnapshotQuery()
+        : automatic(-1)
+    {}
+};
+
+/**
+ * @brief Matches for a query, newest first, with facet counts
+ */
+struct SnapshotSearchResult {
+    SnapshotTablePtr snapshots;  // Truncated to the requested limit
+    int total;                   // Matches before truncation
+    int automaticCount;
+    int manualCount;
+
+    SnapshotSearchResult()
+        : total(0)
+        , automaticCount(0)
+        , manualCount(0)
+    {}
+};
+
+/**
+ * @brief Inverted token index over snapshot descriptions and changed paths
+ *
+ * Tokens are lowercased runs of letters and digits. Postings are snapshot
+ * ordinals in insertion order, so adding a snapshot only appends; token
+ * maps are sorted, so a prefix is a contiguous key range.
+ */
+class SnapshotSearchIndex {
+public:
+    void clear();
+
+    void addSnapshot(const QString& snapshotId, const QString& description,
+                     const QDateTime& timestamp, const QStringList& changedPaths);
+
+    SnapshotSearchResult search(const SnapshotQuery& query, int limit) const;
+
+    int size() const { return m_snapshots.size(); }
+
+    static QStringList tokenize(const QString& text);
+
+private:
+    using Postings = QVector<int>;
+
+    SnapshotTable m_snapshots;           // Row number is the ordinal
+    QMap<QString, Postings> m_descriptionTokens;
+    QMap<QString, Postings> m_pathTokens;
+
+    static void addPostings(QMap<QString, Postings>& tokens, const QStringList& words, int ordinal);
+
+    /**
+     * @brief Sorted ordinals of snapshots with a token starting with the term
+     */
+    static Postings lookup(const QMap<QString, Postings>& tokens, const QString& term);
+};
+
+#endif // SNAPSHOTSEARCHINDEX_H
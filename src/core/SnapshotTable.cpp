@@ -0,0 +1,105 @@
+#include "SnapshotTable.h"
+
+static_assert(sizeof(ObjectId) == ObjectId::Size, "ObjectId must have no padding");
+
+SnapshotTable::SnapshotTable()
+{
+}
+
+void SnapshotTable::reserve(int rows)
+{
+    m_rows.reserve(rows);
+}
+
+void SnapshotTable::append(const ObjectId& id, qint64 timestampSecs,
+                           const QString& description, const QString& author)
+{
+    Row row;
+    row.id = id;
+    row.timestamp = timestampSecs;
+    row.descriptionLength = static_cast<quint32>(description.size());
+    row.flags = description.startsWith("[AUTO]") ? AutomaticFlag : 0;
+
+    auto descriptionIt = m_descriptionOffsets.constFind(description);
+    if (descriptionIt != m_descriptionOffsets.constEnd()) {
+        row.descriptionOffset = descriptionIt.value();
+    } else {
+        row.descriptionOffset = static_cast<quint32>(m_descriptions.size());
+        m_descriptions += description;
+        m_descriptionOffsets.insert(description, row.descriptionOffset);
+    }
+
+    auto authorIt = m_authorIndexes.constFind(author);
+    if (authorIt != m_authorIndexes.constEnd()) {
+        row.author = authorIt.value();
+    } else {
+        row.author = static_cast<quint16>(m_authors.size());
+        m_authors.append(author);
+        m_authorIndexes.insert(author, row.author);
+    }
+
+    m_rows.append(row);
+}
+
+void SnapshotTable::appendRow(const SnapshotTable& other, int row)
+{
+    append(other.id(row), other.timestampSecs(row),
+           other.description(row).toString(), other.author(row));
+}
+
+SnapshotTablePtr SnapshotTable::share(SnapshotTable table)
+{
+    table.m_descriptionOffsets = QHash<QString, quint32>();
+    table.m_authorIndexes = QHash<QString, quint16>();
+    table.m_rows.squeeze();
+    table.m_descriptions.squeeze();
+    return SnapshotTablePtr(new SnapshotTable(std::move(table)));
+}
+
+SnapshotTablePtr SnapshotTable::fromSnapshots(const QList<Snapshot>& snapshots)
+{
+    SnapshotTable table;
+    table.reserve(snapshots.size());
+    for (const Snapshot& snapshot : snapshots) {
+        table.append(ObjectId::fromHex(snapshot.id), snapshot.timestamp.toSecsSinceEpoch(),
+                     snapshot.description, snapshot.author);
+    }
+    return share(std::move(table));
+}
+
+QStringView SnapshotTable::description(int row) const
+{
+    const Row& entry = m_rows[row];
+    return QStringView(m_descriptions).mid(entry.descriptionOffset, entry.descriptionLength);
+}
+
+int SnapshotTable::indexOf(const ObjectId& id) const
+{
+    for (int row = 0; row < m_rows.size(); ++row) {
+        if (m_rows[row].id == id) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+Snapshot SnapshotTable::snapshot(int row) const
+{
+    Snapshot snapshot;
+    snapshot.id = id(row).toHex();
+    snapshot.description = description(row).toString();
+    snapshot.timestamp = timestamp(row);
+    snapshot.author = author(row);
+    snapshot.isAutomatic = isAutomatic(row);
+    return snapshot;
+}
+
+QList<Snapshot> SnapshotTable::toList() const
+{
+    QList<Snapshot> snapshots;
+    snapshots.reserve(m_rows.size());
+    for (int row = 0; row < m_rows.size(); ++row) {
+        snapshots.append(snapshot(row));
+    }
+    return snapshots;
+}
@@ -0,0 +1,99 @@
+#ifndef SNAPSHOTTABLE_H
+#define SNAPSHOTTABLE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "types/ObjectId.h"
+#include "types/Snapshot.h"
+
+class SnapshotTable;
+
+/**
+ * @brief Immutable, shared snapshot table; copying it copies a pointer
+ */
+using SnapshotTablePtr = QSharedPointer<const SnapshotTable>;
+
+/**
+ * @brief Column-compact storage for many snapshots
+ *
+ * Each row is a fixed 40-byte record: binary object ID, epoch seconds, and
+ * offsets into shared storage. Descriptions live in a single string arena
+ * and identical ones ("[AUTO] Scheduled snapshot") are stored once; authors
+ * are interned. Rows are appended while the table is built, then the table
+ * is frozen with share() and handed around by pointer, so refreshes and
+ * future results never copy the rows.
+ */
+class SnapshotTable {
+public:
+    SnapshotTable();
+
+    void reserve(int rows);
+
+    void append(const ObjectId& id, qint64 timestampSecs,
+                const QString& description, const QString& author);
+
+    /**
+     * @brief Copy one row of another table
+     */
+    void appendRow(const SnapshotTable& other, int row);
+
+    /**
+     * @brief Freeze the table, dropping build-time lookup structures
+     */
+    static SnapshotTablePtr share(SnapshotTable table);
+
+    static SnapshotTablePtr fromSnapshots(const QList<Snapshot>& snapshots);
+
+    int size() const { return m_rows.size(); }
+    bool isEmpty() const { return m_rows.isEmpty(); }
+
+    const ObjectId& id(int row) const { return m_rows[row].id; }
+    qint64 timestampSecs(int row) const { return m_rows[row].timestamp; }
+    QDateTime timestamp(int row) const { return QDateTime::fromSecsSinceEpoch(m_rows[row].timestamp); }
+    QStringView description(int row) const;
+    const QString& author(int row) const { return m_authors[m_rows[row].author]; }
+    bool isAutomatic(int row) const { return m_rows[row].flags & AutomaticFlag; }
+
+    /**
+     * @return Row holding the ID, or -1; scans from the top, so finding a
+     *         recent snapshot is cheap
+     */
+    int indexOf(const ObjectId& id) const;
+
+    /**
+     * @brief Expand one row into a standalone Snapshot
+     */
+    Snapshot snapshot(int row) const;
+    QList<Snapshot> toList() const;
+
+private:
+    enum Flag : quint16 {
+        AutomaticFlag = 0x1
+    };
+
+    // Ordered so the record packs into 40 bytes
+    struct Row {
+        qint64 timestamp;            // Seconds since the epoch
+        ObjectId id;
+        quint32 descriptionOffset;   // Into m_descriptions
+        quint32 descriptionLength;
+        quint16 author;              // Into m_authors
+        quint16 flags;
+    };
+    static_assert(sizeof(Row) == 40, "Row layout grew");
+
+    QVector<Row> m_rows;
+    QString m_descriptions;          // Arena holding every distinct description
+    QStringList m_authors;
+
+    // Build-time interning; cleared by share()
+    QHash<QString, quint32> m_descriptionOffsets;
+    QHash<QString, quint16> m_authorIndexes;
+};
+
+#endif // SNAPSHOTTABLE_H
@@ -0,0 +1,55 @@
+#include "SyncEngine.h"
+#include <QFutureWatcher>
+#include "ChunkRemote.h"
+
+SyncEngine::SyncEngine(GitService* gitService, QObject* parent)
+    : QObject(parent)
+    , m_gitService(gitService)
+    , m_syncing(false)
+    , m_queued(false)
+{
+    connect(m_gitService, &GitService::operationProgress,
+            this, &SyncEngine::syncProgress);
+}
+
+void SyncEngine::setRemoteUrl(const QString& remoteUrl)
+{
+    m_remoteUrl = remoteUrl.trimmed();
+}
+
+void SyncEngine::sync()
+{
+    if (m_remoteUrl.isEmpty()) {
+        emit syncFailed("No remote configured");
+        return;
+    }
+    if (m_syncing) {
+        m_queued = true;
+        return;
+    }
+    m_syncing = true;
+    m_queued = false;
+
+    auto* watcher = new QFutureWatcher<Result<SyncReport, QString>>(this);
+    connect(watcher, &QFutureWatcher<Result<SyncReport, QString>>::finished,
+            this, [this, watcher]() {
+        auto result = watcher->future().takeResult();
+        watcher->deleteLater();
+        m_syncing = false;
+
+        if (result.isErr()) {
+            m_queued = false;
+            emit syncFailed(result.error());
+            return;
+        }
+        emit syncFinished(result.value());
+
+        if (m_queued) {
+            sync();
+        }
+    });
+
+    watcher->setFuture(ChunkRemote::isChunkUrl(m_remoteUrl)
+        ? m_gitService->uploadSnapshots(m_remoteUrl)
+        : m_gitService->pushSnapshots(m_remoteUrl));
+}
@@ -0,0 +1,48 @@
+#ifndef SYNCENGINE_H
+#define SYNCENGINE_H
+
+#include <QObject>
+#include <QString>
+#include "GitService.h"
+#include "types/SyncReport.h"
+
+/**
+ * @brief Keeps a remote repository up to date with a project's snapshots
+ *
+ * Runs GitService::pushSnapshots(), or uploadSnapshots() for a chunk
+ * remote, one sync at a time. A sync requested
+ * while one is running is queued and starts when it ends, so snapshots
+ * taken mid-transfer go out on the next pass instead of a second
+ * concurrent push. Failed syncs are not retried here: the next request
+ * resumes from whatever already reached the remote.
+ */
+class SyncEngine : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SyncEngine(GitService* gitService, QObject* parent = nullptr);
+    ~SyncEngine() override = default;
+
+    void setRemoteUrl(const QString& remoteUrl);
+    QString remoteUrl() const { return m_remoteUrl; }
+
+    bool isSyncing() const { return m_syncing; }
+
+    /**
+     * @brief Push new snapshots now, or after the running sync
+     */
+    void sync();
+
+signals:
+    void syncProgress(int percentage, const QString& status);
+    void syncFinished(const SyncReport& report);
+    void syncFailed(const QString& error);
+
+private:
+    GitService* m_gitService;
+    QString m_remoteUrl;
+    bool m_syncing;
+    bool m_queued;
+};
+
+#endif // SYNCENGINE_H
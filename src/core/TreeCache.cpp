@@ -0,0 +1,45 @@
+#include "TreeCache.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+TreeCache::TreeCache(int capacity)
+    : m_capacity(capacity)
+{
+}
+
+QSharedPointer<const TreeListing> TreeCache::find(const QString& commitHash)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_listings.constFind(commitHash);
+    if (it == m_listings.constEnd()) {
+        return QSharedPointer<const TreeListing>();
+    }
+
+    m_recentlyUsed.removeOne(commitHash);
+    m_recentlyUsed.append(commitHash);
+    return it.value();
+}
+
+void TreeCache::insert(const QString& commitHash, QSharedPointer<const TreeListing> listing)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_listings.contains(commitHash)) {
+        m_recentlyUsed.removeOne(commitHash);
+    }
+    m_listings.insert(commitHash, listing);
+    m_recentlyUsed.append(commitHash);
+
+    while (m_recentlyUsed.size() > m_capacity) {
+        m_listings.remove(m_recentlyUsed.takeFirst());
+    }
+}
+
+const TreeEntry* TreeCache::lookup(const TreeListing& listing, const QString& path)
+{
+    auto it = std::lower_bound(listing.cbegin(), listing.cend(), path,
+        [](const TreeEntry& entry, const QString& value) { return entry.path < value; });
+    if (it == listing.cend() || it->path != path) {
+        return nullptr;
+    }
+    return &*it;
+}
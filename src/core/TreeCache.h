@@ -0,0 +1,56 @@
+#ifndef TREECACHE_H
+#define TREECACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief One file in a snapshot's tree
+ */
+struct TreeEntry {
+    QString path;
+    QByteArray blobId;       // Content hash; equal IDs mean equal content
+    QByteArray mode;         // git file mode, e.g. 100644
+    qint64 size;             // Size on disk, not of a region or delta manifest
+};
+
+/**
+ * @brief Every file in a snapshot, sorted by path
+ */
+using TreeListing = QVector<TreeEntry>;
+
+/**
+ * @brief Recently used snapshot tree listings, keyed by commit hash
+ *
+ * Commits never change, so a listing never goes stale; the cache only
+ * bounds memory by dropping the least recently used listing. Thread-safe.
+ */
+class TreeCache {
+public:
+    explicit TreeCache(int capacity = 8);
+
+    /**
+     * @return The listing, or null if it isn't cached
+     */
+    QSharedPointer<const TreeListing> find(const QString& commitHash);
+
+    void insert(const QString& commitHash, QSharedPointer<const TreeListing> listing);
+
+    /**
+     * @brief Entry for a path in a sorted listing
+     * @return nullptr if the path isn't in the listing
+     */
+    static const TreeEntry* lookup(const TreeListing& listing, const QString& path);
+
+private:
+    QMutex m_mutex;
+    int m_capacity;
+    QHash<QString, QSharedPointer<const TreeListing>> m_listings;
+    QStringList m_recentlyUsed;  // Least recently used first
+};
+
+#endif // TREECACHE_H
@@ -0,0 +1,83 @@
+#ifndef FILECHANGE_H
+#define FILECHANGE_H
+
+#include <QList>
+#include <QString>
+
+/**
+ * @brief One file that differs between two snapshots
+ *
+ * Sizes are in bytes; the missing side of an added or deleted file is 0.
+ */
+struct FileChange {
+    enum class Kind {
+        Added,
+        Modified,
+        Deleted
+    };
+
+    QString path;            // Relative to the game directory, '/'-separated
+    Kind kind;
+    qint64 oldSize;
+    qint64 newSize;
+
+    qint64 sizeDelta() const { return newSize - oldSize; }
+
+    /**
+     * @brief The same change seen from the other side
+     */
+    FileChange reversed() const {
+        FileChange change = *this;
+        change.oldSize = newSize;
+        change.newSize = oldSize;
+        if (kind == Kind::Added) {
+            change.kind = Kind::Deleted;
+        } else if (kind == Kind::Deleted) {
+            change.kind = Kind::Added;
+        }
+        return change;
+    }
+
+    FileChange()
+        : kind(Kind::Modified)
+        , oldSize(0)
+        , newSize(0)
+    {}
+};
+
+/**
+ * @brief Running totals over a stream of FileChanges
+ */
+struct DiffSummary {
+    int added;
+    int modified;
+    int deleted;
+    qint64 bytesAdded;       // Growth summed over files that grew
+    qint64 bytesRemoved;     // Shrinkage summed over files that shrank
+
+    void add(const FileChange& change) {
+        switch (change.kind) {
+        case FileChange::Kind::Added: ++added; break;
+        case FileChange::Kind::Modified: ++modified; break;
+        case FileChange::Kind::Deleted: ++deleted; break;
+        }
+        qint64 delta = change.sizeDelta();
+        if (delta > 0) {
+            bytesAdded += delta;
+        } else {
+            bytesRemoved -= delta;
+        }
+    }
+
+    int fileCount() const { return added + modified + deleted; }
+
+    DiffSummary()
+        : added(0)
+        , modified(0)
+        , deleted(0)
+        , bytesAdded(0)
+        , bytesRemoved(0)
+    {}
+};
+
+#endif // FILECHANGE_H
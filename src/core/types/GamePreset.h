@@ -14,9 +14,12 @@
 struct GamePreset {
     QString gameId;                              // Unique identifier (e.g., "skyrim_se")
     QString displayName;                         // User-friendly name
+    QString steamAppId;                          // Steam app ID, empty if not on Steam
     QMap<QString, QStringList> detectionPaths;   // platform -> list of common paths
     QStringList trackedPaths;                    // Paths/patterns to track in git
     QStringList ignorePatterns;                  // Patterns for .gitignore
+    QStringList regionFiles;                     // Patterns stored chunk by chunk (Anvil .mca)
+    QStringList deltaFiles;                      // Save files stored as deltas between versions
     qint64 largeFileWarningMB;                  // Warn if total size exceeds this
     
     /**
@@ -0,0 +1,104 @@
+#ifndef OBJECTID_H
+#define OBJECTID_H
+
+#include <QByteArrayView>
+#include <QHashFunctions>
+#include <QString>
+#include <array>
+#include <cstring>
+
+/**
+ * @brief A git object name (SHA-1) stored as 20 raw bytes
+ *
+ * A quarter of the size of the 40-character hex QString, with no heap
+ * allocation, and comparisons are a memcmp.
+ */
+class ObjectId {
+public:
+    static constexpr int Size = 20;
+
+    ObjectId() { m_bytes.fill(0); }
+
+    /**
+     * @return Null ID unless the input is exactly 40 hex digits
+     */
+    static ObjectId fromHex(QStringView hex) {
+        ObjectId id;
+        if (hex.size() != Size * 2) {
+            return id;
+        }
+        for (int i = 0; i < Size; ++i) {
+            int high = hexValue(hex[2 * i]);
+            int low = hexValue(hex[2 * i + 1]);
+            if (high < 0 || low < 0) {
+                return ObjectId();
+            }
+            id.m_bytes[i] = static_cast<quint8>((high << 4) | low);
+        }
+        return id;
+    }
+
+    /**
+     * @return Null ID unless the input is exactly 20 bytes
+     */
+    static ObjectId fromBytes(QByteArrayView bytes) {
+        ObjectId id;
+        if (bytes.size() == Size) {
+            std::memcpy(id.m_bytes.data(), bytes.data(), Size);
+        }
+        return id;
+    }
+
+    QString toHex() const {
+        static const char digits[] = "0123456789abcdef";
+        QString hex(Size * 2, Qt::Uninitialized);
+        QChar* out = hex.data();
+        for (quint8 byte : m_bytes) {
+            *out++ = QLatin1Char(digits[byte >> 4]);
+            *out++ = QLatin1Char(digits[byte & 0xf]);
+        }
+        return hex;
+    }
+
+    bool isNull() const {
+        for (quint8 byte : m_bytes) {
+            if (byte != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const quint8* data() const { return m_bytes.data(); }
+
+    bool operator==(const ObjectId& other) const { return m_bytes == other.m_bytes; }
+    bool operator!=(const ObjectId& other) const { return m_bytes != other.m_bytes; }
+    bool operator<(const ObjectId& other) const { return m_bytes < other.m_bytes; }
+
+private:
+    std::array<quint8, Size> m_bytes;
+
+    static int hexValue(QChar c) {
+        ushort u = c.unicode();
+        if (u >= '0' && u <= '9') {
+            return u - '0';
+        }
+        if (u >= 'a' && u <= 'f') {
+            return u - 'a' + 10;
+        }
+        if (u >= 'A' && u <= 'F') {
+            return u - 'A' + 10;
+        }
+        return -1;
+    }
+};
+
+inline size_t qHash(const ObjectId& id, size_t seed = 0)
+{
+    // Object names are uniformly distributed; the first bytes are a fine hash
+    size_t value;
+    std::memcpy(&value, id.data(), sizeof(value));
+    return value ^ seed;
+}
+
+#endif // OBJECTID_H
@@ -1,125 +1,265 @@
 #ifndef RESULT_H
 #define RESULT_H
 
-#include <utility>
+#include <optional>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+template<typename T, typename E>
+class Result;
+
+namespace ResultDetail {
+
+template<typename R>
+struct IsResult : std::false_type {};
+
+template<typename T, typename E>
+struct IsResult<Result<T, E>> : std::true_type {};
+
+} // namespace ResultDetail
 
 /**
  * @brief Rust-style Result<T, E> type for error handling
- * 
+ *
  * Provides a type-safe way to return either a success value or an error.
+ * Only the active alternative is ever constructed, move-only payloads
+ * are supported, and rvalue accessors move the payload out instead of
+ * copying it.
  * Usage:
  *   auto result = someFunction();
  *   if (result.isOk()) {
- *       auto value = result.value();
+ *       auto value = result.takeValue();
  *   } else {
  *       auto error = result.error();
  *   }
+ *
+ * or chained:
+ *   auto size = readFile(path)
+ *       .andThen([](QByteArray data) { return parse(std::move(data)); })
+ *       .map([](const Document& doc) { return doc.size(); });
  */
 template<typename T, typename E>
 class Result {
 public:
-    static Result ok(T value) { 
-        Result r;
-        r.m_isOk = true;
-        r.m_value = std::move(value);
-        return r;
+    using ValueType = T;
+    using ErrorType = E;
+
+    static Result ok(T value) {
+        return Result(std::in_place_index<0>, std::move(value));
     }
-    
-    static Result err(E error) { 
-        Result r;
-        r.m_isOk = false;
-        r.m_error = std::move(error);
-        return r;
+
+    static Result err(E error) {
+        return Result(std::in_place_index<1>, std::move(error));
     }
-    
-    bool isOk() const { return m_isOk; }
-    bool isErr() const { return !m_isOk; }
-    
-    T& value() { 
-        if (!m_isOk) {
+
+    bool isOk() const { return m_storage.index() == 0; }
+    bool isErr() const { return m_storage.index() == 1; }
+
+    T& value() & {
+        if (!isOk()) {
             throw std::runtime_error("Called value() on an error Result");
         }
-        return m_value; 
+        return std::get<0>(m_storage);
     }
-    
-    const T& value() const { 
-        if (!m_isOk) {
+
+    const T& value() const & {
+        if (!isOk()) {
             throw std::runtime_error("Called value() on an error Result");
         }
-        return m_value; 
+        return std::get<0>(m_storage);
+    }
+
+    // By value, so binding a temporary Result's value never dangles
+    T value() && {
+        return takeValue();
+    }
+
+    /**
+     * @brief Move the value out; the Result keeps a moved-from value
+     */
+    T takeValue() {
+        if (!isOk()) {
+            throw std::runtime_error("Called takeValue() on an error Result");
+        }
+        return std::move(std::get<0>(m_storage));
     }
-    
-    E& error() { 
-        if (m_isOk) {
+
+    E& error() & {
+        if (!isErr()) {
             throw std::runtime_error("Called error() on an ok Result");
         }
-        return m_error; 
+        return std::get<1>(m_storage);
     }
-    
-    const E& error() const { 
-        if (m_isOk) {
+
+    const E& error() const & {
+        if (!isErr()) {
             throw std::runtime_error("Called error() on an ok Result");
         }
-        return m_error; 
+        return std::get<1>(m_storage);
     }
-    
-    T valueOr(T defaultValue) const {
-        return m_isOk ? m_value : defaultValue;
+
+    E takeError() {
+        if (!isErr()) {
+            throw std::runtime_error("Called takeError() on an ok Result");
+        }
+        return std::move(std::get<1>(m_storage));
+    }
+
+    T valueOr(T defaultValue) const & {
+        return isOk() ? std::get<0>(m_storage) : std::move(defaultValue);
     }
-    
+
+    T valueOr(T defaultValue) && {
+        return isOk() ? std::move(std::get<0>(m_storage)) : std::move(defaultValue);
+    }
+
+    /**
+     * @brief Transform the value, passing errors through
+     *
+     * f takes T&& and returns U (or void); the result is Result<U, E>.
+     */
+    template<typename F>
+    auto map(F&& f) && {
+        using U = std::invoke_result_t<F, T&&>;
+        if (isErr()) {
+            return Result<U, E>::err(std::move(std::get<1>(m_storage)));
+        }
+        if constexpr (std::is_void_v<U>) {
+            std::forward<F>(f)(std::move(std::get<0>(m_storage)));
+            return Result<void, E>::ok();
+        } else {
+            return Result<U, E>::ok(std::forward<F>(f)(std::move(std::get<0>(m_storage))));
+        }
+    }
+
+    /**
+     * @brief Run a fallible step on the value
+     *
+     * f takes T&& and returns Result<U, E>; errors short-circuit.
+     */
+    template<typename F>
+    auto andThen(F&& f) && {
+        using R = std::invoke_result_t<F, T&&>;
+        static_assert(ResultDetail::IsResult<R>::value, "andThen() needs a function returning Result");
+        if (isErr()) {
+            return R::err(std::move(std::get<1>(m_storage)));
+        }
+        return std::forward<F>(f)(std::move(std::get<0>(m_storage)));
+    }
+
+    /**
+     * @brief Transform the error, passing values through
+     */
+    template<typename F>
+    auto mapError(F&& f) && {
+        using G = std::invoke_result_t<F, E&&>;
+        if (isOk()) {
+            return Result<T, G>::ok(std::move(std::get<0>(m_storage)));
+        }
+        return Result<T, G>::err(std::forward<F>(f)(std::move(std::get<1>(m_storage))));
+    }
+
 private:
-    bool m_isOk;
-    T m_value;
-    E m_error;
-    
-    Result() : m_isOk(false), m_value(), m_error() {}
+    // Indexed rather than typed alternatives, so Result<QString, QString> works
+    std::variant<T, E> m_storage;
+
+    template<std::size_t Index, typename V>
+    Result(std::in_place_index_t<Index> index, V&& payload)
+        : m_storage(index, std::forward<V>(payload))
+    {}
 };
 
 /**
  * @brief Specialization for void success type
- * 
+ *
  * Used when an operation doesn't return a value on success,
  * only indicates success or failure.
  */
 template<typename E>
 class Result<void, E> {
 public:
-    static Result ok() { 
-        Result r;
-        r.m_isOk = true;
-        return r;
+    using ValueType = void;
+    using ErrorType = E;
+
+    static Result ok() {
+        return Result();
     }
-    
-    static Result err(E error) { 
+
+    static Result err(E error) {
         Result r;
-        r.m_isOk = false;
-        r.m_error = std::move(error);
+        r.m_error.emplace(std::move(error));
         return r;
     }
-    
-    bool isOk() const { return m_isOk; }
-    bool isErr() const { return !m_isOk; }
-    
-    E& error() { 
-        if (m_isOk) {
+
+    bool isOk() const { return !m_error.has_value(); }
+    bool isErr() const { return m_error.has_value(); }
+
+    E& error() & {
+        if (isOk()) {
             throw std::runtime_error("Called error() on an ok Result");
         }
-        return m_error; 
+        return *m_error;
     }
-    
-    const E& error() const { 
-        if (m_isOk) {
+
+    const E& error() const & {
+        if (isOk()) {
             throw std::runtime_error("Called error() on an ok Result");
         }
-        return m_error; 
+        return *m_error;
+    }
+
+    E takeError() {
+        if (isOk()) {
+            throw std::runtime_error("Called takeError() on an ok Result");
+        }
+        return std::move(*m_error);
+    }
+
+    /**
+     * @brief Produce a value on success; f takes no arguments
+     */
+    template<typename F>
+    auto map(F&& f) && {
+        using U = std::invoke_result_t<F>;
+        if (isErr()) {
+            return Result<U, E>::err(std::move(*m_error));
+        }
+        if constexpr (std::is_void_v<U>) {
+            std::forward<F>(f)();
+            return Result<void, E>::ok();
+        } else {
+            return Result<U, E>::ok(std::forward<F>(f)());
+        }
     }
-    
+
+    /**
+     * @brief Run the next fallible step on success
+     */
+    template<typename F>
+    auto andThen(F&& f) && {
+        using R = std::invoke_result_t<F>;
+        static_assert(ResultDetail::IsResult<R>::value, "andThen() needs a function returning Result");
+        if (isErr()) {
+            return R::err(std::move(*m_error));
+        }
+        return std::forward<F>(f)();
+    }
+
+    template<typename F>
+    auto mapError(F&& f) && {
+        using G = std::invoke_result_t<F, E&&>;
+        if (isOk()) {
+            return Result<void, G>::ok();
+        }
+        return Result<void, G>::err(std::forward<F>(f)(std::move(*m_error)));
+    }
+
 private:
-    bool m_isOk;
-    E m_error;
-    
-    Result() : m_isOk(false), m_error() {}
+    std::optional<E> m_error;  // Empty on success
+
+    Result() = default;
 };
 
 #endif // RESULT_H
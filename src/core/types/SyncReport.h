@@ -0,0 +1,20 @@
+#ifndef SYNCREPORT_H
+#define SYNCREPORT_H
+
+#include <QString>
+
+/**
+ * @brief Outcome of pushing snapshots to a remote repository or chunk remote
+ */
+struct SyncReport {
+    QString remoteUrl;
+    QString remoteTip;       // Newest snapshot the remote holds after the sync
+    int pushedSnapshots = 0;
+    int batches = 0;         // Separate transfers; each one is a resume point
+    int uploadedChunks = 0;  // Chunk remotes only: chunks the remote lacked
+    qint64 uploadedBytes = 0;
+
+    bool isUpToDate() const { return pushedSnapshots == 0; }
+};
+
+#endif // SYNCREPORT_H
@@ -0,0 +1,290 @@
+#include "DaemonServer.h"
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QLocalSocket>
+#include <QPointer>
+#include "core/ProjectCommands.h"
+#include "ipc/DaemonProtocol.h"
+#include "utils/Logger.h"
+
+namespace {
+
+constexpr int ScheduleTickMs = 60 * 1000;
+constexpr qint64 MaintenanceIntervalSecs = 24 * 60 * 60;
+
+using JobResult = JobScheduler::JobResult;
+
+/**
+ * @brief Load a preset, detecting the game when no ID is given
+ *
+ * Detection reads the preset index, so this runs inside jobs, never on
+ * the event loop.
+ */
+GamePreset resolvePreset(PresetManager& presetManager, const QString& path, const QString& presetId)
+{
+    QString gameId = presetId;
+    if (gameId.isEmpty()) {
+        auto gameResult = presetManager.detectGame(path);
+        if (gameResult.isOk()) {
+            gameId = gameResult.value();
+        }
+    }
+    if (gameId.isEmpty()) {
+        return GamePreset();
+    }
+
+    auto presetResult = presetManager.loadPreset(gameId);
+    return presetResult.isOk() ? presetResult.value() : GamePreset();
+}
+
+} // namespace
+
+DaemonServer::DaemonServer(ProjectRegistry* registry, JobScheduler* scheduler, QObject* parent)
+    : QObject(parent)
+    , m_registry(registry)
+    , m_scheduler(scheduler)
+{
+    connect(&m_server, &QLocalServer::newConnection, this, &DaemonServer::onNewConnection);
+    connect(&m_scheduleTimer, &QTimer::timeout, this, &DaemonServer::onScheduleTick);
+}
+
+Result<void, QString> DaemonServer::listen()
+{
+    QString name = DaemonProtocol::serverName();
+
+    // A daemon that is already answering owns the name; otherwise the
+    // socket file is left over from a crash
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(200)) {
+        return Result<void, QString>::err("vgvcd is already running");
+    }
+    QLocalServer::removeServer(name);
+
+    // Detection scans the Steam libraries once; do it before serving requests
+    m_presetManager.ensureIndex();
+
+    m_server.setSocketOptions(QLocalServer::UserAccessOption);
+    if (!m_server.listen(name)) {
+        return Result<void, QString>::err(m_server.errorString());
+    }
+
+    m_scheduleTimer.start(ScheduleTickMs);
+    onScheduleTick();
+
+    Logger::info(QString("Listening on %1").arg(m_server.fullServerName()), "DaemonServer");
+    return Result<void, QString>::ok();
+}
+
+void DaemonServer::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server.nextPendingConnection()) {
+        m_buffers.insert(socket, QByteArray());
+
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            m_buffers.remove(socket);
+            socket->deleteLater();
+        });
+
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            QByteArray& buffer = m_buffers[socket];
+            buffer += socket->readAll();
+
+            QPointer<QLocalSocket> guard(socket);
+            for (const QJsonObject& request : DaemonProtocol::takeMessages(buffer)) {
+                QJsonValue id = request["id"];
+                handleRequest(request, [guard, id](const JobResult& result) {
+                    if (!guard) {
+                        return;  // Client went away; the job still ran
+                    }
+                    QJsonObject response{{"id", id}};
+                    if (result.isOk()) {
+                        response["result"] = result.value();
+                    } else {
+                        response["error"] = result.error();
+                    }
+                    guard->write(DaemonProtocol::encode(response));
+                });
+            }
+        });
+    }
+}
+
+void DaemonServer::handleRequest(const QJsonObject& request, Reply reply)
+{
+    const QString method = request["method"].toString();
+    const QJsonObject params = request["params"].toObject();
+    const QString path = ProjectRegistry::normalizePath(params["path"].toString());
+
+    if (method == "ping") {
+        reply(JobResult::ok(QJsonObject{
+            {"version", QCoreApplication::applicationVersion()},
+            {"pid", QCoreApplication::applicationPid()}
+        }));
+    } else if (method == "status") {
+        QJsonObject status = m_scheduler->status();
+        status["projects"] = m_registry->projects().size();
+        reply(JobResult::ok(status));
+    } else if (method == "projects") {
+        QJsonArray projects;
+        for (const RegisteredProject& project : m_registry->projects()) {
+            projects.append(project.toJson());
+        }
+        reply(JobResult::ok(QJsonObject{{"projects", projects}}));
+    } else if (method == "register") {
+        registerProject(params, reply);
+    } else if (method == "unregister") {
+        if (!m_registry->remove(path)) {
+            reply(JobResult::err(QString("Not registered: %1").arg(path)));
+            return;
+        }
+        m_registry->save();
+        reply(JobResult::ok(QJsonObject{{"path", path}}));
+    } else if (method == "snapshot") {
+        // Requested snapshots run at full speed unless the client (e.g. a
+        // game-launch hook) asks to stay out of the game's way
+        ExecutionClass executionClass = params["background"].toBool()
+            ? ExecutionClass::Background : ExecutionClass::Foreground;
+        submitSnapshot(path, params["message"].toString(), params["preset"].toString(),
+                       executionClass, reply);
+    } else if (method == "list") {
+        int limit = params["limit"].toInt(50);
+        m_scheduler->submit(path, method, JobScheduler::Weight::Light,
+            [path, limit]() { return ProjectCommands::list(path, limit); }, reply);
+    } else if (method == "restore") {
+        QString presetId = presetIdFor(path, params["preset"].toString());
+        QString snapshotId = params["snapshot"].toString();
+        PresetManager* presetManager = &m_presetManager;
+        m_scheduler->submit(path, method, JobScheduler::Weight::Heavy,
+            [presetManager, path, snapshotId, presetId]() {
+                GamePreset preset = resolvePreset(*presetManager, path, presetId);
+                return ProjectCommands::restore(path, snapshotId, preset);
+            },
+            reply);
+    } else if (method == "export") {
+        QString snapshotId = params["snapshot"].toString();
+        QString archive = params["archive"].toString();
+        m_scheduler->submit(path, method, JobScheduler::Weight::Heavy,
+            [path, snapshotId, archive]() { return ProjectCommands::exportSnapshot(path, snapshotId, archive); },
+            reply);
+    } else if (method == "maintenance") {
+        m_scheduler->submit(path, method, JobScheduler::Weight::Heavy,
+            [path]() { return ProjectCommands::maintenance(path); }, reply);
+    } else {
+        reply(JobResult::err(QString("Unknown method: %1").arg(method)));
+    }
+}
+
+void DaemonServer::registerProject(const QJsonObject& params, Reply reply)
+{
+    const QString path = ProjectRegistry::normalizePath(params["path"].toString());
+    if (!QFileInfo(path).isDir()) {
+        reply(JobResult::err(QString("Not a directory: %1").arg(path)));
+        return;
+    }
+
+    // Runs on the event loop once the game is known; the registry may have
+    // changed while a detection job ran, so it is read only here
+    auto finish = [this, params, path, reply](const QString& detectedGameId) {
+        RegisteredProject project = m_registry->project(path);
+        project.path = path;
+        if (params.contains("preset")) {
+            project.gameId = params["preset"].toString();
+        } else if (project.gameId.isEmpty()) {
+            project.gameId = detectedGameId;
+        }
+        if (params.contains("interval_minutes")) {
+            project.snapshotIntervalMinutes = qMax(0, params["interval_minutes"].toInt());
+        }
+
+        m_registry->upsert(project);
+        auto saveResult = m_registry->save();
+        if (saveResult.isErr()) {
+            reply(JobResult::err(saveResult.error()));
+            return;
+        }
+        reply(JobResult::ok(project.toJson()));
+    };
+
+    if (params.contains("preset") || !m_registry->project(path).gameId.isEmpty()) {
+        finish(QString());
+        return;
+    }
+
+    PresetManager* presetManager = &m_presetManager;
+    m_scheduler->submit(path, "register", JobScheduler::Weight::Light,
+        [presetManager, path]() {
+            auto gameResult = presetManager->detectGame(path);
+            return JobResult::ok(QJsonObject{{"game", gameResult.isOk() ? gameResult.value() : QString()}});
+        },
+        [finish](const JobResult& result) {
+            finish(result.isOk() ? result.value()["game"].toString() : QString());
+        });
+}
+
+void DaemonServer::submitSnapshot(const QString& path, const QString& message,
+                                  const QString& presetId, ExecutionClass executionClass, Reply reply)
+{
+    QString resolvedPresetId = presetIdFor(path, presetId);
+    PresetManager* presetManager = &m_presetManager;
+
+    m_scheduler->submit(path, "snapshot", JobScheduler::Weight::Heavy,
+        [presetManager, path, message, resolvedPresetId, executionClass]() {
+            GamePreset preset = resolvePreset(*presetManager, path, resolvedPresetId);
+            return ProjectCommands::snapshot(path, message, preset, executionClass);
+        },
+        [this, path, reply](const JobResult& result) {
+            if (result.isOk() && result.value()["status"].toString() == "created"
+                && m_registry->contains(path)) {
+                RegisteredProject project = m_registry->project(path);
+                project.lastSnapshot = QDateTime::currentDateTime();
+                m_registry->upsert(project);
+                m_registry->save();
+            }
+            if (reply) {
+                reply(result);
+            }
+        });
+}
+
+void DaemonServer::onScheduleTick()
+{
+    QDateTime now = QDateTime::currentDateTime();
+
+    for (const RegisteredProject& project : m_registry->projects()) {
+        if (project.snapshotIntervalMinutes > 0) {
+            // Checked from the last check, not the last snapshot, so an
+            // unchanged project isn't rescanned every tick
+            QDateTime lastCheck = m_lastScheduledCheck.value(project.path, project.lastSnapshot);
+            if ((!lastCheck.isValid() || lastCheck.addSecs(project.snapshotIntervalMinutes * 60) <= now)
+                && !m_scheduler->hasJob(project.path, "snapshot")) {
+                m_lastScheduledCheck.insert(project.path, now);
+                submitSnapshot(project.path, "[AUTO] Scheduled snapshot", QString(),
+                               ExecutionClass::Background, Reply());
+            }
+        }
+
+        if ((!project.lastMaintenance.isValid()
+             || project.lastMaintenance.addSecs(MaintenanceIntervalSecs) <= now)
+            && !m_scheduler->hasJob(project.path, "maintenance")) {
+            QString path = project.path;
+            m_scheduler->submit(path, "maintenance", JobScheduler::Weight::Heavy,
+                [path]() { return ProjectCommands::maintenance(path, ExecutionClass::Background); },
+                [this, path](const JobResult&) {
+                    // Recorded even on failure so a broken repo isn't retried every minute
+                    if (m_registry->contains(path)) {
+                        RegisteredProject updated = m_registry->project(path);
+                        updated.lastMaintenance = QDateTime::currentDateTime();
+                        m_registry->upsert(updated);
+                        m_registry->save();
+                    }
+                });
+        }
+    }
+}
+
+QString DaemonServer::presetIdFor(const QString& path, const QString& presetId) const
+{
+    return presetId.isEmpty() ? m_registry->project(path).gameId : presetId;
+}
@@ -0,0 +1,60 @@
+#ifndef DAEMONSERVER_H
+#define DAEMONSERVER_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QObject>
+#include <QTimer>
+#include <functional>
+#include "JobScheduler.h"
+#include "core/PresetManager.h"
+#include "core/ProjectRegistry.h"
+#include "core/types/Result.h"
+#include "utils/ExecutionPolicy.h"
+
+class QLocalSocket;
+
+/**
+ * @brief vgvcd request handling and scheduled work
+ *
+ * Owns the project registry and routes every project operation, whether
+ * requested by a client or due on a schedule, through the JobScheduler.
+ */
+class DaemonServer : public QObject {
+    Q_OBJECT
+
+public:
+    DaemonServer(ProjectRegistry* registry, JobScheduler* scheduler, QObject* parent = nullptr);
+    ~DaemonServer() override = default;
+
+    Result<void, QString> listen();
+
+private slots:
+    void onNewConnection();
+    void onScheduleTick();
+
+private:
+    ProjectRegistry* m_registry;
+    JobScheduler* m_scheduler;
+    PresetManager m_presetManager;
+    QLocalServer m_server;
+    QTimer m_scheduleTimer;
+    QHash<QLocalSocket*, QByteArray> m_buffers;
+    QHash<QString, QDateTime> m_lastScheduledCheck;  // project path -> time
+
+    using Reply = std::function<void(const Result<QJsonObject, QString>&)>;
+
+    void handleRequest(const QJsonObject& request, Reply reply);
+    void registerProject(const QJsonObject& params, Reply reply);
+    void submitSnapshot(const QString& path, const QString& message, const QString& presetId,
+                        ExecutionClass executionClass, Reply reply);
+
+    /**
+     * @brief The explicit preset, else the registered one; empty to detect
+     */
+    QString presetIdFor(const QString& path, const QString& presetId) const;
+};
+
+#endif // DAEMONSERVER_H
@@ -0,0 +1,54 @@
+#include "IoBudget.h"
+#include <QStorageInfo>
+
+IoBudget::IoBudget(int maxJobs, int maxJobsPerDevice)
+    : m_maxJobs(qMax(1, maxJobs))
+    , m_maxJobsPerDevice(qMax(1, maxJobsPerDevice))
+    , m_activeJobs(0)
+{
+}
+
+bool IoBudget::tryAcquire(const QString& device)
+{
+    if (m_activeJobs >= m_maxJobs || m_activeByDevice.value(device) >= m_maxJobsPerDevice) {
+        return false;
+    }
+
+    ++m_activeJobs;
+    ++m_activeByDevice[device];
+    return true;
+}
+
+void IoBudget::release(const QString& device)
+{
+    m_activeJobs = qMax(0, m_activeJobs - 1);
+
+    auto it = m_activeByDevice.find(device);
+    if (it != m_activeByDevice.end() && --it.value() <= 0) {
+        m_activeByDevice.erase(it);
+    }
+}
+
+QJsonObject IoBudget::status() const
+{
+    QJsonObject devices;
+    for (auto it = m_activeByDevice.constBegin(); it != m_activeByDevice.constEnd(); ++it) {
+        devices[it.key()] = it.value();
+    }
+
+    return QJsonObject{
+        {"maxJobs", m_maxJobs},
+        {"maxJobsPerDevice", m_maxJobsPerDevice},
+        {"activeJobs", m_activeJobs},
+        {"activeByDevice", devices}
+    };
+}
+
+QString IoBudget::deviceFor(const QString& path)
+{
+    QStorageInfo storage(path);
+    if (!storage.isValid()) {
+        return QString();
+    }
+    return QString::fromUtf8(storage.device());
+}
@@ -0,0 +1,40 @@
+#ifndef IOBUDGET_H
+#define IOBUDGET_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+
+/**
+ * @brief Global limit on concurrent disk-heavy jobs
+ *
+ * Caps the number of heavy jobs running at once, and separately the number
+ * running against any one storage device, so snapshots of projects on
+ * different disks proceed in parallel while projects sharing a disk take
+ * turns instead of seeking against each other. Main thread only.
+ */
+class IoBudget {
+public:
+    IoBudget(int maxJobs, int maxJobsPerDevice);
+
+    bool tryAcquire(const QString& device);
+    void release(const QString& device);
+
+    int maxJobs() const { return m_maxJobs; }
+    int activeJobs() const { return m_activeJobs; }
+
+    QJsonObject status() const;
+
+    /**
+     * @brief Identifier of the storage device holding a path
+     */
+    static QString deviceFor(const QString& path);
+
+private:
+    int m_maxJobs;
+    int m_maxJobsPerDevice;
+    int m_activeJobs;
+    QHash<QString, int> m_activeByDevice;
+};
+
+#endif // IOBUDGET_H
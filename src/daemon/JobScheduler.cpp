@@ -0,0 +1,131 @@
+#include "JobScheduler.h"
+#include <QFutureWatcher>
+#include <QJsonArray>
+#include <QtConcurrent>
+#include "utils/Logger.h"
+#include "utils/Tracer.h"
+
+JobScheduler::JobScheduler(int maxJobs, int maxJobsPerDevice, QObject* parent)
+    : QObject(parent)
+    , m_budget(maxJobs, maxJobsPerDevice)
+    , m_nextId(1)
+{
+    // One thread per budget slot, plus one so light jobs never queue
+    // behind a full set of heavy ones
+    m_pool.setMaxThreadCount(m_budget.maxJobs() + 1);
+    m_pool.setObjectName("JobScheduler");
+}
+
+JobScheduler::~JobScheduler()
+{
+    m_pool.waitForDone();
+}
+
+void JobScheduler::submit(const QString& projectPath, const QString& kind, Weight weight,
+                          JobWork work, JobDone done)
+{
+    auto deviceIt = m_devices.find(projectPath);
+    if (deviceIt == m_devices.end()) {
+        deviceIt = m_devices.insert(projectPath, IoBudget::deviceFor(projectPath));
+    }
+
+    Job job;
+    job.id = m_nextId++;
+    job.projectPath = projectPath;
+    job.device = deviceIt.value();
+    job.kind = kind;
+    job.weight = weight;
+    job.work = std::move(work);
+    job.done = std::move(done);
+    job.queuedAtUs = Tracer::nowUs();
+    m_pending.append(std::move(job));
+
+    dispatch();
+}
+
+bool JobScheduler::hasJob(const QString& projectPath, const QString& kind) const
+{
+    if (m_running.value(projectPath) == kind) {
+        return true;
+    }
+    for (const Job& job : m_pending) {
+        if (job.projectPath == projectPath && job.kind == kind) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QJsonObject JobScheduler::status() const
+{
+    QJsonArray running;
+    for (auto it = m_running.constBegin(); it != m_running.constEnd(); ++it) {
+        running.append(QJsonObject{{"path", it.key()}, {"kind", it.value()}});
+    }
+
+    QJsonArray pending;
+    for (const Job& job : m_pending) {
+        pending.append(QJsonObject{{"path", job.projectPath}, {"kind", job.kind}});
+    }
+
+    return QJsonObject{
+        {"budget", m_budget.status()},
+        {"running", running},
+        {"pending", pending}
+    };
+}
+
+void JobScheduler::dispatch()
+{
+    // Walk in submission order; a blocked job doesn't hold back jobs for
+    // other projects or other disks
+    for (int i = 0; i < m_pending.size();) {
+        const Job& job = m_pending[i];
+
+        bool projectBusy = m_running.contains(job.projectPath);
+        bool budgetOk = projectBusy ? false
+            : job.weight == Weight::Light || m_budget.tryAcquire(job.device);
+
+        if (projectBusy || !budgetOk) {
+            ++i;
+            continue;
+        }
+
+        start(m_pending.takeAt(i));
+    }
+}
+
+void JobScheduler::start(Job job)
+{
+    m_running.insert(job.projectPath, job.kind);
+
+    QString taskName = QString("%1 %2").arg(job.kind, job.projectPath);
+    qint64 queuedAt = job.queuedAtUs;
+    JobWork work = job.work;
+
+    auto* watcher = new QFutureWatcher<JobResult>(this);
+    connect(watcher, &QFutureWatcher<JobResult>::finished, this, [this, watcher, job]() {
+        JobResult result = watcher->result();
+        watcher->deleteLater();
+
+        m_running.remove(job.projectPath);
+        if (job.weight == Weight::Heavy) {
+            m_budget.release(job.device);
+        }
+        if (result.isErr()) {
+            Logger::warning(QString("%1 failed for %2: %3")
+                .arg(job.kind, job.projectPath, result.error()), "JobScheduler");
+        }
+
+        if (job.done) {
+            job.done(result);
+        }
+        dispatch();
+    });
+
+    watcher->setFuture(QtConcurrent::run(&m_pool, [work, taskName, queuedAt]() -> JobResult {
+        Tracer::recordQueueWait(taskName, queuedAt);
+        TraceSpan span("daemon", taskName);
+        return work();
+    }));
+}
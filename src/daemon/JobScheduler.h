@@ -0,0 +1,69 @@
+#ifndef JOBSCHEDULER_H
+#define JOBSCHEDULER_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+#include <functional>
+#include "IoBudget.h"
+#include "core/types/Result.h"
+
+/**
+ * @brief Runs project jobs on a private pool under the global I/O budget
+ *
+ * Jobs start in submission order, subject to three rules: at most one job
+ * per project at a time (git serializes on the index lock anyway), heavy
+ * jobs only when the I/O budget has room on their device, and light jobs
+ * (history listing) never wait for budget. Completion callbacks run on the
+ * scheduler's thread.
+ */
+class JobScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    using JobResult = Result<QJsonObject, QString>;
+    using JobWork = std::function<JobResult()>;
+    using JobDone = std::function<void(const JobResult&)>;
+
+    enum class Weight {
+        Light,  // Reads a little metadata
+        Heavy   // Scans, hashes or writes game data
+    };
+
+    JobScheduler(int maxJobs, int maxJobsPerDevice, QObject* parent = nullptr);
+    ~JobScheduler() override;
+
+    void submit(const QString& projectPath, const QString& kind, Weight weight,
+                JobWork work, JobDone done);
+
+    bool hasJob(const QString& projectPath, const QString& kind) const;
+
+    QJsonObject status() const;
+
+private:
+    struct Job {
+        int id;
+        QString projectPath;
+        QString device;
+        QString kind;
+        Weight weight;
+        JobWork work;
+        JobDone done;
+        qint64 queuedAtUs;
+    };
+
+    QThreadPool m_pool;
+    IoBudget m_budget;
+    QList<Job> m_pending;
+    QHash<QString, QString> m_running;   // project path -> job kind
+    QHash<QString, QString> m_devices;   // project path -> storage device
+    int m_nextId;
+
+    void dispatch();
+    void start(Job job);
+};
+
+#endif // JOBSCHEDULER_H
@@ -0,0 +1,59 @@
+#include "DaemonServer.h"
+#include "JobScheduler.h"
+#include "core/ProjectRegistry.h"
+#include "utils/Logger.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QStandardPaths>
+#include <QTextStream>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("VideoGameVersionControl");
+    QCoreApplication::setApplicationVersion("1.0.0");
+    QCoreApplication::setOrganizationName("VGVC Team");
+    QCoreApplication::setOrganizationDomain("github.com/vgvc");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Background service that snapshots and maintains all registered game projects.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({
+        {"max-jobs", "Disk-heavy jobs running at once across all projects.", "count", "2"},
+        {"max-jobs-per-disk", "Disk-heavy jobs running at once on one storage device.", "count", "1"},
+        {"registry", "Project registry file.", "file", ProjectRegistry::defaultFilePath()},
+    });
+    parser.process(app);
+
+    Logger::setLogLevel(Logger::Level::Info);
+    QString logDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (QDir().mkpath(logDir)) {
+        Logger::setLogFile(logDir + "/vgvcd.log");
+    }
+
+    ProjectRegistry registry;
+    auto loadResult = registry.load(parser.value("registry"));
+    if (loadResult.isErr()) {
+        Logger::error(loadResult.error(), "Main");
+        Logger::shutdown();
+        return 1;
+    }
+
+    JobScheduler scheduler(parser.value("max-jobs").toInt(), parser.value("max-jobs-per-disk").toInt());
+    DaemonServer server(&registry, &scheduler);
+
+    auto listenResult = server.listen();
+    if (listenResult.isErr()) {
+        QTextStream(stderr) << "vgvcd: " << listenResult.error() << Qt::endl;
+        Logger::shutdown();
+        return 1;
+    }
+
+    Logger::info(QString("vgvcd started with %1 registered projects").arg(registry.projects().size()), "Main");
+    int result = app.exec();
+
+    Logger::shutdown();
+    return result;
+}
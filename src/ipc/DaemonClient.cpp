@@ -0,0 +1,61 @@
+#include "DaemonClient.h"
+#include <QDeadlineTimer>
+#include "DaemonProtocol.h"
+
+DaemonClient::DaemonClient()
+    : m_nextId(1)
+{
+}
+
+bool DaemonClient::connectToDaemon(int timeoutMs)
+{
+    m_socket.connectToServer(DaemonProtocol::serverName());
+    return m_socket.waitForConnected(timeoutMs);
+}
+
+bool DaemonClient::isConnected() const
+{
+    return m_socket.state() == QLocalSocket::ConnectedState;
+}
+
+Result<QJsonObject, QString> DaemonClient::call(const QString& method, const QJsonObject& params,
+                                                int timeoutMs)
+{
+    if (!isConnected()) {
+        return Result<QJsonObject, QString>::err("Not connected to vgvcd");
+    }
+
+    int id = m_nextId++;
+    m_socket.write(DaemonProtocol::encode(QJsonObject{
+        {"id", id},
+        {"method", method},
+        {"params", params}
+    }));
+    if (!m_socket.waitForBytesWritten(5000)) {
+        return Result<QJsonObject, QString>::err("Failed to send request to vgvcd");
+    }
+
+    QDeadlineTimer deadline(timeoutMs < 0 ? QDeadlineTimer::Forever : QDeadlineTimer(timeoutMs));
+    while (true) {
+        for (const QJsonObject& message : DaemonProtocol::takeMessages(m_buffer)) {
+            if (message["id"].toInt() != id) {
+                continue;  // Response to an abandoned earlier request
+            }
+            if (message.contains("error")) {
+                return Result<QJsonObject, QString>::err(message["error"].toString());
+            }
+            return Result<QJsonObject, QString>::ok(message["result"].toObject());
+        }
+
+        if (deadline.hasExpired()) {
+            return Result<QJsonObject, QString>::err("Timed out waiting for vgvcd");
+        }
+        if (!m_socket.waitForReadyRead(deadline.isForever() ? -1 : int(deadline.remainingTime()))) {
+            if (!isConnected()) {
+                return Result<QJsonObject, QString>::err("Connection to vgvcd lost");
+            }
+            continue;
+        }
+        m_buffer += m_socket.readAll();
+    }
+}
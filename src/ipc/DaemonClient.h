@@ -0,0 +1,41 @@
+#ifndef DAEMONCLIENT_H
+#define DAEMONCLIENT_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QString>
+#include "core/types/Result.h"
+
+/**
+ * @brief Blocking client for the vgvcd daemon
+ *
+ * Used by vgvc-cli and the GUI to hand work to the daemon, which owns
+ * scheduling and the I/O budget for every registered project.
+ */
+class DaemonClient {
+public:
+    DaemonClient();
+
+    /**
+     * @brief Connect if a daemon is running
+     * @return false quickly when no daemon is listening
+     */
+    bool connectToDaemon(int timeoutMs = 500);
+    bool isConnected() const;
+
+    /**
+     * @brief Send a request and wait for its response
+     * @param timeoutMs -1 waits indefinitely (snapshots may queue behind
+     *        other projects' jobs)
+     */
+    Result<QJsonObject, QString> call(const QString& method, const QJsonObject& params = QJsonObject(),
+                                      int timeoutMs = -1);
+
+private:
+    QLocalSocket m_socket;
+    QByteArray m_buffer;
+    int m_nextId;
+};
+
+#endif // DAEMONCLIENT_H
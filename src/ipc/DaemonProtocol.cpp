@@ -0,0 +1,36 @@
+#include "DaemonProtocol.h"
+#include <QJsonDocument>
+#include <QList>
+
+namespace DaemonProtocol {
+
+QString serverName()
+{
+    QString user = qEnvironmentVariable("USER", qEnvironmentVariable("USERNAME"));
+    return user.isEmpty() ? QString("vgvcd") : QString("vgvcd-%1").arg(user);
+}
+
+QByteArray encode(const QJsonObject& message)
+{
+    return QJsonDocument(message).toJson(QJsonDocument::Compact) + '\n';
+}
+
+QList<QJsonObject> takeMessages(QByteArray& buffer)
+{
+    QList<QJsonObject> messages;
+
+    int start = 0;
+    int newline;
+    while ((newline = buffer.indexOf('\n', start)) >= 0) {
+        QJsonDocument doc = QJsonDocument::fromJson(buffer.mid(start, newline - start));
+        if (doc.isObject()) {
+            messages.append(doc.object());
+        }
+        start = newline + 1;
+    }
+    buffer.remove(0, start);
+
+    return messages;
+}
+
+} // namespace DaemonProtocol
@@ -0,0 +1,38 @@
+#ifndef DAEMONPROTOCOL_H
+#define DAEMONPROTOCOL_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief Wire format shared by vgvcd and its clients
+ *
+ * Messages are compact JSON objects, one per line, over a QLocalSocket
+ * (a Unix socket or Windows named pipe private to the user).
+ *
+ * Request:  {"id": 1, "method": "snapshot", "params": {...}}
+ * Response: {"id": 1, "result": {...}}  or  {"id": 1, "error": "..."}
+ */
+namespace DaemonProtocol {
+
+/**
+ * @brief Per-user local server name
+ */
+QString serverName();
+
+/**
+ * @brief Serialize a message including its line terminator
+ */
+QByteArray encode(const QJsonObject& message);
+
+/**
+ * @brief Split complete lines off a receive buffer
+ * @return Parsed messages; incomplete trailing data stays in the buffer
+ */
+QList<QJsonObject> takeMessages(QByteArray& buffer);
+
+} // namespace DaemonProtocol
+
+#endif // DAEMONPROTOCOL_H
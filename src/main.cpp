@@ -1,7 +1,10 @@
 #include "ui/MainWindow.h"
 #include "utils/Logger.h"
+#include "utils/Tracer.h"
 #include <QApplication>
 #include <QStyleFactory>
+#include <QStandardPaths>
+#include <QDir>
 
 int main(int argc, char *argv[])
 {
@@ -15,8 +18,18 @@ int main(int argc, char *argv[])
     
     // Initialize logger
     Logger::setLogLevel(Logger::Level::Debug);
+    QString logDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (QDir().mkpath(logDir)) {
+        Logger::setLogFile(logDir + "/vgvc.log");
+    }
     Logger::info("Application starting", "Main");
     
+    // VGVC_TRACE=<file> records a Chrome trace of the whole session
+    QString tracePath = qEnvironmentVariable("VGVC_TRACE");
+    if (!tracePath.isEmpty()) {
+        Tracer::setEnabled(true);
+    }
+    
     // Set application style
     QApplication::setStyle(QStyleFactory::create("Fusion"));
     
@@ -29,5 +42,14 @@ int main(int argc, char *argv[])
     int result = app.exec();
     
     Logger::info("Application shutting down", "Main");
+    
+    if (!tracePath.isEmpty()) {
+        auto traceResult = Tracer::writeChromeTrace(tracePath);
+        if (traceResult.isErr()) {
+            Logger::error(traceResult.error(), "Main");
+        }
+    }
+    
+    Logger::shutdown();
     return result;
 }
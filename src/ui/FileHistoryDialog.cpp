@@ -0,0 +1,114 @@
+#include "FileHistoryDialog.h"
+#include <QVBoxLayout>
+#include <QDialogButtonBox>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QMessageBox>
+#include "core/SnapshotManager.h"
+
+FileHistoryDialog::FileHistoryDialog(const QString& filePath, SnapshotManager* snapshotManager,
+                                     QWidget* parent)
+    : QDialog(parent)
+    , m_filePath(filePath)
+    , m_snapshotManager(snapshotManager)
+{
+    setWindowTitle(QString("History of %1").arg(QFileInfo(filePath).fileName()));
+    resize(500, 400);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    m_statusLabel = new QLabel("Loading history...", this);
+    m_statusLabel->setWordWrap(true);
+    layout->addWidget(m_statusLabel);
+
+    m_versionList = new QListWidget(this);
+    layout->addWidget(m_versionList, 1);
+
+    // Buttons
+    QDialogButtonBox* buttonBox = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    m_restoreButton = buttonBox->addButton("Restore This Version", QDialogButtonBox::ActionRole);
+    m_restoreButton->setEnabled(false);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    connect(m_restoreButton, &QPushButton::clicked, this, &FileHistoryDialog::onRestoreClicked);
+    connect(m_versionList, &QListWidget::itemSelectionChanged,
+            this, &FileHistoryDialog::onSelectionChanged);
+    layout->addWidget(buttonBox);
+
+    loadHistory();
+}
+
+void FileHistoryDialog::loadHistory()
+{
+    auto* watcher = new QFutureWatcher<Result<QList<FileVersion>, QString>>(this);
+    connect(watcher, &QFutureWatcher<Result<QList<FileVersion>, QString>>::finished,
+            this, [this, watcher]() {
+        auto result = watcher->future().takeResult();
+        watcher->deleteLater();
+
+        if (result.isErr()) {
+            m_statusLabel->setText(QString("Could not load history: %1").arg(result.error()));
+            return;
+        }
+
+        m_versions = result.takeValue();
+        if (m_versions.isEmpty()) {
+            m_statusLabel->setText("This file isn't in any snapshot yet.");
+            return;
+        }
+
+        m_statusLabel->setText(QString("%1 is different in %2 snapshots:")
+            .arg(QFileInfo(m_filePath).fileName())
+            .arg(m_versions.size()));
+        for (const FileVersion& version : m_versions) {
+            QString text = QString("%1 - %2")
+                .arg(version.timestamp.toString("yyyy-MM-dd HH:mm"))
+                .arg(version.description);
+            auto* item = new QListWidgetItem(version.isDeleted() ? text + " (deleted)" : text);
+            if (version.isDeleted()) {
+                item->setFlags(item->flags() & ~Qt::ItemIsEnabled);
+            }
+            m_versionList->addItem(item);
+        }
+    });
+    watcher->setFuture(m_snapshotManager->fileHistory(m_filePath));
+}
+
+void FileHistoryDialog::onSelectionChanged()
+{
+    int row = m_versionList->currentRow();
+    m_restoreButton->setEnabled(row >= 0 && row < m_versions.size() && !m_versions[row].isDeleted());
+}
+
+void FileHistoryDialog::onRestoreClicked()
+{
+    int row = m_versionList->currentRow();
+    if (row < 0 || row >= m_versions.size()) {
+        return;
+    }
+    const FileVersion& version = m_versions[row];
+
+    int ret = QMessageBox::question(this, "Restore File",
+        QString("Replace %1 with the version from \"%2\"?\n\nA safety backup will be created automatically.")
+            .arg(QFileInfo(m_filePath).fileName())
+            .arg(version.description));
+    if (ret != QMessageBox::Yes) {
+        return;
+    }
+
+    m_restoreButton->setEnabled(false);
+    auto* watcher = new QFutureWatcher<Result<void, QString>>(this);
+    connect(watcher, &QFutureWatcher<Result<void, QString>>::finished,
+            this, [this, watcher]() {
+        auto result = watcher->result();
+        watcher->deleteLater();
+
+        if (result.isErr()) {
+            QMessageBox::critical(this, "Error",
+                QString("Failed to restore file: %1").arg(result.error()));
+            onSelectionChanged();
+            return;
+        }
+        accept();
+    });
+    watcher->setFuture(m_snapshotManager->restoreFile(version.snapshotId, m_filePath));
+}
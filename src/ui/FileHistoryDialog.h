@@ -0,0 +1,40 @@
+#ifndef FILEHISTORYDIALOG_H
+#define FILEHISTORYDIALOG_H
+
+#include <QDialog>
+#include <QLabel>
+#include <QListWidget>
+#include <QPushButton>
+#include "core/FileHistoryIndex.h"
+
+class SnapshotManager;
+
+/**
+ * @brief Lists the snapshots holding other versions of one file
+ *
+ * Selecting a version and choosing Restore brings back just that file.
+ */
+class FileHistoryDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    FileHistoryDialog(const QString& filePath, SnapshotManager* snapshotManager,
+                      QWidget* parent = nullptr);
+
+private slots:
+    void onSelectionChanged();
+    void onRestoreClicked();
+
+private:
+    QString m_filePath;
+    SnapshotManager* m_snapshotManager;
+    QList<FileVersion> m_versions;
+
+    QLabel* m_statusLabel;
+    QListWidget* m_versionList;
+    QPushButton* m_restoreButton;
+
+    void loadHistory();
+};
+
+#endif // FILEHISTORYDIALOG_H
@@ -1,25 +1,43 @@
 #include "MainWindow.h"
 #include "CreateSnapshotDialog.h"
+#include "FileHistoryDialog.h"
+#include "RestoreDialog.h"
 #include "SettingsDialog.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QInputDialog>
 #include <QMenuBar>
 #include <QToolBar>
 #include <QStatusBar>
 #include <QProgressDialog>
 #include <QFutureWatcher>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include "ipc/DaemonClient.h"
 #include "utils/FileUtils.h"
+#include "utils/Logger.h"
+#include "utils/Tracer.h"
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
     , m_gitService(nullptr)
     , m_snapshotManager(nullptr)
+    , m_syncEngine(nullptr)
     , m_presetManager(new PresetManager(this))
+    , m_recentMenu(nullptr)
+    , m_searchGeneration(0)
 {
+    auto libraryResult = m_library.load(ProjectLibrary::defaultDirectory());
+    if (libraryResult.isErr()) {
+        Logger::warning(libraryResult.error(), "MainWindow");
+    }
+    
     setupUi();
     setupConnections();
+    rebuildRecentMenu();
 }
 
 void MainWindow::setupUi()
@@ -35,11 +53,20 @@ void MainWindow::setupUi()
     QMenuBar* menuBar = new QMenuBar(this);
     QMenu* fileMenu = menuBar->addMenu("&File");
     fileMenu->addAction("&Open Project...", this, &MainWindow::onOpenProjectClicked);
+    m_recentMenu = fileMenu->addMenu("Open &Recent");
+    fileMenu->addAction("File &History...", this, &MainWindow::onFileHistoryClicked);
+    fileMenu->addAction("&Verify Restored Files...", this, &MainWindow::onVerifyRestoreClicked);
+    fileMenu->addAction("&Sync to Remote...", this, &MainWindow::onSyncClicked);
     fileMenu->addSeparator();
     fileMenu->addAction("E&xit", this, &QWidget::close);
     
     QMenu* viewMenu = menuBar->addMenu("&View");
     viewMenu->addAction("&Refresh", this, &MainWindow::refreshSnapshotList);
+    viewMenu->addSeparator();
+    QAction* traceAction = viewMenu->addAction("Record &Trace");
+    traceAction->setCheckable(true);
+    traceAction->setChecked(Tracer::isEnabled());
+    connect(traceAction, &QAction::toggled, this, &MainWindow::onRecordTraceToggled);
     
     QMenu* helpMenu = menuBar->addMenu("&Help");
     helpMenu->addAction("&About", [this]() {
@@ -81,6 +108,17 @@ void MainWindow::setupUi()
     recentLabel->setStyleSheet("font-size: 14px; font-weight: bold;");
     mainLayout->addWidget(recentLabel);
     
+    // Search box: filters the list as the user types
+    m_searchEdit = new QLineEdit(this);
+    m_searchEdit->setPlaceholderText("Search snapshots (e.g. skyui, path:skse, is:manual since:7d)");
+    m_searchEdit->setClearButtonEnabled(true);
+    m_searchEdit->setEnabled(false);
+    mainLayout->addWidget(m_searchEdit);
+    
+    m_searchTimer = new QTimer(this);
+    m_searchTimer->setSingleShot(true);
+    m_searchTimer->setInterval(150);
+    
     // Snapshot list with empty state label
     QWidget* listContainer = new QWidget(this);
     QVBoxLayout* listLayout = new QVBoxLayout(listContainer);
@@ -135,6 +173,10 @@ void MainWindow::setupConnections()
             this, &MainWindow::onManageClicked);
     connect(m_settingsButton, &QPushButton::clicked,
             this, &MainWindow::onSettingsClicked);
+    connect(m_searchEdit, &QLineEdit::textChanged,
+            m_searchTimer, qOverload<>(&QTimer::start));
+    connect(m_searchTimer, &QTimer::timeout,
+            this, &MainWindow::runSearch);
 }
 
 void MainWindow::onOpenProjectClicked()
@@ -149,16 +191,35 @@ void MainWindow::onOpenProjectClicked()
         return;
     }
     
-    m_currentProjectPath = path;
+    openProject(path);
+}
+
+void MainWindow::openProject(const QString& path)
+{
+    if (!QFileInfo(path).isDir()) {
+        QMessageBox::warning(this, "Project Not Found",
+            QString("%1 no longer exists.").arg(QDir::toNativeSeparators(path)));
+        m_library.remove(path);
+        rebuildRecentMenu();
+        return;
+    }
+    
+    bool known = m_library.contains(path);
+    m_projectConfig = m_library.project(path);
+    m_projectConfig.lastOpened = QDateTime::currentDateTime();
+    m_currentProjectPath = m_projectConfig.projectPath;
     
     // Initialize git service
     if (m_gitService) {
         m_gitService->deleteLater();
         m_snapshotManager->deleteLater();
+        m_syncEngine->deleteLater();
     }
     
-    m_gitService = new GitService(path, this);
+    m_gitService = new GitService(m_currentProjectPath, this);
     m_snapshotManager = new SnapshotManager(m_gitService, this);
+    m_syncEngine = new SyncEngine(m_gitService, this);
+    m_syncEngine->setRemoteUrl(m_projectConfig.remoteUrl);
     
     connect(m_snapshotManager, &SnapshotManager::snapshotCreated,
             this, &MainWindow::onSnapshotCreated);
@@ -166,11 +227,43 @@ void MainWindow::onOpenProjectClicked()
             this, &MainWindow::onSnapshotRestored);
     connect(m_snapshotManager, &SnapshotManager::operationProgress,
             this, &MainWindow::onOperationProgress);
+    connect(m_syncEngine, &SyncEngine::syncProgress,
+            this, &MainWindow::onOperationProgress);
+    connect(m_syncEngine, &SyncEngine::syncFinished,
+            this, &MainWindow::onSyncFinished);
+    connect(m_syncEngine, &SyncEngine::syncFailed,
+            this, &MainWindow::onSyncFailed);
+    
+    m_searchEdit->clear();
+    m_searchEdit->setEnabled(true);
+    
+    applyDetectedPreset();
+    
+    // Let the background service schedule maintenance for this project.
+    // Registered on every open: the daemon may not have been running last
+    // time, or may have lost its registry, and registering again keeps its
+    // settings. Off the main thread, so a slow daemon never holds up the
+    // cached view.
+    QString registerPath = m_currentProjectPath;
+    QThreadPool::globalInstance()->start([registerPath]() {
+        DaemonClient daemon;
+        if (!daemon.connectToDaemon(200)) {
+            return;
+        }
+        auto result = daemon.call("register", {{"path", registerPath}}, 2000);
+        if (result.isErr()) {
+            Logger::warning(QString("Daemon did not register %1: %2").arg(registerPath, result.error()),
+                            "MainWindow");
+        }
+    });
     
     // Check if git repo exists
-    QDir repoDir(path);
+    QDir repoDir(m_currentProjectPath);
     if (repoDir.exists(".git")) {
-        // Repo exists, load snapshots
+        // Show the list as last seen, then load it from the repo
+        if (known) {
+            showCachedState();
+        }
         refreshSnapshotList();
     } else {
         // No git repo yet - don't initialize until user is ready
@@ -183,6 +276,139 @@ void MainWindow::onOpenProjectClicked()
     }
     
     updateStatusBar();
+    checkProjectSize();
+    
+    saveProjectConfig();
+    rebuildRecentMenu();
+}
+
+void MainWindow::showCachedState()
+{
+    const QList<Snapshot>& page = m_projectConfig.historyPage;
+    m_snapshotModel->setTable(SnapshotTable::fromSnapshots(page));
+    m_emptyListLabel->setText("No Checkpoints Found!\nCreate a new checkpoint using the buttons below");
+    m_emptyListLabel->setVisible(page.isEmpty());
+    m_snapshotList->setVisible(!page.isEmpty());
+    m_restoreLastButton->setEnabled(!page.isEmpty());
+    
+    if (m_projectConfig.cachedSizeBytes >= 0) {
+        statusBar()->showMessage(QString("Tracked files: %1")
+            .arg(FileUtils::formatSize(m_projectConfig.cachedSizeBytes)), 3000);
+    }
+}
+
+void MainWindow::rebuildRecentMenu()
+{
+    m_recentMenu->clear();
+    
+    for (const ProjectConfig& project : m_library.projects()) {
+        QString location = QDir::toNativeSeparators(project.projectPath);
+        QString label = project.gameName.isEmpty()
+            ? location
+            : QString("%1 - %2").arg(project.gameName, location);
+        QString path = project.projectPath;
+        m_recentMenu->addAction(label, this, [this, path]() {
+            openProject(path);
+        });
+    }
+    
+    m_recentMenu->setEnabled(!m_recentMenu->isEmpty());
+}
+
+void MainWindow::saveProjectConfig()
+{
+    auto result = m_library.save(m_projectConfig);
+    if (result.isErr()) {
+        Logger::warning(result.error(), "MainWindow");
+    }
+}
+
+void MainWindow::applyDetectedPreset()
+{
+    m_currentPreset = GamePreset();
+    
+    // A known project keeps the game it was detected as
+    if (!m_projectConfig.gameId.isEmpty()) {
+        applyPreset(m_projectConfig.gameId);
+        return;
+    }
+    
+    // The first detection builds the index and scans the Steam libraries
+    QString projectPath = m_currentProjectPath;
+    PresetManager* presetManager = m_presetManager;
+    auto* watcher = new QFutureWatcher<Result<QString, QString>>(this);
+    connect(watcher, &QFutureWatcher<Result<QString, QString>>::finished,
+            this, [this, watcher, projectPath]() {
+        auto result = watcher->result();
+        watcher->deleteLater();
+        
+        if (result.isErr() || projectPath != m_currentProjectPath) {
+            return;
+        }
+        
+        applyPreset(result.value());
+        checkProjectSize();
+        saveProjectConfig();
+        rebuildRecentMenu();
+    });
+    
+    watcher->setFuture(QtConcurrent::run([presetManager, projectPath]() {
+        return presetManager->detectGame(projectPath);
+    }));
+}
+
+void MainWindow::applyPreset(const QString& gameId)
+{
+    auto presetResult = m_presetManager->loadPreset(gameId);
+    if (presetResult.isOk()) {
+        m_currentPreset = presetResult.value();
+        m_projectConfig.gameId = m_currentPreset.gameId;
+        m_projectConfig.gameName = m_currentPreset.displayName;
+        m_gitService->setTrackedPaths(m_currentPreset.trackedPaths);
+        m_gitService->setRegionFiles(m_currentPreset.regionFiles);
+        m_gitService->setDeltaFiles(m_currentPreset.deltaFiles);
+        statusBar()->showMessage(
+            QString("Detected game: %1").arg(m_currentPreset.displayName), 3000);
+    }
+}
+
+void MainWindow::checkProjectSize()
+{
+    if (m_currentProjectPath.isEmpty()) {
+        return;
+    }
+    
+    // Size of what would be versioned: the preset's ignore patterns and
+    // tracked paths are applied while scanning, so skipped folders are never
+    // walked
+    PatternMatcher ignore = m_currentPreset.isValid()
+        ? m_presetManager->ignoreMatcher(m_currentPreset)
+        : PatternMatcher(QStringList() << ".git/");
+    TrackedScope scope(m_currentPreset.trackedPaths);
+    QString projectPath = m_currentProjectPath;
+    
+    auto* watcher = new QFutureWatcher<Result<qint64, QString>>(this);
+    connect(watcher, &QFutureWatcher<Result<qint64, QString>>::finished,
+            this, [this, watcher, projectPath]() {
+        auto result = watcher->result();
+        watcher->deleteLater();
+        
+        if (result.isErr() || projectPath != m_currentProjectPath) {
+            return;
+        }
+        
+        m_projectConfig.cachedSizeBytes = result.value();
+        saveProjectConfig();
+        
+        qint64 warningBytes = m_currentPreset.largeFileWarningMB * 1024 * 1024;
+        if (result.value() > warningBytes) {
+            statusBar()->showMessage(
+                QString("Warning: tracked files total %1, snapshots may be slow")
+                    .arg(FileUtils::formatSize(result.value())));
+        }
+    });
+    
+    watcher->setFuture(FileUtils::getDirectorySize(projectPath, ignore, scope));
 }
 
 void MainWindow::onCreateSnapshotClicked()
@@ -245,11 +471,8 @@ void MainWindow::onRestoreLastClicked()
         
         const Snapshot& latest = result.value().first();
         
-        int ret = QMessageBox::question(this, "Restore Snapshot",
-            QString("Restore snapshot: %1\n\nThis will revert your game files to this state.")
-                .arg(latest.displayText()));
-        
-        if (ret == QMessageBox::Yes) {
+        RestoreDialog dialog(latest, m_snapshotManager, this);
+        if (dialog.exec() == QDialog::Accepted) {
             auto* progress = new QProgressDialog("Restoring snapshot...", "Cancel", 0, 100, this);
             progress->setWindowModality(Qt::WindowModal);
             progress->show();
@@ -263,9 +486,8 @@ void MainWindow::onRestoreLastClicked()
                     QMessageBox::critical(this, "Error",
                         QString("Failed to restore: %1").arg(restoreResult.error()));
                 } else {
-                    QMessageBox::information(this, "Success",
-                        "Snapshot restored successfully!");
-                    refreshSnapshotList();
+                    // Verify against a settled repository, not one still being read
+                    loadSnapshotList([this]() { verifyRestore(VerifyMode::Quick, true); });
                 }
                 restoreWatcher->deleteLater();
                 progress->deleteLater();
@@ -283,6 +505,217 @@ void MainWindow::onRestoreLastClicked()
     listWatcher->setFuture(future);
 }
 
+void MainWindow::onFileHistoryClicked()
+{
+    if (!m_snapshotManager) {
+        QMessageBox::information(this, "No Project", "Open a game folder first.");
+        return;
+    }
+    
+    QString path = QFileDialog::getOpenFileName(
+        this,
+        "Select File",
+        m_currentProjectPath
+    );
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    FileHistoryDialog dialog(path, m_snapshotManager, this);
+    if (dialog.exec() == QDialog::Accepted) {
+        statusBar()->showMessage(QString("Restored %1").arg(QFileInfo(path).fileName()), 3000);
+        refreshSnapshotList();  // The safety backup is a new snapshot
+    }
+}
+
+void MainWindow::onVerifyRestoreClicked()
+{
+    if (!m_snapshotManager) {
+        QMessageBox::information(this, "No Project", "Open a game folder first.");
+        return;
+    }
+    
+    auto answer = QMessageBox::question(this, "Verify Restored Files",
+        "Re-read every file from the last restore and compare it with the snapshot?\n\n"
+        "This can take a while for large installs. Choose No for a quick check "
+        "of files changed since the restore.",
+        QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+    if (answer == QMessageBox::Cancel) {
+        return;
+    }
+    verifyRestore(answer == QMessageBox::Yes ? VerifyMode::Deep : VerifyMode::Quick, false);
+}
+
+void MainWindow::verifyRestore(VerifyMode mode, bool restoredJustNow)
+{
+    auto* progress = new QProgressDialog("Verifying restored files...", QString(), 0, 0, this);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->show();
+    
+    auto* watcher = new QFutureWatcher<Result<VerifyReport, QString>>(this);
+    connect(watcher, &QFutureWatcher<Result<VerifyReport, QString>>::finished,
+            this, [this, watcher, progress, restoredJustNow]() {
+        progress->close();
+        progress->deleteLater();
+        auto result = watcher->future().takeResult();
+        watcher->deleteLater();
+        
+        if (result.isErr()) {
+            // The restore itself succeeded; only the check couldn't run
+            if (restoredJustNow) {
+                QMessageBox::information(this, "Success",
+                    QString("Snapshot restored successfully!\n\n"
+                            "The restored files could not be checked: %1").arg(result.error()));
+            } else {
+                QMessageBox::warning(this, "Verification Failed",
+                    QString("Could not verify restored files: %1").arg(result.error()));
+            }
+            return;
+        }
+        
+        const VerifyReport& report = result.value();
+        if (!report.isClean()) {
+            repairRestore(report);
+            return;
+        }
+        
+        // A quick check only re-reads files whose stat data changed
+        QString message;
+        if (report.hashedFiles == report.checkedFiles) {
+            message = QString("All %1 files match the snapshot.").arg(report.checkedFiles);
+        } else if (report.hashedFiles > 0) {
+            message = QString("All %1 files are present. %2 changed since the restore and were "
+                              "re-read; they match the snapshot.")
+                          .arg(report.checkedFiles).arg(report.hashedFiles);
+        } else {
+            message = QString("All %1 files are present and unchanged since the restore.")
+                          .arg(report.checkedFiles);
+        }
+        if (restoredJustNow) {
+            QMessageBox::information(this, "Success",
+                QString("Snapshot restored successfully!\n\n%1").arg(message));
+        } else {
+            QMessageBox::information(this, "Verified", message);
+        }
+    });
+    
+    watcher->setFuture(m_snapshotManager->verifyRestore(mode));
+}
+
+void MainWindow::repairRestore(const VerifyReport& report)
+{
+    QStringList lines;
+    for (const QString& path : report.modified) {
+        lines << QString("Changed: %1").arg(path);
+    }
+    for (const QString& path : report.missing) {
+        lines << QString("Missing: %1").arg(path);
+    }
+    
+    QMessageBox box(QMessageBox::Warning, "Files Differ From Snapshot",
+        QString("%1 of %2 restored files no longer match the snapshot.\n\n"
+                "Repair rewrites just these files from the snapshot.")
+            .arg(lines.size()).arg(report.checkedFiles),
+        QMessageBox::NoButton, this);
+    box.setDetailedText(lines.join('\n'));
+    QPushButton* repairButton = box.addButton("Repair", QMessageBox::AcceptRole);
+    box.addButton(QMessageBox::Cancel);
+    box.exec();
+    if (box.clickedButton() != repairButton) {
+        return;
+    }
+    
+    auto* watcher = new QFutureWatcher<Result<void, QString>>(this);
+    connect(watcher, &QFutureWatcher<Result<void, QString>>::finished,
+            this, [this, watcher, count = lines.size()]() {
+        auto result = watcher->result();
+        watcher->deleteLater();
+        
+        if (result.isErr()) {
+            QMessageBox::critical(this, "Error",
+                QString("Failed to repair files: %1").arg(result.error()));
+        } else {
+            statusBar()->showMessage(QString("Repaired %1 files").arg(count), 3000);
+        }
+    });
+    
+    watcher->setFuture(m_snapshotManager->repairRestore(report.damaged()));
+}
+
+void MainWindow::onSyncClicked()
+{
+    if (!m_syncEngine) {
+        QMessageBox::information(this, "No Project", "Open a game folder first.");
+        return;
+    }
+    
+    bool accepted = false;
+    QString remoteUrl = QInputDialog::getText(this, "Sync to Remote",
+        "Remote repository (git URL, or a local folder for a backup drive),\n"
+        "or chunks:<folder> to share deduplicated backups between machines.\n"
+        "New snapshots are sent there automatically from now on.",
+        QLineEdit::Normal, m_projectConfig.remoteUrl, &accepted).trimmed();
+    if (!accepted || remoteUrl.isEmpty()) {
+        return;
+    }
+    
+    m_projectConfig.remoteUrl = remoteUrl;
+    m_projectConfig.cloudSyncEnabled = true;
+    saveProjectConfig();
+    
+    m_syncEngine->setRemoteUrl(remoteUrl);
+    m_syncEngine->sync();
+    statusBar()->showMessage("Syncing snapshots...");
+}
+
+void MainWindow::onSyncFinished(const SyncReport& report)
+{
+    m_projectConfig.lastSyncTime = QDateTime::currentDateTime();
+    saveProjectConfig();
+    
+    if (report.isUpToDate()) {
+        statusBar()->showMessage("Remote is up to date", 3000);
+    } else {
+        statusBar()->showMessage(QString("Synced %1 snapshots to %2")
+            .arg(report.pushedSnapshots).arg(report.remoteUrl), 5000);
+    }
+}
+
+void MainWindow::onSyncFailed(const QString& error)
+{
+    Logger::warning(QString("Sync failed: %1").arg(error), "MainWindow");
+    statusBar()->showMessage(QString("Sync failed: %1").arg(error));
+}
+
+void MainWindow::onRecordTraceToggled(bool enabled)
+{
+    if (enabled) {
+        Tracer::clear();
+        Tracer::setEnabled(true);
+        statusBar()->showMessage("Recording trace...", 3000);
+        return;
+    }
+    
+    Tracer::setEnabled(false);
+    
+    QString path = QFileDialog::getSaveFileName(
+        this,
+        "Save Trace",
+        QDir::homePath() + "/vgvc-trace.json",
+        "Chrome Trace (*.json)"
+    );
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    auto result = Tracer::writeChromeTrace(path);
+    if (result.isErr()) {
+        QMessageBox::critical(this, "Error", result.error());
+    } else {
+        statusBar()->showMessage(QString("Trace saved to %1").arg(path), 3000);
+    }
+}
+
 void MainWindow::onManageClicked()
 {
     // TODO: Open snapshot management dialog
@@ -300,11 +733,16 @@ void MainWindow::onSnapshotCreated(const Snapshot& snapshot)
 {
     refreshSnapshotList();
     statusBar()->showMessage(QString("Snapshot created: %1").arg(snapshot.description), 3000);
+    
+    if (m_projectConfig.cloudSyncEnabled && m_syncEngine) {
+        m_syncEngine->sync();
+    }
 }
 
 void MainWindow::onSnapshotRestored(const QString& snapshotId)
 {
-    refreshSnapshotList();
+    // The restore handler refreshes the list before verifying
+    statusBar()->showMessage(QString("Restored snapshot %1").arg(snapshotId.left(8)), 3000);
 }
 
 void MainWindow::onOperationProgress(int percentage, const QString& status)
@@ -313,30 +751,69 @@ void MainWindow::onOperationProgress(int percentage, const QString& status)
 }
 
 void MainWindow::refreshSnapshotList()
+{
+    loadSnapshotList({});
+}
+
+void MainWindow::loadSnapshotList(const std::function<void()>& onLoaded)
 {
     if (!m_snapshotManager) {
         return;
     }
     
-    auto* watcher = new QFutureWatcher<Result<QList<Snapshot>, QString>>(this);
-    connect(watcher, &QFutureWatcher<Result<QList<Snapshot>, QString>>::finished,
-            this, [this, watcher]() {
-        auto result = watcher->result();
+    // An active search stays applied across refreshes. Searching only
+    // reads the index, so there is nothing to wait for
+    if (!m_searchEdit->text().trimmed().isEmpty()) {
+        runSearch();
+        if (onLoaded) {
+            onLoaded();
+        }
+        return;
+    }
+    int generation = ++m_searchGeneration;
+    QString projectPath = m_currentProjectPath;
+    
+    auto* watcher = new QFutureWatcher<Result<SnapshotTablePtr, QString>>(this);
+    connect(watcher, &QFutureWatcher<Result<SnapshotTablePtr, QString>>::finished,
+            this, [this, watcher, generation, projectPath, onLoaded]() {
+        auto result = watcher->future().takeResult();
+        
+        if (projectPath != m_currentProjectPath) {
+            watcher->deleteLater();
+            return;  // Another project was opened meanwhile
+        }
+        if (generation != m_searchGeneration) {
+            watcher->deleteLater();
+            if (onLoaded) {
+                onLoaded();
+            }
+            return;  // A search or a newer refresh started meanwhile
+        }
         
         if (result.isOk()) {
-            if (result.value().isEmpty()) {
+            // The repository's answer replaces the cached page for next time
+            const SnapshotTablePtr& table = result.value();
+            QString head = table->isEmpty() ? QString() : table->id(0).toHex();
+            if (head != m_projectConfig.headSnapshotId
+                || table->size() != m_projectConfig.historyPage.size()) {
+                m_projectConfig.headSnapshotId = head;
+                m_projectConfig.historyPage = table->toList();
+                saveProjectConfig();
+            }
+            
+            if (result.value()->isEmpty()) {
                 m_statusLabel->setText("No snapshots yet. Create your first one!");
-                m_snapshotModel->setSnapshots(QList<Snapshot>());
+                m_snapshotModel->setTable(result.value());
                 m_emptyListLabel->setText("No Checkpoints Found!\nCreate a new checkpoint using the buttons below");
                 m_emptyListLabel->setVisible(true);
                 m_snapshotList->setVisible(false);
             } else {
-                m_snapshotModel->setSnapshots(result.value());
+                m_snapshotModel->setTable(result.value());
                 m_statusLabel->setText(QString("Project: %1").arg(m_currentProjectPath));
                 m_emptyListLabel->setVisible(false);
                 m_snapshotList->setVisible(true);
             }
-            m_restoreLastButton->setEnabled(!result.value().isEmpty());
+            m_restoreLastButton->setEnabled(!result.value()->isEmpty());
         } else {
             m_statusLabel->setText(QString("Error loading snapshots: %1").arg(result.error()));
             m_restoreLastButton->setEnabled(false);
@@ -346,12 +823,57 @@ void MainWindow::refreshSnapshotList()
         }
         
         watcher->deleteLater();
+        if (onLoaded) {
+            onLoaded();
+        }
     });
     
-    QFuture<Result<QList<Snapshot>, QString>> future = m_snapshotManager->listSnapshots();
+    QFuture<Result<SnapshotTablePtr, QString>> future = m_snapshotManager->listSnapshotTable();
     watcher->setFuture(future);
 }
 
+void MainWindow::runSearch()
+{
+    if (!m_snapshotManager) {
+        return;
+    }
+    
+    QString text = m_searchEdit->text().trimmed();
+    if (text.isEmpty()) {
+        refreshSnapshotList();
+        return;
+    }
+    
+    int generation = ++m_searchGeneration;
+    auto* watcher = new QFutureWatcher<Result<SnapshotSearchResult, QString>>(this);
+    connect(watcher, &QFutureWatcher<Result<SnapshotSearchResult, QString>>::finished,
+            this, [this, watcher, generation]() {
+        auto result = watcher->future().takeResult();
+        watcher->deleteLater();
+        
+        if (generation != m_searchGeneration) {
+            return;  // The user kept typing
+        }
+        
+        if (result.isErr()) {
+            m_statusLabel->setText(QString("Search failed: %1").arg(result.error()));
+            return;
+        }
+        
+        const SnapshotSearchResult& search = result.value();
+        m_snapshotModel->setTable(search.snapshots);
+        m_statusLabel->setText(QString("%1 matching snapshots (%2 manual, %3 automatic)")
+            .arg(search.total)
+            .arg(search.manualCount)
+            .arg(search.automaticCount));
+        m_emptyListLabel->setText("No snapshots match your search.");
+        m_emptyListLabel->setVisible(search.snapshots->isEmpty());
+        m_snapshotList->setVisible(!search.snapshots->isEmpty());
+    });
+    
+    watcher->setFuture(m_snapshotManager->searchSnapshots(text));
+}
+
 void MainWindow::updateStatusBar()
 {
     if (m_currentProjectPath.isEmpty()) {
@@ -5,8 +5,13 @@
 #include <QPushButton>
 #include <QListView>
 #include <QLabel>
+#include <QLineEdit>
+#include <QTimer>
+#include <functional>
 #include "core/SnapshotManager.h"
 #include "core/PresetManager.h"
+#include "core/ProjectLibrary.h"
+#include "core/SyncEngine.h"
 #include "ui/models/SnapshotListModel.h"
 
 /**
@@ -30,21 +35,63 @@ private slots:
     void onManageClicked();
     void onSettingsClicked();
     void onOpenProjectClicked();
+    void onFileHistoryClicked();
+    void onVerifyRestoreClicked();
+    void onSyncClicked();
+    void onRecordTraceToggled(bool enabled);
+    void runSearch();
     
     void onSnapshotCreated(const Snapshot& snapshot);
     void onSnapshotRestored(const QString& snapshotId);
     void onOperationProgress(int percentage, const QString& status);
+    void onSyncFinished(const SyncReport& report);
+    void onSyncFailed(const QString& error);
     
 private:
     void setupUi();
     void setupConnections();
+    
+    /**
+     * @brief Open a project, showing its cached state at once if known
+     *
+     * The snapshot list and size come from the project library in the
+     * same frame; the repository is then read in the background and the
+     * view and cache are updated with what it returns.
+     */
+    void openProject(const QString& path);
+    void showCachedState();
+    void rebuildRecentMenu();
+    void saveProjectConfig();
     void refreshSnapshotList();
+    
+    /**
+     * @brief Refresh the list, then run onLoaded once the history is read
+     *
+     * onLoaded is skipped only if another project is opened meanwhile.
+     */
+    void loadSnapshotList(const std::function<void()>& onLoaded);
     void updateStatusBar();
     
+    /**
+     * @brief Use the project's preset; an unknown game is detected off the UI thread
+     */
+    void applyDetectedPreset();
+    void applyPreset(const QString& gameId);
+    void checkProjectSize();
+    
+    /**
+     * @brief Verify the last restore and offer to repair damaged files
+     * @param restoredJustNow Report success too, as the end of a restore
+     */
+    void verifyRestore(VerifyMode mode, bool restoredJustNow);
+    void repairRestore(const VerifyReport& report);
+    
     // Core services
     GitService* m_gitService;
     SnapshotManager* m_snapshotManager;
+    SyncEngine* m_syncEngine;
     PresetManager* m_presetManager;
+    ProjectLibrary m_library;
     
     // UI widgets
     QPushButton* m_restoreLastButton;
@@ -55,9 +102,15 @@ private:
     SnapshotListModel* m_snapshotModel;
     QLabel* m_statusLabel;
     QLabel* m_emptyListLabel;
+    QLineEdit* m_searchEdit;
+    QTimer* m_searchTimer;      // Debounces typing in the search box
+    QMenu* m_recentMenu;
     
     // State
     QString m_currentProjectPath;
+    ProjectConfig m_projectConfig;  // Library entry for the open project
+    GamePreset m_currentPreset;  // Invalid if the game wasn't detected
+    int m_searchGeneration;      // Results of older searches are dropped
 };
 
 #endif // MAINWINDOW_H
@@ -1,14 +1,40 @@
 #include "RestoreDialog.h"
 #include <QVBoxLayout>
-#include <QLabel>
+#include <QHeaderView>
 #include <QDialogButtonBox>
+#include "core/SnapshotManager.h"
+#include "utils/FileUtils.h"
 
-RestoreDialog::RestoreDialog(const Snapshot& snapshot, QWidget* parent)
+namespace {
+
+QString changeLabel(FileChange::Kind kind)
+{
+    switch (kind) {
+    case FileChange::Kind::Added: return "Restored";
+    case FileChange::Kind::Modified: return "Overwritten";
+    case FileChange::Kind::Deleted: return "Deleted";
+    }
+    return QString();
+}
+
+QString signedSize(qint64 bytes)
+{
+    if (bytes == 0) {
+        return "±0 B";
+    }
+    return QString("%1%2").arg(bytes > 0 ? "+" : "-").arg(FileUtils::formatSize(qAbs(bytes)));
+}
+
+} // namespace
+
+RestoreDialog::RestoreDialog(const Snapshot& snapshot, SnapshotManager* snapshotManager,
+                             QWidget* parent)
     : QDialog(parent)
     , m_snapshot(snapshot)
+    , m_previewWatcher(new QFutureWatcher<Result<QList<FileChange>, QString>>(this))
 {
     setWindowTitle("Restore Snapshot");
-    resize(500, 300);
+    resize(600, 450);
     
     QVBoxLayout* layout = new QVBoxLayout(this);
     
@@ -25,7 +51,18 @@ RestoreDialog::RestoreDialog(const Snapshot& snapshot, QWidget* parent)
      .arg(snapshot.id.left(10)));
     layout->addWidget(infoLabel);
     
-    layout->addSpacing(20);
+    layout->addSpacing(10);
+    
+    // Files the restore will touch
+    m_summaryLabel = new QLabel("Comparing with your current files...", this);
+    layout->addWidget(m_summaryLabel);
+    
+    m_changeList = new QTreeWidget(this);
+    m_changeList->setHeaderLabels({"Change", "File", "Size"});
+    m_changeList->setRootIsDecorated(false);
+    m_changeList->setUniformRowHeights(true);
+    m_changeList->header()->setSectionResizeMode(1, QHeaderView::Stretch);
+    layout->addWidget(m_changeList, 1);
     
     // Warning
     QLabel* warningLabel = new QLabel(
@@ -35,12 +72,73 @@ RestoreDialog::RestoreDialog(const Snapshot& snapshot, QWidget* parent)
     warningLabel->setStyleSheet("color: orange; font-weight: bold;");
     layout->addWidget(warningLabel);
     
-    layout->addStretch();
-    
     // Buttons
     QDialogButtonBox* buttonBox = new QDialogButtonBox(
         QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
     connect(buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
     connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
     layout->addWidget(buttonBox);
+    
+    connect(m_previewWatcher, &QFutureWatcher<Result<QList<FileChange>, QString>>::resultsReadyAt,
+            this, &RestoreDialog::onChangesReady);
+    connect(m_previewWatcher, &QFutureWatcher<Result<QList<FileChange>, QString>>::finished,
+            this, &RestoreDialog::onPreviewFinished);
+    m_previewWatcher->setFuture(snapshotManager->previewRestore(snapshot.id));
+}
+
+RestoreDialog::~RestoreDialog()
+{
+    // Stops the diff early if the dialog closes before it completes
+    m_previewWatcher->cancel();
+}
+
+void RestoreDialog::onChangesReady(int beginIndex, int endIndex)
+{
+    QList<QTreeWidgetItem*> items;
+    for (int i = beginIndex; i < endIndex; ++i) {
+        auto batch = m_previewWatcher->resultAt(i);
+        if (batch.isErr()) {
+            m_previewError = batch.error();
+            continue;
+        }
+        
+        for (const FileChange& change : batch.value()) {
+            m_summary.add(change);
+            items << new QTreeWidgetItem(QStringList()
+                << changeLabel(change.kind) << change.path << signedSize(change.sizeDelta()));
+        }
+    }
+    
+    m_changeList->addTopLevelItems(items);
+    updateSummary(false);
+}
+
+void RestoreDialog::onPreviewFinished()
+{
+    // Sorting while rows stream in would re-sort on every batch
+    m_changeList->setSortingEnabled(true);
+    m_changeList->sortByColumn(1, Qt::AscendingOrder);
+    updateSummary(true);
+}
+
+void RestoreDialog::updateSummary(bool finished)
+{
+    if (!m_previewError.isEmpty()) {
+        m_summaryLabel->setText(QString("Could not compare files: %1").arg(m_previewError));
+        return;
+    }
+    
+    if (finished && m_summary.fileCount() == 0) {
+        m_summaryLabel->setText("Your files already match this snapshot.");
+        return;
+    }
+    
+    m_summaryLabel->setText(QString("%1%2 files: %3 restored, %4 overwritten, %5 deleted (%6 / %7)")
+        .arg(finished ? "" : "Comparing... ")
+        .arg(m_summary.fileCount())
+        .arg(m_summary.added)
+        .arg(m_summary.modified)
+        .arg(m_summary.deleted)
+        .arg(signedSize(m_summary.bytesAdded))
+        .arg(signedSize(-m_summary.bytesRemoved)));
 }
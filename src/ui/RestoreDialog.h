@@ -2,19 +2,42 @@
 #define RESTOREDIALOG_H
 
 #include <QDialog>
+#include <QFutureWatcher>
+#include <QLabel>
+#include <QTreeWidget>
+#include "core/types/FileChange.h"
+#include "core/types/Result.h"
 #include "core/types/Snapshot.h"
 
+class SnapshotManager;
+
 /**
  * @brief Dialog for restoring a snapshot with preview
+ *
+ * Lists the files the restore would add, overwrite or delete, filling in
+ * while the diff streams in.
  */
 class RestoreDialog : public QDialog {
     Q_OBJECT
-    
+
 public:
-    explicit RestoreDialog(const Snapshot& snapshot, QWidget* parent = nullptr);
-    
+    RestoreDialog(const Snapshot& snapshot, SnapshotManager* snapshotManager,
+                  QWidget* parent = nullptr);
+    ~RestoreDialog() override;
+
+private slots:
+    void onChangesReady(int beginIndex, int endIndex);
+    void onPreviewFinished();
+
 private:
     Snapshot m_snapshot;
+    QTreeWidget* m_changeList;
+    QLabel* m_summaryLabel;
+    QFutureWatcher<Result<QList<FileChange>, QString>>* m_previewWatcher;
+    DiffSummary m_summary;
+    QString m_previewError;
+    
+    void updateSummary(bool finished);
 };
 
 #endif // RESTOREDIALOG_H
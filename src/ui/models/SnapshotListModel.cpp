@@ -1,7 +1,17 @@
 #include "SnapshotListModel.h"
+#include <QHash>
+
+namespace {
+
+// Enough for several screens of rows; older entries are reformatted on demand
+constexpr int DisplayCacheRows = 2000;
+
+} // namespace
 
 SnapshotListModel::SnapshotListModel(QObject* parent)
     : QAbstractListModel(parent)
+    , m_table(SnapshotTable::share(SnapshotTable()))
+    , m_displayText(DisplayCacheRows)
 {
 }
 
@@ -10,26 +20,35 @@ int SnapshotListModel::rowCount(const QModelIndex& parent) const
     if (parent.isValid()) {
         return 0;
     }
-    return m_snapshots.count();
+    return m_rows.count();
 }
 
 QVariant SnapshotListModel::data(const QModelIndex& index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_snapshots.count()) {
+    if (!index.isValid() || index.row() >= m_rows.count()) {
         return QVariant();
     }
     
-    const Snapshot& snapshot = m_snapshots.at(index.row());
+    int row = m_rows.at(index.row());
     
     switch (role) {
-        case Qt::DisplayRole:
-            return snapshot.displayText();
+        case Qt::DisplayRole: {
+            const ObjectId& id = m_table->id(row);
+            if (QString* cached = m_displayText.object(id)) {
+                return *cached;
+            }
+            QString text = QString("%1 - %2")
+                .arg(m_table->timestamp(row).toString("yyyy-MM-dd HH:mm"))
+                .arg(m_table->description(row));
+            m_displayText.insert(id, new QString(text));
+            return text;
+        }
             
         case Qt::ToolTipRole:
             return QString("ID: %1\nAuthor: %2\nAutomatic: %3")
-                .arg(snapshot.id)
-                .arg(snapshot.author)
-                .arg(snapshot.isAutomatic ? "Yes" : "No");
+                .arg(m_table->id(row).toHex())
+                .arg(m_table->author(row))
+                .arg(m_table->isAutomatic(row) ? "Yes" : "No");
             
         default:
             return QVariant();
@@ -38,15 +57,133 @@ QVariant SnapshotListModel::data(const QModelIndex& index, int role) const
 
 void SnapshotListModel::setSnapshots(const QList<Snapshot>& snapshots)
 {
-    beginResetModel();
-    m_snapshots = snapshots;
-    endResetModel();
+    setTable(SnapshotTable::fromSnapshots(snapshots));
+}
+
+void SnapshotListModel::setTable(const SnapshotTablePtr& table)
+{
+    if (m_rows.isEmpty() || table->isEmpty()) {
+        removeRowRange(0, m_rows.size());
+        m_table = table;
+        insertTableRows(0, 0, table->size());
+        return;
+    }
+    
+    // Common case: new snapshots on top of the same chain. indexOf scans
+    // from the top, so finding the old top costs O(new snapshots); the rows
+    // below it must then hold the same snapshots in the same order, which
+    // a search result or a rewritten history need not
+    int newCount = table->indexOf(m_table->id(m_rows.first()));
+    int kept = newCount >= 0 ? qMin(m_rows.size(), table->size() - newCount) : 0;
+    bool sameChain = newCount >= 0;
+    for (int i = 1; sameChain && i < kept; ++i) {
+        sameChain = table->id(newCount + i) == m_table->id(m_rows[i]);
+    }
+    if (sameChain) {
+        // Trim against the old table, then switch tables: the surviving
+        // rows hold the same snapshots at the same offsets in both
+        removeRowRange(kept, m_rows.size() - kept);
+        m_table = table;
+        for (int i = 0; i < m_rows.size(); ++i) {
+            m_rows[i] = newCount + i;
+        }
+        
+        insertTableRows(0, 0, newCount);
+        insertTableRows(m_rows.size(), m_rows.size(), table->size() - m_rows.size());
+        return;
+    }
+    
+    if (!applyGeneralUpdate(table)) {
+        beginResetModel();
+        m_table = table;
+        m_rows.resize(table->size());
+        for (int i = 0; i < m_rows.size(); ++i) {
+            m_rows[i] = i;
+        }
+        endResetModel();
+    }
+}
+
+bool SnapshotListModel::applyGeneralUpdate(const SnapshotTablePtr& table)
+{
+    QHash<ObjectId, int> newRows;
+    newRows.reserve(table->size());
+    for (int i = 0; i < table->size(); ++i) {
+        newRows.insert(table->id(i), i);
+    }
+    
+    // Remove vanished rows as contiguous ranges, bottom up
+    int row = m_rows.size() - 1;
+    while (row >= 0) {
+        if (newRows.contains(m_table->id(m_rows[row]))) {
+            --row;
+            continue;
+        }
+        int last = row;
+        while (row > 0 && !newRows.contains(m_table->id(m_rows[row - 1]))) {
+            --row;
+        }
+        removeRowRange(row, last - row + 1);
+        --row;
+    }
+    
+    // Switch tables; every remaining row exists in the new one
+    QVector<bool> kept(table->size(), false);
+    for (int i = 0; i < m_rows.size(); ++i) {
+        m_rows[i] = newRows.value(m_table->id(m_rows[i]));
+        kept[m_rows[i]] = true;
+    }
+    m_table = table;
+    
+    // The remaining rows are in the new order unless history was rewritten
+    int i = 0;
+    while (i < table->size()) {
+        if (i < m_rows.size() && m_rows[i] == i) {
+            ++i;
+            continue;
+        }
+        if (kept[i]) {
+            return false;
+        }
+        
+        int first = i;
+        while (i < table->size() && !kept[i]) {
+            ++i;
+        }
+        insertTableRows(first, first, i - first);
+    }
+    return m_rows.size() == table->size();
+}
+
+void SnapshotListModel::insertTableRows(int row, int tableRow, int count)
+{
+    if (count <= 0) {
+        return;
+    }
+    
+    beginInsertRows(QModelIndex(), row, row + count - 1);
+    m_rows.insert(row, count, 0);
+    for (int i = 0; i < count; ++i) {
+        m_rows[row + i] = tableRow + i;
+    }
+    endInsertRows();
+}
+
+void SnapshotListModel::removeRowRange(int first, int count)
+{
+    if (count <= 0) {
+        return;
+    }
+    
+    beginRemoveRows(QModelIndex(), first, first + count - 1);
+    m_rows.remove(first, count);
+    endRemoveRows();
 }
 
 Snapshot SnapshotListModel::getSnapshot(int index) const
 {
-    if (index >= 0 && index < m_snapshots.count()) {
-        return m_snapshots.at(index);
+    if (index >= 0 && index < m_rows.count()) {
+        return m_table->snapshot(m_rows.at(index));
     }
     return Snapshot();
 }
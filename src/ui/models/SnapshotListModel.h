@@ -2,10 +2,18 @@
 #define SNAPSHOTLISTMODEL_H
 
 #include <QAbstractListModel>
+#include <QCache>
+#include <QVector>
+#include "core/SnapshotTable.h"
 #include "core/types/Snapshot.h"
 
 /**
  * @brief Qt model for displaying snapshot list
+ * 
+ * Shows a shared SnapshotTable without copying it. Refreshes are applied
+ * as row insertions and removals rather than a reset, so the view keeps its
+ * selection and scroll position; display strings are formatted on first
+ * use and cached for the rows the view has shown.
  */
 class SnapshotListModel : public QAbstractListModel {
     Q_OBJECT
@@ -16,11 +24,27 @@ public:
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
     
+    /**
+     * @brief Update the rows to match a newest-first snapshot table
+     * 
+     * When the previous newest snapshot is still in the table and the rows
+     * below it are unchanged, only the snapshots above it are inserted and
+     * any rows beyond the new length are trimmed. Other updates, such as
+     * entering or leaving a search, remove and insert rows by ID; a
+     * reordering falls back to a reset.
+     */
+    void setTable(const SnapshotTablePtr& table);
     void setSnapshots(const QList<Snapshot>& snapshots);
     Snapshot getSnapshot(int index) const;
     
 private:
-    QList<Snapshot> m_snapshots;
+    SnapshotTablePtr m_table;
+    QVector<int> m_rows;                          // Model row -> table row
+    mutable QCache<ObjectId, QString> m_displayText;
+    
+    void removeRowRange(int first, int count);
+    void insertTableRows(int row, int tableRow, int count);
+    bool applyGeneralUpdate(const SnapshotTablePtr& table);
 };
 
 #endif // SNAPSHOTLISTMODEL_H
@@ -0,0 +1,175 @@
+#include "AdaptiveThrottle.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QStorageInfo>
+#include <QThread>
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#endif
+
+namespace {
+
+constexpr int SampleIntervalMs = 100;
+constexpr int MinDelayMs = 25;
+constexpr int MaxDelayMs = 2000;
+constexpr int PollIntervalMs = 50;
+
+// Congested: latency well above baseline, with an absolute floor so tiny
+// baselines on fast SSDs don't turn noise into pauses
+constexpr double CongestionFactor = 2.0;
+constexpr double CongestionFloorMs = 4.0;
+
+// The baseline follows drops immediately and rises slowly, so it tracks
+// the quiet latency rather than the average under load
+constexpr double BaselineRise = 0.02;
+
+} // namespace
+
+AdaptiveThrottle::AdaptiveThrottle(const QString& path)
+    : m_statName(statNameFor(path))
+    , m_lastIos(0)
+    , m_lastIoMs(0)
+    , m_baselineMs(-1.0)
+    , m_delayMs(0)
+    , m_throttledMs(0)
+{
+    if (isActive() && !readStats(m_lastIos, m_lastIoMs)) {
+        m_statName.clear();
+    }
+    m_sampleTimer.start();
+}
+
+void AdaptiveThrottle::pace()
+{
+    if (!isActive()) {
+        return;
+    }
+
+    update();
+    if (m_delayMs > 0) {
+        QThread::msleep(m_delayMs);
+        m_throttledMs += m_delayMs;
+    }
+}
+
+bool AdaptiveThrottle::waitForProcess(QProcess& process, int activeTimeoutMs)
+{
+    if (!isActive()) {
+        return process.waitForFinished(activeTimeoutMs);
+    }
+
+    QElapsedTimer active;
+    active.start();
+    qint64 activeMs = 0;
+
+    while (!process.waitForFinished(PollIntervalMs)) {
+        if (process.state() == QProcess::NotRunning) {
+            return true;
+        }
+
+        activeMs += active.restart();
+        if (activeTimeoutMs >= 0 && activeMs >= activeTimeoutMs) {
+            return false;
+        }
+
+        update();
+        if (m_delayMs > 0) {
+#ifdef Q_OS_UNIX
+            // Stopping the child frees the disk for the game immediately; a
+            // lower I/O priority alone only reorders queued requests
+            ::kill(static_cast<pid_t>(process.processId()), SIGSTOP);
+            QThread::msleep(m_delayMs);
+            ::kill(static_cast<pid_t>(process.processId()), SIGCONT);
+#else
+            QThread::msleep(m_delayMs);
+#endif
+            m_throttledMs += m_delayMs;
+            active.restart();
+        }
+    }
+    return true;
+}
+
+void AdaptiveThrottle::update()
+{
+    if (m_sampleTimer.elapsed() < SampleIntervalMs) {
+        return;
+    }
+    m_sampleTimer.restart();
+
+    quint64 ios = 0;
+    quint64 ioMs = 0;
+    if (!readStats(ios, ioMs)) {
+        return;
+    }
+
+    quint64 deltaIos = ios - m_lastIos;
+    quint64 deltaMs = ioMs - m_lastIoMs;
+    m_lastIos = ios;
+    m_lastIoMs = ioMs;
+
+    if (deltaIos == 0) {
+        m_delayMs /= 2;  // Idle disk
+        return;
+    }
+
+    double latencyMs = double(deltaMs) / double(deltaIos);
+    if (m_baselineMs < 0 || latencyMs < m_baselineMs) {
+        m_baselineMs = latencyMs;
+    } else {
+        m_baselineMs += (latencyMs - m_baselineMs) * BaselineRise;
+    }
+
+    bool congested = latencyMs > qMax(m_baselineMs * CongestionFactor, m_baselineMs + CongestionFloorMs);
+    if (congested) {
+        m_delayMs = qBound(MinDelayMs, m_delayMs * 2, MaxDelayMs);
+    } else {
+        m_delayMs /= 2;
+        if (m_delayMs < MinDelayMs) {
+            m_delayMs = 0;
+        }
+    }
+}
+
+bool AdaptiveThrottle::readStats(quint64& ios, quint64& ioMs) const
+{
+    QFile file("/proc/diskstats");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    // major minor name reads merged sectors ms_reading writes merged sectors ms_writing ...
+    const QByteArray name = m_statName.toLatin1();
+    for (const QByteArray& line : file.readAll().split('\n')) {
+        QList<QByteArray> fields = line.simplified().split(' ');
+        if (fields.size() >= 11 && fields[2] == name) {
+            ios = fields[3].toULongLong() + fields[7].toULongLong();
+            ioMs = fields[6].toULongLong() + fields[10].toULongLong();
+            return true;
+        }
+    }
+    return false;
+}
+
+QString AdaptiveThrottle::statNameFor(const QString& path)
+{
+#ifdef Q_OS_LINUX
+    QStorageInfo storage(path);
+    if (!storage.isValid()) {
+        return QString();
+    }
+
+    // /dev/mapper/root -> /dev/dm-0, /dev/disk/by-uuid/... -> /dev/sda2
+    QString device = QString::fromUtf8(storage.device());
+    QString canonical = QFileInfo(device).canonicalFilePath();
+    if (!canonical.startsWith("/dev/")) {
+        return QString();  // tmpfs, network and overlay filesystems
+    }
+    return QFileInfo(canonical).fileName();
+#else
+    Q_UNUSED(path);
+    return QString();
+#endif
+}
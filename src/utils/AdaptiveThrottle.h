@@ -0,0 +1,60 @@
+#ifndef ADAPTIVETHROTTLE_H
+#define ADAPTIVETHROTTLE_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+class QProcess;
+
+/**
+ * @brief Backs background work off while the disk is under pressure
+ *
+ * Samples the average completion latency of the storage device holding a
+ * path (from /proc/diskstats on Linux). A running baseline tracks the
+ * device's latency when quiet; when recent latency rises well above it,
+ * usually because the game is streaming assets, the throttle inserts
+ * pauses that double while the pressure persists and halve once it
+ * clears. Where latency isn't observable the throttle never pauses.
+ */
+class AdaptiveThrottle {
+public:
+    explicit AdaptiveThrottle(const QString& path);
+
+    /**
+     * @brief Sleep if the disk is congested; call between units of work
+     *
+     * Samples at most every SampleIntervalMs, so calling it per directory
+     * or per file costs almost nothing.
+     */
+    void pace();
+
+    /**
+     * @brief Wait for a process, suspending it while the disk is congested
+     * @param activeTimeoutMs Time the process may spend running; suspended
+     *        time does not count; -1 for no limit
+     * @return true if the process finished in time
+     */
+    bool waitForProcess(QProcess& process, int activeTimeoutMs);
+
+    bool isActive() const { return !m_statName.isEmpty(); }
+    qint64 throttledMs() const { return m_throttledMs; }
+
+private:
+    QString m_statName;       // Device name as listed in /proc/diskstats
+    QElapsedTimer m_sampleTimer;
+    quint64 m_lastIos;
+    quint64 m_lastIoMs;
+    double m_baselineMs;      // Typical per-request latency when quiet
+    int m_delayMs;            // Current back-off
+    qint64 m_throttledMs;
+
+    /**
+     * @brief Update the back-off from a fresh sample, if one is due
+     */
+    void update();
+
+    bool readStats(quint64& ios, quint64& ioMs) const;
+    static QString statNameFor(const QString& path);
+};
+
+#endif // ADAPTIVETHROTTLE_H
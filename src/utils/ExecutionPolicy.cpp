@@ -0,0 +1,115 @@
+#include "ExecutionPolicy.h"
+#include <QProcess>
+#include <QThreadPool>
+
+#if defined(Q_OS_LINUX)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(Q_OS_MACOS)
+#include <sys/resource.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#endif
+
+namespace {
+
+constexpr int BackgroundPoolThreads = 2;
+constexpr int BackgroundNice = 10;
+
+#if defined(Q_OS_LINUX)
+// linux/ioprio.h is not shipped by every libc, so the ABI values are spelled out
+constexpr int IoprioWhoProcess = 1;
+constexpr int IoprioClassShift = 13;
+constexpr int IoprioClassBestEffort = 2;
+constexpr int IoprioLowestLevel = 7;
+
+void lowerLinuxPriority(pid_t tid)
+{
+    // Best-effort level 7 rather than the idle class: idle I/O can starve
+    // indefinitely behind a game streaming assets, and a snapshot that never
+    // finishes is worse than one that finishes slowly
+    syscall(SYS_ioprio_set, IoprioWhoProcess, tid,
+            (IoprioClassBestEffort << IoprioClassShift) | IoprioLowestLevel);
+    setpriority(PRIO_PROCESS, static_cast<id_t>(tid), BackgroundNice);
+}
+#endif
+
+} // namespace
+
+QThreadPool* ExecutionPolicy::pool(ExecutionClass executionClass)
+{
+    if (executionClass == ExecutionClass::Foreground) {
+        return QThreadPool::globalInstance();
+    }
+
+    static QThreadPool* backgroundPool = []() {
+        auto* threadPool = new QThreadPool();
+        threadPool->setMaxThreadCount(BackgroundPoolThreads);
+        threadPool->setObjectName("Background");
+        return threadPool;
+    }();
+    return backgroundPool;
+}
+
+void ExecutionPolicy::applyToCurrentThread(ExecutionClass executionClass)
+{
+    if (executionClass == ExecutionClass::Foreground) {
+        return;
+    }
+
+    thread_local bool applied = false;
+    if (applied) {
+        return;
+    }
+    applied = true;
+
+#if defined(Q_OS_LINUX)
+    // On Linux both calls take a thread ID and affect only this thread
+    lowerLinuxPriority(static_cast<pid_t>(syscall(SYS_gettid)));
+#elif defined(Q_OS_MACOS)
+    setpriority(PRIO_DARWIN_THREAD, 0, PRIO_DARWIN_BG);
+#elif defined(Q_OS_WIN)
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#endif
+}
+
+void ExecutionPolicy::configureProcess(QProcess& process, ExecutionClass executionClass)
+{
+    if (executionClass == ExecutionClass::Foreground) {
+        return;
+    }
+
+#if defined(Q_OS_LINUX)
+    // Runs in the child between fork and exec: only async-signal-safe calls
+    process.setChildProcessModifier([]() {
+        lowerLinuxPriority(0);
+    });
+#elif defined(Q_OS_MACOS)
+    process.setChildProcessModifier([]() {
+        setpriority(PRIO_DARWIN_PROCESS, 0, PRIO_DARWIN_BG);
+    });
+#elif defined(Q_OS_WIN)
+    process.setCreateProcessArgumentsModifier([](QProcess::CreateProcessArguments* args) {
+        args->flags |= BELOW_NORMAL_PRIORITY_CLASS;
+    });
+#else
+    Q_UNUSED(process);
+#endif
+}
+
+QStringList ExecutionPolicy::gitConfigArgs(ExecutionClass executionClass)
+{
+    if (executionClass == ExecutionClass::Foreground) {
+        return QStringList();
+    }
+
+    // Single-threaded delta search, index reads and checkout; with one
+    // thread git's memory and cache footprint shrinks as well
+    return {
+        "-c", "pack.threads=1",
+        "-c", "index.threads=1",
+        "-c", "checkout.workers=1",
+        "-c", "core.preloadIndex=false",
+    };
+}
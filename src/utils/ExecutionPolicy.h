@@ -0,0 +1,52 @@
+#ifndef EXECUTIONPOLICY_H
+#define EXECUTIONPOLICY_H
+
+#include <QStringList>
+
+class QProcess;
+class QThreadPool;
+
+/**
+ * @brief How hard an operation may compete with the game for the machine
+ */
+enum class ExecutionClass {
+    Foreground,  // User is waiting: full speed
+    Background   // Game may be running: yield CPU and disk
+};
+
+/**
+ * @brief Applies an ExecutionClass to threads and git child processes
+ *
+ * Background work runs on a dedicated small thread pool whose threads get
+ * a raised nice value and the lowest best-effort I/O priority (Linux), the
+ * background QoS band (macOS) or background processing mode (Windows).
+ * Unprivileged processes cannot undo a nice increase, which is why
+ * background work never shares threads with foreground work.
+ */
+class ExecutionPolicy {
+public:
+    /**
+     * @brief Pool for the given class; the global pool for Foreground
+     */
+    static QThreadPool* pool(ExecutionClass executionClass);
+
+    /**
+     * @brief Lower the calling thread's priorities (Background only)
+     *
+     * Call at the start of every task on the background pool; cheap after
+     * the first call on a thread.
+     */
+    static void applyToCurrentThread(ExecutionClass executionClass);
+
+    /**
+     * @brief Make a child process start with the class's priorities
+     */
+    static void configureProcess(QProcess& process, ExecutionClass executionClass);
+
+    /**
+     * @brief git "-c" options limiting its own worker threads
+     */
+    static QStringList gitConfigArgs(ExecutionClass executionClass);
+};
+
+#endif // EXECUTIONPOLICY_H
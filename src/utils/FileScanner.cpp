@@ -0,0 +1,151 @@
+#include "FileScanner.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QDateTime>
+#include "AdaptiveThrottle.h"
+#include "Tracer.h"
+
+FileScanner::FileScanner(const QString& rootPath)
+    : m_rootPath(QDir::cleanPath(rootPath))
+    , m_throttle(nullptr)
+{
+}
+
+void FileScanner::setIgnoreMatcher(const PatternMatcher& matcher)
+{
+    m_ignore = matcher;
+}
+
+void FileScanner::setTrackedScope(const TrackedScope& scope)
+{
+    m_scope = scope;
+}
+
+void FileScanner::setThrottle(AdaptiveThrottle* throttle)
+{
+    m_throttle = throttle;
+}
+
+void FileScanner::scan(const Visitor& visitor) const
+{
+    TraceSpan span("scan", "Directory scan");
+    int directoryCount = 0;
+    int fileCount = 0;
+
+    struct PendingDir {
+        QString relativePath;  // "" is the root
+        bool tracked;          // Selected by the scope, with everything below it
+    };
+
+    QList<PendingDir> pending;
+    pending.append({QString(), m_scope.isEmpty()});
+
+    while (!pending.isEmpty()) {
+        PendingDir current = pending.takeLast();
+        ++directoryCount;
+        if (m_throttle) {
+            m_throttle->pace();
+        }
+        const QString& relativeDir = current.relativePath;
+        QString absoluteDir = relativeDir.isEmpty()
+            ? m_rootPath
+            : m_rootPath + '/' + relativeDir;
+
+        QDirIterator it(absoluteDir,
+                        QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+        while (it.hasNext()) {
+            it.next();
+
+            QString relativePath = relativeDir.isEmpty()
+                ? it.fileName()
+                : relativeDir + '/' + it.fileName();
+
+            // Entry type comes from the directory read, not a stat
+            QFileInfo info = it.fileInfo();
+            bool isDirectory = info.isDir() && !info.isSymLink();
+
+            if (m_ignore.matches(relativePath, isDirectory)) {
+                continue;
+            }
+
+            bool tracked = current.tracked || m_scope.matchesEntry(relativePath, isDirectory);
+
+            if (isDirectory) {
+                if (tracked || m_scope.mayContainTracked(relativePath)) {
+                    pending.append({relativePath, tracked});
+                }
+                continue;
+            }
+
+            if (!tracked) {
+                continue;
+            }
+
+            ScannedFile file;
+            file.relativePath = relativePath;
+            file.size = info.size();
+            file.modifiedMs = info.lastModified().toMSecsSinceEpoch();
+            ++fileCount;
+            visitor(file);
+        }
+    }
+
+    span.setArg("directories", directoryCount);
+    span.setArg("files", fileCount);
+}
+
+QList<ScannedFile> FileScanner::collect() const
+{
+    QList<ScannedFile> files;
+    scan([&files](const ScannedFile& file) {
+        files.append(file);
+    });
+    return files;
+}
+
+QStringList FileScanner::trackedRoots() const
+{
+    if (m_scope.isEmpty()) {
+        return QStringList() << ".";
+    }
+
+    QStringList roots;
+    QStringList pending;
+    pending << QString();
+
+    while (!pending.isEmpty()) {
+        QString relativeDir = pending.takeLast();
+        if (m_throttle) {
+            m_throttle->pace();
+        }
+        QString absoluteDir = relativeDir.isEmpty()
+            ? m_rootPath
+            : m_rootPath + '/' + relativeDir;
+
+        QDirIterator it(absoluteDir,
+                        QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+        while (it.hasNext()) {
+            it.next();
+
+            QString relativePath = relativeDir.isEmpty()
+                ? it.fileName()
+                : relativeDir + '/' + it.fileName();
+
+            QFileInfo info = it.fileInfo();
+            bool isDirectory = info.isDir() && !info.isSymLink();
+
+            if (m_ignore.matches(relativePath, isDirectory)) {
+                continue;
+            }
+
+            if (m_scope.matchesEntry(relativePath, isDirectory)) {
+                roots << relativePath;
+            } else if (isDirectory && m_scope.mayContainTracked(relativePath)) {
+                pending << relativePath;
+            }
+        }
+    }
+
+    return roots;
+}
@@ -0,0 +1,73 @@
+#ifndef FILESCANNER_H
+#define FILESCANNER_H
+
+#include <QString>
+#include <QList>
+#include <functional>
+#include "PatternMatcher.h"
+#include "TrackedScope.h"
+
+class AdaptiveThrottle;
+
+/**
+ * @brief A regular file found by FileScanner
+ */
+struct ScannedFile {
+    QString relativePath;  // '/'-separated, relative to the scan root
+    qint64 size;
+    qint64 modifiedMs;     // Last modification, ms since epoch
+
+    ScannedFile()
+        : size(0)
+        , modifiedMs(0)
+    {}
+};
+
+/**
+ * @brief Directory walker that applies compiled ignore patterns
+ *
+ * Each entry is tested against the ignore matcher using only its name and
+ * the entry type reported by the directory read, so ignored files are never
+ * stat'ed and ignored directories are never opened. With a tracked scope,
+ * directories outside it are skipped the same way.
+ */
+class FileScanner {
+public:
+    using Visitor = std::function<void(const ScannedFile&)>;
+
+    explicit FileScanner(const QString& rootPath);
+
+    void setIgnoreMatcher(const PatternMatcher& matcher);
+    void setTrackedScope(const TrackedScope& scope);
+    
+    /**
+     * @brief Pace the walk with a throttle, once per directory read
+     */
+    void setThrottle(AdaptiveThrottle* throttle);
+
+    /**
+     * @brief Walk the tree and call the visitor for every non-ignored file
+     */
+    void scan(const Visitor& visitor) const;
+
+    /**
+     * @brief Walk the tree and collect every non-ignored file
+     */
+    QList<ScannedFile> collect() const;
+
+    /**
+     * @brief Find the topmost entries selected by the tracked scope
+     *
+     * Only directories on the way to a tracked path are read; selected
+     * subtrees are reported but not entered. Returns relative paths.
+     */
+    QStringList trackedRoots() const;
+
+private:
+    QString m_rootPath;
+    PatternMatcher m_ignore;
+    TrackedScope m_scope;
+    AdaptiveThrottle* m_throttle;
+};
+
+#endif // FILESCANNER_H
@@ -1,43 +1,52 @@
 #include "FileUtils.h"
+#include "FileScanner.h"
+#include "Tracer.h"
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
+#include <QThread>
 #include <QtConcurrent>
 
-QFuture<Result<qint64, QString>> FileUtils::getDirectorySize(const QString& path)
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#elif defined(Q_OS_MACOS)
+#include <sys/clonefile.h>
+#endif
+
+QFuture<Result<qint64, QString>> FileUtils::getDirectorySize(
+    const QString& path, const PatternMatcher& ignore, const TrackedScope& scope)
 {
-    return QtConcurrent::run([path]() -> Result<qint64, QString> {
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run([path, ignore, scope, queuedAt]() -> Result<qint64, QString> {
+        Tracer::recordQueueWait("FileUtils::getDirectorySize", queuedAt);
+        TraceSpan span("fs", "FileUtils::getDirectorySize");
+        
         if (!QDir(path).exists()) {
             return Result<qint64, QString>::err("Directory does not exist");
         }
         
-        qint64 size = calculateDirSizeRecursive(path);
+        qint64 size = 0;
+        FileScanner scanner(path);
+        scanner.setIgnoreMatcher(ignore);
+        scanner.setTrackedScope(scope);
+        scanner.scan([&size](const ScannedFile& file) {
+            size += file.size;
+        });
         return Result<qint64, QString>::ok(size);
     });
 }
 
-qint64 FileUtils::calculateDirSizeRecursive(const QString& path)
-{
-    qint64 totalSize = 0;
-    QDir dir(path);
-    
-    QFileInfoList entries = dir.entryInfoList(
-        QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden);
-    
-    for (const QFileInfo& entry : entries) {
-        if (entry.isFile()) {
-            totalSize += entry.size();
-        } else if (entry.isDir()) {
-            totalSize += calculateDirSizeRecursive(entry.absoluteFilePath());
-        }
-    }
-    
-    return totalSize;
-}
-
 QFuture<Result<void, QString>> FileUtils::copyDirectory(
     const QString& source, const QString& destination)
 {
-    return QtConcurrent::run([source, destination]() -> Result<void, QString> {
+    qint64 queuedAt = Tracer::nowUs();
+    return QtConcurrent::run([source, destination, queuedAt]() -> Result<void, QString> {
+        Tracer::recordQueueWait("FileUtils::copyDirectory", queuedAt);
+        TraceSpan span("fs", "FileUtils::copyDirectory");
+        
         QDir sourceDir(source);
         if (!sourceDir.exists()) {
             return Result<void, QString>::err("Source directory does not exist");
@@ -62,10 +71,11 @@ QFuture<Result<void, QString>> FileUtils::copyDirectory(
                         QString("Failed to copy file: %1").arg(entry.fileName()));
                 }
             } else if (entry.isDir()) {
-                auto result = copyDirectory(entry.absoluteFilePath(), destPath);
-                result.waitForFinished();
-                if (result.result().isErr()) {
-                    return result.result();
+                auto future = copyDirectory(entry.absoluteFilePath(), destPath);
+                future.waitForFinished();
+                auto result = future.takeResult();
+                if (result.isErr()) {
+                    return result;
                 }
             }
         }
@@ -74,6 +84,64 @@ QFuture<Result<void, QString>> FileUtils::copyDirectory(
     });
 }
 
+Result<bool, QString> FileUtils::cloneFile(const QString& source, const QString& destination)
+{
+    QFile::remove(destination);
+    
+#if defined(Q_OS_LINUX)
+    int sourceFd = ::open(QFile::encodeName(source).constData(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd >= 0) {
+        int destinationFd = ::open(QFile::encodeName(destination).constData(),
+                                   O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        bool cloned = destinationFd >= 0 && ::ioctl(destinationFd, FICLONE, sourceFd) == 0;
+        if (destinationFd >= 0) {
+            ::close(destinationFd);
+        }
+        ::close(sourceFd);
+        if (cloned) {
+            return Result<bool, QString>::ok(true);
+        }
+        QFile::remove(destination);  // Unsupported here (ext4, NTFS via FUSE...)
+    }
+#elif defined(Q_OS_MACOS)
+    if (::clonefile(QFile::encodeName(source).constData(),
+                    QFile::encodeName(destination).constData(), 0) == 0) {
+        return Result<bool, QString>::ok(true);
+    }
+#endif
+    
+    if (!QFile::copy(source, destination)) {
+        return Result<bool, QString>::err(QString("Failed to copy %1").arg(source));
+    }
+    return Result<bool, QString>::ok(false);
+}
+
+Result<bool, QString> FileUtils::copyStable(const QString& source, const QString& destination,
+                                            int attempts, int retryMs, const CopyFunction& copy)
+{
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        if (attempt > 0) {
+            QThread::msleep(retryMs << (attempt - 1));
+        }
+        
+        // Read into locals now: QFileInfo stats lazily, and a stat taken
+        // after the copy would compare the file with itself
+        QFileInfo before(source);
+        qint64 sizeBefore = before.size();
+        QDateTime modifiedBefore = before.lastModified();
+        
+        auto copyResult = copy(source, destination);
+        if (copyResult.isErr()) {
+            continue;  // Locked or vanished for a moment
+        }
+        QFileInfo after(source);
+        if (after.size() == sizeBefore && after.lastModified() == modifiedBefore) {
+            return copyResult;
+        }
+    }
+    return Result<bool, QString>::err(QString("%1 kept changing").arg(source));
+}
+
 bool FileUtils::isAccessible(const QString& path)
 {
     QFileInfo info(path);
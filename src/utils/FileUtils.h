@@ -3,17 +3,30 @@
 
 #include <QString>
 #include <QFuture>
+#include <functional>
 #include "core/types/Result.h"
+#include "PatternMatcher.h"
+#include "TrackedScope.h"
 
 /**
  * @brief File system utility functions
  */
 class FileUtils {
 public:
+    using CopyFunction = std::function<Result<bool, QString>(const QString&, const QString&)>;
+    
     /**
      * @brief Calculate directory size recursively
+     * 
+     * Symlinked directories are not followed, matching what git stores
+     * (the link, not its target); they used to be counted in full.
+     * @param ignore Entries matching these patterns are skipped without a stat
+     * @param scope Only files inside this scope are counted
      */
-    static QFuture<Result<qint64, QString>> getDirectorySize(const QString& path);
+    static QFuture<Result<qint64, QString>> getDirectorySize(
+        const QString& path,
+        const PatternMatcher& ignore = PatternMatcher(),
+        const TrackedScope& scope = TrackedScope());
     
     /**
      * @brief Copy directory recursively
@@ -21,6 +34,29 @@ public:
     static QFuture<Result<void, QString>> copyDirectory(
         const QString& source, const QString& destination);
     
+    /**
+     * @brief Copy one file, sharing its data blocks where the file system can
+     * 
+     * Uses a reflink clone (FICLONE on Btrfs/XFS, clonefile on APFS), which
+     * is near-instant and takes a point-in-time copy; otherwise falls back
+     * to a plain copy. An existing destination is replaced.
+     * @return true if the file was cloned, false if it was copied
+     */
+    static Result<bool, QString> cloneFile(const QString& source, const QString& destination);
+    
+    /**
+     * @brief Copy a file that may be written meanwhile, retrying until one copy is whole
+     * 
+     * A copy is kept when the source's size and modification time, read
+     * before the copy started, still match after it.
+     * @param retryMs Wait before the second attempt; doubles after every failed one
+     * @param copy Takes each copy; cloneFile unless a test needs to intervene
+     * @return Whether the kept copy was cloned; an error if the file never held still
+     */
+    static Result<bool, QString> copyStable(const QString& source, const QString& destination,
+                                            int attempts, int retryMs,
+                                            const CopyFunction& copy = cloneFile);
+    
     /**
      * @brief Check if path exists and is accessible
      */
@@ -35,9 +71,6 @@ public:
      * @brief Check if directory is a git repository
      */
     static bool isGitRepository(const QString& path);
-    
-private:
-    static qint64 calculateDirSizeRecursive(const QString& path);
 };
 
 #endif // FILEUTILS_H
@@ -1,11 +1,363 @@
 #include "Logger.h"
+#include "BoundedQueue.h"
 #include <QDateTime>
 #include <QFile>
-#include <QTextStream>
 #include <QMutex>
+#include <QVector>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
-Logger::Level Logger::s_logLevel = Logger::Level::Debug;
-QString Logger::s_logFilePath;
+std::atomic<Logger::Level> Logger::s_logLevel{Logger::Level::Debug};
+
+namespace {
+
+struct LogRecord {
+    Logger::Level level = Logger::Level::Debug;
+    qint64 timestampMs = 0;
+    QString message;
+    QString context;
+};
+
+constexpr size_t QueueCapacity = 8192;
+constexpr int MaxBatchSize = 512;
+constexpr auto IdleWait = std::chrono::milliseconds(50);
+constexpr qint64 DefaultMaxFileBytes = 10 * 1024 * 1024;  // 10MB
+constexpr int DefaultKeepFiles = 3;
+
+} // namespace
+
+/**
+ * @brief Background thread that drains the record buffer
+ *
+ * Only the writer thread touches m_file; configuration changes from other
+ * threads are picked up at the start of the next batch.
+ */
+class LogWriter {
+public:
+    static LogWriter& instance()
+    {
+        static LogWriter writer;
+        return writer;
+    }
+
+    void push(LogRecord record)
+    {
+        // Announced before checking m_accepting, so stop() can wait for
+        // every push that still saw the queue open
+        m_pushers.fetch_add(1);
+        if (!m_accepting.load()) {
+            m_pushers.fetch_sub(1);
+            writeSynchronously(record);
+            return;
+        }
+
+        bool queued = m_queue.tryPush(std::move(record));
+        if (queued) {
+            m_accepted.fetch_add(1, std::memory_order_release);
+        } else {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            m_droppedSinceReport.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_pushers.fetch_sub(1);
+
+        if (queued && m_idle.load(std::memory_order_acquire)) {
+            m_wake.notify_one();
+        }
+    }
+
+    void setFile(const QString& filePath)
+    {
+        QMutexLocker locker(&m_configMutex);
+        m_filePath = filePath;
+        m_configChanged = true;
+    }
+
+    void setRotation(qint64 maxBytes, int keepFiles)
+    {
+        QMutexLocker locker(&m_configMutex);
+        m_maxBytes = maxBytes;
+        m_keepFiles = qMax(0, keepFiles);
+    }
+
+    void flush()
+    {
+        if (!m_running.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        quint64 target = m_accepted.load(std::memory_order_acquire);
+        m_wake.notify_one();
+
+        std::unique_lock<std::mutex> lock(m_flushMutex);
+        m_flushed.wait(lock, [this, target]() {
+            return m_written.load(std::memory_order_acquire) >= target
+                || !m_running.load(std::memory_order_acquire);
+        });
+    }
+
+    void stop()
+    {
+        if (!m_running.exchange(false)) {
+            return;
+        }
+        m_wake.notify_one();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+
+        // Switch to synchronous writes only after everything queued is out.
+        // Records pushed while the writer drained are written here, and
+        // synchronous writers wait on m_syncMutex until they are.
+        {
+            QMutexLocker locker(&m_syncMutex);
+            m_accepting.store(false);
+            while (m_pushers.load() > 0) {
+                std::this_thread::yield();
+            }
+
+            QVector<LogRecord> leftovers;
+            LogRecord record;
+            while (m_queue.tryPop(record)) {
+                leftovers.append(std::move(record));
+            }
+            if (!leftovers.isEmpty()) {
+                writeBatch(leftovers);
+                m_written.fetch_add(leftovers.size(), std::memory_order_release);
+            }
+            m_file.close();
+        }
+        m_flushed.notify_all();
+    }
+
+    quint64 droppedCount() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    BoundedQueue<LogRecord> m_queue;
+    std::thread m_thread;
+    std::atomic<bool> m_running;     // Writer thread draining the queue
+    std::atomic<bool> m_accepting;   // push() queues; false after stop()
+    std::atomic<int> m_pushers;      // push() calls between check and queue
+    std::atomic<bool> m_idle;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+
+    // Flush bookkeeping: records accepted into the queue vs. written out
+    std::atomic<quint64> m_accepted;
+    std::atomic<quint64> m_written;
+    std::mutex m_flushMutex;
+    std::condition_variable m_flushed;
+
+    std::atomic<quint64> m_dropped;
+    std::atomic<quint64> m_droppedSinceReport;
+
+    QMutex m_configMutex;
+    QString m_filePath;
+    bool m_configChanged;
+    qint64 m_maxBytes;
+    int m_keepFiles;
+
+    // Writer thread state; stop() takes it over once the thread has joined
+    QFile m_file;
+
+    // Used after shutdown, when there is no writer thread
+    QMutex m_syncMutex;
+
+    LogWriter()
+        : m_queue(QueueCapacity)
+        , m_running(true)
+        , m_accepting(true)
+        , m_pushers(0)
+        , m_idle(false)
+        , m_accepted(0)
+        , m_written(0)
+        , m_dropped(0)
+        , m_droppedSinceReport(0)
+        , m_configChanged(false)
+        , m_maxBytes(DefaultMaxFileBytes)
+        , m_keepFiles(DefaultKeepFiles)
+    {
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    ~LogWriter()
+    {
+        stop();
+    }
+
+    void run()
+    {
+        QVector<LogRecord> batch;
+        batch.reserve(MaxBatchSize);
+
+        while (true) {
+            LogRecord record;
+            while (batch.size() < MaxBatchSize && m_queue.tryPop(record)) {
+                batch.append(std::move(record));
+            }
+
+            if (batch.isEmpty()) {
+                if (!m_running.load(std::memory_order_acquire)) {
+                    break;  // Stopped and fully drained
+                }
+                std::unique_lock<std::mutex> lock(m_wakeMutex);
+                m_idle.store(true, std::memory_order_release);
+                m_wake.wait_for(lock, IdleWait);
+                m_idle.store(false, std::memory_order_release);
+                continue;
+            }
+
+            writeBatch(batch);
+            m_written.fetch_add(batch.size(), std::memory_order_release);
+            batch.clear();
+
+            std::lock_guard<std::mutex> lock(m_flushMutex);
+            m_flushed.notify_all();
+        }
+    }
+
+    static QString format(const LogRecord& record)
+    {
+        // Records arrive in bursts, so most share the previous second. Per
+        // thread: synchronous writers format on their own threads.
+        thread_local qint64 cachedSecond = -1;
+        thread_local QString cachedTimestamp;
+        qint64 second = record.timestampMs / 1000;
+        if (second != cachedSecond) {
+            cachedSecond = second;
+            cachedTimestamp = QDateTime::fromMSecsSinceEpoch(record.timestampMs)
+                .toString("yyyy-MM-dd HH:mm:ss");
+        }
+
+        QString contextStr = record.context.isEmpty() ? "" : QString(" [%1]").arg(record.context);
+
+        return QString("%1 [%2]%3: %4")
+            .arg(cachedTimestamp)
+            .arg(Logger::levelToString(record.level))
+            .arg(contextStr)
+            .arg(record.message);
+    }
+
+    static void writeConsole(Logger::Level level, const QString& logMessage)
+    {
+        switch (level) {
+            case Logger::Level::Debug:
+                qDebug().noquote() << logMessage;
+                break;
+            case Logger::Level::Info:
+                qInfo().noquote() << logMessage;
+                break;
+            case Logger::Level::Warning:
+                qWarning().noquote() << logMessage;
+                break;
+            case Logger::Level::Error:
+                qCritical().noquote() << logMessage;
+                break;
+        }
+    }
+
+    void applyConfig(qint64& maxBytes, int& keepFiles)
+    {
+        QMutexLocker locker(&m_configMutex);
+        maxBytes = m_maxBytes;
+        keepFiles = m_keepFiles;
+
+        if (!m_configChanged) {
+            return;
+        }
+        m_configChanged = false;
+
+        m_file.close();
+        if (!m_filePath.isEmpty()) {
+            m_file.setFileName(m_filePath);
+            if (!m_file.open(QIODevice::Append | QIODevice::Text)) {
+                qWarning().noquote() << "Failed to open log file" << m_filePath;
+            }
+        }
+    }
+
+    void rotate(int keepFiles)
+    {
+        QString path = m_file.fileName();
+        m_file.close();
+
+        if (keepFiles == 0) {
+            QFile::remove(path);
+        } else {
+            QFile::remove(QString("%1.%2").arg(path).arg(keepFiles));
+            for (int i = keepFiles - 1; i >= 1; --i) {
+                QFile::rename(QString("%1.%2").arg(path).arg(i),
+                              QString("%1.%2").arg(path).arg(i + 1));
+            }
+            QFile::rename(path, path + ".1");
+        }
+
+        m_file.setFileName(path);
+        m_file.open(QIODevice::Append | QIODevice::Text);
+    }
+
+    void writeBatch(const QVector<LogRecord>& batch)
+    {
+        qint64 maxBytes = -1;
+        int keepFiles = 0;
+        applyConfig(maxBytes, keepFiles);
+
+        QByteArray buffer;
+
+        quint64 dropped = m_droppedSinceReport.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            LogRecord notice;
+            notice.level = Logger::Level::Warning;
+            notice.timestampMs = batch.first().timestampMs;
+            notice.message = QString("%1 log messages dropped (buffer full)").arg(dropped);
+            notice.context = "Logger";
+            QString line = format(notice);
+            writeConsole(notice.level, line);
+            buffer += line.toUtf8() + '\n';
+        }
+
+        for (const LogRecord& record : batch) {
+            QString line = format(record);
+            writeConsole(record.level, line);
+            if (m_file.isOpen()) {
+                buffer += line.toUtf8() + '\n';
+            }
+        }
+
+        if (!m_file.isOpen() || buffer.isEmpty()) {
+            return;
+        }
+
+        if (maxBytes > 0 && m_file.size() > 0 && m_file.size() + buffer.size() > maxBytes) {
+            rotate(keepFiles);
+        }
+        m_file.write(buffer);
+        m_file.flush();
+    }
+
+    void writeSynchronously(const LogRecord& record)
+    {
+        QMutexLocker locker(&m_syncMutex);
+        QString line = format(record);
+        writeConsole(record.level, line);
+
+        QString filePath;
+        {
+            QMutexLocker configLocker(&m_configMutex);
+            filePath = m_filePath;
+        }
+        if (!filePath.isEmpty()) {
+            QFile file(filePath);
+            if (file.open(QIODevice::Append | QIODevice::Text)) {
+                file.write(line.toUtf8() + '\n');
+            }
+        }
+    }
+};
 
 QString Logger::levelToString(Level level)
 {
@@ -20,47 +372,17 @@ QString Logger::levelToString(Level level)
 
 void Logger::log(Level level, const QString& message, const QString& context)
 {
-    if (level < s_logLevel) {
+    if (level < s_logLevel.load(std::memory_order_relaxed)) {
         return;
     }
-    
-    QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
-    QString levelStr = levelToString(level);
-    QString contextStr = context.isEmpty() ? "" : QString(" [%1]").arg(context);
-    
-    QString logMessage = QString("%1 [%2]%3: %4")
-        .arg(timestamp)
-        .arg(levelStr)
-        .arg(contextStr)
-        .arg(message);
-    
-    // Output to console
-    switch (level) {
-        case Level::Debug:
-            qDebug().noquote() << logMessage;
-            break;
-        case Level::Info:
-            qInfo().noquote() << logMessage;
-            break;
-        case Level::Warning:
-            qWarning().noquote() << logMessage;
-            break;
-        case Level::Error:
-            qCritical().noquote() << logMessage;
-            break;
-    }
-    
-    // Write to file if configured
-    if (!s_logFilePath.isEmpty()) {
-        static QMutex mutex;
-        QMutexLocker locker(&mutex);
-        
-        QFile file(s_logFilePath);
-        if (file.open(QIODevice::Append | QIODevice::Text)) {
-            QTextStream stream(&file);
-            stream << logMessage << "\n";
-        }
-    }
+
+    // Formatting and I/O happen on the writer thread
+    LogRecord record;
+    record.level = level;
+    record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    record.message = message;
+    record.context = context;
+    LogWriter::instance().push(std::move(record));
 }
 
 void Logger::debug(const QString& message, const QString& context)
@@ -85,10 +407,30 @@ void Logger::error(const QString& message, const QString& context)
 
 void Logger::setLogLevel(Level level)
 {
-    s_logLevel = level;
+    s_logLevel.store(level, std::memory_order_relaxed);
 }
 
 void Logger::setLogFile(const QString& filePath)
 {
-    s_logFilePath = filePath;
+    LogWriter::instance().setFile(filePath);
+}
+
+void Logger::setRotation(qint64 maxBytes, int keepFiles)
+{
+    LogWriter::instance().setRotation(maxBytes, keepFiles);
+}
+
+void Logger::flush()
+{
+    LogWriter::instance().flush();
+}
+
+void Logger::shutdown()
+{
+    LogWriter::instance().stop();
+}
+
+quint64 Logger::droppedCount()
+{
+    return LogWriter::instance().droppedCount();
 }
@@ -3,11 +3,19 @@
 
 #include <QString>
 #include <QDebug>
+#include <atomic>
 
 /**
  * @brief Simple logging utility
- * 
+ *
  * Provides structured logging for the application.
+ *
+ * Logging is asynchronous: callers push a record into a lock-free ring
+ * buffer and return immediately. A single background writer formats the
+ * records, prints them to the console and appends them in batches to a log
+ * file it keeps open, rotating it once it grows past the size limit. If the
+ * buffer is full the record is dropped and counted; the writer reports how
+ * many were lost.
  */
 class Logger {
 public:
@@ -17,22 +25,45 @@ public:
         Warning,
         Error
     };
-    
+
     static void log(Level level, const QString& message, const QString& context = QString());
-    
+
     static void debug(const QString& message, const QString& context = QString());
     static void info(const QString& message, const QString& context = QString());
     static void warning(const QString& message, const QString& context = QString());
     static void error(const QString& message, const QString& context = QString());
-    
+
     static void setLogLevel(Level level);
     static void setLogFile(const QString& filePath);
-    
+
+    /**
+     * @brief Rotate the log file once it exceeds this size
+     * @param maxBytes Size limit, or -1 to never rotate
+     * @param keepFiles Number of rotated files to keep (file.1 ... file.N)
+     */
+    static void setRotation(qint64 maxBytes, int keepFiles);
+
+    /**
+     * @brief Block until every record logged so far has been written
+     */
+    static void flush();
+
+    /**
+     * @brief Flush and stop the background writer
+     */
+    static void shutdown();
+
+    /**
+     * @brief Number of records dropped because the buffer was full
+     */
+    static quint64 droppedCount();
+
 private:
-    static Level s_logLevel;
-    static QString s_logFilePath;
-    
+    static std::atomic<Level> s_logLevel;
+
     static QString levelToString(Level level);
+
+    friend class LogWriter;
 };
 
 #endif // LOGGER_H
@@ -1,7 +1,104 @@
 #include "PathDetector.h"
+#include "VdfParser.h"
 #include <QDir>
 #include <QStandardPaths>
 #include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QtConcurrent>
+
+namespace {
+
+struct LibraryCacheEntry {
+    QDateTime steamappsModified;
+    QList<SteamInstall> installs;
+};
+
+struct LibraryFoldersCacheEntry {
+    QDateTime vdfModified;
+    QStringList libraries;
+};
+
+struct SteamCache {
+    QMutex mutex;
+    QHash<QString, LibraryCacheEntry> libraries;         // library root -> installs
+    QHash<QString, LibraryFoldersCacheEntry> folders;    // libraryfolders.vdf -> roots
+};
+
+SteamCache& steamCache()
+{
+    static SteamCache cache;
+    return cache;
+}
+
+QString canonicalDir(const QString& path)
+{
+    QString canonical = QFileInfo(path).canonicalFilePath();
+    return canonical.isEmpty() ? QDir::cleanPath(path) : canonical;
+}
+
+QStringList parseLibraryFolders(const QString& vdfPath)
+{
+    QStringList libraries;
+
+    auto result = VdfParser::parseFile(vdfPath);
+    if (result.isErr()) {
+        return libraries;
+    }
+
+    // Newer Steam writes "libraryfolders", older clients "LibraryFolders"
+    QVariantMap root = result.value().value("libraryfolders").toMap();
+    if (root.isEmpty()) {
+        root = result.value().value("LibraryFolders").toMap();
+    }
+
+    for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+        bool isIndex = false;
+        it.key().toInt(&isIndex);
+        if (!isIndex) {
+            continue;  // Skip "TimeNextStatsReport", "ContentStatsID", ...
+        }
+
+        // New format: "0" { "path" "..." }, old format: "1" "D:\\SteamLibrary"
+        QString path = it.value().typeId() == QMetaType::QVariantMap
+            ? it.value().toMap().value("path").toString()
+            : it.value().toString();
+        if (!path.isEmpty()) {
+            libraries << QDir::fromNativeSeparators(path);
+        }
+    }
+
+    return libraries;
+}
+
+SteamInstall parseAppManifest(const QString& manifestPath)
+{
+    SteamInstall install;
+
+    auto result = VdfParser::parseFile(manifestPath);
+    if (result.isErr()) {
+        return install;
+    }
+
+    QVariantMap appState = result.value().value("AppState").toMap();
+    QString installDir = appState.value("installdir").toString();
+    if (installDir.isEmpty()) {
+        return install;
+    }
+
+    // Manifests live in <library>/steamapps/appmanifest_<id>.acf
+    QDir steamappsDir = QFileInfo(manifestPath).absoluteDir();
+    install.appId = appState.value("appid").toString();
+    install.name = appState.value("name").toString();
+    install.installPath = steamappsDir.absoluteFilePath("common/" + installDir);
+    install.libraryPath = QDir::cleanPath(steamappsDir.absoluteFilePath(".."));
+    return install;
+}
+
+} // namespace
 
 QString PathDetector::getCurrentPlatform()
 {
@@ -14,37 +111,173 @@ QString PathDetector::getCurrentPlatform()
 #endif
 }
 
-QStringList PathDetector::getSteamLibraryPaths()
+QStringList PathDetector::getSteamRoots()
 {
-    QStringList paths;
-    QString platform = getCurrentPlatform();
-    
+    QStringList candidates;
+
 #ifdef Q_OS_WIN
-    QString steamPath = "C:/Program Files (x86)/Steam";
-    if (QDir(steamPath).exists()) {
-        paths << steamPath + "/steamapps/common";
-    }
+    candidates << "C:/Program Files (x86)/Steam"
+               << "C:/Program Files/Steam";
 #elif defined(Q_OS_MAC)
-    QString steamPath = QDir::homePath() + "/Library/Application Support/Steam";
-    if (QDir(steamPath).exists()) {
-        paths << steamPath + "/steamapps/common";
-    }
+    candidates << QDir::homePath() + "/Library/Application Support/Steam";
 #else // Linux
-    QString steamPath = QDir::homePath() + "/.steam/steam";
-    if (QDir(steamPath).exists()) {
-        paths << steamPath + "/steamapps/common";
-    }
-    
+    candidates << QDir::homePath() + "/.steam/steam"
+               << QDir::homePath() + "/.local/share/Steam";
+
     // Also check Flatpak Steam
-    QString flatpakSteam = QDir::homePath() + "/.var/app/com.valvesoftware.Steam/.steam/steam";
-    if (QDir(flatpakSteam).exists()) {
-        paths << flatpakSteam + "/steamapps/common";
-    }
+    candidates << QDir::homePath() + "/.var/app/com.valvesoftware.Steam/.steam/steam"
+               << QDir::homePath() + "/.var/app/com.valvesoftware.Steam/.local/share/Steam";
 #endif
-    
+
+    // ~/.steam/steam is usually a symlink to ~/.local/share/Steam
+    QStringList roots;
+    for (const QString& candidate : candidates) {
+        if (!QDir(candidate).exists()) {
+            continue;
+        }
+        QString canonical = canonicalDir(candidate);
+        if (!roots.contains(canonical)) {
+            roots << canonical;
+        }
+    }
+    return roots;
+}
+
+QStringList PathDetector::getSteamLibraryRoots()
+{
+    QStringList libraries;
+    SteamCache& cache = steamCache();
+
+    for (const QString& steamRoot : getSteamRoots()) {
+        if (!libraries.contains(steamRoot)) {
+            libraries << steamRoot;
+        }
+
+        QString vdfPath = steamRoot + "/steamapps/libraryfolders.vdf";
+        QFileInfo vdfInfo(vdfPath);
+        if (!vdfInfo.exists()) {
+            vdfPath = steamRoot + "/config/libraryfolders.vdf";
+            vdfInfo = QFileInfo(vdfPath);
+            if (!vdfInfo.exists()) {
+                continue;
+            }
+        }
+
+        // An empty list is a valid entry too: parsed, no extra libraries
+        QStringList folders;
+        bool cached = false;
+        {
+            QMutexLocker locker(&cache.mutex);
+            auto it = cache.folders.constFind(vdfPath);
+            if (it != cache.folders.constEnd() && it->vdfModified == vdfInfo.lastModified()) {
+                folders = it->libraries;
+                cached = true;
+            }
+        }
+
+        if (!cached) {
+            for (const QString& folder : parseLibraryFolders(vdfPath)) {
+                if (QDir(folder).exists()) {
+                    folders << canonicalDir(folder);
+                }
+            }
+            QMutexLocker locker(&cache.mutex);
+            cache.folders.insert(vdfPath, {vdfInfo.lastModified(), folders});
+        }
+
+        for (const QString& folder : folders) {
+            if (!libraries.contains(folder)) {
+                libraries << folder;
+            }
+        }
+    }
+
+    return libraries;
+}
+
+QStringList PathDetector::getSteamLibraryPaths()
+{
+    QStringList paths;
+    for (const QString& library : getSteamLibraryRoots()) {
+        QString commonPath = library + "/steamapps/common";
+        if (QDir(commonPath).exists()) {
+            paths << commonPath;
+        }
+    }
     return paths;
 }
 
+QList<SteamInstall> PathDetector::scanLibrary(const QString& libraryRoot)
+{
+    QDir steamappsDir(libraryRoot + "/steamapps");
+    QStringList manifests = steamappsDir.entryList(
+        QStringList() << "appmanifest_*.acf", QDir::Files);
+
+    QStringList manifestPaths;
+    manifestPaths.reserve(manifests.size());
+    for (const QString& manifest : manifests) {
+        manifestPaths << steamappsDir.absoluteFilePath(manifest);
+    }
+
+    QList<SteamInstall> installs;
+    const QList<SteamInstall> parsed = QtConcurrent::blockingMapped(manifestPaths, parseAppManifest);
+    for (const SteamInstall& install : parsed) {
+        if (!install.appId.isEmpty()) {
+            installs << install;
+        }
+    }
+    return installs;
+}
+
+QList<SteamInstall> PathDetector::getSteamInstalls()
+{
+    SteamCache& cache = steamCache();
+
+    QList<SteamInstall> installs;
+    QStringList staleLibraries;
+    QHash<QString, QDateTime> modifiedTimes;
+
+    for (const QString& library : getSteamLibraryRoots()) {
+        // Installing or removing a game adds/removes an appmanifest, which
+        // bumps the steamapps directory mtime and invalidates the entry.
+        QDateTime modified = QFileInfo(library + "/steamapps").lastModified();
+        modifiedTimes.insert(library, modified);
+
+        QMutexLocker locker(&cache.mutex);
+        auto it = cache.libraries.constFind(library);
+        if (it != cache.libraries.constEnd() && it->steamappsModified == modified) {
+            installs << it->installs;
+        } else {
+            staleLibraries << library;
+        }
+    }
+
+    if (staleLibraries.isEmpty()) {
+        return installs;
+    }
+
+    // Each library usually sits on its own drive, so scan them concurrently
+    const QList<QList<SteamInstall>> scanned =
+        QtConcurrent::blockingMapped(staleLibraries, &PathDetector::scanLibrary);
+
+    QMutexLocker locker(&cache.mutex);
+    for (int i = 0; i < staleLibraries.size(); ++i) {
+        const QString& library = staleLibraries[i];
+        cache.libraries.insert(library, {modifiedTimes.value(library), scanned[i]});
+        installs << scanned[i];
+    }
+
+    return installs;
+}
+
+void PathDetector::clearCache()
+{
+    SteamCache& cache = steamCache();
+    QMutexLocker locker(&cache.mutex);
+    cache.libraries.clear();
+    cache.folders.clear();
+}
+
 QStringList PathDetector::getCommonGamePaths()
 {
     QStringList paths;
@@ -91,20 +324,30 @@ bool PathDetector::looksLikeGameDirectory(const QString& path)
     }
     
     // Look for common game file indicators
-    QStringList indicators = {
-        "*.exe",  // Windows executables
-        "*.app",  // macOS applications
-        "*.so",   // Linux shared libraries
-        "Data",   // Common data folder
-        "Saves",  // Save files
-        "*.ini",  // Config files
-        "*.pak",  // Package files
-        "*.unity3d"  // Unity games
+    static const QSet<QString> indicatorSuffixes = {
+        "exe",      // Windows executables
+        "app",      // macOS applications
+        "so",       // Linux shared libraries
+        "ini",      // Config files
+        "pak",      // Package files
+        "unity3d"   // Unity games
+    };
+    static const QSet<QString> indicatorNames = {
+        "data",     // Common data folder
+        "saves"     // Save files
     };
     
-    for (const QString& pattern : indicators) {
-        QStringList matches = dir.entryList(QStringList() << pattern);
-        if (!matches.isEmpty()) {
+    // Read the directory once and test every entry against all indicators
+    const QStringList entries = dir.entryList(
+        QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System, QDir::Unsorted);
+    
+    for (const QString& entry : entries) {
+        QString lower = entry.toLower();
+        if (indicatorNames.contains(lower)) {
+            return true;
+        }
+        int dot = lower.lastIndexOf('.');
+        if (dot >= 0 && indicatorSuffixes.contains(lower.mid(dot + 1))) {
             return true;
         }
     }
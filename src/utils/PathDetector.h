@@ -4,6 +4,17 @@
 #include <QString>
 #include <QStringList>
 #include <QMap>
+#include <QList>
+
+/**
+ * @brief A game installed in one of the Steam libraries
+ */
+struct SteamInstall {
+    QString appId;        // Steam app ID (e.g., "489830")
+    QString name;         // Name from the app manifest
+    QString installPath;  // Absolute path to steamapps/common/<installdir>
+    QString libraryPath;  // Root of the library containing the install
+};
 
 /**
  * @brief Detects game installation paths on different platforms
@@ -12,9 +23,20 @@ class PathDetector {
 public:
     /**
      * @brief Find Steam library folders
+     *
+     * Returns the steamapps/common directory of every library listed in
+     * libraryfolders.vdf, so games on secondary drives are included.
      */
     static QStringList getSteamLibraryPaths();
     
+    /**
+     * @brief Find every game installed across all Steam libraries
+     *
+     * Libraries are scanned in parallel. Results are cached per library and
+     * reused until the library's steamapps directory changes.
+     */
+    static QList<SteamInstall> getSteamInstalls();
+    
     /**
      * @brief Find common game installation directories
      */
@@ -30,8 +52,16 @@ public:
      */
     static bool looksLikeGameDirectory(const QString& path);
     
+    /**
+     * @brief Drop all cached Steam library data
+     */
+    static void clearCache();
+    
 private:
     static QString getCurrentPlatform();
+    static QStringList getSteamRoots();
+    static QStringList getSteamLibraryRoots();
+    static QList<SteamInstall> scanLibrary(const QString& libraryRoot);
 };
 
 #endif // PATHDETECTOR_H
@@ -0,0 +1,202 @@
+#include "PatternMatcher.h"
+
+PatternMatcher::PatternMatcher()
+    : m_caseSensitivity(defaultCaseSensitivity())
+    , m_patternCount(0)
+{
+}
+
+PatternMatcher::PatternMatcher(const QStringList& patterns, Qt::CaseSensitivity caseSensitivity)
+    : m_caseSensitivity(caseSensitivity)
+    , m_patternCount(0)
+{
+    compile(patterns, caseSensitivity);
+}
+
+Qt::CaseSensitivity PatternMatcher::defaultCaseSensitivity()
+{
+    // Mirrors git's core.ignorecase default for the platform's filesystems
+#if defined(Q_OS_WIN) || defined(Q_OS_MAC)
+    return Qt::CaseInsensitive;
+#else
+    return Qt::CaseSensitive;
+#endif
+}
+
+void PatternMatcher::compile(const QStringList& patterns, Qt::CaseSensitivity caseSensitivity)
+{
+    m_any = Tables();
+    m_directories = Tables();
+    m_caseSensitivity = caseSensitivity;
+    m_patternCount = 0;
+
+    for (const QString& pattern : patterns) {
+        addPattern(pattern);
+    }
+
+    finalize(m_any);
+    finalize(m_directories);
+}
+
+void PatternMatcher::addPattern(const QString& rawPattern)
+{
+    QString pattern = rawPattern.trimmed();
+    if (pattern.isEmpty() || pattern.startsWith('#') || pattern.startsWith('!')) {
+        return;
+    }
+
+    bool directoryOnly = pattern.endsWith('/');
+    while (pattern.endsWith('/')) {
+        pattern.chop(1);
+    }
+
+    bool anchored = pattern.contains('/');
+    if (pattern.startsWith('/')) {
+        pattern = pattern.mid(1);
+    }
+    if (pattern.isEmpty()) {
+        return;
+    }
+
+    if (m_caseSensitivity == Qt::CaseInsensitive) {
+        pattern = pattern.toCaseFolded();
+    }
+
+    static const QRegularExpression wildcardChars(R"([*?\[\\])");
+    bool hasWildcard = pattern.contains(wildcardChars);
+
+    Tables& tables = directoryOnly ? m_directories : m_any;
+    ++m_patternCount;
+
+    if (anchored) {
+        if (hasWildcard) {
+            tables.pathRegexes << globToRegex(pattern);
+        } else {
+            tables.paths.insert(pattern);
+        }
+        return;
+    }
+
+    if (!hasWildcard) {
+        tables.names.insert(pattern);
+        return;
+    }
+
+    QString suffix = pattern.mid(1);
+    if (pattern.startsWith('*') && !suffix.isEmpty() && !suffix.contains(wildcardChars)) {
+        tables.suffixes[suffix.size()].insert(suffix);
+        return;
+    }
+
+    tables.nameRegexes << globToRegex(pattern);
+}
+
+void PatternMatcher::finalize(Tables& tables)
+{
+    QRegularExpression::PatternOptions options = QRegularExpression::DontCaptureOption;
+    if (m_caseSensitivity == Qt::CaseInsensitive) {
+        options |= QRegularExpression::CaseInsensitiveOption;
+    }
+
+    auto join = [](const QStringList& regexes) {
+        QStringList groups;
+        groups.reserve(regexes.size());
+        for (const QString& regex : regexes) {
+            groups << QString("(?:%1)").arg(regex);
+        }
+        return groups.join('|');
+    };
+
+    if (!tables.nameRegexes.isEmpty()) {
+        tables.nameRegex = QRegularExpression(join(tables.nameRegexes), options);
+        tables.nameRegex.optimize();
+    }
+    if (!tables.pathRegexes.isEmpty()) {
+        tables.pathRegex = QRegularExpression(join(tables.pathRegexes), options);
+        tables.pathRegex.optimize();
+    }
+}
+
+QString PatternMatcher::globToRegex(const QString& glob)
+{
+    QString regex = "^";
+
+    for (int i = 0; i < glob.size(); ++i) {
+        QChar c = glob[i];
+
+        if (c == '*') {
+            if (i + 1 < glob.size() && glob[i + 1] == '*') {
+                ++i;
+                if (i + 1 < glob.size() && glob[i + 1] == '/') {
+                    ++i;
+                    regex += "(?:.*/)?";  // "**/" matches zero or more directories
+                } else {
+                    regex += ".*";
+                }
+            } else {
+                regex += "[^/]*";
+            }
+        } else if (c == '?') {
+            regex += "[^/]";
+        } else if (c == '[') {
+            int close = glob.indexOf(']', i + 2);
+            if (close < 0) {
+                regex += "\\[";
+                continue;
+            }
+            QString set = glob.mid(i + 1, close - i - 1);
+            if (set.startsWith('!')) {
+                set[0] = QLatin1Char('^');
+            }
+            set.replace("\\", "\\\\");
+            regex += '[' + set + ']';
+            i = close;
+        } else if (c == '\\' && i + 1 < glob.size()) {
+            regex += QRegularExpression::escape(QString(glob[++i]));
+        } else {
+            regex += QRegularExpression::escape(QString(c));
+        }
+    }
+
+    regex += '$';
+    return regex;
+}
+
+bool PatternMatcher::matchTables(const Tables& tables, const QString& path, const QString& name) const
+{
+    if (tables.names.contains(name) || tables.paths.contains(path)) {
+        return true;
+    }
+
+    for (auto it = tables.suffixes.constBegin(); it != tables.suffixes.constEnd(); ++it) {
+        if (name.size() >= it.key() && it.value().contains(name.right(it.key()))) {
+            return true;
+        }
+    }
+
+    if (!tables.nameRegexes.isEmpty() && tables.nameRegex.match(name).hasMatch()) {
+        return true;
+    }
+    if (!tables.pathRegexes.isEmpty() && tables.pathRegex.match(path).hasMatch()) {
+        return true;
+    }
+
+    return false;
+}
+
+bool PatternMatcher::matches(const QString& relativePath, bool isDirectory) const
+{
+    if (m_patternCount == 0) {
+        return false;
+    }
+
+    QString path = m_caseSensitivity == Qt::CaseInsensitive
+        ? relativePath.toCaseFolded()
+        : relativePath;
+    QString name = path.mid(path.lastIndexOf('/') + 1);
+
+    if (matchTables(m_any, path, name)) {
+        return true;
+    }
+    return isDirectory && matchTables(m_directories, path, name);
+}
@@ -0,0 +1,81 @@
+#ifndef PATTERNMATCHER_H
+#define PATTERNMATCHER_H
+
+#include <QString>
+#include <QStringList>
+#include <QSet>
+#include <QHash>
+#include <QVector>
+#include <QRegularExpression>
+
+/**
+ * @brief Compiled matcher for .gitignore-style patterns
+ *
+ * Patterns are sorted once into the cheapest structure that can answer them:
+ * - literal names ("Logs/", "servers.dat") go into hash sets
+ * - "*<literal>" globs ("*.log", "*.log.gz") go into suffix tables keyed by
+ *   suffix length, so a name is checked with one hash lookup per length
+ * - everything else is translated to a regular expression and all of them
+ *   are joined into a single alternation, compiled and JIT-optimized once
+ *
+ * Semantics follow gitignore: a trailing '/' restricts the pattern to
+ * directories, a pattern containing any other '/' is anchored to the root
+ * and matched against the full relative path, and anything else is matched
+ * against the entry name at any depth. Negated ('!') patterns are not
+ * supported and are skipped.
+ */
+class PatternMatcher {
+public:
+    PatternMatcher();
+    explicit PatternMatcher(const QStringList& patterns,
+                            Qt::CaseSensitivity caseSensitivity = defaultCaseSensitivity());
+
+    /**
+     * @brief Replace the compiled pattern set
+     */
+    void compile(const QStringList& patterns,
+                 Qt::CaseSensitivity caseSensitivity = defaultCaseSensitivity());
+
+    bool isEmpty() const { return m_patternCount == 0; }
+
+    /**
+     * @brief Test an entry against the compiled patterns
+     * @param relativePath Path relative to the scan root, '/'-separated
+     * @param isDirectory Whether the entry is a directory
+     */
+    bool matches(const QString& relativePath, bool isDirectory) const;
+
+    /**
+     * @brief Case sensitivity git uses by default on this platform
+     */
+    static Qt::CaseSensitivity defaultCaseSensitivity();
+
+    /**
+     * @brief Translate a single glob into an anchored regular expression
+     */
+    static QString globToRegex(const QString& glob);
+
+private:
+    // One table set for patterns that apply to any entry, one for
+    // directory-only patterns
+    struct Tables {
+        QSet<QString> names;                 // Literal entry names
+        QHash<int, QSet<QString>> suffixes;  // Suffix length -> literal suffixes
+        QSet<QString> paths;                 // Literal root-anchored paths
+        QStringList nameRegexes;
+        QStringList pathRegexes;
+        QRegularExpression nameRegex;
+        QRegularExpression pathRegex;
+    };
+
+    Tables m_any;
+    Tables m_directories;
+    Qt::CaseSensitivity m_caseSensitivity;
+    int m_patternCount;
+
+    void addPattern(const QString& pattern);
+    void finalize(Tables& tables);
+    bool matchTables(const Tables& tables, const QString& path, const QString& name) const;
+};
+
+#endif // PATTERNMATCHER_H
@@ -0,0 +1,204 @@
+#include "Tracer.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+namespace {
+
+struct TraceEvent {
+    const char* category;
+    QString name;
+    qint64 startUs;
+    qint64 durationUs;
+    QJsonObject args;
+};
+
+struct ThreadBuffer {
+    QMutex mutex;  // Only contended while exporting
+    QVector<TraceEvent> events;
+    int tid = 0;
+    QString threadName;
+};
+
+struct TraceRegistry {
+    std::atomic<bool> enabled{false};
+    std::atomic<int> nextTid{1};
+    QElapsedTimer clock;
+    QMutex mutex;
+    QList<std::shared_ptr<ThreadBuffer>> buffers;
+
+    TraceRegistry()
+    {
+        clock.start();
+    }
+};
+
+TraceRegistry& registry()
+{
+    static TraceRegistry instance;
+    return instance;
+}
+
+ThreadBuffer& localBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        TraceRegistry& reg = registry();
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->tid = reg.nextTid.fetch_add(1);
+
+        QThread* thread = QThread::currentThread();
+        QCoreApplication* app = QCoreApplication::instance();
+        if (app && thread == app->thread()) {
+            buffer->threadName = "Main";
+        } else if (!thread->objectName().isEmpty()) {
+            buffer->threadName = QString("%1 %2").arg(thread->objectName()).arg(buffer->tid);
+        } else {
+            buffer->threadName = QString("Thread %1").arg(buffer->tid);
+        }
+
+        // The registry keeps the buffer alive after its thread exits
+        QMutexLocker locker(&reg.mutex);
+        reg.buffers.append(buffer);
+    }
+    return *buffer;
+}
+
+} // namespace
+
+void Tracer::setEnabled(bool enabled)
+{
+    registry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Tracer::isEnabled()
+{
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+qint64 Tracer::nowUs()
+{
+    return registry().clock.nsecsElapsed() / 1000;
+}
+
+void Tracer::recordSpan(const char* category, const QString& name,
+                        qint64 startUs, qint64 durationUs, const QJsonObject& args)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    ThreadBuffer& buffer = localBuffer();
+    QMutexLocker locker(&buffer.mutex);
+    buffer.events.append({category, name, startUs, durationUs, args});
+}
+
+void Tracer::recordQueueWait(const QString& taskName, qint64 queuedAtUs)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    recordSpan("queue", QString("Queued: %1").arg(taskName), queuedAtUs, nowUs() - queuedAtUs);
+}
+
+Result<void, QString> Tracer::writeChromeTrace(const QString& filePath)
+{
+    TraceRegistry& reg = registry();
+    qint64 pid = QCoreApplication::applicationPid();
+
+    QList<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        QMutexLocker locker(&reg.mutex);
+        buffers = reg.buffers;
+    }
+
+    QJsonArray events;
+    for (const auto& buffer : buffers) {
+        QMutexLocker locker(&buffer->mutex);
+
+        // Thread name metadata so Perfetto labels each track
+        QJsonObject meta;
+        meta["name"] = "thread_name";
+        meta["ph"] = "M";
+        meta["pid"] = pid;
+        meta["tid"] = buffer->tid;
+        meta["args"] = QJsonObject{{"name", buffer->threadName}};
+        events.append(meta);
+
+        for (const TraceEvent& event : buffer->events) {
+            QJsonObject obj;
+            obj["name"] = event.name;
+            obj["cat"] = QString::fromLatin1(event.category);
+            obj["ph"] = "X";
+            obj["ts"] = event.startUs;
+            obj["dur"] = event.durationUs;
+            obj["pid"] = pid;
+            obj["tid"] = buffer->tid;
+            if (!event.args.isEmpty()) {
+                obj["args"] = event.args;
+            }
+            events.append(obj);
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return Result<void, QString>::err(
+            QString("Failed to open trace file: %1").arg(filePath));
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return Result<void, QString>::ok();
+}
+
+void Tracer::clear()
+{
+    TraceRegistry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        buffer->events.clear();
+    }
+}
+
+TraceSpan::TraceSpan(const char* category, const QString& name)
+    : m_active(Tracer::isEnabled())
+    , m_category(category)
+    , m_startUs(0)
+{
+    if (m_active) {
+        m_name = name;
+        m_startUs = Tracer::nowUs();
+    }
+}
+
+TraceSpan::~TraceSpan()
+{
+    finish();
+}
+
+void TraceSpan::finish()
+{
+    if (m_active) {
+        m_active = false;
+        Tracer::recordSpan(m_category, m_name, m_startUs, Tracer::nowUs() - m_startUs, m_args);
+    }
+}
+
+void TraceSpan::setArg(const QString& key, const QVariant& value)
+{
+    if (m_active) {
+        m_args.insert(key, QJsonValue::fromVariant(value));
+    }
+}
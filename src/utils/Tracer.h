@@ -0,0 +1,82 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QVariant>
+#include "core/types/Result.h"
+
+/**
+ * @brief Span-based operation tracing with Chrome trace-event export
+ *
+ * Disabled by default; when disabled a span costs one atomic load. Each
+ * thread records into its own buffer, so enabled tracing does not
+ * serialize worker threads. The collected spans are written as Chrome
+ * trace-event JSON, which loads directly into Perfetto or chrome://tracing.
+ */
+class Tracer {
+public:
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * @brief Monotonic timestamp in microseconds used for all events
+     */
+    static qint64 nowUs();
+
+    /**
+     * @brief Record a finished span
+     */
+    static void recordSpan(const char* category, const QString& name,
+                           qint64 startUs, qint64 durationUs,
+                           const QJsonObject& args = QJsonObject());
+
+    /**
+     * @brief Record the time a task spent queued before a worker picked it up
+     * @param queuedAtUs nowUs() captured when the task was submitted
+     */
+    static void recordQueueWait(const QString& taskName, qint64 queuedAtUs);
+
+    /**
+     * @brief Write every recorded event as Chrome trace-event JSON
+     */
+    static Result<void, QString> writeChromeTrace(const QString& filePath);
+
+    /**
+     * @brief Discard all recorded events
+     */
+    static void clear();
+};
+
+/**
+ * @brief RAII span: records from construction until destruction
+ *
+ * Usage:
+ *   TraceSpan span("git", "git add");
+ *   span.setArg("files", count);
+ *   span.finish();  // optional, otherwise ends with the scope
+ */
+class TraceSpan {
+public:
+    TraceSpan(const char* category, const QString& name);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void setArg(const QString& key, const QVariant& value);
+
+    /**
+     * @brief End the span before the object goes out of scope
+     */
+    void finish();
+
+private:
+    bool m_active;
+    const char* m_category;
+    QString m_name;
+    qint64 m_startUs;
+    QJsonObject m_args;
+};
+
+#endif // TRACER_H
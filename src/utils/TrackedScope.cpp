@@ -0,0 +1,125 @@
+#include "TrackedScope.h"
+#include <QRegularExpression>
+
+TrackedScope::TrackedScope()
+    : m_caseSensitivity(PatternMatcher::defaultCaseSensitivity())
+    , m_patternCount(0)
+{
+}
+
+TrackedScope::TrackedScope(const QStringList& trackedPaths, Qt::CaseSensitivity caseSensitivity)
+    : m_caseSensitivity(caseSensitivity)
+    , m_patternCount(0)
+{
+    static const QRegularExpression wildcardChars(R"([*?\[\\])");
+    QStringList anchoredGlobs;
+
+    for (const QString& rawPath : trackedPaths) {
+        QString path = rawPath.trimmed();
+        if (path.isEmpty() || path.startsWith('#')) {
+            continue;
+        }
+        while (path.startsWith('/')) {
+            path = path.mid(1);
+        }
+
+        QString stripped = path;
+        while (stripped.endsWith('/')) {
+            stripped.chop(1);
+        }
+        if (stripped.isEmpty()) {
+            continue;
+        }
+        ++m_patternCount;
+
+        if (!stripped.contains(wildcardChars)) {
+            m_literalPaths << stripped;
+            m_literals.insert(fold(stripped));
+            continue;
+        }
+
+        // A leading '/' anchors the glob to the root in gitignore syntax
+        m_globs << path;
+        anchoredGlobs << QStringLiteral("/") + path;
+
+        GlobPrefix prefix;
+        const QStringList components = fold(stripped).split('/', Qt::SkipEmptyParts);
+        for (const QString& component : components) {
+            if (component.contains(wildcardChars)) {
+                break;
+            }
+            prefix.fixedComponents << component;
+        }
+        prefix.componentCount = stripped.contains("**") ? -1 : components.size();
+        m_globPrefixes.append(prefix);
+    }
+
+    m_globMatcher.compile(anchoredGlobs, caseSensitivity);
+}
+
+QString TrackedScope::fold(const QString& path) const
+{
+    return m_caseSensitivity == Qt::CaseInsensitive ? path.toCaseFolded() : path;
+}
+
+bool TrackedScope::matchesEntry(const QString& relativePath, bool isDirectory) const
+{
+    if (m_patternCount == 0) {
+        return true;
+    }
+    return m_literals.contains(fold(relativePath))
+        || m_globMatcher.matches(relativePath, isDirectory);
+}
+
+bool TrackedScope::isTracked(const QString& relativePath, bool isDirectory) const
+{
+    if (m_patternCount == 0) {
+        return true;
+    }
+
+    int separator = relativePath.indexOf('/');
+    while (separator >= 0) {
+        if (matchesEntry(relativePath.left(separator), true)) {
+            return true;
+        }
+        separator = relativePath.indexOf('/', separator + 1);
+    }
+    return matchesEntry(relativePath, isDirectory);
+}
+
+bool TrackedScope::mayContainTracked(const QString& relativeDir) const
+{
+    if (m_patternCount == 0) {
+        return true;
+    }
+
+    QString dir = fold(relativeDir);
+    QString dirPrefix = dir + '/';
+    for (const QString& literal : m_literals) {
+        if (literal.startsWith(dirPrefix)) {
+            return true;
+        }
+    }
+
+    const QStringList components = dir.split('/', Qt::SkipEmptyParts);
+    for (const GlobPrefix& glob : m_globPrefixes) {
+        // "*.ini" has one component, so nothing below the root can match it
+        if (glob.componentCount != -1 && glob.componentCount <= components.size()) {
+            continue;
+        }
+
+        bool prefixMatches = true;
+        int fixed = qMin(components.size(), glob.fixedComponents.size());
+        for (int i = 0; i < fixed; ++i) {
+            if (components[i] != glob.fixedComponents[i]) {
+                prefixMatches = false;
+                break;
+            }
+        }
+        if (prefixMatches) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,70 @@
+#ifndef TRACKEDSCOPE_H
+#define TRACKEDSCOPE_H
+
+#include <QString>
+#include <QStringList>
+#include <QSet>
+#include <QVector>
+#include "PatternMatcher.h"
+
+/**
+ * @brief The part of a game directory selected by a preset's trackedPaths
+ *
+ * Tracked paths are anchored at the project root: "Data/" selects the Data
+ * subtree and "*.ini" selects ini files in the root folder only. A directory
+ * that is neither selected nor on the way to a selected path is never
+ * visited. An empty scope selects everything.
+ */
+class TrackedScope {
+public:
+    TrackedScope();
+    explicit TrackedScope(const QStringList& trackedPaths,
+                          Qt::CaseSensitivity caseSensitivity = PatternMatcher::defaultCaseSensitivity());
+
+    bool isEmpty() const { return m_patternCount == 0; }
+
+    /**
+     * @brief Whether the entry itself is selected by a tracked path
+     *
+     * Ancestors are not checked; a selected directory selects its subtree.
+     */
+    bool matchesEntry(const QString& relativePath, bool isDirectory) const;
+
+    /**
+     * @brief Whether the path or one of its parent directories is selected
+     */
+    bool isTracked(const QString& relativePath, bool isDirectory) const;
+
+    /**
+     * @brief Whether an unselected directory may contain selected entries
+     */
+    bool mayContainTracked(const QString& relativeDir) const;
+
+    /**
+     * @brief Tracked paths without wildcards, as written in the preset
+     */
+    QStringList literalPaths() const { return m_literalPaths; }
+
+    /**
+     * @brief Tracked paths with wildcards, as written in the preset
+     */
+    QStringList globs() const { return m_globs; }
+
+private:
+    struct GlobPrefix {
+        QStringList fixedComponents;  // Components before the first wildcard
+        int componentCount;           // -1 if the glob contains "**"
+    };
+
+    QSet<QString> m_literals;         // Case-folded if insensitive
+    QStringList m_literalPaths;
+    QStringList m_globs;
+    QVector<GlobPrefix> m_globPrefixes;
+    PatternMatcher m_globMatcher;
+    Qt::CaseSensitivity m_caseSensitivity;
+    int m_patternCount;
+
+    QString fold(const QString& path) const;
+};
+
+#endif // TRACKEDSCOPE_H
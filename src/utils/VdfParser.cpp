@@ -0,0 +1,167 @@
+#include "VdfParser.h"
+#include <QFile>
+
+namespace {
+
+enum class TokenType {
+    String,
+    OpenBrace,
+    CloseBrace,
+    End
+};
+
+struct Token {
+    TokenType type;
+    QString text;
+};
+
+class Tokenizer {
+public:
+    explicit Tokenizer(const QByteArray& data)
+        : m_data(data)
+        , m_pos(0)
+    {}
+
+    Token next()
+    {
+        skipWhitespaceAndComments();
+        if (m_pos >= m_data.size()) {
+            return {TokenType::End, QString()};
+        }
+
+        char c = m_data[m_pos];
+        if (c == '{') {
+            ++m_pos;
+            return {TokenType::OpenBrace, QString()};
+        }
+        if (c == '}') {
+            ++m_pos;
+            return {TokenType::CloseBrace, QString()};
+        }
+        if (c == '"') {
+            return {TokenType::String, readQuoted()};
+        }
+        return {TokenType::String, readUnquoted()};
+    }
+
+private:
+    const QByteArray& m_data;
+    int m_pos;
+
+    void skipWhitespaceAndComments()
+    {
+        while (m_pos < m_data.size()) {
+            char c = m_data[m_pos];
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                ++m_pos;
+            } else if (c == '/' && m_pos + 1 < m_data.size() && m_data[m_pos + 1] == '/') {
+                while (m_pos < m_data.size() && m_data[m_pos] != '\n') {
+                    ++m_pos;
+                }
+            } else {
+                break;
+            }
+        }
+    }
+
+    QString readQuoted()
+    {
+        QByteArray out;
+        ++m_pos;  // Opening quote
+        while (m_pos < m_data.size() && m_data[m_pos] != '"') {
+            char c = m_data[m_pos++];
+            if (c == '\\' && m_pos < m_data.size()) {
+                char escaped = m_data[m_pos++];
+                switch (escaped) {
+                    case 'n': out.append('\n'); break;
+                    case 't': out.append('\t'); break;
+                    default:  out.append(escaped); break;
+                }
+            } else {
+                out.append(c);
+            }
+        }
+        ++m_pos;  // Closing quote
+        return QString::fromUtf8(out);
+    }
+
+    QString readUnquoted()
+    {
+        int start = m_pos;
+        while (m_pos < m_data.size()) {
+            char c = m_data[m_pos];
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '{' || c == '}' || c == '"') {
+                break;
+            }
+            ++m_pos;
+        }
+        return QString::fromUtf8(m_data.constData() + start, m_pos - start);
+    }
+};
+
+bool isConditional(const QString& token)
+{
+    // Platform conditionals such as [$WIN32] trail a key/value pair
+    return token.startsWith('[') && token.endsWith(']');
+}
+
+Result<QVariantMap, QString> parseSection(Tokenizer& tokenizer, bool topLevel)
+{
+    QVariantMap section;
+    Token key = tokenizer.next();
+
+    while (true) {
+        if (key.type == TokenType::End) {
+            if (topLevel) {
+                return Result<QVariantMap, QString>::ok(section);
+            }
+            return Result<QVariantMap, QString>::err("Unexpected end of VDF data");
+        }
+        if (key.type == TokenType::CloseBrace) {
+            if (topLevel) {
+                return Result<QVariantMap, QString>::err("Unbalanced '}' in VDF data");
+            }
+            return Result<QVariantMap, QString>::ok(section);
+        }
+        if (key.type != TokenType::String) {
+            return Result<QVariantMap, QString>::err("Expected key in VDF data");
+        }
+
+        Token value = tokenizer.next();
+        if (value.type == TokenType::OpenBrace) {
+            auto child = parseSection(tokenizer, false);
+            if (child.isErr()) {
+                return child;
+            }
+            section.insert(key.text, child.value());
+        } else if (value.type == TokenType::String) {
+            section.insert(key.text, value.text);
+        } else {
+            return Result<QVariantMap, QString>::err(
+                QString("Missing value for key '%1'").arg(key.text));
+        }
+
+        key = tokenizer.next();
+        if (key.type == TokenType::String && isConditional(key.text)) {
+            key = tokenizer.next();
+        }
+    }
+}
+
+} // namespace
+
+Result<QVariantMap, QString> VdfParser::parse(const QByteArray& data)
+{
+    Tokenizer tokenizer(data);
+    return parseSection(tokenizer, true);
+}
+
+Result<QVariantMap, QString> VdfParser::parseFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Result<QVariantMap, QString>::err(
+            QString("Failed to open VDF file: %1").arg(filePath));
+    }
+    return parse(file.readAll());
+}
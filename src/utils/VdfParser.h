@@ -0,0 +1,28 @@
+#ifndef VDFPARSER_H
+#define VDFPARSER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVariantMap>
+#include "core/types/Result.h"
+
+/**
+ * @brief Parser for Valve's KeyValues (VDF) text format
+ *
+ * Used to read Steam's libraryfolders.vdf and appmanifest_*.acf files.
+ * Values become QString entries and sections become nested QVariantMaps.
+ */
+class VdfParser {
+public:
+    /**
+     * @brief Parse VDF text into a nested map
+     */
+    static Result<QVariantMap, QString> parse(const QByteArray& data);
+
+    /**
+     * @brief Read and parse a VDF file from disk
+     */
+    static Result<QVariantMap, QString> parseFile(const QString& filePath);
+};
+
+#endif // VDFPARSER_H
@@ -0,0 +1,86 @@
+#ifndef TESTHELPERS_H
+#define TESTHELPERS_H
+
+#include <QtTest/QtTest>
+#include <QFuture>
+#include <QProcess>
+#include <QTemporaryDir>
+
+/**
+ * @brief Base for tests that work in a fresh temporary directory
+ *
+ * Call resetDirectory() from init(). Anything holding files open in the
+ * old directory (stores, indexes) must be released before it.
+ */
+class TemporaryDirectoryTest : public QObject
+{
+protected:
+    QScopedPointer<QTemporaryDir> m_dir;
+
+    void resetDirectory()
+    {
+        m_dir.reset(new QTemporaryDir);
+        QVERIFY(m_dir->isValid());
+    }
+
+    QString filePath(const QString& relativePath) const
+    {
+        return m_dir->filePath(relativePath);
+    }
+
+    /**
+     * @brief Write a file, creating its parent directories
+     * @param modified Set explicitly when valid, so tests don't depend on
+     *                 the file system's timestamp resolution
+     */
+    static void writeFile(const QString& path, const QByteArray& content,
+                          const QDateTime& modified = QDateTime())
+    {
+        QVERIFY(QDir().mkpath(QFileInfo(path).path()));
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        QCOMPARE(file.write(content), content.size());
+        QVERIFY(file.flush());
+        if (modified.isValid()) {
+            QVERIFY(file.setFileTime(modified, QFileDevice::FileModificationTime));
+        }
+    }
+
+    template<typename T>
+    static T await(QFuture<T> future)
+    {
+        future.waitForFinished();
+        return future.takeResult();
+    }
+
+    static QByteArray readFile(const QString& path)
+    {
+        QFile file(path);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    /**
+     * @brief Run git in the temporary directory, with a fixed identity
+     * @return Whether git exited with status 0
+     */
+    bool git(const QStringList& arguments, QByteArray* output = nullptr) const
+    {
+        QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+        environment.insert("GIT_AUTHOR_NAME", "test");
+        environment.insert("GIT_AUTHOR_EMAIL", "test@example.com");
+        environment.insert("GIT_COMMITTER_NAME", "test");
+        environment.insert("GIT_COMMITTER_EMAIL", "test@example.com");
+
+        QProcess process;
+        process.setWorkingDirectory(m_dir->path());
+        process.setProcessEnvironment(environment);
+        process.start("git", arguments);
+        bool finished = process.waitForFinished();
+        if (output) {
+            *output = process.readAllStandardOutput();
+        }
+        return finished && process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+    }
+};
+
+#endif // TESTHELPERS_H
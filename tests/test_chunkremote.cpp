@@ -0,0 +1,136 @@
+#include <QtTest/QtTest>
+#include <QCryptographicHash>
+#include "TestHelpers.h"
+#include "../src/core/ChunkRemote.h"
+#include "../src/core/LocalChunkRemote.h"
+
+class TestChunkRemote : public TemporaryDirectoryTest
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        m_remote.reset();
+        resetDirectory();
+        m_remote.reset(new LocalChunkRemote(filePath("remote")));
+        QVERIFY(m_remote->open().isOk());
+        m_target = filePath("restore");
+        m_outside = filePath("outside");
+        QVERIFY(QDir().mkpath(m_outside));
+        m_blobCount = 0;
+        m_contents.clear();
+    }
+
+    void testDownload()
+    {
+        RemoteSnapshot snapshot;
+        snapshot.commit = "1111111111111111111111111111111111111111";
+        snapshot.entries = {
+            file("saves/slot1.sav", "progress"),
+            link("saves/latest", "slot1.sav")
+        };
+        store(snapshot);
+
+        QVERIFY(m_remote->download(snapshot.commit, m_target).isOk());
+        QCOMPARE(readFile(m_target + "/saves/slot1.sav"), QByteArray("progress"));
+        QCOMPARE(QFileInfo(m_target + "/saves/latest").symLinkTarget(),
+                 QFileInfo(m_target + "/saves/slot1.sav").absoluteFilePath());
+    }
+
+    void testFileThroughDownloadedLink()
+    {
+        // The link would come first in the manifest and the file be written through it
+        RemoteSnapshot snapshot;
+        snapshot.commit = "2222222222222222222222222222222222222222";
+        snapshot.entries = {
+            link("a", m_outside),
+            file("a/.bashrc", "owned")
+        };
+        store(snapshot);
+
+        QVERIFY(m_remote->download(snapshot.commit, m_target).isErr());
+        QVERIFY(!QFileInfo::exists(m_outside + "/.bashrc"));
+    }
+
+    void testLinkThroughDownloadedLink()
+    {
+        RemoteSnapshot snapshot;
+        snapshot.commit = "3333333333333333333333333333333333333333";
+        snapshot.entries = {
+            link("a", m_outside),
+            link("a/b", "/etc/passwd")
+        };
+        store(snapshot);
+
+        QVERIFY(m_remote->download(snapshot.commit, m_target).isErr());
+        QVERIFY(!QFileInfo(m_outside + "/b").isSymLink());
+    }
+
+    void testFileThroughExistingLink()
+    {
+        QVERIFY(QDir().mkpath(m_target));
+        QVERIFY(QFile::link(m_outside, m_target + "/mods"));
+
+        RemoteSnapshot snapshot;
+        snapshot.commit = "4444444444444444444444444444444444444444";
+        snapshot.entries = {file("mods/sub/plugin.dll", "payload")};
+        store(snapshot);
+
+        QVERIFY(m_remote->download(snapshot.commit, m_target).isErr());
+        QVERIFY(!QFileInfo::exists(m_outside + "/sub"));
+    }
+
+    void testPathsAboveTarget()
+    {
+        RemoteSnapshot snapshot;
+        snapshot.commit = "5555555555555555555555555555555555555555";
+        snapshot.entries = {file("saves/../../escape", "owned")};
+        store(snapshot);
+
+        QVERIFY(m_remote->download(snapshot.commit, m_target).isErr());
+        QVERIFY(!QFileInfo::exists(filePath("escape")));
+    }
+
+private:
+    QScopedPointer<LocalChunkRemote> m_remote;
+    QString m_target;
+    QString m_outside;
+    int m_blobCount = 0;
+    QHash<QString, QByteArray> m_contents;   // Blob ID -> content, until store()
+
+    RemoteSnapshot::Entry file(const QString& path, const QByteArray& content)
+    {
+        return entry(path, "100644", content);
+    }
+
+    RemoteSnapshot::Entry link(const QString& path, const QString& target)
+    {
+        return entry(path, "120000", target.toUtf8());
+    }
+
+    RemoteSnapshot::Entry entry(const QString& path, const QString& mode, const QByteArray& content)
+    {
+        // Any unique name will do; the remote never checks it against the content
+        QString blobId = QString::number(++m_blobCount).rightJustified(40, '0');
+        m_contents.insert(blobId, content);
+        return {path, mode, blobId};
+    }
+
+    void store(const RemoteSnapshot& snapshot)
+    {
+        for (auto it = m_contents.cbegin(); it != m_contents.cend(); ++it) {
+            ObjectId chunk = ObjectId::fromBytes(QCryptographicHash::hash(it.value(), QCryptographicHash::Sha1));
+            QVERIFY(m_remote->put(chunk, it.value()).isOk());
+
+            ChunkRecipe recipe;
+            recipe.size = it.value().size();
+            recipe.chunks = {chunk};
+            QVERIFY(m_remote->put(ChunkRecipe::recipeKey(it.key()), recipe.encode()).isOk());
+        }
+        QVERIFY(m_remote->put(RemoteSnapshot::snapshotKey(snapshot.commit), snapshot.encode()).isOk());
+    }
+};
+
+QTEST_MAIN(TestChunkRemote)
+#include "test_chunkremote.moc"
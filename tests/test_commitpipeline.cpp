@@ -0,0 +1,102 @@
+#include <QtTest/QtTest>
+#include <QCryptographicHash>
+#include "TestHelpers.h"
+#include "../src/core/CommitPipeline.h"
+
+class TestCommitPipeline : public TemporaryDirectoryTest
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        resetDirectory();
+        QVERIFY(git({"init", "--quiet"}));
+        writeFile(filePath("saves/slot1.sav"), "first save");
+        writeFile(filePath("saves/slot2.sav"), "second save");
+    }
+
+    void testWritesLooseObjects()
+    {
+        auto result = CommitPipeline(m_dir->path(), ExecutionClass::Foreground).run();
+        QVERIFY(result.isOk());
+        QCOMPARE(result.value().write.items, qint64(2));
+        QCOMPARE(result.value().existingObjects, qint64(0));
+
+        // git reads them back as the blobs it would have written
+        QByteArray content;
+        QVERIFY(git({"cat-file", "-p", blobId("first save")}, &content));
+        QCOMPARE(content, QByteArray("first save"));
+    }
+
+    void testSkipsStoredObjects()
+    {
+        QVERIFY(git({"add", "saves/slot1.sav"}));
+        QVERIFY(git({"commit", "--quiet", "-m", "first"}));
+
+        auto result = CommitPipeline(m_dir->path(), ExecutionClass::Foreground).run();
+        QVERIFY(result.isOk());
+        QCOMPARE(result.value().existingObjects, qint64(1));
+        QCOMPARE(result.value().write.items, qint64(1));
+    }
+
+    void testSkipsPackedObjects()
+    {
+        QVERIFY(git({"add", "saves"}));
+        QVERIFY(git({"commit", "--quiet", "-m", "first"}));
+        QVERIFY(git({"repack", "-a", "-d", "--quiet"}));
+        QVERIFY(git({"prune-packed"}));
+        QVERIFY(!QFileInfo::exists(filePath(".git/objects/" + looseName("first save"))));
+
+        auto result = CommitPipeline(m_dir->path(), ExecutionClass::Foreground).run();
+        QVERIFY(result.isOk());
+        QCOMPARE(result.value().existingObjects, qint64(2));
+        QCOMPARE(result.value().write.items, qint64(0));
+        QVERIFY(!QFileInfo::exists(filePath(".git/objects/" + looseName("first save"))));
+    }
+
+    void testSkipsIgnoredFiles()
+    {
+        writeFile(filePath("saves/.gitignore"), "*.bak\n");
+        writeFile(filePath("saves/slot1.bak"), "backup");
+        writeFile(filePath(".git/info/exclude"), "slot2.sav\n");
+
+        auto result = CommitPipeline(m_dir->path(), ExecutionClass::Foreground).run();
+        QVERIFY(result.isOk());
+        QCOMPARE(result.value().write.items, qint64(2));
+        QVERIFY(QFileInfo::exists(filePath(".git/objects/" + looseName("first save"))));
+        QVERIFY(!QFileInfo::exists(filePath(".git/objects/" + looseName("second save"))));
+        QVERIFY(!QFileInfo::exists(filePath(".git/objects/" + looseName("backup"))));
+    }
+
+    void testSkipsConvertedFiles()
+    {
+        QVERIFY(git({"config", "core.autocrlf", "true"}));
+        writeFile(filePath(".git/info/attributes"), "*.txt text\n");
+        writeFile(filePath("saves/notes.txt"), "notes");
+        writeFile(filePath("saves/slot3.sav"), "line\r\nline");
+
+        auto result = CommitPipeline(m_dir->path(), ExecutionClass::Foreground).run();
+        QVERIFY(result.isOk());
+        QCOMPARE(result.value().write.items, qint64(2));
+        QVERIFY(QFileInfo::exists(filePath(".git/objects/" + looseName("first save"))));
+        QVERIFY(!QFileInfo::exists(filePath(".git/objects/" + looseName("notes"))));
+        QVERIFY(!QFileInfo::exists(filePath(".git/objects/" + looseName("line\r\nline"))));
+    }
+
+private:
+    static QString blobId(const QByteArray& content)
+    {
+        QByteArray object = "blob " + QByteArray::number(content.size()) + '\0' + content;
+        return QString::fromLatin1(QCryptographicHash::hash(object, QCryptographicHash::Sha1).toHex());
+    }
+
+    static QString looseName(const QByteArray& content)
+    {
+        QString id = blobId(content);
+        return id.left(2) + '/' + id.mid(2);
+    }
+};
+
+QTEST_MAIN(TestCommitPipeline)
+#include "test_commitpipeline.moc"
@@ -0,0 +1,290 @@
+#include <QtTest/QtTest>
+#include <QCryptographicHash>
+#include <QRandomGenerator>
+#include "TestHelpers.h"
+#include "../src/core/ChunkStore.h"
+#include "../src/core/DeltaCodec.h"
+#include "../src/core/DeltaFile.h"
+
+namespace {
+
+QByteArray randomBytes(qsizetype size, quint32 seed)
+{
+    QRandomGenerator generator(seed);
+    QByteArray data(size, Qt::Uninitialized);
+    for (qsizetype i = 0; i < size; ++i) {
+        data[i] = char(generator.bounded(256));
+    }
+    return data;
+}
+
+/**
+ * @brief A save with a few records rewritten, as a game does between saves
+ */
+QByteArray edited(QByteArray data, int version)
+{
+    for (int i = 0; i < 4; ++i) {
+        qsizetype offset = (qsizetype(version) * 7919 + i * 4099) % (data.size() - 8);
+        data.replace(offset, 8, QByteArray::number(version * 10 + i).rightJustified(8, '#'));
+    }
+    return data;
+}
+
+} // namespace
+
+class TestDeltaFile : public TemporaryDirectoryTest
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        // The store keeps its files open; release them before their directory
+        m_deltaFile.reset();
+        m_store.reset();
+        resetDirectory();
+        m_store.reset(new ChunkStore(filePath("deltas")));
+        QVERIFY(m_store->open().isOk());
+        m_deltaFile.reset(new DeltaFile(*m_store));
+        QVERIFY(m_deltaFile->load().isOk());
+    }
+
+    void testCodecRoundTrip_data()
+    {
+        QTest::addColumn<QByteArray>("base");
+        QTest::addColumn<QByteArray>("target");
+
+        QByteArray save = randomBytes(64 * 1024, 1);
+        QTest::newRow("both empty") << QByteArray() << QByteArray();
+        QTest::newRow("empty base") << QByteArray() << save;
+        QTest::newRow("empty target") << save << QByteArray();
+        QTest::newRow("target under one block") << save << save.left(31);
+        QTest::newRow("base under one block") << save.left(31) << save;
+        QTest::newRow("identical") << save << save;
+        QTest::newRow("edited") << save << edited(save, 3);
+        QTest::newRow("truncated") << save << save.left(40000);
+        QTest::newRow("appended") << save << save + randomBytes(5000, 2);
+        QTest::newRow("unrelated") << save << randomBytes(64 * 1024, 3);
+    }
+
+    void testCodecRoundTrip()
+    {
+        QFETCH(QByteArray, base);
+        QFETCH(QByteArray, target);
+
+        QByteArray delta = DeltaCodec::encode(base, target);
+        auto applied = DeltaCodec::apply(base, delta);
+        QVERIFY2(applied.isOk(), qPrintable(applied.isErr() ? applied.error() : QString()));
+        QCOMPARE(applied.value(), target);
+    }
+
+    void testCodecSmallEditsEncodeSmall()
+    {
+        QByteArray save = randomBytes(64 * 1024, 4);
+        QVERIFY(DeltaCodec::encode(save, edited(save, 1)).size() < 1024);
+    }
+
+    void testCodecRejectsCorruptDeltas()
+    {
+        QByteArray base = randomBytes(4096, 5);
+        QByteArray target = edited(base, 2);
+        QByteArray delta = DeltaCodec::encode(base, target);
+
+        QVERIFY(DeltaCodec::apply(base.left(4000), delta).isErr());  // Another base
+        QVERIFY(DeltaCodec::apply(base, QByteArray()).isErr());
+        QVERIFY(DeltaCodec::apply(base, delta.left(delta.size() - 1)).isErr());
+        QVERIFY(DeltaCodec::apply(base, delta + char(0x01)).isErr());
+        QVERIFY(DeltaCodec::apply(base, delta + char(0x07)).isErr());
+
+        // Copy running past the base: sizes 4096 -> 16, copy 4090 + 16
+        QByteArray outside = QByteArray::fromHex("8020" "10" "01" "fa1f" "10");
+        QVERIFY(DeltaCodec::apply(base, outside).isErr());
+
+        // Claims an enormous target; fails without reserving it
+        QByteArray huge = QByteArray::fromHex("8020" "ffffffffffffffff7f" "0004") + "abcd";
+        QVERIFY(DeltaCodec::apply(base, huge).isErr());
+    }
+
+    void testCleanSmudgeRoundTrip()
+    {
+        QByteArray save = randomBytes(32 * 1024, 6);
+        auto manifest = m_deltaFile->clean("saves/slot1.sav", save);
+        QVERIFY(manifest.isOk());
+        QVERIFY(DeltaFile::isManifest(manifest.value()));
+
+        auto smudged = m_deltaFile->smudge(manifest.value());
+        QVERIFY(smudged.isOk());
+        QCOMPARE(smudged.value(), save);
+
+        auto empty = m_deltaFile->clean("saves/empty.sav", QByteArray());
+        QVERIFY(empty.isOk());
+        QCOMPARE(m_deltaFile->smudge(empty.value()).value(), QByteArray());
+    }
+
+    void testManifestDependsOnlyOnContent()
+    {
+        QByteArray first = randomBytes(32 * 1024, 7);
+        QByteArray second = edited(first, 1);
+
+        QByteArray firstManifest = m_deltaFile->clean("a.sav", first).value();
+        QByteArray secondManifest = m_deltaFile->clean("a.sav", second).value();
+        int chunks = m_store->chunkCount();
+
+        // Re-cleaning (git status after a touch), reverting, or the same
+        // bytes under another path: same manifests, nothing stored
+        QCOMPARE(m_deltaFile->clean("a.sav", second).value(), secondManifest);
+        QCOMPARE(m_deltaFile->clean("a.sav", first).value(), firstManifest);
+        QCOMPARE(m_deltaFile->clean("b.sav", second).value(), secondManifest);
+        QCOMPARE(m_store->chunkCount(), chunks);
+
+        // A fresh store produces the same manifest for the same bytes
+        ChunkStore otherStore(filePath("other/deltas"));
+        QVERIFY(otherStore.open().isOk());
+        DeltaFile other(otherStore);
+        QVERIFY(other.load().isOk());
+        QCOMPARE(other.clean("c.sav", second).value(), secondManifest);
+    }
+
+    void testIndexSurvivesReload()
+    {
+        QByteArray save = randomBytes(16 * 1024, 8);
+        QByteArray manifest = m_deltaFile->clean("a.sav", save).value();
+
+        DeltaFile reloaded(*m_store);
+        QVERIFY(reloaded.load().isOk());
+        QCOMPARE(reloaded.smudge(manifest).value(), save);
+    }
+
+    void testIndexIsAppended()
+    {
+        QByteArray save = randomBytes(16 * 1024, 12);
+        QVERIFY(m_deltaFile->clean("a.sav", save).isOk());
+        QByteArray before = readFile(headsPath());
+
+        QVERIFY(m_deltaFile->clean("a.sav", edited(save, 1)).isOk());
+        QByteArray after = readFile(headsPath());
+        QVERIFY(after.startsWith(before));
+        QVERIFY(after.size() - before.size() < 256);
+    }
+
+    void testCorruptIndexIsKept()
+    {
+        QByteArray save = randomBytes(16 * 1024, 13);
+        QVERIFY(m_deltaFile->clean("a.sav", save).isOk());
+        writeFile(headsPath(), "not an index");
+
+        DeltaFile reloaded(*m_store);
+        QVERIFY(reloaded.load().isErr());
+        QVERIFY(reloaded.clean("b.sav", randomBytes(1024, 14)).isErr());
+        QCOMPARE(readFile(headsPath()), QByteArray("not an index"));
+
+        // Written by a newer version: also an error, also untouched
+        QByteArray newer = QByteArray::fromHex("5647444800000063");
+        writeFile(headsPath(), newer);
+        QVERIFY(reloaded.load().isErr());
+        QCOMPARE(readFile(headsPath()), newer);
+    }
+
+    void testDeletedIndexIsRebuilt()
+    {
+        QByteArray first = randomBytes(32 * 1024, 15);
+        QByteArray second = edited(first, 1);
+        QByteArray firstManifest = m_deltaFile->clean("a.sav", first).value();
+        QByteArray secondManifest = m_deltaFile->clean("a.sav", second).value();
+        QVERIFY(QFile::remove(headsPath()));
+
+        DeltaFile rebuilt(*m_store);
+        QVERIFY(rebuilt.load().isOk());
+        QCOMPARE(rebuilt.smudge(firstManifest).value(), first);
+        QCOMPARE(rebuilt.smudge(secondManifest).value(), second);
+        QVERIFY(QFileInfo::exists(headsPath()));
+    }
+
+    void testTornEntryIsDropped()
+    {
+        QByteArray first = randomBytes(16 * 1024, 16);
+        QByteArray second = edited(first, 1);
+        QByteArray firstManifest = m_deltaFile->clean("a.sav", first).value();
+        qint64 firstSize = QFileInfo(headsPath()).size();
+        QVERIFY(m_deltaFile->clean("a.sav", second).isOk());
+        QVERIFY(QFile::resize(headsPath(), QFileInfo(headsPath()).size() - 5));
+
+        DeltaFile reloaded(*m_store);
+        QVERIFY(reloaded.load().isOk());
+        QCOMPARE(QFileInfo(headsPath()).size(), firstSize);
+        QCOMPARE(reloaded.smudge(firstManifest).value(), first);
+
+        QByteArray secondManifest = reloaded.clean("a.sav", second).value();
+        QCOMPARE(reloaded.smudge(secondManifest).value(), second);
+    }
+
+    void testChainCapRollover()
+    {
+        // Enough versions to pass the cap twice; every one must restore
+        QByteArray save = randomBytes(32 * 1024, 9);
+        QList<QByteArray> versions;
+        QList<QByteArray> manifests;
+        for (int version = 0; version < 2 * DeltaFile::MaxChainDepth + 3; ++version) {
+            save = edited(save, version + 1);
+            versions.append(save);
+            auto manifest = m_deltaFile->clean("world.sav", save);
+            QVERIFY(manifest.isOk());
+            manifests.append(manifest.value());
+        }
+
+        for (int i = 0; i < versions.size(); ++i) {
+            auto smudged = m_deltaFile->smudge(manifests[i]);
+            QVERIFY2(smudged.isOk(), qPrintable(QString("version %1").arg(i)));
+            QCOMPARE(smudged.value(), versions[i]);
+        }
+    }
+
+    void testSmudgeRejectsBadManifests()
+    {
+        QByteArray save = randomBytes(8 * 1024, 10);
+        QByteArray manifest = m_deltaFile->clean("a.sav", save).value();
+
+        QByteArray wrongSize = manifest;
+        wrongSize.replace("size " + QByteArray::number(save.size()), "size 1");
+        QVERIFY(m_deltaFile->smudge(wrongSize).isErr());
+
+        QByteArray unknown = manifest;
+        int contentStart = unknown.indexOf("content ") + 8;
+        unknown.replace(contentStart, 40, QByteArray(40, 'e'));
+        QVERIFY(m_deltaFile->smudge(unknown).isErr());
+
+        QByteArray noContent = manifest.left(manifest.indexOf("content "));
+        QVERIFY(m_deltaFile->smudge(noContent).isErr());
+
+        // Anything that isn't a manifest is an ordinary save
+        QCOMPARE(m_deltaFile->smudge(save).value(), save);
+    }
+
+    void testVersionOneManifests()
+    {
+        QByteArray save = randomBytes(8 * 1024, 11);
+        QByteArray record = QByteArray(1, 'F') + save;
+        auto put = m_store->put(record);
+        QVERIFY(put.isOk());
+        QByteArray content = QCryptographicHash::hash(save, QCryptographicHash::Sha1).toHex();
+
+        QByteArray manifest = "vgvc-delta 1\nsize " + QByteArray::number(save.size()) + "\ncontent "
+            + content + "\nrecord " + put.value().toHex().toLatin1() + '\n';
+        QCOMPARE(m_deltaFile->smudge(manifest).value(), save);
+
+        QByteArray noRecord = manifest.left(manifest.indexOf("record "));
+        QVERIFY(m_deltaFile->smudge(noRecord).isErr());
+    }
+
+private:
+    QScopedPointer<ChunkStore> m_store;
+    QScopedPointer<DeltaFile> m_deltaFile;
+
+    QString headsPath() const
+    {
+        return filePath("deltas/heads");
+    }
+};
+
+QTEST_MAIN(TestDeltaFile)
+#include "test_deltafile.moc"
@@ -0,0 +1,101 @@
+#include <QtTest/QtTest>
+#include "TestHelpers.h"
+#include "../src/utils/FileUtils.h"
+
+class TestFileUtils : public TemporaryDirectoryTest
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        resetDirectory();
+        m_source = filePath("save.dat");
+        m_destination = filePath("capture");
+        m_baseTime = QDateTime::currentDateTime().addSecs(-3600);
+        writeFile(m_source, "first save", m_baseTime);
+    }
+
+    void testCopyOfQuietFile()
+    {
+        auto result = FileUtils::copyStable(m_source, m_destination, 3, 1);
+        QVERIFY(result.isOk());
+        QCOMPARE(readFile(m_destination), QByteArray("first save"));
+    }
+
+    void testChangeDuringCopyIsRetried()
+    {
+        // The game saves while the first copy is taken; the second attempt is quiet
+        int attempts = 0;
+        auto copy = [this, &attempts](const QString& source, const QString& destination) {
+            if (++attempts == 1) {
+                auto result = FileUtils::cloneFile(source, destination);
+                writeFile(source, "second save, longer", m_baseTime.addSecs(10));
+                return result;
+            }
+            return FileUtils::cloneFile(source, destination);
+        };
+
+        auto result = FileUtils::copyStable(m_source, m_destination, 3, 1, copy);
+        QVERIFY(result.isOk());
+        QCOMPARE(attempts, 2);
+        QCOMPARE(readFile(m_destination), QByteArray("second save, longer"));
+    }
+
+    void testSameSizeRewriteIsDetected()
+    {
+        // Only the modification time tells this save apart
+        int attempts = 0;
+        auto copy = [this, &attempts](const QString& source, const QString& destination) {
+            auto result = FileUtils::cloneFile(source, destination);
+            if (++attempts == 1) {
+                writeFile(source, "first SAVE", m_baseTime.addSecs(10));
+            }
+            return result;
+        };
+
+        auto result = FileUtils::copyStable(m_source, m_destination, 3, 1, copy);
+        QVERIFY(result.isOk());
+        QCOMPARE(attempts, 2);
+        QCOMPARE(readFile(m_destination), QByteArray("first SAVE"));
+    }
+
+    void testFileThatNeverHoldsStill()
+    {
+        int attempts = 0;
+        auto copy = [this, &attempts](const QString& source, const QString& destination) {
+            auto result = FileUtils::cloneFile(source, destination);
+            ++attempts;
+            writeFile(source, QByteArray(attempts, 'x'), m_baseTime.addSecs(attempts));
+            return result;
+        };
+
+        QVERIFY(FileUtils::copyStable(m_source, m_destination, 3, 1, copy).isErr());
+        QCOMPARE(attempts, 3);
+    }
+
+    void testFailedCopiesAreRetried()
+    {
+        int attempts = 0;
+        auto copy = [&attempts](const QString& source, const QString& destination) {
+            if (++attempts < 3) {
+                return Result<bool, QString>::err("locked");
+            }
+            return FileUtils::cloneFile(source, destination);
+        };
+
+        QVERIFY(FileUtils::copyStable(m_source, m_destination, 3, 1, copy).isOk());
+        QCOMPARE(attempts, 3);
+
+        attempts = -10;
+        QVERIFY(FileUtils::copyStable(m_source, m_destination, 3, 1, copy).isErr());
+    }
+
+private:
+    QString m_source;
+    QString m_destination;
+    QDateTime m_baseTime;
+};
+
+QTEST_MAIN(TestFileUtils)
+#include "test_fileutils.moc"
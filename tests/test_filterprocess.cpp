@@ -0,0 +1,214 @@
+#include <QtTest/QtTest>
+#include <QBuffer>
+#include <QtEndian>
+#include "TestHelpers.h"
+#include "../src/cli/FilterProcess.h"
+#include "../src/core/RegionFile.h"
+
+namespace {
+
+constexpr int MaxPacketPayload = 65516;
+const QByteArray Flush = QByteArrayLiteral("0000");
+
+QByteArray packet(const QByteArray& payload)
+{
+    return QByteArray::number(payload.size() + 4, 16).rightJustified(4, '0') + payload;
+}
+
+QByteArray contentPackets(const QByteArray& content)
+{
+    QByteArray packets;
+    for (qsizetype offset = 0; offset < content.size(); offset += MaxPacketPayload) {
+        packets += packet(content.mid(offset, MaxPacketPayload));
+    }
+    return packets + Flush;
+}
+
+QByteArray handshake()
+{
+    return packet("git-filter-client\n") + packet("version=2\n") + Flush
+        + packet("capability=clean\n") + packet("capability=smudge\n") + packet("capability=delay\n")
+        + Flush;
+}
+
+QByteArray request(const QByteArray& command, const QByteArray& path, const QByteArray& content)
+{
+    return packet("command=" + command + '\n') + packet("pathname=" + path + '\n') + Flush
+        + contentPackets(content);
+}
+
+/**
+ * @brief Split pkt-line output into payloads; a flush becomes Flush
+ */
+QList<QByteArray> parsePackets(const QByteArray& output, bool* wellFormed)
+{
+    QList<QByteArray> packets;
+    *wellFormed = true;
+    qsizetype position = 0;
+    while (position < output.size()) {
+        bool ok = false;
+        int length = output.mid(position, 4).toInt(&ok, 16);
+        if (!ok || (length != 0 && length < 4) || length - 4 > MaxPacketPayload
+            || position + qMax(length, 4) > output.size()) {
+            *wellFormed = false;
+            return packets;
+        }
+        packets.append(length == 0 ? Flush : output.mid(position + 4, length - 4));
+        position += qMax(length, 4);
+    }
+    return packets;
+}
+
+/**
+ * @brief A region file with one chunk per slot, large enough to span packets
+ */
+QByteArray makeRegion(int chunkCount)
+{
+    constexpr qint64 SectorSize = 4096;
+    QByteArray data((2 + chunkCount) * SectorSize, '\0');
+    for (int slot = 0; slot < chunkCount; ++slot) {
+        qToBigEndian(quint32(((2 + slot) << 8) | 1), data.data() + 4 * slot);
+        for (qint64 i = 0; i < SectorSize; ++i) {
+            data[(2 + slot) * SectorSize + i] = char((slot * 7 + i) & 0xff);
+        }
+    }
+    return data;
+}
+
+} // namespace
+
+class TestFilterProcess : public TemporaryDirectoryTest
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        // The filter finds its store relative to the repository root
+        resetDirectory();
+        QVERIFY(QDir::setCurrent(m_dir->path()));
+    }
+
+    void cleanup()
+    {
+        QDir::setCurrent(QDir::tempPath());
+    }
+
+    void testHandshake()
+    {
+        bool wellFormed = false;
+        QList<QByteArray> packets = parsePackets(runFilter(handshake()), &wellFormed);
+        QVERIFY(wellFormed);
+
+        // Only the capabilities it implements, never delay
+        const QList<QByteArray> expected = {
+            "git-filter-server\n", "version=2\n", Flush,
+            "capability=clean\n", "capability=smudge\n", Flush
+        };
+        QCOMPARE(packets, expected);
+        QCOMPARE(m_exitCode, 0);
+    }
+
+    void testCleanAndSmudgeFraming()
+    {
+        QByteArray region = makeRegion(40);
+        QVERIFY(region.size() > 2 * MaxPacketPayload);
+
+        QByteArray manifest = filterContent("clean", region);
+        QVERIFY(RegionFile::isManifest(manifest));
+
+        // Smudge output spans several packets and must reassemble exactly
+        QCOMPARE(filterContent("smudge", manifest), region);
+    }
+
+    void testEmptyContent()
+    {
+        QCOMPARE(filterContent("clean", QByteArray()), QByteArray());
+    }
+
+    void testUnsupportedCommandKeepsServing()
+    {
+        QByteArray input = handshake() + request("frobnicate", "r.0.0.mca", "data")
+            + request("clean", "r.0.0.mca", "not a region");
+        bool wellFormed = false;
+        QList<QByteArray> packets = parsePackets(runFilter(input), &wellFormed);
+        QVERIFY(wellFormed);
+        QCOMPARE(m_exitCode, 0);
+
+        const QList<QByteArray> responses = packets.mid(6);
+        const QList<QByteArray> expected = {
+            "status=error\n", Flush,
+            "status=success\n", Flush, "not a region", Flush, Flush
+        };
+        QCOMPARE(responses, expected);
+    }
+
+    void testMalformedPacketHeader()
+    {
+        runFilter(handshake() + "zz!!");
+        QCOMPARE(m_exitCode, 1);
+
+        // 1..3 are reserved lengths, never valid packets
+        runFilter(handshake() + "0002");
+        QCOMPARE(m_exitCode, 1);
+    }
+
+    void testTruncatedInput()
+    {
+        runFilter(handshake() + "0010abc");
+        QCOMPARE(m_exitCode, 1);
+
+        // Git closing the pipe mid-request is an error, between requests it isn't
+        runFilter(handshake() + packet("command=clean\n") + Flush + packet("half"));
+        QCOMPARE(m_exitCode, 1);
+    }
+
+    void testUnsupportedProtocolVersion()
+    {
+        runFilter(packet("git-filter-client\n") + packet("version=3\n") + Flush);
+        QCOMPARE(m_exitCode, 1);
+    }
+
+private:
+    int m_exitCode = -1;
+
+    QByteArray runFilter(const QByteArray& input)
+    {
+        QByteArray inputData = input;
+        QByteArray outputData;
+        QBuffer inputBuffer(&inputData);
+        QBuffer outputBuffer(&outputData);
+        inputBuffer.open(QIODevice::ReadOnly);
+        outputBuffer.open(QIODevice::WriteOnly);
+        m_exitCode = FilterProcess(FilterProcess::Kind::Region, &inputBuffer, &outputBuffer).run();
+        return outputData;
+    }
+
+    /**
+     * @brief Run one request and return the filtered content
+     */
+    QByteArray filterContent(const QByteArray& command, const QByteArray& content)
+    {
+        bool wellFormed = false;
+        QList<QByteArray> packets = parsePackets(
+            runFilter(handshake() + request(command, "region/r.0.0.mca", content)), &wellFormed);
+        [&]() {
+            QVERIFY(wellFormed);
+            QCOMPARE(m_exitCode, 0);
+            QVERIFY(packets.size() >= 10);
+            QCOMPARE(packets[6], QByteArray("status=success\n"));
+            QCOMPARE(packets[7], Flush);
+            QCOMPARE(packets.last(), Flush);
+            QCOMPARE(packets[packets.size() - 2], Flush);
+        }();
+
+        QByteArray filtered;
+        for (int i = 8; i < packets.size() - 2; ++i) {
+            filtered += packets[i];
+        }
+        return filtered;
+    }
+};
+
+QTEST_MAIN(TestFilterProcess)
+#include "test_filterprocess.moc"
@@ -1,37 +1,325 @@
 #include <QtTest/QtTest>
+#include "TestHelpers.h"
 #include "../src/core/GitService.h"
 
-class TestGitService : public QObject
+class TestGitService : public TemporaryDirectoryTest
 {
     Q_OBJECT
 
 private slots:
-    void initTestCase()
+    void init()
     {
-        // Setup test environment
+        m_git.reset();
+        resetDirectory();
+        m_git.reset(new GitService(m_dir->path()));
+        QVERIFY(await(m_git->init()).isOk());
     }
 
-    void cleanupTestCase()
+    void testCommit()
     {
-        // Cleanup test environment
+        writeFile(filePath("saves/slot1.sav"), "first save");
+        QVERIFY(await(m_git->commit("First")).isOk());
+
+        QByteArray files;
+        QVERIFY(git({"ls-tree", "-r", "--name-only", "main"}, &files));
+        QCOMPARE(files, QByteArray("saves/slot1.sav\n"));
     }
 
-    void testInit()
+    void testVerifyAfterRestore()
     {
-        // TODO: Implement test for git init
-        QVERIFY(true);
+        QString first = commitSaves("one", "other");
+        commitSaves("two", "other, changed");
+
+        QVERIFY(await(m_git->checkout(first)).isOk());
+        QCOMPARE(readFile(filePath("saves/a.sav")), QByteArray("one"));
+
+        auto report = await(m_git->verifyRestore(VerifyMode::Quick));
+        QVERIFY(report.isOk());
+        QVERIFY(report.value().isClean());
+        QCOMPARE(report.value().snapshotId, first);
+        QCOMPARE(report.value().checkedFiles, 2);
+
+        // Listing the history leaves the restored files alone
+        QVERIFY(await(m_git->getHistory()).isOk());
+        QCOMPARE(readFile(filePath("saves/a.sav")), QByteArray("one"));
+        report = await(m_git->verifyRestore(VerifyMode::Deep));
+        QVERIFY(report.isOk());
+        QVERIFY(report.value().isClean());
+        QCOMPARE(report.value().hashedFiles, 2);
     }
 
-    void testCommit()
+    void testRepairRestore()
     {
-        // TODO: Implement test for git commit
-        QVERIFY(true);
+        QString first = commitSaves("one", "other");
+        commitSaves("two", "other, changed");
+        QVERIFY(await(m_git->checkout(first)).isOk());
+
+        writeFile(filePath("saves/a.sav"), "damaged");
+        QVERIFY(QFile::remove(filePath("saves/b.sav")));
+
+        auto report = await(m_git->verifyRestore(VerifyMode::Quick));
+        QVERIFY(report.isOk());
+        QCOMPARE(report.value().modified, QStringList{"saves/a.sav"});
+        QCOMPARE(report.value().missing, QStringList{"saves/b.sav"});
+
+        QVERIFY(await(m_git->repairRestore(report.value().damaged())).isOk());
+        QCOMPARE(readFile(filePath("saves/a.sav")), QByteArray("one"));
+        QCOMPARE(readFile(filePath("saves/b.sav")), QByteArray("other"));
+
+        report = await(m_git->verifyRestore(VerifyMode::Quick));
+        QVERIFY(report.isOk());
+        QVERIFY(report.value().isClean());
+        QCOMPARE(report.value().hashedFiles, 0);
+    }
+
+    void testSnapshotAfterRestoreGoesOnMain()
+    {
+        QString first = commitSaves("one", "other");
+        QString second = commitSaves("two", "other, changed");
+        QVERIFY(await(m_git->checkout(first)).isOk());
+
+        writeFile(filePath("saves/c.sav"), "new");
+        QVERIFY(await(m_git->commit("After restore")).isOk());
+
+        QByteArray branch;
+        QByteArray parent;
+        QVERIFY(git({"symbolic-ref", "--short", "HEAD"}, &branch));
+        QCOMPARE(branch, QByteArray("main\n"));
+        QVERIFY(git({"rev-parse", "main^"}, &parent));
+        QCOMPARE(QString::fromLatin1(parent.trimmed()), second);
+
+        // The new snapshot holds the restored files as they were on disk
+        QByteArray content;
+        QVERIFY(git({"show", "main:saves/a.sav"}, &content));
+        QCOMPARE(content, QByteArray("one"));
     }
 
-    void testGetHistory()
+    void testDiffReportsLogicalSizes()
     {
-        // TODO: Implement test for git history
-        QVERIFY(true);
+        // Stored directly, as the filter would have stored them
+        QString first = commitManifest(1000);
+        QString second = commitManifest(3000);
+        writeFile(filePath(".git/info/attributes"), "*.sav filter=vgvc-delta -diff\n");
+
+        auto changes = diff(first, second);
+        QCOMPARE(changes.size(), 1);
+        QCOMPARE(changes[0].path, QString("saves/a.sav"));
+        QCOMPARE(changes[0].oldSize, qint64(1000));
+        QCOMPARE(changes[0].newSize, qint64(3000));
+
+        // The working tree holds the file itself
+        writeFile(filePath("saves/a.sav"), QByteArray(5000, 'x'));
+        changes = diff(second, QString());
+        QCOMPARE(changes.size(), 1);
+        QCOMPARE(changes[0].oldSize, qint64(3000));
+        QCOMPARE(changes[0].newSize, qint64(5000));
+    }
+
+    void testAttributeLinesAreRewritten()
+    {
+        QVERIFY(git({"config", "filter.vgvc-region.process", "git region-filter"}));
+        QVERIFY(git({"config", "filter.vgvc-delta.process", "git delta-filter"}));
+        writeFile(filePath(".git/info/attributes"),
+                  "*.log -diff\n*.sav filter=vgvc-region -diff\n*.sav filter=vgvc-region -diff\n");
+
+        m_git->setDeltaFiles({"*.sav", "*.dat"});
+        writeFile(filePath("notes.txt"), "notes");
+        QVERIFY(await(m_git->commit("Notes")).isOk());
+        QCOMPARE(readFile(filePath(".git/info/attributes")),
+                 QByteArray("*.log -diff\n*.sav filter=vgvc-delta -diff\n*.dat filter=vgvc-delta -diff\n"));
+
+        // Opening again changes nothing
+        m_git.reset(new GitService(m_dir->path()));
+        m_git->setDeltaFiles({"*.sav", "*.dat"});
+        writeFile(filePath("notes.txt"), "more notes");
+        QVERIFY(await(m_git->commit("More notes")).isOk());
+        QCOMPARE(readFile(filePath(".git/info/attributes")),
+                 QByteArray("*.log -diff\n*.sav filter=vgvc-delta -diff\n*.dat filter=vgvc-delta -diff\n"));
+    }
+
+    void testMissingCli()
+    {
+        if (!QStandardPaths::findExecutable("vgvc-cli").isEmpty()
+            || QFileInfo::exists(QDir(QCoreApplication::applicationDirPath()).filePath("vgvc-cli"))) {
+            QSKIP("vgvc-cli is installed");
+        }
+
+        // Nothing stored through the filter yet: files are stored whole
+        m_git->setDeltaFiles({"*.sav"});
+        writeFile(filePath("saves/a.sav"), "save");
+        QVERIFY(await(m_git->commit("Save")).isOk());
+        QVERIFY(!readFile(filePath(".git/info/attributes")).contains("filter="));
+
+        // Snapshots need the filter: opening fails instead of breaking git
+        writeFile(filePath(".git/info/attributes"), "*.sav filter=vgvc-delta -diff\n");
+        m_git.reset(new GitService(m_dir->path()));
+        writeFile(filePath("saves/a.sav"), "changed");
+        auto result = await(m_git->commit("Changed"));
+        QVERIFY(result.isErr());
+        QVERIFY(result.error().contains("vgvc-cli"));
+    }
+
+    void testPushResumesAfterFailedBatch()
+    {
+        QStringList snapshots;
+        for (int i = 0; i < 20; ++i) {
+            writeFile(filePath("saves/a.sav"), QByteArray::number(i));
+            QVERIFY(git({"add", "saves"}));
+            QVERIFY(git({"commit", "--quiet", "-m", QString("Save %1").arg(i)}));
+            QByteArray head;
+            QVERIFY(git({"rev-parse", "HEAD"}, &head));
+            snapshots << QString::fromLatin1(head.trimmed());
+        }
+
+        // The remote takes its first batch, then turns the next one down
+        QString remote = filePath("remote.git");
+        QVERIFY(git({"init", "--quiet", "--bare", "-b", "main", remote}));
+        writeFile(remote + "/reject", QByteArray());
+        writeFile(remote + "/hooks/pre-receive",
+                  "#!/bin/sh\n"
+                  "read old new ref\n"
+                  "if [ -e reject ] && [ \"$old\" != 0000000000000000000000000000000000000000 ]; then\n"
+                  "    exit 1\n"
+                  "fi\n");
+        QVERIFY(QFile::setPermissions(remote + "/hooks/pre-receive",
+                                      QFile::permissions(remote + "/hooks/pre-receive") | QFile::ExeOwner));
+
+        auto failed = await(m_git->pushSnapshots(remote));
+        QVERIFY(failed.isErr());
+        QVERIFY(failed.error().startsWith("Synced 8 of 20 snapshots"));
+        QByteArray remoteTip;
+        QVERIFY(git({"--git-dir", remote, "rev-parse", "main"}, &remoteTip));
+        QCOMPARE(QString::fromLatin1(remoteTip.trimmed()), snapshots[7]);
+
+        // Only what the remote lacks is sent again
+        QVERIFY(QFile::remove(remote + "/reject"));
+        auto resumed = await(m_git->pushSnapshots(remote));
+        QVERIFY(resumed.isOk());
+        QCOMPARE(resumed.value().pushedSnapshots, 12);
+        QCOMPARE(resumed.value().batches, 2);
+        QCOMPARE(resumed.value().remoteTip, snapshots.last());
+
+        auto upToDate = await(m_git->pushSnapshots(remote));
+        QVERIFY(upToDate.isOk());
+        QVERIFY(upToDate.value().isUpToDate());
+    }
+
+    void testFileHistoryIsExtendedIncrementally()
+    {
+        QString first = commitSaves("one", "other");
+        QString second = commitSaves("two", "other");
+        auto history = await(m_git->fileHistory(filePath("saves/a.sav")));
+        QVERIFY(history.isOk());
+        QCOMPARE(versionIds(history.value()), QStringList({second, first}));
+
+        // Committed behind GitService's back: found from the stored tips
+        writeFile(filePath("saves/a.sav"), "three");
+        QVERIFY(git({"commit", "--quiet", "-am", "Outside"}));
+        QByteArray head;
+        QVERIFY(git({"rev-parse", "HEAD"}, &head));
+        const QString third = QString::fromLatin1(head.trimmed());
+
+        history = await(m_git->fileHistory(filePath("saves/a.sav")));
+        QVERIFY(history.isOk());
+        QCOMPARE(versionIds(history.value()), QStringList({third, second, first}));
+        history = await(m_git->fileHistory(filePath("saves/b.sav")));
+        QVERIFY(history.isOk());
+        QCOMPARE(versionIds(history.value()), QStringList({first}));
+
+        // Each snapshot was indexed once, and the tips moved to the new head
+        FileHistoryIndex stored(m_dir->path());
+        QVERIFY(stored.load().isOk());
+        QCOMPARE(stored.snapshotCount(), 3);
+        QCOMPARE(stored.tips(), QStringList({third}));
+    }
+
+    void testFileHistoryAfterBranchRewrite()
+    {
+        QString first = commitSaves("one", "other");
+        commitSaves("two", "other");
+        commitSaves("three", "other");
+        QVERIFY(await(m_git->fileHistory(filePath("saves/a.sav"))).isOk());
+
+        // Drop the last two snapshots for good, so the indexed tip is gone
+        QVERIFY(git({"reset", "--quiet", "--hard", first}));
+        QVERIFY(git({"update-ref", "-d", "ORIG_HEAD"}));
+        QVERIFY(git({"reflog", "expire", "--expire=now", "--all"}));
+        QVERIFY(git({"gc", "--quiet", "--prune=now"}));
+        QString rewritten = commitSaves("rewritten", "other");
+
+        auto history = await(m_git->fileHistory(filePath("saves/a.sav")));
+        QVERIFY(history.isOk());
+        QCOMPARE(versionIds(history.value()), QStringList({rewritten, first}));
+
+        FileHistoryIndex stored(m_dir->path());
+        QVERIFY(stored.load().isOk());
+        QCOMPARE(stored.snapshotCount(), 2);
+        QCOMPARE(stored.tips(), QStringList({rewritten}));
+    }
+
+private:
+    QScopedPointer<GitService> m_git;
+
+    static QStringList versionIds(const QList<FileVersion>& versions)
+    {
+        QStringList ids;
+        for (const FileVersion& version : versions) {
+            ids << version.snapshotId;
+        }
+        return ids;
+    }
+
+    /**
+     * @brief Commit a delta manifest with git itself, bypassing any filter
+     * @return The new snapshot's ID
+     */
+    QString commitManifest(qint64 size)
+    {
+        writeFile(filePath("saves/a.sav"), manifest(size));
+        writeFile(filePath("saves/b.sav"), "other");
+        git({"add", "saves"});
+        git({"commit", "--quiet", "-m", QString("Manifest %1").arg(size)});
+
+        QByteArray head;
+        git({"rev-parse", "HEAD"}, &head);
+        return QString::fromLatin1(head.trimmed());
+    }
+
+    static QByteArray manifest(qint64 size)
+    {
+        return "vgvc-delta 2\nsize " + QByteArray::number(size) + "\nhead 0123\n";
+    }
+
+    /**
+     * @brief Every change the streamed diff reports
+     */
+    QList<FileChange> diff(const QString& from, const QString& to)
+    {
+        auto future = m_git->diff(from, to);
+        future.waitForFinished();
+        QList<FileChange> changes;
+        for (const auto& batch : future.results()) {
+            [&]() { QVERIFY(batch.isOk()); }();
+            if (batch.isOk()) {
+                changes += batch.value();
+            }
+        }
+        return changes;
+    }
+
+    /**
+     * @brief Write both saves and snapshot them
+     * @return The new snapshot's ID
+     */
+    QString commitSaves(const QByteArray& a, const QByteArray& b)
+    {
+        writeFile(filePath("saves/a.sav"), a);
+        writeFile(filePath("saves/b.sav"), b);
+        [&]() { QVERIFY(await(m_git->commit(QString("Saves %1").arg(QString::fromUtf8(a)))).isOk()); }();
+
+        QByteArray head;
+        git({"rev-parse", "HEAD"}, &head);
+        return QString::fromLatin1(head.trimmed());
     }
 };
 
@@ -0,0 +1,88 @@
+#include <QtTest/QtTest>
+#include "../src/utils/PatternMatcher.h"
+
+class TestPatternMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testMatches_data()
+    {
+        QTest::addColumn<QStringList>("patterns");
+        QTest::addColumn<QString>("path");
+        QTest::addColumn<bool>("isDirectory");
+        QTest::addColumn<bool>("caseInsensitive");
+        QTest::addColumn<bool>("expected");
+
+        // Literal names match at any depth
+        QTest::newRow("name") << QStringList{"servers.dat"} << "servers.dat" << false << false << true;
+        QTest::newRow("name, nested") << QStringList{"servers.dat"} << "a/b/servers.dat" << false << false << true;
+        QTest::newRow("name, other") << QStringList{"servers.dat"} << "servers.dat.bak" << false << false << false;
+
+        // A trailing '/' restricts the pattern to directories
+        QTest::newRow("directory") << QStringList{"Logs/"} << "Logs" << true << false << true;
+        QTest::newRow("directory, nested") << QStringList{"Logs/"} << "saves/Logs" << true << false << true;
+        QTest::newRow("directory, file") << QStringList{"Logs/"} << "Logs" << false << false << false;
+        QTest::newRow("directory glob") << QStringList{"*cache/"} << "shadercache" << true << false << true;
+        QTest::newRow("directory glob, file") << QStringList{"*cache/"} << "shadercache" << false << false << false;
+
+        // Any other '/' anchors the pattern to the root
+        QTest::newRow("anchored") << QStringList{"config/settings.ini"} << "config/settings.ini" << false << false << true;
+        QTest::newRow("anchored, nested") << QStringList{"config/settings.ini"} << "mods/config/settings.ini" << false << false << false;
+        QTest::newRow("leading slash") << QStringList{"/root.txt"} << "root.txt" << false << false << true;
+        QTest::newRow("leading slash, nested") << QStringList{"/root.txt"} << "sub/root.txt" << false << false << false;
+        QTest::newRow("anchored glob") << QStringList{"saves/*.bak"} << "saves/a.bak" << false << false << true;
+        QTest::newRow("star stops at '/'") << QStringList{"saves/*.bak"} << "saves/old/a.bak" << false << false << false;
+
+        // "**" crosses directories
+        QTest::newRow("**/ at the top") << QStringList{"**/cache"} << "cache" << true << false << true;
+        QTest::newRow("**/ nested") << QStringList{"**/cache"} << "a/b/cache" << true << false << true;
+        QTest::newRow("/** contents") << QStringList{"logs/**"} << "logs/a/b.txt" << false << false << true;
+        QTest::newRow("/** not the directory") << QStringList{"logs/**"} << "logs" << true << false << false;
+        QTest::newRow("/**/ no directories") << QStringList{"a/**/b"} << "a/b" << false << false << true;
+        QTest::newRow("/**/ several") << QStringList{"a/**/b"} << "a/x/y/b" << false << false << true;
+
+        // Suffix globs go to the suffix tables; the rest to regexes
+        QTest::newRow("suffix") << QStringList{"*.log"} << "x/debug.log" << false << false << true;
+        QTest::newRow("suffix, longer name") << QStringList{"*.log"} << "debug.log.gz" << false << false << false;
+        QTest::newRow("two suffixes") << QStringList{"*.log", "*.log.gz"} << "debug.log.gz" << false << false << true;
+        QTest::newRow("question mark") << QStringList{"save?.dat"} << "save1.dat" << false << false << true;
+        QTest::newRow("question mark, two") << QStringList{"save?.dat"} << "save10.dat" << false << false << false;
+        QTest::newRow("class") << QStringList{"save[0-9].dat"} << "save5.dat" << false << false << true;
+        QTest::newRow("class, outside") << QStringList{"save[0-9].dat"} << "savex.dat" << false << false << false;
+        QTest::newRow("negated class") << QStringList{"save[!0-9].dat"} << "savex.dat" << false << false << true;
+
+        // Case folding follows the requested sensitivity
+        QTest::newRow("case sensitive") << QStringList{"*.LOG"} << "debug.log" << false << false << false;
+        QTest::newRow("case insensitive") << QStringList{"*.LOG"} << "debug.log" << false << true << true;
+        QTest::newRow("case insensitive directory") << QStringList{"Saves/"} << "saves" << true << true << true;
+        QTest::newRow("case insensitive anchored") << QStringList{"Config/*.INI"} << "config/a.ini" << false << true << true;
+
+        // Negations are unsupported and skipped; comments are ignored
+        QTest::newRow("negation skipped") << QStringList{"*.log", "!keep.log"} << "keep.log" << false << false << true;
+        QTest::newRow("negation only") << QStringList{"!keep.log"} << "keep.log" << false << false << false;
+        QTest::newRow("comment") << QStringList{"# servers.dat"} << "servers.dat" << false << false << false;
+    }
+
+    void testMatches()
+    {
+        QFETCH(QStringList, patterns);
+        QFETCH(QString, path);
+        QFETCH(bool, isDirectory);
+        QFETCH(bool, caseInsensitive);
+        QFETCH(bool, expected);
+
+        PatternMatcher matcher(patterns, caseInsensitive ? Qt::CaseInsensitive : Qt::CaseSensitive);
+        QCOMPARE(matcher.matches(path, isDirectory), expected);
+    }
+
+    void testSkippedPatternsLeaveItEmpty()
+    {
+        QVERIFY(PatternMatcher().isEmpty());
+        QVERIFY(PatternMatcher({"!keep.log", "# comment", "", "/"}).isEmpty());
+        QVERIFY(!PatternMatcher({"!keep.log", "*.log"}).isEmpty());
+    }
+};
+
+QTEST_MAIN(TestPatternMatcher)
+#include "test_patternmatcher.moc"
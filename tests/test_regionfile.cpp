@@ -0,0 +1,190 @@
+#include <QtTest/QtTest>
+#include <QtEndian>
+#include "TestHelpers.h"
+#include "../src/core/ChunkStore.h"
+#include "../src/core/RegionFile.h"
+
+namespace {
+
+constexpr qint64 SectorSize = 4096;
+constexpr qint64 HeaderSize = 2 * SectorSize;
+
+struct TestChunk {
+    int slot;
+    int sector;       // First sector; 2 is the first after the header
+    int sectorCount;
+    quint32 timestamp;
+};
+
+/**
+ * @brief A region file whose chunks are filled with bytes derived from their slot
+ */
+QByteArray makeRegion(const QList<TestChunk>& chunks, qint64 trailingBytes = 0)
+{
+    qint64 size = HeaderSize;
+    for (const TestChunk& chunk : chunks) {
+        size = qMax(size, (chunk.sector + chunk.sectorCount) * SectorSize);
+    }
+    QByteArray data(size + trailingBytes, '\0');
+
+    for (const TestChunk& chunk : chunks) {
+        quint32 location = (quint32(chunk.sector) << 8) | quint32(chunk.sectorCount);
+        qToBigEndian(location, data.data() + 4 * chunk.slot);
+        qToBigEndian(chunk.timestamp, data.data() + SectorSize + 4 * chunk.slot);
+        for (qint64 i = 0; i < chunk.sectorCount * SectorSize; ++i) {
+            data[chunk.sector * SectorSize + i] = char((chunk.slot * 31 + i) & 0xff);
+        }
+    }
+    for (qint64 i = size; i < data.size(); ++i) {
+        data[i] = char(0xa5);
+    }
+    return data;
+}
+
+} // namespace
+
+class TestRegionFile : public TemporaryDirectoryTest
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        m_store.reset();
+        resetDirectory();
+        m_store.reset(new ChunkStore(filePath("chunks")));
+        QVERIFY(m_store->open().isOk());
+    }
+
+    void testSplitCoversEveryByte()
+    {
+        // Out of order on disk, with a one-sector gap and trailing bytes
+        QByteArray data = makeRegion({{5, 6, 1, 100}, {0, 2, 2, 200}}, 123);
+        auto result = RegionFile::split(data);
+        QVERIFY(result.isOk());
+
+        const QVector<RegionSegment>& segments = result.value();
+        QCOMPARE(segments.size(), 5);
+        QVERIFY(segments[0].kind == RegionSegment::Kind::Header);
+        QVERIFY(segments[1].kind == RegionSegment::Kind::Chunk);
+        QCOMPARE(segments[1].slot, 0);
+        QCOMPARE(segments[1].timestamp, quint32(200));
+        QVERIFY(segments[2].kind == RegionSegment::Kind::Gap);
+        QCOMPARE(segments[3].slot, 5);
+        QVERIFY(segments[4].kind == RegionSegment::Kind::Gap);
+        QCOMPARE(segments[4].length, qint64(123));
+
+        qint64 position = 0;
+        for (const RegionSegment& segment : segments) {
+            QCOMPARE(segment.offset, position);
+            position += segment.length;
+        }
+        QCOMPARE(position, qint64(data.size()));
+    }
+
+    void testSplitRejectsMalformedHeaders()
+    {
+        QVERIFY(RegionFile::split(QByteArray(HeaderSize - 1, '\0')).isErr());
+
+        // Chunk runs past the end of the file
+        QByteArray outside = makeRegion({{0, 2, 1, 0}});
+        qToBigEndian(quint32((2u << 8) | 4u), outside.data());
+        QVERIFY(RegionFile::split(outside).isErr());
+
+        // Chunk points into the header
+        QByteArray inHeader = makeRegion({{0, 2, 1, 0}});
+        qToBigEndian(quint32((1u << 8) | 1u), inHeader.data());
+        QVERIFY(RegionFile::split(inHeader).isErr());
+
+        QVERIFY(RegionFile::split(makeRegion({{0, 2, 2, 0}, {1, 3, 1, 0}})).isErr());
+    }
+
+    void testCleanSmudgeRoundTrip()
+    {
+        QByteArray data = makeRegion({{0, 2, 1, 1}, {7, 4, 3, 2}, {1023, 3, 1, 3}}, 17);
+        auto cleaned = RegionFile::clean(data, *m_store);
+        QVERIFY(cleaned.isOk());
+        QVERIFY(RegionFile::isManifest(cleaned.value()));
+        QVERIFY(cleaned.value().size() < 1024);
+
+        auto smudged = RegionFile::smudge(cleaned.value(), *m_store);
+        QVERIFY(smudged.isOk());
+        QCOMPARE(smudged.value(), data);
+    }
+
+    void testUnchangedChunksAreStoredOnce()
+    {
+        QByteArray first = makeRegion({{0, 2, 1, 1}, {1, 3, 1, 1}});
+        QVERIFY(RegionFile::clean(first, *m_store).isOk());
+        int chunksAfterFirst = m_store->chunkCount();
+
+        // Only chunk 1 was saved again: a new header and one new chunk
+        QByteArray second = first;
+        qToBigEndian(quint32(2), second.data() + SectorSize + 4);
+        second[3 * SectorSize] = char(0x7f);
+        QVERIFY(RegionFile::clean(second, *m_store).isOk());
+        QCOMPARE(m_store->chunkCount(), chunksAfterFirst + 2);
+    }
+
+    void testNonRegionDataPassesThrough()
+    {
+        QByteArray truncated("half a region file");
+        auto cleaned = RegionFile::clean(truncated, *m_store);
+        QVERIFY(cleaned.isOk());
+        QCOMPARE(cleaned.value(), truncated);
+        QCOMPARE(m_store->chunkCount(), 0);
+
+        auto smudged = RegionFile::smudge(truncated, *m_store);
+        QVERIFY(smudged.isOk());
+        QCOMPARE(smudged.value(), truncated);
+    }
+
+    void testSmudgeRejectsMalformedManifests()
+    {
+        QByteArray data = makeRegion({{0, 2, 1, 1}});
+        auto cleaned = RegionFile::clean(data, *m_store);
+        QVERIFY(cleaned.isOk());
+        const QByteArray manifest = cleaned.value();
+
+        QByteArray noSize = manifest;
+        noSize.replace("size ", "sise ");
+        QVERIFY(RegionFile::smudge(noSize, *m_store).isErr());
+
+        QByteArray badSize = manifest;
+        badSize.replace("size ", "size x");
+        QVERIFY(RegionFile::smudge(badSize, *m_store).isErr());
+
+        QByteArray shortLine = manifest + "g 12\n";
+        QVERIFY(RegionFile::smudge(shortLine, *m_store).isErr());
+
+        QByteArray unknownChunk = manifest + "g 1 " + QByteArray(40, 'e') + '\n';
+        QVERIFY(RegionFile::smudge(unknownChunk, *m_store).isErr());
+
+        // Every chunk resolves, but the total disagrees with the size line
+        QByteArray wrongSize = manifest;
+        wrongSize.replace("size " + QByteArray::number(data.size()),
+                          "size " + QByteArray::number(data.size() + 1));
+        QVERIFY(RegionFile::smudge(wrongSize, *m_store).isErr());
+    }
+
+    void testCorruptChunkIsRejected()
+    {
+        auto put = m_store->put(QByteArray(100, 'c'));
+        QVERIFY(put.isOk());
+        m_store.reset();
+
+        QByteArray stored = readFile(filePath("chunks/chunks.dat"));
+        stored[50] = 'd';
+        writeFile(filePath("chunks/chunks.dat"), stored);
+
+        m_store.reset(new ChunkStore(filePath("chunks")));
+        QVERIFY(m_store->open().isOk());
+        QVERIFY(m_store->get(put.value()).isErr());
+    }
+
+private:
+    QScopedPointer<ChunkStore> m_store;
+};
+
+QTEST_MAIN(TestRegionFile)
+#include "test_regionfile.moc"
@@ -0,0 +1,197 @@
+#include <QtTest/QtTest>
+#include <memory>
+#include "../src/core/types/Result.h"
+
+namespace {
+
+// Counts copies, to check that rvalue paths move instead
+struct CopyCounter {
+    static int copies;
+
+    int value = 0;
+
+    explicit CopyCounter(int v) : value(v) {}
+    CopyCounter(const CopyCounter& other) : value(other.value) { ++copies; }
+    CopyCounter(CopyCounter&&) = default;
+    CopyCounter& operator=(const CopyCounter& other)
+    {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+    CopyCounter& operator=(CopyCounter&&) = default;
+};
+
+int CopyCounter::copies = 0;
+
+} // namespace
+
+class TestResult : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        CopyCounter::copies = 0;
+    }
+
+    void testOkAndErr()
+    {
+        auto ok = Result<int, QString>::ok(42);
+        QVERIFY(ok.isOk());
+        QVERIFY(!ok.isErr());
+        QCOMPARE(ok.value(), 42);
+        QVERIFY_THROWS_EXCEPTION(std::runtime_error, ok.error());
+
+        auto err = Result<int, QString>::err("failed");
+        QVERIFY(err.isErr());
+        QCOMPARE(err.error(), QString("failed"));
+        QVERIFY_THROWS_EXCEPTION(std::runtime_error, err.value());
+        QVERIFY_THROWS_EXCEPTION(std::runtime_error, err.takeValue());
+    }
+
+    void testSameValueAndErrorType()
+    {
+        // Alternatives are told apart by index, not by type
+        auto ok = Result<QString, QString>::ok("value");
+        auto err = Result<QString, QString>::err("error");
+        QVERIFY(ok.isOk());
+        QCOMPARE(ok.value(), QString("value"));
+        QVERIFY(err.isErr());
+        QCOMPARE(err.error(), QString("error"));
+    }
+
+    void testMoveOnlyValue()
+    {
+        auto result = Result<std::unique_ptr<int>, QString>::ok(std::make_unique<int>(7));
+        std::unique_ptr<int> value = result.takeValue();
+        QVERIFY(value);
+        QCOMPARE(*value, 7);
+        QVERIFY(!result.value());
+
+        auto error = Result<int, std::unique_ptr<QString>>::err(std::make_unique<QString>("gone"));
+        QCOMPARE(*error.takeError(), QString("gone"));
+    }
+
+    void testRvalueValueMoves()
+    {
+        auto make = [] { return Result<CopyCounter, QString>::ok(CopyCounter(3)); };
+        CopyCounter value = make().value();
+        QCOMPARE(value.value, 3);
+        QCOMPARE(CopyCounter::copies, 0);
+
+        CopyCounter fallback = make().valueOr(CopyCounter(0));
+        QCOMPARE(fallback.value, 3);
+        QCOMPARE(CopyCounter::copies, 0);
+    }
+
+    void testValueOr()
+    {
+        auto ok = Result<int, QString>::ok(1);
+        auto err = Result<int, QString>::err("failed");
+        QCOMPARE(ok.valueOr(5), 1);
+        QCOMPARE(err.valueOr(5), 5);
+    }
+
+    void testMap()
+    {
+        auto doubled = Result<int, QString>::ok(21).map([](int v) { return v * 2; });
+        QVERIFY(doubled.isOk());
+        QCOMPARE(doubled.value(), 42);
+
+        auto text = Result<int, QString>::ok(5).map([](int v) { return QString::number(v); });
+        static_assert(std::is_same_v<decltype(text), Result<QString, QString>>);
+        QCOMPARE(text.value(), QString("5"));
+
+        bool called = false;
+        auto skipped = Result<int, QString>::err("failed").map([&called](int v) {
+            called = true;
+            return v;
+        });
+        QVERIFY(!called);
+        QCOMPARE(skipped.error(), QString("failed"));
+
+        int seen = 0;
+        auto toVoid = Result<int, QString>::ok(9).map([&seen](int v) { seen = v; });
+        static_assert(std::is_same_v<decltype(toVoid), Result<void, QString>>);
+        QVERIFY(toVoid.isOk());
+        QCOMPARE(seen, 9);
+    }
+
+    void testMapMovesPayload()
+    {
+        auto size = Result<CopyCounter, QString>::ok(CopyCounter(4))
+            .map([](CopyCounter&& c) { return c.value; });
+        QCOMPARE(size.value(), 4);
+        QCOMPARE(CopyCounter::copies, 0);
+    }
+
+    void testAndThen()
+    {
+        auto parse = [](QString text) -> Result<int, QString> {
+            bool ok = false;
+            int value = text.toInt(&ok);
+            return ok ? Result<int, QString>::ok(value) : Result<int, QString>::err("not a number");
+        };
+
+        auto parsed = Result<QString, QString>::ok("12").andThen(parse);
+        QCOMPARE(parsed.value(), 12);
+
+        auto rejected = Result<QString, QString>::ok("twelve").andThen(parse);
+        QCOMPARE(rejected.error(), QString("not a number"));
+
+        bool called = false;
+        auto skipped = Result<QString, QString>::err("read failed").andThen([&called](QString) {
+            called = true;
+            return Result<int, QString>::ok(0);
+        });
+        QVERIFY(!called);
+        QCOMPARE(skipped.error(), QString("read failed"));
+    }
+
+    void testMapError()
+    {
+        auto err = Result<int, QString>::err("disk").mapError([](QString e) { return e.size(); });
+        static_assert(std::is_same_v<decltype(err), Result<int, qsizetype>>);
+        QCOMPARE(err.error(), qsizetype(4));
+
+        auto ok = Result<int, QString>::ok(1).mapError([](QString e) { return e.size(); });
+        QVERIFY(ok.isOk());
+        QCOMPARE(ok.value(), 1);
+    }
+
+    void testVoidResult()
+    {
+        auto ok = Result<void, QString>::ok();
+        QVERIFY(ok.isOk());
+        QVERIFY_THROWS_EXCEPTION(std::runtime_error, ok.error());
+
+        auto err = Result<void, QString>::err("failed");
+        QVERIFY(err.isErr());
+        QCOMPARE(err.takeError(), QString("failed"));
+    }
+
+    void testVoidChaining()
+    {
+        auto value = Result<void, QString>::ok().map([] { return 3; });
+        QCOMPARE(value.value(), 3);
+
+        auto next = Result<void, QString>::ok().andThen([] { return Result<int, QString>::err("step 2"); });
+        QCOMPARE(next.error(), QString("step 2"));
+
+        bool called = false;
+        auto skipped = Result<void, QString>::err("step 1").andThen([&called] {
+            called = true;
+            return Result<void, QString>::ok();
+        });
+        QVERIFY(!called);
+        QCOMPARE(skipped.error(), QString("step 1"));
+
+        auto mapped = Result<void, QString>::err("x").mapError([](QString e) { return e + "y"; });
+        QCOMPARE(mapped.error(), QString("xy"));
+    }
+};
+
+QTEST_MAIN(TestResult)
+#include "test_result.moc"
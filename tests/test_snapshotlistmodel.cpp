@@ -0,0 +1,140 @@
+#include <QtTest/QtTest>
+#include <QAbstractItemModelTester>
+#include "../src/ui/models/SnapshotListModel.h"
+
+namespace {
+
+ObjectId snapshotId(int number)
+{
+    return ObjectId::fromHex(QString::number(number).rightJustified(40, '0'));
+}
+
+/**
+ * @brief A newest-first table of the numbered snapshots
+ */
+SnapshotTablePtr makeTable(const QList<int>& numbers)
+{
+    SnapshotTable table;
+    for (int number : numbers) {
+        table.append(snapshotId(number), 1700000000 + number, QString("Snapshot %1").arg(number), "VGVC User");
+    }
+    return SnapshotTable::share(std::move(table));
+}
+
+QList<int> range(int newest, int oldest)
+{
+    QList<int> numbers;
+    for (int number = newest; number >= oldest; --number) {
+        numbers << number;
+    }
+    return numbers;
+}
+
+} // namespace
+
+class TestSnapshotListModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        m_model.reset(new SnapshotListModel);
+        m_tester.reset(new QAbstractItemModelTester(m_model.data(),
+                                                    QAbstractItemModelTester::FailureReportingMode::QtTest));
+    }
+
+    void cleanup()
+    {
+        m_tester.reset();
+    }
+
+    void testHistorySearchHistory()
+    {
+        m_model->setTable(makeTable(range(9, 0)));
+        QCOMPARE(shown(), range(9, 0));
+        QPersistentModelIndex removed = m_model->index(3);    // Snapshot 6
+
+        m_model->setTable(makeTable({7, 3, 1}));
+        QCOMPARE(shown(), QList<int>({7, 3, 1}));
+        QVERIFY(!removed.isValid());
+        QPersistentModelIndex selected = m_model->index(1);   // Snapshot 3
+
+        m_model->setTable(makeTable(range(9, 0)));
+        QCOMPARE(shown(), range(9, 0));
+        QCOMPARE(selected.row(), 6);
+        QCOMPARE(selected.data().toString().section(" - ", 1), QString("Snapshot 3"));
+    }
+
+    void testSearchSharingTheNewestSnapshot()
+    {
+        // The top row survives, but the rows below it are other snapshots
+        m_model->setTable(makeTable(range(9, 0)));
+        QPersistentModelIndex second = m_model->index(1);      // Snapshot 8
+
+        m_model->setTable(makeTable({9, 5, 2}));
+        QCOMPARE(shown(), QList<int>({9, 5, 2}));
+        QVERIFY(!second.isValid());
+        for (int row = 0; row < 3; ++row) {
+            QCOMPARE(m_model->index(row).data().toString().section(" - ", 1),
+                     QString("Snapshot %1").arg(QList<int>({9, 5, 2})[row]));
+        }
+    }
+
+    void testNewSnapshotsArePrepended()
+    {
+        m_model->setTable(makeTable(range(9, 0)));
+        QPersistentModelIndex selected = m_model->index(2);    // Snapshot 7
+        QSignalSpy inserted(m_model.data(), &QAbstractItemModel::rowsInserted);
+        QSignalSpy removed(m_model.data(), &QAbstractItemModel::rowsRemoved);
+        QSignalSpy reset(m_model.data(), &QAbstractItemModel::modelReset);
+
+        m_model->setTable(makeTable(range(12, 0)));
+        QCOMPARE(shown(), range(12, 0));
+        QCOMPARE(selected.row(), 5);
+        QCOMPARE(inserted.size(), 1);
+        QCOMPARE(inserted[0][1].toInt(), 0);
+        QCOMPARE(inserted[0][2].toInt(), 2);
+        QCOMPARE(removed.size(), 0);
+        QCOMPARE(reset.size(), 0);
+    }
+
+    void testPageIsTrimmed()
+    {
+        // A fixed-size page: two new snapshots push the two oldest out
+        m_model->setTable(makeTable(range(9, 0)));
+        QPersistentModelIndex oldest = m_model->index(8);      // Snapshot 1
+        QPersistentModelIndex selected = m_model->index(4);    // Snapshot 5
+        QSignalSpy inserted(m_model.data(), &QAbstractItemModel::rowsInserted);
+        QSignalSpy removed(m_model.data(), &QAbstractItemModel::rowsRemoved);
+        QSignalSpy reset(m_model.data(), &QAbstractItemModel::modelReset);
+
+        m_model->setTable(makeTable(range(11, 2)));
+        QCOMPARE(shown(), range(11, 2));
+        QVERIFY(!oldest.isValid());
+        QCOMPARE(selected.row(), 6);
+        QCOMPARE(removed.size(), 1);
+        QCOMPARE(removed[0][1].toInt(), 8);
+        QCOMPARE(removed[0][2].toInt(), 9);
+        QCOMPARE(inserted.size(), 1);
+        QCOMPARE(inserted[0][1].toInt(), 0);
+        QCOMPARE(inserted[0][2].toInt(), 1);
+        QCOMPARE(reset.size(), 0);
+    }
+
+private:
+    QScopedPointer<SnapshotListModel> m_model;
+    QScopedPointer<QAbstractItemModelTester> m_tester;
+
+    QList<int> shown() const
+    {
+        QList<int> numbers;
+        for (int row = 0; row < m_model->rowCount(); ++row) {
+            numbers << m_model->getSnapshot(row).id.toInt();
+        }
+        return numbers;
+    }
+};
+
+QTEST_MAIN(TestSnapshotListModel)
+#include "test_snapshotlistmodel.moc"
@@ -0,0 +1,119 @@
+#include <QtTest/QtTest>
+#include "../src/core/SnapshotTable.h"
+
+namespace {
+
+ObjectId snapshotId(int number)
+{
+    return ObjectId::fromHex(QString::number(number).rightJustified(40, '0'));
+}
+
+} // namespace
+
+class TestSnapshotTable : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRowsReadBack()
+    {
+        SnapshotTable table;
+        table.append(snapshotId(2), 1700000002, "Before the boss", "VGVC User");
+        table.append(snapshotId(1), 1700000001, "[AUTO] Scheduled snapshot", "daemon");
+        SnapshotTablePtr shared = SnapshotTable::share(std::move(table));
+
+        QCOMPARE(shared->size(), 2);
+        QVERIFY(shared->id(0) == snapshotId(2));
+        QCOMPARE(shared->timestampSecs(0), qint64(1700000002));
+        QCOMPARE(shared->description(0).toString(), QString("Before the boss"));
+        QCOMPARE(shared->author(0), QString("VGVC User"));
+        QVERIFY(!shared->isAutomatic(0));
+        QVERIFY(shared->isAutomatic(1));
+        QCOMPARE(shared->author(1), QString("daemon"));
+
+        Snapshot snapshot = shared->snapshot(1);
+        QCOMPARE(snapshot.id, snapshotId(1).toHex());
+        QCOMPARE(snapshot.description, QString("[AUTO] Scheduled snapshot"));
+        QCOMPARE(snapshot.timestamp, QDateTime::fromSecsSinceEpoch(1700000001));
+        QVERIFY(snapshot.isAutomatic);
+    }
+
+    void testRepeatedTextIsStoredOnce()
+    {
+        SnapshotTable table;
+        for (int number = 0; number < 100; ++number) {
+            table.append(snapshotId(number), 1700000000 + number, "[AUTO] Scheduled snapshot", "VGVC User");
+        }
+        table.append(snapshotId(100), 1700000100, "Manual", "VGVC User");
+        SnapshotTablePtr shared = SnapshotTable::share(std::move(table));
+
+        // Every row points into the same arena range and author entry
+        for (int row = 1; row < 100; ++row) {
+            QCOMPARE(shared->description(row).data(), shared->description(0).data());
+            QCOMPARE(&shared->author(row), &shared->author(0));
+        }
+        QVERIFY(shared->description(100).data() != shared->description(0).data());
+        QCOMPARE(shared->description(100).toString(), QString("Manual"));
+    }
+
+    void testAppendRowCopiesAcrossTables()
+    {
+        SnapshotTable source;
+        source.append(snapshotId(3), 1700000003, "Third", "VGVC User");
+        source.append(snapshotId(2), 1700000002, "Second", "VGVC User");
+        source.append(snapshotId(1), 1700000001, "Third", "VGVC User");
+        SnapshotTablePtr sourceTable = SnapshotTable::share(std::move(source));
+
+        // A search result keeps some rows; the shared source is unaffected
+        SnapshotTable result;
+        result.appendRow(*sourceTable, 2);
+        result.appendRow(*sourceTable, 0);
+        SnapshotTablePtr resultTable = SnapshotTable::share(std::move(result));
+
+        QCOMPARE(resultTable->size(), 2);
+        QVERIFY(resultTable->id(0) == snapshotId(1));
+        QVERIFY(resultTable->id(1) == snapshotId(3));
+        QCOMPARE(resultTable->description(1).toString(), QString("Third"));
+        QCOMPARE(resultTable->description(0).data(), resultTable->description(1).data());
+        QCOMPARE(sourceTable->size(), 3);
+    }
+
+    void testIndexOf()
+    {
+        SnapshotTable table;
+        for (int number = 9; number >= 0; --number) {
+            table.append(snapshotId(number), 1700000000 + number, "Snapshot", "VGVC User");
+        }
+        SnapshotTablePtr shared = SnapshotTable::share(std::move(table));
+
+        QCOMPARE(shared->indexOf(snapshotId(9)), 0);
+        QCOMPARE(shared->indexOf(snapshotId(0)), 9);
+        QCOMPARE(shared->indexOf(snapshotId(42)), -1);
+    }
+
+    void testSnapshotListRoundTrip()
+    {
+        QList<Snapshot> snapshots;
+        for (int number = 0; number < 3; ++number) {
+            Snapshot snapshot;
+            snapshot.id = snapshotId(number).toHex();
+            snapshot.description = number == 1 ? "[AUTO] Game closed" : QString("Save %1").arg(number);
+            snapshot.timestamp = QDateTime::fromSecsSinceEpoch(1700000000 + number);
+            snapshot.author = "VGVC User";
+            snapshots << snapshot;
+        }
+
+        const QList<Snapshot> copied = SnapshotTable::fromSnapshots(snapshots)->toList();
+        QCOMPARE(copied.size(), 3);
+        for (int i = 0; i < 3; ++i) {
+            QCOMPARE(copied[i].id, snapshots[i].id);
+            QCOMPARE(copied[i].description, snapshots[i].description);
+            QCOMPARE(copied[i].timestamp, snapshots[i].timestamp);
+            QCOMPARE(copied[i].author, snapshots[i].author);
+            QCOMPARE(copied[i].isAutomatic, i == 1);
+        }
+    }
+};
+
+QTEST_MAIN(TestSnapshotTable)
+#include "test_snapshottable.moc"
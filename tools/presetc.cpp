@@ -0,0 +1,64 @@
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+#include <cstdlib>
+#include "core/PresetBundle.h"
+
+/**
+ * presetc: compile preset JSON files into the bundle embedded in vgvc
+ *
+ * Usage: presetc <output> <preset.json>...
+ *
+ * Runs at build time so the applications never parse JSON to start up;
+ * a malformed preset fails the build instead of being skipped at runtime.
+ */
+
+namespace {
+
+[[noreturn]] void fail(const QString& message)
+{
+    QTextStream(stderr) << "presetc: " << message << Qt::endl;
+    std::exit(1);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList arguments = app.arguments().mid(1);
+    if (arguments.isEmpty()) {
+        fail("Usage: presetc <output> <preset.json>...");
+    }
+    const QString outputPath = arguments.takeFirst();
+
+    QList<GamePreset> presets;
+    presets.reserve(arguments.size());
+    for (const QString& path : arguments) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            fail(QString("Cannot read %1").arg(path));
+        }
+        auto result = PresetBundle::parseJson(file.readAll());
+        if (result.isErr()) {
+            fail(QString("%1: %2").arg(QFileInfo(path).fileName(), result.error()));
+        }
+        presets.append(result.takeValue());
+    }
+
+    auto bundle = PresetBundle::compile(presets);
+    if (bundle.isErr()) {
+        fail(bundle.error());
+    }
+
+    QSaveFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly)
+        || output.write(bundle.value()) != bundle.value().size()
+        || !output.commit()) {
+        fail(QString("Cannot write %1").arg(outputPath));
+    }
+    return 0;
+}